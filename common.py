@@ -74,6 +74,7 @@ def get_sources(env, is_editor_build):
         "storage/*.cpp",
         "storage/metadata/*.cpp",
 
+        "generators/generated_block_disk_cache.cpp",
         "generators/generate_block_task.cpp",
         "generators/voxel_generator_script.cpp",
         "generators/voxel_generator.cpp",
@@ -110,6 +111,7 @@ def get_sources(env, is_editor_build):
         "util/noise/gd_noise_range.cpp",
         "util/noise/spot_noise_gd.cpp",
         "util/string/*.cpp",
+        "util/thread/cpu_topology.cpp",
         "util/thread/thread.cpp",
         "util/thread/spatial_lock_2d.cpp",
         "util/thread/spatial_lock_3d.cpp",
@@ -187,6 +189,7 @@ def get_sources(env, is_editor_build):
             "tests/*.cpp",
             "tests/util/*.cpp",
 
+            "tests/voxel/test_block_data_tasks.cpp",
             "tests/voxel/test_block_serializer.cpp",
             "tests/voxel/test_curve_range.cpp",
             "tests/voxel/test_edition_funcs.cpp",
@@ -199,6 +202,7 @@ def get_sources(env, is_editor_build):
             "tests/voxel/test_voxel_data_map.cpp",
             "tests/voxel/test_voxel_graph.cpp",
             "tests/voxel/test_voxel_instancer.cpp",
+            "tests/voxel/test_voxel_mesher_blocky.cpp",
             "tests/voxel/test_voxel_mesher_cubes.cpp",
         ]
 
@@ -214,14 +218,14 @@ def get_sources(env, is_editor_build):
             "thirdparty/meshoptimizer/*.cpp"
         ]
 
+        if tests_enabled:
+            sources += ["tests/voxel/test_transvoxel.cpp"]
+
         if gpu_enabled:
             sources += ["engine/detail_rendering/render_detail_texture_gpu_task.cpp"]
 
             if tests_enabled:
-                sources += [
-                    "tests/voxel/test_detail_rendering_gpu.cpp",
-                    "tests/voxel/test_transvoxel.cpp"
-                ]
+                sources += ["tests/voxel/test_detail_rendering_gpu.cpp"]
         
     if modifiers_enabled:
         env.Append(CPPDEFINES={"VOXEL_ENABLE_MODIFIERS": 1})
@@ -265,6 +269,9 @@ def get_sources(env, is_editor_build):
             "engine/gpu/*.cpp",
             "generators/generate_block_gpu_task.cpp",
         ]
+
+        if tests_enabled:
+            sources += ["tests/voxel/test_generate_block_gpu_task.cpp"]
     
     if basic_generators_enabled:
         env.Append(CPPDEFINES={"VOXEL_ENABLE_BASIC_GENERATORS": 1})
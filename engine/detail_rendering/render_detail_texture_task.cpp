@@ -125,6 +125,11 @@ void RenderDetailTextureTask::apply_result() {
 		return;
 	}
 
+	if (!output_textures->valid) {
+		// Cancelled before it could run
+		return;
+	}
+
 	if (!VoxelEngine::get_singleton().is_volume_valid(volume_id)) {
 		// This can happen if the user removes the volume while requests are still about to return
 		ZN_PRINT_VERBOSE("Normalmap task completed but volume wasn't found");
@@ -151,7 +156,9 @@ TaskPriority RenderDetailTextureTask::get_priority() {
 }
 
 bool RenderDetailTextureTask::is_cancelled() {
-	// TODO Cancel if too far?
+	if (cancellation_token.is_valid()) {
+		return cancellation_token.is_cancelled();
+	}
 	return false;
 }
 
@@ -5,6 +5,7 @@
 #include "../../meshers/voxel_mesher.h"
 #include "../../util/containers/std_vector.h"
 #include "../../util/memory/memory.h"
+#include "../../util/tasks/cancellation_token.h"
 #include "../../util/tasks/threaded_task.h"
 #include "../ids.h"
 #include "../priority_dependency.h"
@@ -41,6 +42,8 @@ public:
 	Vector3i mesh_block_position;
 	VolumeID volume_id;
 	PriorityDependency priority_dependency;
+	// Usually a child of the token of the meshing task, so both get cancelled together
+	TaskCancellationToken cancellation_token;
 
 	const char *get_debug_name() const override {
 		return "RenderDetailTexture";
@@ -120,6 +120,24 @@ void GPUTaskRunner::thread_func() {
 			MutexLock mlock(_mutex);
 			tasks = std::move(_shared_tasks);
 		}
+
+		// Drop tasks cancelled while they were waiting, so we don't spend GPU time on results nobody wants
+		{
+			size_t kept_count = 0;
+			for (size_t i = 0; i < tasks.size(); ++i) {
+				IGPUTask *task = tasks[i];
+				if (task->is_cancelled()) {
+					task->discard();
+					ZN_DELETE(task);
+					--_pending_count;
+				} else {
+					tasks[kept_count] = task;
+					++kept_count;
+				}
+			}
+			tasks.resize(kept_count);
+		}
+
 		if (tasks.size() == 0) {
 			_semaphore.wait();
 			continue;
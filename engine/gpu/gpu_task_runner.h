@@ -67,6 +67,14 @@ public:
 
 	virtual void prepare(GPUTaskContext &ctx) = 0;
 	virtual void collect(GPUTaskContext &ctx) = 0;
+
+	// May return `true` in order for the runner to skip the task before it is prepared.
+	virtual bool is_cancelled() {
+		return false;
+	}
+
+	// Called instead of `prepare` and `collect` when the task is skipped, before it gets destroyed.
+	virtual void discard() {}
 };
 
 // Runs tasks that schedules compute shaders and collects their results.
@@ -2,6 +2,7 @@
 #define VOXEL_STREAMING_DEPENDENCY_H
 
 #include "../generators/voxel_generator.h"
+#include "../streams/block_io_ordering.h"
 #include "../streams/voxel_stream.h"
 
 namespace zylann::voxel {
@@ -13,6 +14,8 @@ namespace zylann::voxel {
 struct StreamingDependency {
 	Ref<VoxelStream> stream;
 	Ref<VoxelGenerator> generator;
+	// Load and save tasks on the stream use this so they don't overtake each other on the same block
+	BlockIOOrdering io_ordering;
 	bool valid = true;
 
 	static void reset(
@@ -5,16 +5,19 @@
 #include "../streams/load_all_blocks_data_task.h"
 #include "../streams/load_block_data_task.h"
 #include "../streams/save_block_data_task.h"
+#include "../storage/voxel_memory_pool.h"
 #include "../util/godot/classes/os.h"
 #include "../util/godot/classes/project_settings.h"
 #include "../util/godot/classes/rd_sampler_state.h"
 #include "../util/godot/classes/rendering_device.h"
 #include "../util/godot/classes/rendering_server.h"
+#include "../util/godot/classes/time.h"
 #include "../util/io/log.h"
 #include "../util/macros.h"
 #include "../util/math/conv.h"
 #include "../util/profiling.h"
 #include "../util/string/format.h"
+#include "../util/thread/cpu_topology.h"
 
 namespace zylann::voxel {
 
@@ -58,9 +61,23 @@ VoxelEngine::VoxelEngine(Config config) {
 	}
 
 	_general_thread_pool.set_name("Voxel general");
+	_general_thread_pool.set_affinity_mode(config.thread_affinity);
+	if (config.thread_affinity != ThreadedTaskRunner::AFFINITY_NONE) {
+		ZN_PRINT_VERBOSE(format("Voxel: NUMA nodes: {}", cpu_topology::get_numa_node_count()));
+		// Only worth it when threads stay on their node. Otherwise most of them would use the list of node 0.
+		VoxelMemoryPool::get_singleton().set_numa_node_count(cpu_topology::get_numa_node_count());
+	}
 	_general_thread_pool.set_thread_count(thread_count);
 	_general_thread_pool.set_priority_update_period(200);
 
+	if (config.io_thread_count > 0) {
+		// I/O threads spend most of their time waiting on the device, so they are not counted in the general pool
+		ZN_PRINT_VERBOSE(format("Voxel: I/O thread count set to {}", config.io_thread_count));
+		_io_thread_pool.set_name("Voxel I/O");
+		_io_thread_pool.set_thread_count(config.io_thread_count);
+		_io_thread_pool.set_priority_update_period(200);
+	}
+
 	// Init world
 	_world.shared_priority_dependency = make_shared_instance<PriorityDependency::ViewersData>();
 	// Give initial capacity to make invalidation less likely
@@ -71,6 +88,31 @@ VoxelEngine::VoxelEngine(Config config) {
 	ZN_PRINT_VERBOSE(format("Size of MeshBlockTask: {}", sizeof(MeshBlockTask)));
 
 	set_main_thread_time_budget_usec(config.main_thread_budget_usec);
+	set_main_thread_target_frame_time_usec(config.main_thread_target_frame_time_usec);
+
+	// Collision and instancer work runs outside of time-spread tasks, only their time is reported so it is deducted
+	// from the budget of other categories. They keep a weight of zero.
+	_time_spread_task_runner.set_category_weight(MAIN_THREAD_CATEGORY_MESH, 4.f);
+	_time_spread_task_runner.set_category_weight(MAIN_THREAD_CATEGORY_DETAIL_TEXTURE, 1.f);
+	_time_spread_task_runner.set_category_weight(MAIN_THREAD_CATEGORY_OTHER, 1.f);
+}
+
+const char *VoxelEngine::get_main_thread_category_name(MainThreadCategory category) {
+	switch (category) {
+		case MAIN_THREAD_CATEGORY_COLLISION:
+			return "collision";
+		case MAIN_THREAD_CATEGORY_MESH:
+			return "mesh";
+		case MAIN_THREAD_CATEGORY_DETAIL_TEXTURE:
+			return "detail_texture";
+		case MAIN_THREAD_CATEGORY_INSTANCER:
+			return "instancer";
+		case MAIN_THREAD_CATEGORY_OTHER:
+			return "other";
+		default:
+			ZN_PRINT_ERROR("Unknown category");
+			return "";
+	}
 }
 
 VoxelEngine::~VoxelEngine() {
@@ -132,9 +174,11 @@ void VoxelEngine::try_initialize_gpu_features() {
 }
 
 void VoxelEngine::wait_and_clear_all_tasks(bool warn) {
+	// I/O tasks may schedule general tasks when they complete, so wait for them first
+	_io_thread_pool.wait_for_all_tasks();
 	_general_thread_pool.wait_for_all_tasks();
 
-	_general_thread_pool.dequeue_completed_tasks([warn](zylann::IThreadedTask *task) {
+	auto clear_task = [warn](zylann::IThreadedTask *task) {
 		if (warn) {
 			ZN_PRINT_WARNING(
 					"General tasks remain on module cleanup, "
@@ -142,16 +186,30 @@ void VoxelEngine::wait_and_clear_all_tasks(bool warn) {
 			);
 		}
 		ZN_DELETE(task);
-	});
+	};
+
+	_io_thread_pool.dequeue_completed_tasks(clear_task);
+	_general_thread_pool.dequeue_completed_tasks(clear_task);
 }
 
 VolumeID VoxelEngine::add_volume(VolumeCallbacks callbacks) {
 	ZN_ASSERT(callbacks.check_callbacks());
 	Volume volume;
 	volume.callbacks = callbacks;
+	const unsigned int numa_node_count = cpu_topology::get_numa_node_count();
+	if (_general_thread_pool.get_affinity_mode() != ThreadedTaskRunner::AFFINITY_NONE && numa_node_count > 1) {
+		// Round-robin. Volumes are usually few, so this should be enough to spread them.
+		volume.numa_node = _next_volume_numa_node % numa_node_count;
+		++_next_volume_numa_node;
+	}
 	return _world.volumes.add(volume);
 }
 
+int8_t VoxelEngine::get_volume_numa_node(VolumeID volume_id) const {
+	const Volume &volume = _world.volumes.get(volume_id);
+	return volume.numa_node;
+}
+
 VoxelEngine::VolumeCallbacks VoxelEngine::get_volume_callbacks(VolumeID volume_id) const {
 	const Volume &volume = _world.volumes.get(volume_id);
 	return volume.callbacks;
@@ -245,9 +303,10 @@ bool VoxelEngine::viewer_exists(ViewerID viewer_id) const {
 
 void VoxelEngine::push_main_thread_time_spread_task(
 		zylann::ITimeSpreadTask *task,
-		TimeSpreadTaskRunner::Priority priority
+		TimeSpreadTaskRunner::Priority priority,
+		MainThreadCategory category
 ) {
-	_time_spread_task_runner.push(task, priority);
+	_time_spread_task_runner.push(task, priority, category);
 }
 
 void VoxelEngine::push_main_thread_progressive_task(zylann::IProgressiveTask *task) {
@@ -255,11 +314,23 @@ void VoxelEngine::push_main_thread_progressive_task(zylann::IProgressiveTask *ta
 }
 
 int VoxelEngine::get_main_thread_time_budget_usec() const {
-	return _main_thread_time_budget_usec;
+	return _main_thread_time_budget.get_max_usec();
 }
 
 void VoxelEngine::set_main_thread_time_budget_usec(unsigned int usec) {
-	_main_thread_time_budget_usec = usec;
+	_main_thread_time_budget.set_max_usec(usec);
+}
+
+void VoxelEngine::set_main_thread_target_frame_time_usec(unsigned int usec) {
+	_main_thread_time_budget.set_target_frame_time_usec(usec);
+}
+
+unsigned int VoxelEngine::get_main_thread_available_budget_usec() const {
+	return _main_thread_time_budget.get_usec();
+}
+
+void VoxelEngine::report_main_thread_time_usage(MainThreadCategory category, uint32_t usec) {
+	_time_spread_task_runner.add_external_time_usage(category, usec);
 }
 
 bool VoxelEngine::is_threaded_graphics_resource_building_enabled() const {
@@ -279,12 +350,22 @@ void VoxelEngine::push_async_tasks(Span<zylann::IThreadedTask *> tasks) {
 }
 
 void VoxelEngine::push_async_io_task(zylann::IThreadedTask *task) {
-	// I/O tasks run in serial because they usually can't run well in parallel due to locking shared resources.
-	_general_thread_pool.enqueue(task, true);
+	if (_io_thread_pool.get_thread_count() > 0) {
+		// Streams are thread-safe, so requests can overlap. This allows to keep fast storage devices busy.
+		// Tasks on the same block still run in the order they were created, see `BlockIOOrdering`.
+		_io_thread_pool.enqueue(task, false);
+	} else {
+		// I/O tasks run in serial because they usually can't run well in parallel due to locking shared resources.
+		_general_thread_pool.enqueue(task, true);
+	}
 }
 
 void VoxelEngine::push_async_io_tasks(Span<zylann::IThreadedTask *> tasks) {
-	_general_thread_pool.enqueue(tasks, true);
+	if (_io_thread_pool.get_thread_count() > 0) {
+		_io_thread_pool.enqueue(tasks, false);
+	} else {
+		_general_thread_pool.enqueue(tasks, true);
+	}
 }
 
 #ifdef VOXEL_ENABLE_GPU
@@ -303,6 +384,7 @@ void VoxelEngine::process() {
 	ZN_PROFILE_PLOT("TimeSpread tasks", int64_t(_time_spread_task_runner.get_pending_count()));
 	ZN_PROFILE_PLOT("Progressive tasks", int64_t(_progressive_task_runner.get_pending_count()));
 	ZN_PROFILE_PLOT("Threaded tasks", int64_t(_general_thread_pool.get_debug_remaining_tasks()));
+	ZN_PROFILE_PLOT("I/O tasks", int64_t(_io_thread_pool.get_debug_remaining_tasks()));
 	ZN_PROFILE_PLOT("Objects", int64_t(ObjectDB::get_object_count()));
 	ZN_PROFILE_PLOT(
 			"ZN Std Allocator",
@@ -310,14 +392,19 @@ void VoxelEngine::process() {
 	);
 
 	// Receive generation and meshing results
-	_general_thread_pool.dequeue_completed_tasks([](zylann::IThreadedTask *task) {
+	auto apply_task_result = [](zylann::IThreadedTask *task) {
 		task->apply_result();
 		ZN_DELETE(task);
-	});
+	};
+	_io_thread_pool.dequeue_completed_tasks(apply_task_result);
+	_general_thread_pool.dequeue_completed_tasks(apply_task_result);
+
+	_main_thread_time_budget.update(Time::get_singleton()->get_ticks_usec());
+	ZN_PROFILE_PLOT("Main thread budget", int64_t(_main_thread_time_budget.get_usec()));
 
 	// Run this after dequeueing threaded tasks, because they can add some to this runner,
 	// which could in turn complete right away (we avoid 1-frame delays this way).
-	_time_spread_task_runner.process(_main_thread_time_budget_usec);
+	_time_spread_task_runner.process(_main_thread_time_budget.get_usec());
 
 	_progressive_task_runner.process();
 
@@ -397,6 +484,16 @@ VoxelEngine::Stats::ThreadPoolStats debug_get_pool_stats(const zylann::ThreadedT
 VoxelEngine::Stats VoxelEngine::get_stats() const {
 	Stats s;
 	s.general = debug_get_pool_stats(_general_thread_pool);
+	s.io = debug_get_pool_stats(_io_thread_pool);
+	s.main_thread_budget_usec = _main_thread_time_budget.get_usec();
+	for (unsigned int i = 0; i < MAIN_THREAD_CATEGORY_COUNT; ++i) {
+		const TimeSpreadTaskRunner::CategoryStats cs = _time_spread_task_runner.get_category_stats(i);
+		Stats::MainThreadCategoryStats &d = s.main_thread_categories[i];
+		d.time_usec = cs.last_time_usec;
+		d.budget_usec = cs.last_budget_usec;
+		d.run_tasks = cs.last_run_count;
+		d.pending_tasks = cs.pending_count;
+	}
 	s.generation_tasks = _debug_generate_block_task_count;
 	s.meshing_tasks = MeshBlockTask::debug_get_running_count();
 	s.streaming_tasks = LoadBlockDataTask::debug_get_running_count() + SaveBlockDataTask::debug_get_running_count();
@@ -411,6 +508,10 @@ int VoxelEngine::get_thread_count() const {
 	return _general_thread_pool.get_thread_count();
 }
 
+unsigned int VoxelEngine::get_idle_thread_count() const {
+	return _general_thread_pool.get_idle_thread_count();
+}
+
 void VoxelEngine::set_thread_count(uint32_t count) {
 	_general_thread_pool.set_thread_count(count);
 }
@@ -8,6 +8,7 @@
 #include "../util/io/file_locker.h"
 #include "../util/memory/memory.h"
 #include "../util/string/std_string.h"
+#include "../util/tasks/adaptive_time_budget.h"
 #include "../util/tasks/progressive_task_runner.h"
 #include "../util/tasks/threaded_task_runner.h"
 #include "../util/tasks/time_spread_task_runner.h"
@@ -65,6 +66,10 @@ public:
 		bool has_mesh_resource;
 		// Tells if the meshing task was required to build a rendering mesh if possible.
 		bool visual_was_required;
+		// Set if incremental meshing was requested, so it can be given to the next update of the same block.
+		std::shared_ptr<VoxelMesher::IncrementalCache> incremental_cache;
+		// Identifies which update of the block this output comes from
+		uint32_t mesh_update_id;
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 		// Can be null. Attached to meshing output so it is tracked more easily, because it is baked asynchronously
 		// starting from the mesh task, and it might complete earlier or later than the mesh.
@@ -148,6 +153,19 @@ public:
 
 	static constexpr unsigned int DEFAULT_MAIN_THREAD_BUDGET_USEC = 8000;
 
+	// Kinds of work done on the main thread. Each gets its own share of the main thread budget, so that one kind
+	// can't starve the others. Categories are listed in processing order, most important first.
+	enum MainThreadCategory {
+		MAIN_THREAD_CATEGORY_COLLISION = 0,
+		MAIN_THREAD_CATEGORY_MESH,
+		MAIN_THREAD_CATEGORY_DETAIL_TEXTURE,
+		MAIN_THREAD_CATEGORY_INSTANCER,
+		MAIN_THREAD_CATEGORY_OTHER,
+		MAIN_THREAD_CATEGORY_COUNT
+	};
+
+	static const char *get_main_thread_category_name(MainThreadCategory category);
+
 	struct Config {
 		int thread_count_minimum = 1;
 		// How many threads below available count on the CPU should we set as limit
@@ -155,6 +173,15 @@ public:
 		// Portion of available CPU threads to attempt using
 		float thread_count_ratio_over_max = 0.5;
 		unsigned int main_thread_budget_usec = DEFAULT_MAIN_THREAD_BUDGET_USEC;
+		// Pins threads to CPUs. On multi-socket machines, threads are grouped by NUMA node, and volumes are assigned a
+		// node so their tasks tend to run close to their memory.
+		ThreadedTaskRunner::AffinityMode thread_affinity = ThreadedTaskRunner::AFFINITY_NONE;
+		// If not zero, the main thread budget shrinks when frames take longer than this, and grows back up to
+		// `main_thread_budget_usec` when they are shorter.
+		unsigned int main_thread_target_frame_time_usec = 0;
+		// If zero, I/O tasks run one at a time in the general pool. Otherwise, they run in a separate pool with this
+		// many threads, so multiple requests can be in flight at once. Streams must be thread-safe for that.
+		unsigned int io_thread_count = 0;
 	};
 
 	static VoxelEngine &get_singleton();
@@ -172,6 +199,8 @@ public:
 
 	void remove_volume(VolumeID volume_id);
 	bool is_volume_valid(VolumeID volume_id) const;
+	// Gets which NUMA node tasks of a volume should preferably run on, or -1 if there is no preference.
+	int8_t get_volume_numa_node(VolumeID volume_id) const;
 
 	std::shared_ptr<PriorityDependency::ViewersData> get_shared_viewers_data_from_default_world() const {
 		return _world.shared_priority_dependency;
@@ -201,10 +230,17 @@ public:
 
 	void push_main_thread_time_spread_task(
 			ITimeSpreadTask *task,
-			TimeSpreadTaskRunner::Priority priority = TimeSpreadTaskRunner::PRIORITY_NORMAL
+			TimeSpreadTaskRunner::Priority priority = TimeSpreadTaskRunner::PRIORITY_NORMAL,
+			MainThreadCategory category = MAIN_THREAD_CATEGORY_OTHER
 	);
 	int get_main_thread_time_budget_usec() const;
 	void set_main_thread_time_budget_usec(unsigned int usec);
+	void set_main_thread_target_frame_time_usec(unsigned int usec);
+	// Gets the main thread budget after adaptation to frame time.
+	unsigned int get_main_thread_available_budget_usec() const;
+	// Accounts for main thread work that doesn't run as a time-spread task. It will be deducted from the budget of
+	// the next frame and reported in stats. Must be called on the main thread.
+	void report_main_thread_time_usage(MainThreadCategory category, uint32_t usec);
 
 	// This should be fast and safe to access from multiple threads.
 	bool is_threaded_graphics_resource_building_enabled() const;
@@ -262,7 +298,17 @@ public:
 			FixedArray<const char *, ThreadedTaskRunner::MAX_THREADS> active_task_names;
 		};
 
+		struct MainThreadCategoryStats {
+			uint32_t time_usec;
+			uint32_t budget_usec;
+			uint32_t run_tasks;
+			uint32_t pending_tasks;
+		};
+
 		ThreadPoolStats general;
+		ThreadPoolStats io;
+		FixedArray<MainThreadCategoryStats, MAIN_THREAD_CATEGORY_COUNT> main_thread_categories;
+		unsigned int main_thread_budget_usec;
 		int generation_tasks;
 		int streaming_tasks;
 		int meshing_tasks;
@@ -277,6 +323,9 @@ public:
 	int get_thread_count() const;
 	void set_thread_count(uint32_t count);
 
+	// Thread-safe. Approximate count of threads of the general pool that have nothing to do.
+	unsigned int get_idle_thread_count() const;
+
 #ifdef VOXEL_ENABLE_GPU
 	bool has_rendering_device() const {
 		return _gpu_task_runner.has_rendering_device();
@@ -329,6 +378,7 @@ private:
 
 	struct Volume {
 		VolumeCallbacks callbacks;
+		int8_t numa_node = -1;
 	};
 
 	struct World {
@@ -343,9 +393,14 @@ private:
 	World _world;
 
 	ThreadedTaskRunner _general_thread_pool;
+	// Only has threads if I/O tasks are configured to run in parallel
+	ThreadedTaskRunner _io_thread_pool;
+	// Used to distribute volumes across NUMA nodes
+	unsigned int _next_volume_numa_node = 0;
 	// For tasks that can only run on the main thread and be spread out over frames
 	TimeSpreadTaskRunner _time_spread_task_runner;
-	unsigned int _main_thread_time_budget_usec = DEFAULT_MAIN_THREAD_BUDGET_USEC;
+	// Can be lower than the configured budget when frames take too long
+	AdaptiveTimeBudget _main_thread_time_budget;
 	ProgressiveTaskRunner _progressive_task_runner;
 
 	FileLocker _file_locker;
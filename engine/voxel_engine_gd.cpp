@@ -54,10 +54,21 @@ VoxelEngine::Config VoxelEngine::get_config_from_godot() {
 	add_custom_project_setting(
 			Variant::INT, "voxel/threads/main/time_budget_ms", PROPERTY_HINT_RANGE, "0,1000", 8, true
 	);
+	add_custom_project_setting(
+			Variant::FLOAT, "voxel/threads/main/target_frame_time_ms", PROPERTY_HINT_RANGE, "0,1000,0.1", 0.f, true
+	);
+
+	add_custom_project_setting(
+			Variant::INT, "voxel/threads/affinity", PROPERTY_HINT_ENUM, "None,NUMA Node,Core", 0, true
+	);
+
+	add_custom_project_setting(Variant::INT, "voxel/threads/io/count", PROPERTY_HINT_RANGE, "0,32", 0, true);
 
 	add_custom_project_setting(Variant::BOOL, "voxel/ownership_checks", PROPERTY_HINT_NONE, "", true, true);
 
 	config.inner.main_thread_budget_usec = 1000 * int(ps.get("voxel/threads/main/time_budget_ms"));
+	const float target_frame_time_ms = math::max(float(ps.get("voxel/threads/main/target_frame_time_ms")), 0.f);
+	config.inner.main_thread_target_frame_time_usec = static_cast<unsigned int>(1000.f * target_frame_time_ms);
 
 	config.inner.thread_count_minimum = math::max(1, int(ps.get("voxel/threads/count/minimum")));
 
@@ -68,6 +79,12 @@ VoxelEngine::Config VoxelEngine::get_config_from_godot() {
 	config.inner.thread_count_ratio_over_max =
 			math::clamp(float(ps.get("voxel/threads/count/ratio_over_max")), 0.f, 1.f);
 
+	config.inner.thread_affinity = static_cast<ThreadedTaskRunner::AffinityMode>(math::clamp(
+			int(ps.get("voxel/threads/affinity")), 0, static_cast<int>(ThreadedTaskRunner::AFFINITY_MODE_COUNT) - 1
+	));
+
+	config.inner.io_thread_count = math::clamp(int(ps.get("voxel/threads/io/count")), 0, 32);
+
 	config.ownership_checks = ps.get("voxel/ownership_checks");
 
 	return config;
@@ -138,6 +155,7 @@ Dictionary to_dict(const zylann::voxel::VoxelEngine::Stats::ThreadPoolStats &sta
 Dictionary to_dict(const zylann::voxel::VoxelEngine::Stats &stats) {
 	Dictionary pools;
 	pools["general"] = to_dict(stats.general);
+	pools["io"] = to_dict(stats.io);
 
 	Dictionary tasks;
 	tasks["streaming"] = stats.streaming_tasks;
@@ -148,6 +166,24 @@ Dictionary to_dict(const zylann::voxel::VoxelEngine::Stats &stats) {
 	tasks["gpu"] = stats.gpu_tasks;
 #endif
 
+	Dictionary main_thread;
+	main_thread["budget_usec"] = stats.main_thread_budget_usec;
+	{
+		Dictionary categories;
+		for (unsigned int i = 0; i < stats.main_thread_categories.size(); ++i) {
+			const zylann::voxel::VoxelEngine::Stats::MainThreadCategoryStats &cs = stats.main_thread_categories[i];
+			Dictionary cd;
+			cd["time_usec"] = cs.time_usec;
+			cd["budget_usec"] = cs.budget_usec;
+			cd["run_tasks"] = cs.run_tasks;
+			cd["pending_tasks"] = cs.pending_tasks;
+			categories[zylann::voxel::VoxelEngine::get_main_thread_category_name(
+					static_cast<zylann::voxel::VoxelEngine::MainThreadCategory>(i)
+			)] = cd;
+		}
+		main_thread["categories"] = categories;
+	}
+
 	// This part is additional for scripts because VoxelMemoryPool is not exposed
 	Dictionary mem;
 	mem["voxel_total"] = ZN_SIZE_T_TO_VARIANT(VoxelMemoryPool::get_singleton().debug_get_total_memory());
@@ -168,6 +204,7 @@ Dictionary to_dict(const zylann::voxel::VoxelEngine::Stats &stats) {
 	Dictionary d;
 	d["thread_pools"] = pools;
 	d["tasks"] = tasks;
+	d["main_thread"] = main_thread;
 	d["memory_pools"] = mem;
 	return d;
 }
@@ -222,6 +259,9 @@ Vector3 VoxelEngine::get_editor_camera_direction() const {
 void VoxelEngine::run_tests(Dictionary options_dict) {
 	zylann::testing::TestOptions options(options_dict);
 	zylann::voxel::tests::run_voxel_tests(options);
+	if (options_dict.get("benchmarks", false)) {
+		zylann::voxel::tests::run_voxel_benchmarks(options);
+	}
 }
 
 #endif
@@ -493,4 +493,19 @@ void GenerateBlockGPUTask::collect(GPUTaskContext &ctx) {
 	consumer_task = nullptr;
 }
 
+bool GenerateBlockGPUTask::is_cancelled() {
+	ZN_ASSERT_RETURN_V(consumer_task != nullptr, true);
+	return consumer_task->is_cancelled();
+}
+
+void GenerateBlockGPUTask::discard() {
+	ZN_ASSERT_RETURN(consumer_task != nullptr);
+	// Give the consumer back to the task runner without results. It will be completed without running, so whoever
+	// requested it still gets notified. Its own cancellation state is not enough for this, because some of it gets
+	// re-evaluated (like distance to viewers).
+	consumer_task->set_gpu_results_discarded();
+	VoxelEngine::get_singleton().push_async_task(consumer_task);
+	consumer_task = nullptr;
+}
+
 } // namespace zylann::voxel
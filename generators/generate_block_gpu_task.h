@@ -8,7 +8,7 @@
 #include "../util/godot/classes/rd_uniform.h"
 #include "../util/math/box3i.h"
 #include "../util/memory/memory.h"
-#include "../util/tasks/threaded_task.h"
+#include "../util/tasks/resumable_threaded_task.h"
 
 #ifdef VOXEL_ENABLE_MODIFIERS
 #include "../modifiers/voxel_modifier.h"
@@ -42,10 +42,25 @@ private:
 };
 
 // Interface used for tasks that can spawn `GenerateBlockGPUTask`. It is required to return their results.
-class IGeneratingVoxelsThreadedTask : public IThreadedTask {
+// Such tasks suspend while the GPU works, so they are resumable.
+class IGeneratingVoxelsThreadedTask : public IResumableThreadedTask {
 public:
-	// Called when the GPU task is complete.
+	// Called when the GPU task is complete, before the task is scheduled again.
 	virtual void set_gpu_results(StdVector<GenerateBlockGPUTaskResult> &&results) = 0;
+
+	// Called instead of `set_gpu_results` when the GPU task was discarded, before the task is scheduled again. The task
+	// must then report itself as cancelled, so it completes as dropped.
+	void set_gpu_results_discarded() {
+		_gpu_results_discarded = true;
+	}
+
+protected:
+	inline bool are_gpu_results_discarded() const {
+		return _gpu_results_discarded;
+	}
+
+private:
+	bool _gpu_results_discarded = false;
 };
 
 // Generates a block of voxels on the GPU. Must be scheduled from a threaded task, which will be resumed when this one
@@ -58,6 +73,8 @@ public:
 
 	void prepare(GPUTaskContext &ctx) override;
 	void collect(GPUTaskContext &ctx) override;
+	bool is_cancelled() override;
+	void discard() override;
 
 	// TODO Not sure if it's worth dealing with sub-boxes. That's only in case of partially-edited meshing blocks...
 	// this case doesn't sound common enough.
@@ -39,60 +39,74 @@ GenerateBlockTask::~GenerateBlockTask() {
 	// println(format("H {} {} {} {}", position.x, position.y, position.z, Time::get_singleton()->get_ticks_usec()));
 }
 
-void GenerateBlockTask::run(zylann::ThreadedTaskContext &ctx) {
+IResumableThreadedTask::StageResult GenerateBlockTask::run_stage(uint8_t stage, zylann::ThreadedTaskContext &ctx) {
 	ZN_DSTACK();
 	ZN_PROFILE_SCOPE();
 
 	CRASH_COND(_stream_dependency == nullptr);
-	Ref<VoxelGenerator> generator = _stream_dependency->generator;
-	ERR_FAIL_COND(generator.is_null());
 
-	if (_voxels == nullptr) {
-		_voxels = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_POOL);
-		_voxels->create(Vector3iUtil::create(_block_size), &_format);
+	switch (stage) {
+		case STAGE_GENERATE: {
+			Ref<VoxelGenerator> generator = _stream_dependency->generator;
+			ERR_FAIL_COND_V(generator.is_null(), STAGE_DONE);
 
-	} else if (!_voxels->has_format(_format)) {
-		_voxels->create(Vector3iUtil::create(_block_size), &_format);
-	}
+			if (_voxels == nullptr) {
+				_voxels = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_POOL);
+				_voxels->create(Vector3iUtil::create(_block_size), &_format);
+
+			} else if (!_voxels->has_format(_format)) {
+				_voxels->create(Vector3iUtil::create(_block_size), &_format);
+			}
 
 #ifdef VOXEL_ENABLE_GPU
-	if (_use_gpu) {
-		if (_stage == 0) {
-			run_gpu_task(ctx);
+			if (_use_gpu) {
+				return run_gpu_task();
+			}
+#endif
+			run_cpu_generation();
+			set_next_stage(STAGE_SAVE_AND_FINISH);
+			return STAGE_CONTINUE;
 		}
-		if (_stage == 1) {
+
+#ifdef VOXEL_ENABLE_GPU
+		case STAGE_CONVERT_GPU_VOXELS:
+			if (are_gpu_results_discarded()) {
+				// Finish as dropped
+				return STAGE_DONE;
+			}
 			run_gpu_conversion();
-		}
-		if (_stage == 2) {
-			run_stream_saving_and_finish();
-		}
-	} else
+			return STAGE_CONTINUE;
 #endif
-	{
-		run_cpu_generation();
-		run_stream_saving_and_finish();
+
+		case STAGE_SAVE_AND_FINISH:
+			run_stream_saving_and_finish();
+			return STAGE_DONE;
+
+		default:
+			ZN_PRINT_ERROR(format("Unexpected stage {}", stage));
+			return STAGE_DONE;
 	}
 }
 
 #ifdef VOXEL_ENABLE_GPU
 
-void GenerateBlockTask::run_gpu_task(zylann::ThreadedTaskContext &ctx) {
+IResumableThreadedTask::StageResult GenerateBlockTask::run_gpu_task() {
 	Ref<VoxelGenerator> generator = _stream_dependency->generator;
-	ERR_FAIL_COND(generator.is_null());
+	ERR_FAIL_COND_V(generator.is_null(), STAGE_DONE);
 
 	// TODO Broad-phase to avoid the GPU part entirely?
 	// Implement and call `VoxelGenerator::generate_broad_block()`
 
 	std::shared_ptr<ComputeShader> generator_shader = generator->get_block_rendering_shader();
-	ERR_FAIL_COND(generator_shader == nullptr);
+	ERR_FAIL_COND_V(generator_shader == nullptr, STAGE_DONE);
 
 	const Vector3i origin_in_voxels = (_position << _lod_index) * _block_size;
 
 	ZN_ASSERT(_voxels != nullptr);
 	VoxelGenerator::VoxelQueryData generator_query{ *_voxels, origin_in_voxels, _lod_index };
 	if (generator->generate_broad_block(generator_query)) {
-		_stage = 2;
-		return;
+		set_next_stage(STAGE_SAVE_AND_FINISH);
+		return STAGE_CONTINUE;
 	}
 
 	const Vector3i resolution = Vector3iUtil::create(_block_size);
@@ -116,20 +130,19 @@ void GenerateBlockTask::run_gpu_task(zylann::ThreadedTaskContext &ctx) {
 	}
 #endif
 
-	ctx.status = ThreadedTaskContext::STATUS_TAKEN_OUT;
+	set_next_stage(STAGE_CONVERT_GPU_VOXELS);
 
 	// Start GPU task, we'll continue after it
 	VoxelEngine::get_singleton().push_gpu_task(gpu_task);
+	return STAGE_SUSPEND;
 }
 
 void GenerateBlockTask::set_gpu_results(StdVector<GenerateBlockGPUTaskResult> &&results) {
 	_gpu_generation_results = std::move(results);
-	_stage = 1;
 }
 
 void GenerateBlockTask::run_gpu_conversion() {
 	GenerateBlockGPUTaskResult::convert_to_voxel_buffer(to_span(_gpu_generation_results), *_voxels);
-	_stage = 2;
 }
 
 #endif
@@ -191,10 +204,23 @@ TaskPriority GenerateBlockTask::get_priority() {
 	return p;
 }
 
+int GenerateBlockTask::get_preferred_numa_node() const {
+	return _data != nullptr ? _data->get_numa_node_hint() : -1;
+}
+
 bool GenerateBlockTask::is_cancelled() {
+#ifdef VOXEL_ENABLE_GPU
+	if (are_gpu_results_discarded()) {
+		return true;
+	}
+#endif
 	if (_stream_dependency->valid == false) {
 		return false;
 	}
+	if (_tracker != nullptr && _tracker->is_aborted()) {
+		// Another block the same edit depends on was aborted, so that edit won't happen
+		return true;
+	}
 	if (_cancellation_token.is_valid()) {
 		return _cancellation_token.is_cancelled();
 	}
@@ -5,7 +5,7 @@
 #include "../engine/priority_dependency.h"
 #include "../engine/streaming_dependency.h"
 #include "../util/containers/std_vector.h"
-#include "../util/tasks/threaded_task.h"
+#include "../util/tasks/resumable_threaded_task.h"
 
 #ifdef VOXEL_ENABLE_GPU
 #include "generate_block_gpu_task.h"
@@ -24,7 +24,7 @@ class GenerateBlockTask
 #ifdef VOXEL_ENABLE_GPU
 		: public IGeneratingVoxelsThreadedTask
 #else
-		: public IThreadedTask
+		: public IResumableThreadedTask
 #endif
 {
 public:
@@ -35,18 +35,27 @@ public:
 		return "GenerateBlock";
 	}
 
-	void run(ThreadedTaskContext &ctx) override;
 	TaskPriority get_priority() override;
 	bool is_cancelled() override;
+	int get_preferred_numa_node() const override;
 	void apply_result() override;
 
 #ifdef VOXEL_ENABLE_GPU
 	void set_gpu_results(StdVector<GenerateBlockGPUTaskResult> &&results) override;
 #endif
 
+protected:
+	StageResult run_stage(uint8_t stage, ThreadedTaskContext &ctx) override;
+
 private:
+	enum Stage : uint8_t {
+		STAGE_GENERATE = 0,
+		STAGE_CONVERT_GPU_VOXELS,
+		STAGE_SAVE_AND_FINISH,
+	};
+
 #ifdef VOXEL_ENABLE_GPU
-	void run_gpu_task(zylann::ThreadedTaskContext &ctx);
+	StageResult run_gpu_task();
 	void run_gpu_conversion();
 #endif
 	void run_cpu_generation();
@@ -74,7 +83,6 @@ private:
 	bool _too_far = false;
 	bool _max_lod_hint = false;
 #ifdef VOXEL_ENABLE_GPU
-	uint8_t _stage = 0;
 	StdVector<GenerateBlockGPUTaskResult> _gpu_generation_results;
 #endif
 };
@@ -0,0 +1,513 @@
+#include "generated_block_disk_cache.h"
+#include "../engine/voxel_engine.h"
+#include "../storage/voxel_buffer.h"
+#include "../streams/voxel_block_serializer.h"
+#include "../util/containers/fixed_array.h"
+#include "../util/godot/classes/directory.h"
+#include "../util/godot/classes/file_access.h"
+#include "../util/godot/core/array.h"
+#include "../util/godot/file_utils.h"
+#include "../util/io/log.h"
+#include "../util/profiling.h"
+#include "../util/string/format.h"
+
+namespace zylann::voxel {
+
+using namespace zylann::godot;
+
+namespace {
+
+const uint32_t FILE_MAGIC = 0x42475856; // "VXGB"
+const uint32_t FILE_VERSION = 0;
+
+// Fixed-size, so block data always starts at the same aligned offset:
+// - uint32 magic
+// - uint32 version
+// - uint64 hash
+// - int32 origin[3]
+// - uint32 lod
+// - uint32 flags
+// - uint32 size[3]
+// - uint8 channel_depths[8]
+// - uint32 data_size
+// - uint32 reserved
+// - uint8 data[data_size]
+const uint32_t HEADER_SIZE = 64;
+
+const uint32_t FLAG_MAX_LOD_HINT = 1;
+
+struct Header {
+	uint64_t hash = 0;
+	Vector3i origin;
+	uint32_t lod = 0;
+	uint32_t flags = 0;
+	Vector3i size;
+	FixedArray<uint8_t, VoxelBuffer::MAX_CHANNELS> channel_depths;
+	uint32_t data_size = 0;
+};
+
+void store_header(FileAccess &f, const Header &header) {
+	f.store_32(FILE_MAGIC);
+	f.store_32(FILE_VERSION);
+	f.store_64(header.hash);
+	store_vec3u32(f, header.origin);
+	f.store_32(header.lod);
+	f.store_32(header.flags);
+	store_vec3u32(f, header.size);
+	for (const uint8_t depth : header.channel_depths) {
+		f.store_8(depth);
+	}
+	f.store_32(header.data_size);
+	f.store_32(0);
+}
+
+bool load_header(FileAccess &f, Header &out_header) {
+	if (f.get_length() < HEADER_SIZE) {
+		return false;
+	}
+	if (f.get_32() != FILE_MAGIC) {
+		return false;
+	}
+	if (f.get_32() != FILE_VERSION) {
+		return false;
+	}
+	out_header.hash = f.get_64();
+	// Stored as unsigned, but conversion back to signed restores negative values
+	out_header.origin = get_vec3u32(f);
+	out_header.lod = f.get_32();
+	out_header.flags = f.get_32();
+	out_header.size = get_vec3u32(f);
+	for (uint8_t &depth : out_header.channel_depths) {
+		depth = f.get_8();
+	}
+	out_header.data_size = f.get_32();
+	f.get_32();
+	return f.get_position() == HEADER_SIZE;
+}
+
+// Deleting files can take a while, so this is done after unlocking the mutex. If a block gets stored again in the
+// meantime, its file can be deleted after it was written. Loading it will then fail and remove its entry.
+void remove_files(const StdVector<String> &file_paths) {
+	ZN_PROFILE_SCOPE();
+	for (const String &fpath : file_paths) {
+		DirAccess::remove_absolute(fpath);
+	}
+}
+
+void get_channel_depths(const VoxelBuffer &buffer, FixedArray<uint8_t, VoxelBuffer::MAX_CHANNELS> &out_depths) {
+	for (unsigned int channel_index = 0; channel_index < out_depths.size(); ++channel_index) {
+		out_depths[channel_index] = buffer.get_channel_depth(channel_index);
+	}
+}
+
+} // namespace
+
+const char *GeneratedBlockDiskCache::FILE_EXTENSION = "vxgb";
+
+void GeneratedBlockDiskCache::set_directory(String path) {
+	MutexLock mlock(_mutex);
+	if (path == _directory) {
+		return;
+	}
+	_directory = path;
+	_enabled = !path.is_empty();
+	// Forget the hash, so outdated directories get looked for in the new location
+	_hash = 0;
+	_index_loaded = false;
+	_entries.clear();
+	_size = 0;
+}
+
+String GeneratedBlockDiskCache::get_directory() const {
+	MutexLock mlock(_mutex);
+	return _directory;
+}
+
+void GeneratedBlockDiskCache::set_owner_name(String name) {
+	MutexLock mlock(_mutex);
+	if (name == _owner_name) {
+		return;
+	}
+	_owner_name = name;
+	// Forget the hash, so outdated directories get looked for in the new location
+	_hash = 0;
+	_index_loaded = false;
+	_entries.clear();
+	_size = 0;
+}
+
+void GeneratedBlockDiskCache::set_max_size(uint64_t bytes) {
+	StdVector<String> removed_files;
+	{
+		MutexLock mlock(_mutex);
+		_max_size = bytes;
+		while (_size > _max_size && _entries.size() > 0) {
+			remove_least_recently_used(removed_files);
+		}
+	}
+	remove_files(removed_files);
+}
+
+uint64_t GeneratedBlockDiskCache::get_max_size() const {
+	MutexLock mlock(_mutex);
+	return _max_size;
+}
+
+bool GeneratedBlockDiskCache::try_load(
+		uint64_t hash,
+		Vector3i origin,
+		uint32_t lod,
+		VoxelBuffer &out_buffer,
+		bool &out_max_lod_hint
+) {
+	ZN_PROFILE_SCOPE();
+
+	if (!update_index(hash)) {
+		return false;
+	}
+
+	const Key key{ origin, lod };
+	String fpath;
+	{
+		MutexLock mlock(_mutex);
+		if (hash != _hash) {
+			return false;
+		}
+		// Checking the index first avoids accessing the disk when the block is not there
+		auto it = _entries.find(key);
+		if (it == _entries.end()) {
+			return false;
+		}
+		++_time;
+		it->second.last_used = _time;
+		fpath = get_file_path(hash, key);
+	}
+
+	bool success = false;
+	{
+		VoxelFileLockerRead file_rlock(to_std_string(fpath));
+
+		Error err;
+		Ref<FileAccess> f = open_file(fpath, FileAccess::READ, err);
+		if (f.is_valid()) {
+			Header header;
+			FixedArray<uint8_t, VoxelBuffer::MAX_CHANNELS> expected_depths;
+			get_channel_depths(out_buffer, expected_depths);
+
+			if (load_header(**f, header) && header.hash == hash && header.origin == origin && header.lod == lod &&
+				header.size == out_buffer.get_size() && header.channel_depths == expected_depths &&
+				HEADER_SIZE + header.data_size == f->get_length()) {
+				static thread_local StdVector<uint8_t> tls_data;
+				StdVector<uint8_t> &data = tls_data;
+				data.resize(header.data_size);
+				if (get_buffer(**f, to_span(data)) == header.data_size) {
+					success = BlockSerializer::deserialize(to_span(data), out_buffer);
+					out_max_lod_hint = (header.flags & FLAG_MAX_LOD_HINT) != 0;
+				}
+			}
+		}
+	}
+
+	if (!success) {
+		// Missing or invalid, it will be stored again after generation
+		ZN_PRINT_VERBOSE(format("Could not load cached generated block {}", fpath));
+		StdVector<String> removed_files;
+		{
+			MutexLock mlock(_mutex);
+			if (hash == _hash) {
+				remove_entry(key, removed_files);
+			}
+		}
+		remove_files(removed_files);
+	}
+
+	return success;
+}
+
+void GeneratedBlockDiskCache::store(
+		uint64_t hash,
+		Vector3i origin,
+		uint32_t lod,
+		const VoxelBuffer &buffer,
+		bool max_lod_hint
+) {
+	ZN_PROFILE_SCOPE();
+
+	if (!update_index(hash)) {
+		return;
+	}
+
+	const Key key{ origin, lod };
+	String fpath;
+	{
+		MutexLock mlock(_mutex);
+		if (hash != _hash) {
+			return;
+		}
+		fpath = get_file_path(hash, key);
+	}
+
+	const BlockSerializer::SerializeResult res = BlockSerializer::serialize(buffer);
+	ZN_ASSERT_RETURN(res.success);
+
+	Header header;
+	header.hash = hash;
+	header.origin = origin;
+	header.lod = lod;
+	header.flags = max_lod_hint ? FLAG_MAX_LOD_HINT : 0;
+	header.size = buffer.get_size();
+	get_channel_depths(buffer, header.channel_depths);
+	header.data_size = res.data.size();
+
+	const uint64_t file_size = HEADER_SIZE + header.data_size;
+	{
+		MutexLock mlock(_mutex);
+		if (file_size > _max_size) {
+			return;
+		}
+	}
+
+	{
+		VoxelFileLockerWrite file_wlock(to_std_string(fpath));
+
+		Error err;
+		Ref<FileAccess> f = open_file(fpath, FileAccess::WRITE, err);
+		ZN_ASSERT_RETURN_MSG(f.is_valid(), format("Could not write cached generated block {}, error {}", fpath, err));
+		store_header(**f, header);
+		store_buffer(**f, to_span(res.data));
+	}
+
+	StdVector<String> removed_files;
+	{
+		MutexLock mlock(_mutex);
+		if (hash != _hash) {
+			// The hash changed while the file was written, it will be removed with the directory of the old hash
+			return;
+		}
+		Entry &entry = _entries[key];
+		_size -= entry.size;
+		entry.size = file_size;
+		++_time;
+		entry.last_used = _time;
+		_size += file_size;
+
+		while (_size > _max_size && _entries.size() > 0) {
+			remove_least_recently_used(removed_files);
+		}
+	}
+	remove_files(removed_files);
+}
+
+void GeneratedBlockDiskCache::clear() {
+	uint64_t hash;
+	{
+		MutexLock mlock(_mutex);
+		hash = _hash;
+	}
+	if (!update_index(hash)) {
+		return;
+	}
+	StdVector<String> removed_files;
+	{
+		MutexLock mlock(_mutex);
+		while (_entries.size() > 0) {
+			remove_entry(_entries.begin()->first, removed_files);
+		}
+	}
+	remove_files(removed_files);
+}
+
+// Makes sure the index contains blocks of the given hash. Files are scanned without holding the mutex, since there can
+// be many of them. Returns false if the cache can't be used yet, because it is disabled or another thread is building
+// the index.
+bool GeneratedBlockDiskCache::update_index(uint64_t hash) {
+	String owner_dir;
+	String hash_dir;
+	bool remove_outdated = false;
+	{
+		MutexLock mlock(_mutex);
+		if (!_enabled) {
+			return false;
+		}
+		if (hash == _hash && _index_loaded) {
+			return true;
+		}
+		if (_index_loading) {
+			return false;
+		}
+		_index_loading = true;
+		// Results of other hashes can't be used anymore. We only remove them if we know they belong to us.
+		remove_outdated = hash != _hash && !_owner_name.is_empty();
+		_hash = hash;
+		_index_loaded = false;
+		_entries.clear();
+		_size = 0;
+		owner_dir = get_owner_directory();
+		hash_dir = get_hash_directory(hash);
+	}
+
+	ZN_PROFILE_SCOPE();
+
+	if (remove_outdated) {
+		remove_outdated_hash_directories(owner_dir, hash_dir.get_file());
+	}
+
+	StdUnorderedMap<Key, Entry, KeyHasher> entries;
+	uint64_t total_size = 0;
+
+	if (check_directory_created(hash_dir) == OK) {
+		Ref<DirAccess> dir = open_directory(hash_dir, nullptr);
+		if (dir.is_valid()) {
+			const String ext = String(".") + FILE_EXTENSION;
+
+			dir->list_dir_begin();
+			while (true) {
+				const String file_name = dir->get_next();
+				if (file_name == "") {
+					break;
+				}
+				if (dir->current_is_dir() || !file_name.ends_with(ext)) {
+					continue;
+				}
+				// lod.x.y.z.ext
+				const PackedStringArray parts = file_name.split(".");
+				if (parts.size() != 5) {
+					continue;
+				}
+				Key key;
+				key.lod = parts[0].to_int();
+				key.origin.x = parts[1].to_int();
+				key.origin.y = parts[2].to_int();
+				key.origin.z = parts[3].to_int();
+
+				const int64_t file_size = get_file_size(hash_dir.path_join(file_name));
+				if (file_size < 0) {
+					continue;
+				}
+				Entry &entry = entries[key];
+				entry.size = file_size;
+				total_size += entry.size;
+			}
+			dir->list_dir_end();
+		}
+	}
+
+	StdVector<String> removed_files;
+	{
+		MutexLock mlock(_mutex);
+		_index_loading = false;
+		if (hash != _hash || hash_dir != get_hash_directory(_hash)) {
+			// Settings changed while we were scanning, the index will be built again
+			return false;
+		}
+		_entries = std::move(entries);
+		_size = total_size;
+		_index_loaded = true;
+
+		while (_size > _max_size && _entries.size() > 0) {
+			remove_least_recently_used(removed_files);
+		}
+	}
+	remove_files(removed_files);
+	return true;
+}
+
+void GeneratedBlockDiskCache::remove_outdated_hash_directories(String owner_dir, String current_hash_dir_name) {
+	Ref<DirAccess> owner_dir_access = open_directory(owner_dir, nullptr);
+	if (owner_dir_access.is_null()) {
+		return;
+	}
+	StdVector<String> old_dir_names;
+
+	owner_dir_access->list_dir_begin();
+	while (true) {
+		const String dir_name = owner_dir_access->get_next();
+		if (dir_name == "") {
+			break;
+		}
+		// Only consider directories we could have created
+		if (owner_dir_access->current_is_dir() && dir_name != current_hash_dir_name &&
+			dir_name.is_valid_hex_number(false)) {
+			old_dir_names.push_back(dir_name);
+		}
+	}
+	owner_dir_access->list_dir_end();
+
+	const String ext = String(".") + FILE_EXTENSION;
+
+	for (const String &dir_name : old_dir_names) {
+		ZN_PRINT_VERBOSE(format("Removing outdated generated blocks in {}", dir_name));
+		const String dir_path = owner_dir.path_join(dir_name);
+		Ref<DirAccess> old_dir = open_directory(dir_path, nullptr);
+		if (old_dir.is_null()) {
+			continue;
+		}
+		StdVector<String> file_names;
+		old_dir->list_dir_begin();
+		while (true) {
+			const String file_name = old_dir->get_next();
+			if (file_name == "") {
+				break;
+			}
+			if (!old_dir->current_is_dir() && file_name.ends_with(ext)) {
+				file_names.push_back(file_name);
+			}
+		}
+		old_dir->list_dir_end();
+		for (const String &file_name : file_names) {
+			old_dir->remove(file_name);
+		}
+		// Fails if something else was in the directory, in which case we leave it there
+		owner_dir_access->remove(dir_name);
+	}
+}
+
+// Must be called while holding the mutex. The file of the entry is added to `out_removed_files`, and must be deleted
+// after unlocking.
+void GeneratedBlockDiskCache::remove_entry(const Key &key, StdVector<String> &out_removed_files) {
+	auto it = _entries.find(key);
+	if (it == _entries.end()) {
+		return;
+	}
+	// Get the path first, `key` might be a reference to the erased entry
+	out_removed_files.push_back(get_file_path(_hash, key));
+	_size -= it->second.size;
+	_entries.erase(it);
+}
+
+// Must be called while holding the mutex
+void GeneratedBlockDiskCache::remove_least_recently_used(StdVector<String> &out_removed_files) {
+	// Linear search, this only happens when the cache is full
+	auto oldest_it = _entries.begin();
+	for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+		if (it->second.last_used < oldest_it->second.last_used) {
+			oldest_it = it;
+		}
+	}
+	ZN_ASSERT_RETURN(oldest_it != _entries.end());
+	remove_entry(oldest_it->first, out_removed_files);
+}
+
+String GeneratedBlockDiskCache::get_owner_directory() const {
+	if (_owner_name.is_empty()) {
+		return _directory;
+	}
+	return _directory.path_join(_owner_name);
+}
+
+String GeneratedBlockDiskCache::get_hash_directory(uint64_t hash) const {
+	return get_owner_directory().path_join(String::num_uint64(hash, 16));
+}
+
+String GeneratedBlockDiskCache::get_file_path(uint64_t hash, const Key &key) const {
+	Array a;
+	a.resize(5);
+	a[0] = key.lod;
+	a[1] = key.origin.x;
+	a[2] = key.origin.y;
+	a[3] = key.origin.z;
+	a[4] = FILE_EXTENSION;
+	return get_hash_directory(hash).path_join(String("{0}.{1}.{2}.{3}.{4}").format(a));
+}
+
+} // namespace zylann::voxel
@@ -0,0 +1,103 @@
+#ifndef VOXEL_GENERATED_BLOCK_DISK_CACHE_H
+#define VOXEL_GENERATED_BLOCK_DISK_CACHE_H
+
+#include "../util/containers/std_unordered_map.h"
+#include "../util/containers/std_vector.h"
+#include "../util/godot/core/string.h"
+#include "../util/math/vector3i.h"
+#include "../util/thread/mutex.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace zylann::voxel {
+
+class VoxelBuffer;
+
+// Stores blocks produced by a generator in files, so they don't have to be generated again after a restart.
+//
+// Blocks are stored in a sub-directory named after a hash of the generator, which must change if the generator would
+// produce different results. Hash directories are grouped in a sub-directory named after the owner of the cache, so
+// several generators can share the same directory. When a different hash is used, directories of previous hashes of
+// the same owner are removed. Without an owner name, they are left to the size limit instead.
+// When the total size of files exceeds the limit, blocks that were not used for the longest time are removed.
+//
+// Each block is a file starting with a fixed-size header, followed by the uncompressed output of `BlockSerializer`.
+// Generated blocks are often uniform, so they remain small, and their data can be read in place.
+class GeneratedBlockDiskCache {
+public:
+	static const char *FILE_EXTENSION;
+
+	// Empty path disables the cache
+	void set_directory(String path);
+	String get_directory() const;
+
+	// Name of the sub-directory in which blocks are stored. It must be unique among caches using the same directory.
+	void set_owner_name(String name);
+
+	inline bool is_enabled() const {
+		return _enabled;
+	}
+
+	void set_max_size(uint64_t bytes);
+	uint64_t get_max_size() const;
+
+	// Loads a block into a buffer which must already have the same size and channel depths as when it was stored.
+	// Returns false if it was not found.
+	bool try_load(uint64_t hash, Vector3i origin, uint32_t lod, VoxelBuffer &out_buffer, bool &out_max_lod_hint);
+
+	void store(uint64_t hash, Vector3i origin, uint32_t lod, const VoxelBuffer &buffer, bool max_lod_hint);
+
+	// Removes all blocks stored for the current hash
+	void clear();
+
+private:
+	struct Key {
+		Vector3i origin;
+		uint32_t lod;
+
+		inline bool operator==(const Key &other) const {
+			return origin == other.origin && lod == other.lod;
+		}
+	};
+
+	struct KeyHasher {
+		inline size_t operator()(const Key &key) const {
+			return hash_djb2_one_32(key.lod, Vector3iHasher::hash(key.origin));
+		}
+	};
+
+	struct Entry {
+		uint64_t size = 0;
+		uint64_t last_used = 0;
+	};
+
+	bool update_index(uint64_t hash);
+	static void remove_outdated_hash_directories(String owner_dir, String current_hash_dir_name);
+	void remove_entry(const Key &key, StdVector<String> &out_removed_files);
+	void remove_least_recently_used(StdVector<String> &out_removed_files);
+	String get_owner_directory() const;
+	String get_hash_directory(uint64_t hash) const;
+	String get_file_path(uint64_t hash, const Key &key) const;
+
+	String _directory;
+	String _owner_name;
+	std::atomic_bool _enabled = { false };
+	uint64_t _max_size = 0;
+
+	// Hash of the blocks currently indexed
+	uint64_t _hash = 0;
+	bool _index_loaded = false;
+	// True while a thread is scanning files to build the index, which is done without holding the mutex
+	bool _index_loading = false;
+	StdUnorderedMap<Key, Entry, KeyHasher> _entries;
+	uint64_t _size = 0;
+	// Incremented each time an entry is used
+	uint64_t _time = 0;
+
+	BinaryMutex _mutex;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_GENERATED_BLOCK_DISK_CACHE_H
@@ -0,0 +1,91 @@
+#include "node_sampling_profiler.h"
+#include "../../util/godot/core/string.h"
+#include "../../util/string/format.h"
+#include "node_type_db.h"
+
+namespace zylann::voxel::pg {
+
+NodeSamplingProfiler::NodeSamplingProfiler(Span<const OperationInfo> operations, unsigned int operations_size) :
+		_slots(operations.size()) {
+	ZN_ASSERT(operations.size() < NO_SLOT);
+
+	_operations.resize(operations.size());
+	_address_to_slot.resize(operations_size, NO_SLOT);
+
+	for (unsigned int i = 0; i < operations.size(); ++i) {
+		const OperationInfo &op = operations[i];
+		ZN_ASSERT_CONTINUE(op.address < operations_size);
+		_operations[i] = op;
+		_address_to_slot[op.address] = i;
+	}
+
+	clear_stats();
+
+#ifdef ZN_PROFILER_ENABLED
+	const NodeTypeDB &type_db = NodeTypeDB::get_singleton();
+	_plot_names.resize(operations.size());
+	for (unsigned int i = 0; i < operations.size(); ++i) {
+		const OperationInfo &op = operations[i];
+		const NodeType &type = type_db.get_type(op.type_id);
+		_plot_names[i] = format("Graph node {} #{} (ns)", to_std_string(type.name), op.node_id);
+	}
+#endif
+}
+
+void NodeSamplingProfiler::add_sample(uint16_t op_address, uint64_t nanoseconds, uint32_t values_count) {
+#ifdef DEBUG_ENABLED
+	ZN_ASSERT_RETURN(op_address < _address_to_slot.size());
+#endif
+	const uint16_t slot_index = _address_to_slot[op_address];
+	if (slot_index == NO_SLOT) {
+		return;
+	}
+	Slot &slot = _slots[slot_index];
+
+	unsigned int bucket_index = 0;
+	for (uint64_t t = nanoseconds; t > 1 && bucket_index + 1 < HISTOGRAM_BUCKET_COUNT; t >>= 1) {
+		++bucket_index;
+	}
+
+	slot.sample_count.fetch_add(1, std::memory_order_relaxed);
+	slot.total_nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+	slot.total_values.fetch_add(values_count, std::memory_order_relaxed);
+	slot.histogram[bucket_index].fetch_add(1, std::memory_order_relaxed);
+
+#ifdef ZN_PROFILER_ENABLED
+	ZN_PROFILE_PLOT(_plot_names[slot_index].c_str(), int64_t(nanoseconds));
+#endif
+}
+
+void NodeSamplingProfiler::get_stats(StdVector<OperationStats> &out_stats) const {
+	out_stats.resize(_slots.size());
+
+	for (unsigned int i = 0; i < _slots.size(); ++i) {
+		const Slot &slot = _slots[i];
+		const OperationInfo &op = _operations[i];
+		OperationStats &stats = out_stats[i];
+
+		stats.node_id = op.node_id;
+		stats.type_id = op.type_id;
+		// Values are read separately while other threads may be adding samples, so they might be slightly off
+		stats.sample_count = slot.sample_count.load(std::memory_order_relaxed);
+		stats.total_nanoseconds = slot.total_nanoseconds.load(std::memory_order_relaxed);
+		stats.total_values = slot.total_values.load(std::memory_order_relaxed);
+		for (unsigned int bucket_index = 0; bucket_index < HISTOGRAM_BUCKET_COUNT; ++bucket_index) {
+			stats.histogram[bucket_index] = slot.histogram[bucket_index].load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void NodeSamplingProfiler::clear_stats() {
+	for (Slot &slot : _slots) {
+		slot.sample_count.store(0, std::memory_order_relaxed);
+		slot.total_nanoseconds.store(0, std::memory_order_relaxed);
+		slot.total_values.store(0, std::memory_order_relaxed);
+		for (std::atomic_uint64_t &count : slot.histogram) {
+			count.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+} // namespace zylann::voxel::pg
@@ -0,0 +1,102 @@
+#ifndef VOXEL_GRAPH_NODE_SAMPLING_PROFILER_H
+#define VOXEL_GRAPH_NODE_SAMPLING_PROFILER_H
+
+#include "../../util/containers/fixed_array.h"
+#include "../../util/containers/span.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/profiling.h"
+#include "../../util/string/std_string.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace zylann::voxel::pg {
+
+// Measures how long each operation of a program takes, only on one out of N runs, so it can stay enabled in release
+// builds and under real load. Statistics are accumulated with atomics, so it can be used by multiple threads without
+// locking.
+class NodeSamplingProfiler {
+public:
+	// Bucket `i` counts runs of an operation that took between `2^i` and `2^(i+1)` nanoseconds. The last one also
+	// counts longer runs.
+	static const unsigned int HISTOGRAM_BUCKET_COUNT = 32;
+
+	struct OperationInfo {
+		uint16_t address;
+		uint16_t type_id;
+		// ID of the node in the user-facing graph
+		uint32_t node_id;
+	};
+
+	struct OperationStats {
+		uint32_t node_id = 0;
+		uint16_t type_id = 0;
+		uint64_t sample_count = 0;
+		uint64_t total_nanoseconds = 0;
+		// How many values were processed during samples
+		uint64_t total_values = 0;
+		FixedArray<uint64_t, HISTOGRAM_BUCKET_COUNT> histogram;
+	};
+
+	// `operations_size` is the size of the program's operations array, which addresses refer to.
+	NodeSamplingProfiler(Span<const OperationInfo> operations, unsigned int operations_size);
+
+	// Sets every how many runs of the program operations are measured. 0 turns off sampling.
+	inline void set_sample_interval(uint32_t interval) {
+		_sample_interval.store(interval, std::memory_order_relaxed);
+	}
+
+	inline uint32_t get_sample_interval() const {
+		return _sample_interval.load(std::memory_order_relaxed);
+	}
+
+	// Call once per run of the program. Returns true if operations of this run should be measured.
+	inline bool should_sample() {
+		const uint32_t interval = _sample_interval.load(std::memory_order_relaxed);
+		if (interval == 0) {
+			return false;
+		}
+		return _run_counter.fetch_add(1, std::memory_order_relaxed) % interval == 0;
+	}
+
+	static inline uint64_t get_time_nanoseconds() {
+		using namespace std::chrono;
+		return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Records how long the operation at the given address took to process a number of values during a sampled run.
+	void add_sample(uint16_t op_address, uint64_t nanoseconds, uint32_t values_count);
+
+	// Gets statistics of every operation, in the order they are in the program.
+	void get_stats(StdVector<OperationStats> &out_stats) const;
+
+	void clear_stats();
+
+private:
+	struct Slot {
+		std::atomic_uint64_t sample_count = { 0 };
+		std::atomic_uint64_t total_nanoseconds = { 0 };
+		std::atomic_uint64_t total_values = { 0 };
+		FixedArray<std::atomic_uint64_t, HISTOGRAM_BUCKET_COUNT> histogram;
+	};
+
+	static const uint16_t NO_SLOT = 0xffff;
+
+	StdVector<OperationInfo> _operations;
+	// [op_address] => index in `_slots` and `_operations`
+	StdVector<uint16_t> _address_to_slot;
+	// Allocated once, atomics can't be moved
+	StdVector<Slot> _slots;
+#ifdef ZN_PROFILER_ENABLED
+	// Plot names must remain valid as long as the profiler might use them
+	StdVector<StdString> _plot_names;
+#endif
+
+	std::atomic_uint32_t _sample_interval = { 0 };
+	std::atomic_uint32_t _run_counter = { 0 };
+};
+
+} // namespace zylann::voxel::pg
+
+#endif // VOXEL_GRAPH_NODE_SAMPLING_PROFILER_H
@@ -4,6 +4,7 @@
 #include "../../util/string/format.h"
 #include "image_range_grid.h"
 #include "nodes/curve.h"
+#include "nodes/fused.h"
 #include "nodes/image.h"
 #include "nodes/inputs.h"
 #include "nodes/math_funcs.h"
@@ -82,6 +83,7 @@ NodeTypeDB::NodeTypeDB() {
 	register_misc_nodes(types);
 	register_noise_nodes(types);
 	register_sdf_nodes(types);
+	register_fused_node(types);
 
 	CRASH_COND(_expression_functions.size() > 0);
 
@@ -89,7 +91,10 @@ NodeTypeDB::NodeTypeDB() {
 		NodeType &t = _types[i];
 		ZN_ASSERT(!t.name.is_empty());
 
-		_type_name_to_id.insert({ t.name, (VoxelGraphFunction::NodeTypeID)i });
+		if (i < VoxelGraphFunction::NODE_TYPE_COUNT) {
+			// Internal types can't be found by name, they may not be used in saved graphs
+			_type_name_to_id.insert({ t.name, (VoxelGraphFunction::NodeTypeID)i });
+		}
 
 		for (uint32_t param_index = 0; param_index < t.params.size(); ++param_index) {
 			NodeType::Param &p = t.params[param_index];
@@ -28,6 +28,14 @@ enum Category {
 
 const char *get_category_name(Category category);
 
+// Node types that can't be created in a VoxelGraphFunction. They are only produced by the compiler, and come after
+// user-facing types.
+enum InternalNodeTypeID {
+	// Tree of elementwise operations evaluated in a single pass. See `FusedParams`.
+	INTERNAL_NODE_FUSED = VoxelGraphFunction::NODE_TYPE_COUNT,
+	INTERNAL_NODE_TYPE_END
+};
+
 struct NodeType {
 	// TODO Separate Input and Output port types? Some member values don't make sense.
 	struct Port {
@@ -91,6 +99,8 @@ struct NodeType {
 	CompileFunc compile_func = nullptr;
 	Runtime::ProcessBufferFunc process_buffer_func = nullptr;
 	Runtime::RangeAnalysisFunc range_analysis_func = nullptr;
+	// Optional. Nodes without it are considered to output ranges not correlated with anything.
+	Runtime::AffineRangeAnalysisFunc affine_range_analysis_func = nullptr;
 	// If available, name of the corresponding function to be used in expression nodes
 	const char *expression_func_name = nullptr;
 	// The Expression node can invoke the logic of other nodes, but it then needs a specific implementation
@@ -115,11 +125,12 @@ public:
 	static void create_singleton();
 	static void destroy_singleton();
 
+	// Gets the number of user-facing types. Internal types are not included.
 	int get_type_count() const {
-		return _types.size();
+		return VoxelGraphFunction::NODE_TYPE_COUNT;
 	}
 	bool is_valid_type_id(int type_id) const {
-		return type_id >= 0 && type_id < static_cast<int>(_types.size());
+		return type_id >= 0 && type_id < get_type_count();
 	}
 	const NodeType &get_type(uint32_t id) const {
 		return _types[id];
@@ -134,7 +145,7 @@ public:
 	}
 
 private:
-	FixedArray<NodeType, VoxelGraphFunction::NODE_TYPE_COUNT> _types;
+	FixedArray<NodeType, INTERNAL_NODE_TYPE_END> _types;
 	StdUnorderedMap<String, VoxelGraphFunction::NodeTypeID> _type_name_to_id;
 	StdVector<ExpressionParser::Function> _expression_functions;
 };
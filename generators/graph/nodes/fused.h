@@ -0,0 +1,441 @@
+#include "../../../util/containers/fixed_array.h"
+#include "../node_type_db.h"
+#include "../voxel_graph_compiler.h"
+#include "../voxel_graph_runtime.h"
+
+namespace zylann::voxel::pg {
+
+// Number of values a fused operation processes at once. Registers of a tile are small enough to remain in L1 cache,
+// while being long enough for loops over them to be vectorized.
+static const unsigned int FUSED_TILE_SIZE = 64;
+
+// Same results as the nodes the operation comes from, see their `process_buffer_func`.
+inline void run_fused_operation(
+		const FusedParams::Operation &op,
+		float *dst,
+		const float *a,
+		const float *b,
+		const float *c,
+		const uint32_t count,
+		const bool divide_by_constant
+) {
+	using namespace math;
+
+	switch (op.type_id) {
+		case VoxelGraphFunction::NODE_ADD:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = a[i] + b[i];
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_SUBTRACT:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = a[i] - b[i];
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_MULTIPLY:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = a[i] * b[i];
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_DIVIDE:
+			if (divide_by_constant) {
+				// Matches `do_division`, which multiplies by the inverse when only the divisor is constant
+				const float cb = b[0];
+				if (cb == 0.f) {
+					for (uint32_t i = 0; i < count; ++i) {
+						dst[i] = 0.f;
+					}
+				} else {
+					const float inv_b = 1.f / cb;
+					for (uint32_t i = 0; i < count; ++i) {
+						dst[i] = a[i] * inv_b;
+					}
+				}
+			} else {
+				for (uint32_t i = 0; i < count; ++i) {
+					dst[i] = b[i] == 0.f ? 0.f : a[i] / b[i];
+				}
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_SIN:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = Math::sin(a[i]);
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_FLOOR:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = Math::floor(a[i]);
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_ABS:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = Math::abs(a[i]);
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_SQRT:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = Math::sqrt(max(a[i], 0.f));
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_FRACT:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = a[i] - Math::floor(a[i]);
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_MIN:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = min(a[i], b[i]);
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_MAX:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = max(a[i], b[i]);
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_CLAMP:
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = clamp(a[i], b[i], c[i]);
+			}
+			break;
+
+		case VoxelGraphFunction::NODE_CLAMP_C: {
+			const float minv = op.params[0];
+			const float maxv = op.params[1];
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = clamp(a[i], minv, maxv);
+			}
+		} break;
+
+		case VoxelGraphFunction::NODE_REMAP: {
+			const float pa = op.params[0];
+			const float pb = op.params[1];
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = pa * a[i] + pb;
+			}
+		} break;
+
+		case VoxelGraphFunction::NODE_SMOOTHSTEP: {
+			const float edge0 = op.params[0];
+			const float edge1 = op.params[1];
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i] = smoothstep(edge0, edge1, a[i]);
+			}
+		} break;
+
+		default:
+			ZN_PRINT_ERROR("Unsupported operation in fused node");
+			break;
+	}
+}
+
+void process_fused_buffer(Runtime::ProcessBufferContext &ctx) {
+	const FusedParams &params = ctx.get_params<FusedParams>();
+	Runtime::Buffer &out = ctx.get_output(0);
+	const uint32_t buffer_size = out.size;
+
+	const unsigned int operations_begin = params.input_count + params.constant_count;
+
+	// Tile-sized scratch memory for registers
+	FixedArray<FixedArray<float, FUSED_TILE_SIZE>, FusedParams::MAX_REGISTERS> tiles;
+	FixedArray<const float *, FusedParams::MAX_REGISTERS> registers;
+	FixedArray<bool, FusedParams::MAX_REGISTERS> constant_registers;
+
+	for (unsigned int i = 0; i < registers.size(); ++i) {
+		registers[i] = tiles[i].data();
+		constant_registers[i] = false;
+	}
+
+	// Constant inputs are not provided as buffers, and constants don't change between tiles, so they only need to be
+	// filled once
+	for (unsigned int i = 0; i < params.input_count; ++i) {
+		const Runtime::Buffer &input = ctx.get_input(i);
+		if (input.is_constant) {
+			fill(tiles[i], input.constant_value);
+			constant_registers[i] = true;
+		}
+	}
+	for (unsigned int i = 0; i < params.constant_count; ++i) {
+		const unsigned int ri = params.input_count + i;
+		fill(tiles[ri], params.constants[i]);
+		constant_registers[ri] = true;
+	}
+
+	for (uint32_t begin = 0; begin < buffer_size; begin += FUSED_TILE_SIZE) {
+		const uint32_t count = math::min(buffer_size - begin, static_cast<uint32_t>(FUSED_TILE_SIZE));
+
+		// Variable inputs are read directly from their buffer
+		for (unsigned int i = 0; i < params.input_count; ++i) {
+			if (!constant_registers[i]) {
+				registers[i] = ctx.get_input(i).data + begin;
+			}
+		}
+
+		for (unsigned int op_index = 0; op_index < params.operation_count; ++op_index) {
+			const FusedParams::Operation &op = params.operations[op_index];
+			// The last operation writes directly to the output
+			float *dst = op_index + 1 == params.operation_count ? out.data + begin
+																: tiles[operations_begin + op_index].data();
+			run_fused_operation(
+					op,
+					dst,
+					registers[op.args[0]],
+					registers[op.args[1]],
+					registers[op.args[2]],
+					count,
+					constant_registers[op.args[1]] && !constant_registers[op.args[0]]
+			);
+		}
+	}
+}
+
+// Same results as the nodes the operation comes from, see their `range_analysis_func`.
+inline math::Interval get_fused_operation_range(
+		const FusedParams::Operation &op,
+		const math::Interval a,
+		const math::Interval b,
+		const math::Interval c
+) {
+	using namespace math;
+
+	switch (op.type_id) {
+		case VoxelGraphFunction::NODE_ADD:
+			return a + b;
+		case VoxelGraphFunction::NODE_SUBTRACT:
+			return a - b;
+		case VoxelGraphFunction::NODE_MULTIPLY:
+			if (op.args[0] == op.args[1]) {
+				// The two operands have the same source, we can optimize to a square function
+				return squared(a);
+			}
+			return a * b;
+		case VoxelGraphFunction::NODE_DIVIDE:
+			return a / b;
+		case VoxelGraphFunction::NODE_SIN:
+			return sin(a);
+		case VoxelGraphFunction::NODE_FLOOR:
+			return floor(a);
+		case VoxelGraphFunction::NODE_ABS:
+			return abs(a);
+		case VoxelGraphFunction::NODE_SQRT:
+			return sqrt(a);
+		case VoxelGraphFunction::NODE_FRACT:
+			return a - floor(a);
+		case VoxelGraphFunction::NODE_MIN:
+			return min_interval(a, b);
+		case VoxelGraphFunction::NODE_MAX:
+			return max_interval(a, b);
+		case VoxelGraphFunction::NODE_CLAMP:
+			return clamp(a, b, c);
+		case VoxelGraphFunction::NODE_CLAMP_C:
+			return clamp(a, Interval::from_single_value(op.params[0]), Interval::from_single_value(op.params[1]));
+		case VoxelGraphFunction::NODE_REMAP:
+			return op.params[0] * a + op.params[1];
+		case VoxelGraphFunction::NODE_SMOOTHSTEP:
+			return smoothstep<real_t>(op.params[0], op.params[1], a);
+		default:
+			ZN_PRINT_ERROR("Unsupported operation in fused node");
+			return Interval::from_infinity();
+	}
+}
+
+void analyze_fused_range(Runtime::RangeAnalysisContext &ctx) {
+	const FusedParams &params = ctx.get_params<FusedParams>();
+
+	FixedArray<math::Interval, FusedParams::MAX_REGISTERS> registers;
+
+	for (unsigned int i = 0; i < params.input_count; ++i) {
+		registers[i] = ctx.get_input(i);
+	}
+	for (unsigned int i = 0; i < params.constant_count; ++i) {
+		registers[params.input_count + i] = math::Interval::from_single_value(params.constants[i]);
+	}
+
+	const unsigned int operations_begin = params.input_count + params.constant_count;
+
+	for (unsigned int op_index = 0; op_index < params.operation_count; ++op_index) {
+		const FusedParams::Operation &op = params.operations[op_index];
+		registers[operations_begin + op_index] =
+				get_fused_operation_range(op, registers[op.args[0]], registers[op.args[1]], registers[op.args[2]]);
+	}
+
+	ctx.set_output(0, registers[operations_begin + params.operation_count - 1]);
+}
+
+// Returns `false` if the operation has no affine form, in which case its interval range should be used.
+inline bool try_get_fused_operation_affine_range(
+		const FusedParams::Operation &op,
+		const math::AffineInterval &a,
+		const math::AffineInterval &b,
+		const math::AffineInterval &c,
+		math::AffineInterval &out
+) {
+	using namespace math;
+
+	switch (op.type_id) {
+		case VoxelGraphFunction::NODE_ADD:
+			out = a + b;
+			return true;
+		case VoxelGraphFunction::NODE_SUBTRACT:
+			out = a - b;
+			return true;
+		case VoxelGraphFunction::NODE_MULTIPLY:
+			out = op.args[0] == op.args[1] ? squared(a) : a * b;
+			return true;
+		case VoxelGraphFunction::NODE_DIVIDE:
+			out = a * reciprocal(b);
+			return true;
+		case VoxelGraphFunction::NODE_SQRT:
+			out = sqrt(a);
+			return true;
+		case VoxelGraphFunction::NODE_MIN:
+			out = min_interval(a, b);
+			return true;
+		case VoxelGraphFunction::NODE_MAX:
+			out = max_interval(a, b);
+			return true;
+		case VoxelGraphFunction::NODE_CLAMP:
+			out = clamp(a, b, c);
+			return true;
+		case VoxelGraphFunction::NODE_CLAMP_C:
+			out = clamp(
+					a,
+					AffineInterval::from_single_value(op.params[0]),
+					AffineInterval::from_single_value(op.params[1])
+			);
+			return true;
+		case VoxelGraphFunction::NODE_REMAP:
+			out = a * op.params[0] + op.params[1];
+			return true;
+		default:
+			return false;
+	}
+}
+
+void analyze_fused_affine_range(Runtime::AffineRangeAnalysisContext &ctx) {
+	const FusedParams &params = ctx.get_params<FusedParams>();
+
+	// Interval ranges are tracked too, for operations that don't have an affine form
+	FixedArray<math::Interval, FusedParams::MAX_REGISTERS> registers;
+	FixedArray<math::AffineInterval, FusedParams::MAX_REGISTERS> affine_registers;
+
+	for (unsigned int i = 0; i < params.input_count; ++i) {
+		registers[i] = ctx.get_input_interval(i);
+		affine_registers[i] = ctx.get_input(i);
+	}
+	for (unsigned int i = 0; i < params.constant_count; ++i) {
+		const unsigned int ri = params.input_count + i;
+		registers[ri] = math::Interval::from_single_value(params.constants[i]);
+		affine_registers[ri] = math::AffineInterval::from_single_value(params.constants[i]);
+	}
+
+	const unsigned int operations_begin = params.input_count + params.constant_count;
+
+	for (unsigned int op_index = 0; op_index < params.operation_count; ++op_index) {
+		const FusedParams::Operation &op = params.operations[op_index];
+		const unsigned int ri = operations_begin + op_index;
+
+		const math::Interval r =
+				get_fused_operation_range(op, registers[op.args[0]], registers[op.args[1]], registers[op.args[2]]);
+
+		math::AffineInterval ar;
+		if (try_get_fused_operation_affine_range(
+					op,
+					affine_registers[op.args[0]],
+					affine_registers[op.args[1]],
+					affine_registers[op.args[2]],
+					ar
+			)) {
+			registers[ri] = math::get_tightest_interval(r, ar);
+			affine_registers[ri] = ar;
+		} else {
+			registers[ri] = r;
+			affine_registers[ri] = math::AffineInterval::from_interval(r);
+		}
+	}
+
+	ctx.set_output(0, affine_registers[operations_begin + params.operation_count - 1]);
+}
+
+void register_fused_node(Span<NodeType> types) {
+	NodeType &t = types[INTERNAL_NODE_FUSED];
+	t.name = "Fused";
+	t.category = CATEGORY_MATH;
+
+	static const char *s_input_names[FusedParams::MAX_INPUTS] = { "in0", "in1", "in2", "in3",
+																  "in4", "in5", "in6", "in7" };
+	for (const char *input_name : s_input_names) {
+		t.inputs.push_back(NodeType::Port(input_name, 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
+	}
+	t.outputs.push_back(NodeType::Port("out"));
+
+	// Params are generated by the compiler, see `FusedParams`
+	t.compile_func = [](CompileContext &ctx) {
+		FusedParams p{};
+		unsigned int param_index = 0;
+
+		const auto read_param = [&ctx, &param_index]() {
+			return ctx.get_param(param_index++).operator float();
+		};
+
+		if (ctx.get_param_count() < 3) {
+			ctx.make_error("Fused node has invalid params");
+			return;
+		}
+		p.input_count = static_cast<uint8_t>(read_param());
+		p.constant_count = static_cast<uint8_t>(read_param());
+		p.operation_count = static_cast<uint8_t>(read_param());
+
+		const unsigned int operation_param_count = 1 + FusedParams::MAX_ARGS + FusedParams::MAX_OPERATION_PARAMS;
+		if (p.input_count > FusedParams::MAX_INPUTS || p.constant_count > FusedParams::MAX_CONSTANTS ||
+			p.operation_count == 0 || p.operation_count > FusedParams::MAX_OPERATIONS ||
+			ctx.get_param_count() != 3 + p.constant_count + p.operation_count * operation_param_count) {
+			ctx.make_error("Fused node has invalid params");
+			return;
+		}
+
+		for (unsigned int i = 0; i < p.constant_count; ++i) {
+			p.constants[i] = read_param();
+		}
+
+		const unsigned int operations_begin = p.input_count + p.constant_count;
+
+		for (unsigned int op_index = 0; op_index < p.operation_count; ++op_index) {
+			FusedParams::Operation &op = p.operations[op_index];
+			op.type_id = static_cast<uint16_t>(read_param());
+			if (!FusedParams::is_supported_type(op.type_id)) {
+				ctx.make_error("Fused node has an unsupported operation");
+				return;
+			}
+			for (unsigned int i = 0; i < FusedParams::MAX_ARGS; ++i) {
+				op.args[i] = static_cast<uint8_t>(read_param());
+				// Operations can only use inputs, constants, or results of previous operations
+				if (op.args[i] >= operations_begin + op_index) {
+					ctx.make_error("Fused node has an invalid operation argument");
+					return;
+				}
+			}
+			for (unsigned int i = 0; i < FusedParams::MAX_OPERATION_PARAMS; ++i) {
+				op.params[i] = read_param();
+			}
+		}
+
+		ctx.set_params(p);
+	};
+
+	t.process_buffer_func = process_fused_buffer;
+	t.range_analysis_func = analyze_fused_range;
+	t.affine_range_analysis_func = analyze_fused_affine_range;
+}
+
+} // namespace zylann::voxel::pg
@@ -7,6 +7,7 @@ namespace zylann::voxel::pg {
 void register_math_func_nodes(Span<NodeType> types) {
 	typedef Runtime::ProcessBufferContext ProcessBufferContext;
 	typedef Runtime::RangeAnalysisContext RangeAnalysisContext;
+	typedef Runtime::AffineRangeAnalysisContext AffineRangeAnalysisContext;
 
 	using namespace math;
 
@@ -86,6 +87,9 @@ void register_math_func_nodes(Span<NodeType> types) {
 			const Interval a = ctx.get_input(0);
 			ctx.set_output(0, sqrt(a));
 		};
+		t.affine_range_analysis_func = [](AffineRangeAnalysisContext &ctx) { //
+			ctx.set_output(0, sqrt(ctx.get_input(0)));
+		};
 		t.expression_func_name = "sqrt";
 		t.expression_func = [](Span<const float> args) { //
 			return Math::sqrt(math::max(args[0], 0.f));
@@ -185,13 +189,16 @@ void register_math_func_nodes(Span<NodeType> types) {
 		t.inputs.push_back(NodeType::Port("b", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return min(a, b); });
+			do_binop(ctx, [](auto a, auto b) { return min(a, b); });
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
 			const Interval b = ctx.get_input(1);
 			ctx.set_output(0, min_interval(a, b));
 		};
+		t.affine_range_analysis_func = [](AffineRangeAnalysisContext &ctx) { //
+			ctx.set_output(0, min_interval(ctx.get_input(0), ctx.get_input(1)));
+		};
 		t.expression_func_name = "min";
 		t.expression_func = [](Span<const float> args) { //
 			return min(args[0], args[1]);
@@ -208,13 +215,16 @@ void register_math_func_nodes(Span<NodeType> types) {
 		t.inputs.push_back(NodeType::Port("b", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return max(a, b); });
+			do_binop(ctx, [](auto a, auto b) { return max(a, b); });
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
 			const Interval b = ctx.get_input(1);
 			ctx.set_output(0, max_interval(a, b));
 		};
+		t.affine_range_analysis_func = [](AffineRangeAnalysisContext &ctx) { //
+			ctx.set_output(0, max_interval(ctx.get_input(0), ctx.get_input(1)));
+		};
 		t.expression_func_name = "max";
 		t.expression_func = [](Span<const float> args) { //
 			return max(args[0], args[1]);
@@ -236,9 +246,14 @@ void register_math_func_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &minv = ctx.get_input(1);
 			const Runtime::Buffer &maxv = ctx.get_input(2);
 			Runtime::Buffer &out = ctx.get_output(0);
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = clamp(a.data[i], minv.data[i], maxv.data[i]);
-			}
+			apply_op(
+					out.data,
+					out.size,
+					[](auto x, auto lo, auto hi) { return clamp(x, lo, hi); },
+					BufferOperand{ a.data },
+					BufferOperand{ minv.data },
+					BufferOperand{ maxv.data }
+			);
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -246,6 +261,9 @@ void register_math_func_nodes(Span<NodeType> types) {
 			const Interval maxv = ctx.get_input(2);
 			ctx.set_output(0, clamp(a, minv, maxv));
 		};
+		t.affine_range_analysis_func = [](AffineRangeAnalysisContext &ctx) { //
+			ctx.set_output(0, clamp(ctx.get_input(0), ctx.get_input(1), ctx.get_input(2)));
+		};
 		t.expression_func_name = "clamp";
 		t.expression_func = [](Span<const float> args) { //
 			return clamp(args[0], args[1], args[2]);
@@ -282,9 +300,14 @@ void register_math_func_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &a = ctx.get_input(0);
 			Runtime::Buffer &out = ctx.get_output(0);
 			const Params p = ctx.get_params<Params>();
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = clamp(a.data[i], p.min, p.max);
-			}
+			apply_op(
+					out.data,
+					out.size,
+					[](auto x, auto lo, auto hi) { return clamp(x, lo, hi); },
+					BufferOperand{ a.data },
+					ConstantOperand(p.min),
+					ConstantOperand(p.max)
+			);
 		};
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -293,6 +316,12 @@ void register_math_func_nodes(Span<NodeType> types) {
 			const Interval cmax = Interval::from_single_value(p.max);
 			ctx.set_output(0, clamp(a, cmin, cmax));
 		};
+		t.affine_range_analysis_func = [](AffineRangeAnalysisContext &ctx) {
+			const Params p = ctx.get_params<Params>();
+			const AffineInterval cmin = AffineInterval::from_single_value(p.min);
+			const AffineInterval cmax = AffineInterval::from_single_value(p.max);
+			ctx.set_output(0, clamp(ctx.get_input(0), cmin, cmax));
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.add_format(
 					"{} = clamp({}, {}, {});\n",
@@ -382,6 +411,9 @@ void register_math_func_nodes(Span<NodeType> types) {
 			}
 			ctx.set_output(0, lerp(a, b, r));
 		};
+		t.affine_range_analysis_func = [](AffineRangeAnalysisContext &ctx) { //
+			ctx.set_output(0, lerp(ctx.get_input(0), ctx.get_input(1), ctx.get_input(2)));
+		};
 		t.expression_func_name = "lerp";
 		t.expression_func = [](Span<const float> args) { //
 			return Math::lerp(args[0], args[1], args[2]);
@@ -437,6 +469,10 @@ void register_math_func_nodes(Span<NodeType> types) {
 			const Params p = ctx.get_params<Params>();
 			ctx.set_output(0, p.a * x + p.b);
 		};
+		t.affine_range_analysis_func = [](AffineRangeAnalysisContext &ctx) {
+			const Params p = ctx.get_params<Params>();
+			ctx.set_output(0, ctx.get_input(0) * p.a + p.b);
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			const Params p = Params::from_intervals(
 					float(ctx.get_param(0)), float(ctx.get_param(1)), float(ctx.get_param(2)), float(ctx.get_param(3))
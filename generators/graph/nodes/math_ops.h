@@ -4,6 +4,18 @@
 
 namespace zylann::voxel::pg {
 
+// Division giving 0 when the divisor is 0
+struct SafeDivide {
+	inline float operator()(const float a, const float b) const {
+		return b == 0.f ? 0.f : a / b;
+	}
+
+	inline math::Float32x4 operator()(const math::Float32x4 a, const math::Float32x4 b) const {
+		const math::Float32x4 zero(0.f);
+		return math::select(b == zero, zero, a / b);
+	}
+};
+
 // Special case for division because we want to avoid NaNs caused by zeros
 void do_division(Runtime::ProcessBufferContext &ctx) {
 	const Runtime::Buffer &a = ctx.get_input(0);
@@ -13,11 +25,7 @@ void do_division(Runtime::ProcessBufferContext &ctx) {
 
 	if (a.is_constant || b.is_constant) {
 		if (!b.is_constant) {
-			const float c = a.constant_value;
-			const float *v = b.data;
-			for (uint32_t i = 0; i < buffer_size; ++i) {
-				out.data[i] = v[i] == 0.f ? 0.f : c / v[i];
-			}
+			apply_op(out.data, buffer_size, SafeDivide(), ConstantOperand(a.constant_value), BufferOperand{ b.data });
 
 		} else if (!a.is_constant) {
 			if (b.constant_value == 0.f) {
@@ -26,27 +34,24 @@ void do_division(Runtime::ProcessBufferContext &ctx) {
 				}
 			} else {
 				const float c = 1.f / b.constant_value;
-				const float *v = a.data;
-				for (uint32_t i = 0; i < buffer_size; ++i) {
-					out.data[i] = v[i] * c;
-				}
+				apply_op(
+						out.data,
+						buffer_size,
+						[](auto x, auto y) { return x * y; },
+						BufferOperand{ a.data },
+						ConstantOperand(c)
+				);
 			}
 		} else {
 			// Normally this case should have been optimized out at compile-time
-			const float v = b.constant_value == 0.f ? 0.f : a.constant_value / b.constant_value;
+			const float v = SafeDivide()(a.constant_value, b.constant_value);
 			for (uint32_t i = 0; i < buffer_size; ++i) {
 				out.data[i] = v;
 			}
 		}
 
 	} else {
-		for (uint32_t i = 0; i < buffer_size; ++i) {
-			if (b.data[i] == 0.f) {
-				out.data[i] = 0.f;
-			} else {
-				out.data[i] = a.data[i] / b.data[i];
-			}
-		}
+		apply_op(out.data, buffer_size, SafeDivide(), BufferOperand{ a.data }, BufferOperand{ b.data });
 	}
 }
 
@@ -62,13 +67,16 @@ void register_math_ops_nodes(Span<NodeType> types) {
 		t.outputs.push_back(NodeType::Port("out"));
 		t.compile_func = nullptr;
 		t.process_buffer_func = [](Runtime::ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return a + b; });
+			do_binop(ctx, [](auto a, auto b) { return a + b; });
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
 			const Interval b = ctx.get_input(1);
 			ctx.set_output(0, a + b);
 		};
+		t.affine_range_analysis_func = [](Runtime::AffineRangeAnalysisContext &ctx) {
+			ctx.set_output(0, ctx.get_input(0) + ctx.get_input(1));
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.add_format("{} = {} + {};\n", ctx.get_output_name(0), ctx.get_input_name(0), ctx.get_input_name(1));
 		};
@@ -81,13 +89,16 @@ void register_math_ops_nodes(Span<NodeType> types) {
 		t.inputs.push_back(NodeType::Port("b", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](Runtime::ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return a - b; });
+			do_binop(ctx, [](auto a, auto b) { return a - b; });
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
 			const Interval b = ctx.get_input(1);
 			ctx.set_output(0, a - b);
 		};
+		t.affine_range_analysis_func = [](Runtime::AffineRangeAnalysisContext &ctx) {
+			ctx.set_output(0, ctx.get_input(0) - ctx.get_input(1));
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.add_format("{} = {} - {};\n", ctx.get_output_name(0), ctx.get_input_name(0), ctx.get_input_name(1));
 		};
@@ -100,7 +111,7 @@ void register_math_ops_nodes(Span<NodeType> types) {
 		t.inputs.push_back(NodeType::Port("b", 0.f, VoxelGraphFunction::AUTO_CONNECT_NONE, false));
 		t.outputs.push_back(NodeType::Port("out"));
 		t.process_buffer_func = [](Runtime::ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return a * b; });
+			do_binop(ctx, [](auto a, auto b) { return a * b; });
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
@@ -112,6 +123,14 @@ void register_math_ops_nodes(Span<NodeType> types) {
 				ctx.set_output(0, a * b);
 			}
 		};
+		t.affine_range_analysis_func = [](Runtime::AffineRangeAnalysisContext &ctx) {
+			const AffineInterval &a = ctx.get_input(0);
+			if (ctx.get_input_address(0) == ctx.get_input_address(1)) {
+				ctx.set_output(0, squared(a));
+			} else {
+				ctx.set_output(0, a * ctx.get_input(1));
+			}
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.add_format("{} = {} * {};\n", ctx.get_output_name(0), ctx.get_input_name(0), ctx.get_input_name(1));
 		};
@@ -129,6 +148,16 @@ void register_math_ops_nodes(Span<NodeType> types) {
 			const Interval b = ctx.get_input(1);
 			ctx.set_output(0, a / b);
 		};
+		t.affine_range_analysis_func = [](Runtime::AffineRangeAnalysisContext &ctx) {
+			const AffineInterval &a = ctx.get_input(0);
+			const Interval b = ctx.get_input_interval(1);
+			if (b.is_single_value()) {
+				// Division by zero gives zero, see `SafeDivide`
+				ctx.set_output(0, b.min == 0.f ? AffineInterval() : a * (1.f / b.min));
+			} else {
+				ctx.set_output(0, a * reciprocal(ctx.get_input(1)));
+			}
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.add_format("{} = {} / {};\n", ctx.get_output_name(0), ctx.get_input_name(0), ctx.get_input_name(1));
 		};
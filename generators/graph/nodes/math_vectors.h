@@ -1,3 +1,4 @@
+#include "../../../util/math/float32x4.h"
 #include "../../../util/profiling.h"
 #include "../node_type_db.h"
 
@@ -35,6 +36,11 @@ void register_math_vector_nodes(Span<NodeType> types) {
 			const Interval r = sqrt(squared(dx) + squared(dy));
 			ctx.set_output(0, r);
 		};
+		t.affine_range_analysis_func = [](Runtime::AffineRangeAnalysisContext &ctx) {
+			const AffineInterval dx = ctx.get_input(2) - ctx.get_input(0);
+			const AffineInterval dy = ctx.get_input(3) - ctx.get_input(1);
+			ctx.set_output(0, get_length(dx, dy));
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.add_format(
 					"{} = distance(vec2({}, {}), vec2({}, {}));\n",
@@ -85,6 +91,12 @@ void register_math_vector_nodes(Span<NodeType> types) {
 			Interval r = get_length(dx, dy, dz);
 			ctx.set_output(0, r);
 		};
+		t.affine_range_analysis_func = [](Runtime::AffineRangeAnalysisContext &ctx) {
+			const AffineInterval dx = ctx.get_input(3) - ctx.get_input(0);
+			const AffineInterval dy = ctx.get_input(4) - ctx.get_input(1);
+			const AffineInterval dz = ctx.get_input(5) - ctx.get_input(2);
+			ctx.set_output(0, get_length(dx, dy, dz));
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.add_format(
 					"{} = distance(vec3({}, {}, {}), vec3({}, {}, {}));\n",
@@ -120,7 +132,18 @@ void register_math_vector_nodes(Span<NodeType> types) {
 			Runtime::Buffer &out_nz = ctx.get_output(2);
 			Runtime::Buffer &out_len = ctx.get_output(3);
 			const uint32_t buffer_size = out_nx.size;
-			for (uint32_t i = 0; i < buffer_size; ++i) {
+			uint32_t i = 0;
+			for (; i + Float32x4::SIZE <= buffer_size; i += Float32x4::SIZE) {
+				const Float32x4 x = Float32x4::load(xb.data + i);
+				const Float32x4 y = Float32x4::load(yb.data + i);
+				const Float32x4 z = Float32x4::load(zb.data + i);
+				const Float32x4 len = math::sqrt(squared(x) + squared(y) + squared(z));
+				(x / len).store(out_nx.data + i);
+				(y / len).store(out_ny.data + i);
+				(z / len).store(out_nz.data + i);
+				len.store(out_len.data + i);
+			}
+			for (; i < buffer_size; ++i) {
 				const float x = xb.data[i];
 				const float y = yb.data[i];
 				const float z = zb.data[i];
@@ -145,6 +168,17 @@ void register_math_vector_nodes(Span<NodeType> types) {
 			ctx.set_output(2, nz);
 			ctx.set_output(3, len);
 		};
+		t.affine_range_analysis_func = [](Runtime::AffineRangeAnalysisContext &ctx) {
+			const AffineInterval &x = ctx.get_input(0);
+			const AffineInterval &y = ctx.get_input(1);
+			const AffineInterval &z = ctx.get_input(2);
+			const AffineInterval len = get_length(x, y, z);
+			const AffineInterval inv_len = reciprocal(len);
+			ctx.set_output(0, x * inv_len);
+			ctx.set_output(1, y * inv_len);
+			ctx.set_output(2, z * inv_len);
+			ctx.set_output(3, len);
+		};
 
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.require_lib_code(
@@ -1,4 +1,5 @@
 #include "../node_type_db.h"
+#include "util.h"
 
 namespace zylann::voxel::pg {
 
@@ -6,6 +7,10 @@ inline float select(float a, float b, float threshold, float t) {
 	return t < threshold ? a : b;
 }
 
+inline math::Float32x4 select(math::Float32x4 a, math::Float32x4 b, math::Float32x4 threshold, math::Float32x4 t) {
+	return math::select(t < threshold, a, b);
+}
+
 void register_misc_nodes(Span<NodeType> types) {
 	using namespace math;
 
@@ -92,9 +97,15 @@ void register_misc_nodes(Span<NodeType> types) {
 				memcpy(out.data, a.data, buffer_size * sizeof(float));
 
 			} else {
-				for (uint32_t i = 0; i < buffer_size; ++i) {
-					out.data[i] = select(a.data[i], b.data[i], threshold, tested_value.data[i]);
-				}
+				apply_op(
+						out.data,
+						buffer_size,
+						[](auto va, auto vb, auto vthreshold, auto vt) { return select(va, vb, vthreshold, vt); },
+						BufferOperand{ a.data },
+						BufferOperand{ b.data },
+						ConstantOperand(threshold),
+						BufferOperand{ tested_value.data }
+				);
 			}
 		};
 
@@ -16,13 +16,16 @@ void register_sdf_nodes(Span<NodeType> types) {
 		t.inputs.push_back(NodeType::Port("height"));
 		t.outputs.push_back(NodeType::Port("sdf"));
 		t.process_buffer_func = [](Runtime::ProcessBufferContext &ctx) {
-			do_binop(ctx, [](float a, float b) { return a - b; });
+			do_binop(ctx, [](auto a, auto b) { return a - b; });
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval a = ctx.get_input(0);
 			const Interval b = ctx.get_input(1);
 			ctx.set_output(0, a - b);
 		};
+		t.affine_range_analysis_func = [](Runtime::AffineRangeAnalysisContext &ctx) {
+			ctx.set_output(0, ctx.get_input(0) - ctx.get_input(1));
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.add_format("{} = {} - {};\n", ctx.get_output_name(0), ctx.get_input_name(0), ctx.get_input_name(1));
 		};
@@ -56,10 +59,29 @@ void register_sdf_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &z = ctx.get_input(2);
 			const Params p = ctx.get_params<Params>();
 			Runtime::Buffer &out = ctx.get_output(0);
-			const Vector3f size(p.size_x, p.size_y, p.size_z);
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = math::sdf_box(Vector3f(x.data[i], y.data[i], z.data[i]), size);
-			}
+			apply_op(
+					out.data,
+					out.size,
+					[](auto px, auto py, auto pz, auto sx, auto sy, auto sz) {
+						// Same as `math::sdf_box`, written per component so it also works with packs of values
+						using T = decltype(px);
+						const T zero(0.f);
+						const T dx = math::abs(px) - sx;
+						const T dy = math::abs(py) - sy;
+						const T dz = math::abs(pz) - sz;
+						const T ox = math::max(dx, zero);
+						const T oy = math::max(dy, zero);
+						const T oz = math::max(dz, zero);
+						const T outside = math::sqrt(squared(ox) + squared(oy) + squared(oz));
+						return math::min(math::max(dx, math::max(dy, dz)), zero) + outside;
+					},
+					BufferOperand{ x.data },
+					BufferOperand{ y.data },
+					BufferOperand{ z.data },
+					ConstantOperand(p.size_x),
+					ConstantOperand(p.size_y),
+					ConstantOperand(p.size_z)
+			);
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
 			const Interval x = ctx.get_input(0);
@@ -107,15 +129,16 @@ void register_sdf_nodes(Span<NodeType> types) {
 			const Runtime::Buffer &z = ctx.get_input(2);
 			const Runtime::Buffer &r = ctx.get_input(3);
 			Runtime::Buffer &out = ctx.get_output(0);
+			auto f = [](auto px, auto py, auto pz, auto radius) {
+				return math::sqrt(squared(px) + squared(py) + squared(pz)) - radius;
+			};
+			const BufferOperand xo{ x.data };
+			const BufferOperand yo{ y.data };
+			const BufferOperand zo{ z.data };
 			if (r.is_constant) {
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] =
-							Math::sqrt(squared(x.data[i]) + squared(y.data[i]) + squared(z.data[i])) - r.constant_value;
-				}
+				apply_op(out.data, out.size, f, xo, yo, zo, ConstantOperand(r.constant_value));
 			} else {
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = Math::sqrt(squared(x.data[i]) + squared(y.data[i]) + squared(z.data[i])) - r.data[i];
-				}
+				apply_op(out.data, out.size, f, xo, yo, zo, BufferOperand{ r.data });
 			}
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
@@ -125,6 +148,13 @@ void register_sdf_nodes(Span<NodeType> types) {
 			const Interval r = ctx.get_input(3);
 			ctx.set_output(0, get_length(x, y, z) - r);
 		};
+		t.affine_range_analysis_func = [](Runtime::AffineRangeAnalysisContext &ctx) {
+			const AffineInterval &x = ctx.get_input(0);
+			const AffineInterval &y = ctx.get_input(1);
+			const AffineInterval &z = ctx.get_input(2);
+			const AffineInterval &r = ctx.get_input(3);
+			ctx.set_output(0, get_length(x, y, z) - r);
+		};
 		t.shader_gen_func = [](ShaderGenContext &ctx) {
 			ctx.add_format(
 					"{} = length(vec3({}, {}, {})) - {};\n",
@@ -227,14 +257,23 @@ void register_sdf_nodes(Span<NodeType> types) {
 					out.data[i] = a.data[i];
 				}
 			} else if (params.smoothness > 0.0001f) {
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = math::sdf_smooth_union(a.data[i], b.data[i], params.smoothness);
-				}
+				apply_op(
+						out.data,
+						out.size,
+						[](auto va, auto vb, auto s) { return math::sdf_smooth_union(va, vb, s); },
+						BufferOperand{ a.data },
+						BufferOperand{ b.data },
+						ConstantOperand(params.smoothness)
+				);
 			} else {
 				// Fallback on hard-union, smooth union does not support zero smoothness
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = math::sdf_union(a.data[i], b.data[i]);
-				}
+				apply_op(
+						out.data,
+						out.size,
+						[](auto va, auto vb) { return math::sdf_union(va, vb); },
+						BufferOperand{ a.data },
+						BufferOperand{ b.data }
+				);
 			}
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
@@ -331,14 +370,23 @@ void register_sdf_nodes(Span<NodeType> types) {
 					out.data[i] = a.data[i];
 				}
 			} else if (params.smoothness > 0.0001f) {
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = math::sdf_smooth_subtract(a.data[i], b.data[i], params.smoothness);
-				}
+				apply_op(
+						out.data,
+						out.size,
+						[](auto va, auto vb, auto s) { return math::sdf_smooth_subtract(va, vb, s); },
+						BufferOperand{ a.data },
+						BufferOperand{ b.data },
+						ConstantOperand(params.smoothness)
+				);
 			} else {
 				// Fallback on hard-subtract, smooth subtract does not support zero smoothness
-				for (uint32_t i = 0; i < out.size; ++i) {
-					out.data[i] = math::sdf_subtract(a.data[i], b.data[i]);
-				}
+				apply_op(
+						out.data,
+						out.size,
+						[](auto va, auto vb) { return math::sdf_subtract(va, vb); },
+						BufferOperand{ a.data },
+						BufferOperand{ b.data }
+				);
 			}
 		};
 		t.range_analysis_func = [](Runtime::RangeAnalysisContext &ctx) {
@@ -1,7 +1,9 @@
 #ifndef VOXEL_GRAPH_NODES_UTIL_H
 #define VOXEL_GRAPH_NODES_UTIL_H
 
+#include "../../../util/math/float32x4.h"
 #include "../voxel_graph_runtime.h"
+#include <type_traits>
 
 namespace zylann::voxel::pg {
 
@@ -22,6 +24,51 @@ inline void do_monop(pg::Runtime::ProcessBufferContext &ctx, F f) {
 	}
 }
 
+// Operand of `apply_op` having the same value for every element
+struct ConstantOperand {
+	float value;
+	math::Float32x4 value4;
+
+	ConstantOperand(float p_value) : value(p_value), value4(p_value) {}
+
+	inline float get(uint32_t) const {
+		return value;
+	}
+
+	inline math::Float32x4 get4(uint32_t) const {
+		return value4;
+	}
+};
+
+// Operand of `apply_op` reading values from a buffer
+struct BufferOperand {
+	const float *data;
+
+	inline float get(uint32_t i) const {
+		return data[i];
+	}
+
+	inline math::Float32x4 get4(uint32_t i) const {
+		return math::Float32x4::load(data + i);
+	}
+};
+
+// Calls `f` for every element of the operands and writes results into `out`.
+// If `f` can also take `math::Float32x4` arguments, elements are processed by packs of 4 and the remainder one by one.
+// Otherwise all elements are processed one by one.
+template <typename F, typename... Operands>
+inline void apply_op(float *out, const uint32_t size, F f, const Operands... operands) {
+	uint32_t i = 0;
+	if constexpr (std::is_invocable_v<F, decltype(operands.get4(0))...>) {
+		for (; i + math::Float32x4::SIZE <= size; i += math::Float32x4::SIZE) {
+			f(operands.get4(i)...).store(out + i);
+		}
+	}
+	for (; i < size; ++i) {
+		out[i] = f(operands.get(i)...);
+	}
+}
+
 template <typename F>
 inline void do_binop(pg::Runtime::ProcessBufferContext &ctx, F f) {
 	const Runtime::Buffer &a = ctx.get_input(0);
@@ -31,18 +78,10 @@ inline void do_binop(pg::Runtime::ProcessBufferContext &ctx, F f) {
 
 	if (a.is_constant || b.is_constant) {
 		if (!b.is_constant) {
-			const float c = a.constant_value;
-			const float *v = b.data;
-			for (uint32_t i = 0; i < buffer_size; ++i) {
-				out.data[i] = f(c, v[i]);
-			}
+			apply_op(out.data, buffer_size, f, ConstantOperand(a.constant_value), BufferOperand{ b.data });
 
 		} else if (!a.is_constant) {
-			const float c = b.constant_value;
-			const float *v = a.data;
-			for (uint32_t i = 0; i < buffer_size; ++i) {
-				out.data[i] = f(v[i], c);
-			}
+			apply_op(out.data, buffer_size, f, BufferOperand{ a.data }, ConstantOperand(b.constant_value));
 
 		} else {
 			// Normally this case should have been optimized out at compile-time
@@ -53,9 +92,7 @@ inline void do_binop(pg::Runtime::ProcessBufferContext &ctx, F f) {
 		}
 
 	} else {
-		for (uint32_t i = 0; i < buffer_size; ++i) {
-			out.data[i] = f(a.data[i], b.data[i]);
-		}
+		apply_op(out.data, buffer_size, f, BufferOperand{ a.data }, BufferOperand{ b.data });
 	}
 }
 
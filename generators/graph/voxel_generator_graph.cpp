@@ -7,6 +7,7 @@
 #include "../../util/godot/classes/image.h"
 #include "../../util/godot/classes/object.h"
 #include "../../util/godot/core/array.h"
+#include "../../util/godot/core/packed_arrays.h"
 #include "../../util/godot/core/string.h"
 #include "../../util/hash_funcs.h"
 #include "../../util/io/log.h"
@@ -24,6 +25,8 @@ namespace zylann::voxel {
 const char *VoxelGeneratorGraph::SIGNAL_NODE_NAME_CHANGED = "node_name_changed";
 
 VoxelGeneratorGraph::VoxelGeneratorGraph() {
+	_xz_cache.set_max_memory_usage(size_t(_xz_cache_max_memory_mb) * 1024 * 1024);
+	_disk_cache.set_max_size(uint64_t(_disk_cache_max_size_mb) * 1024 * 1024);
 	_main_function.instantiate();
 	_main_function->connect(
 			VoxelStringNames::get_singleton().changed, callable_mp(this, &VoxelGeneratorGraph::_on_subresource_changed)
@@ -47,6 +50,8 @@ void VoxelGeneratorGraph::clear() {
 		RWLockWrite wlock(_runtime_lock);
 		_runtime.reset();
 	}
+
+	_xz_cache.clear();
 }
 
 Ref<pg::VoxelGraphFunction> VoxelGeneratorGraph::get_main_function() const {
@@ -121,6 +126,22 @@ int VoxelGeneratorGraph::get_subdivision_size() const {
 	return _subdivision_size;
 }
 
+void VoxelGeneratorGraph::set_use_adaptive_subdivision(bool use) {
+	_use_adaptive_subdivision = use;
+}
+
+bool VoxelGeneratorGraph::is_using_adaptive_subdivision() const {
+	return _use_adaptive_subdivision;
+}
+
+void VoxelGeneratorGraph::set_use_affine_range_analysis(bool use) {
+	_use_affine_range_analysis = use;
+}
+
+bool VoxelGeneratorGraph::is_using_affine_range_analysis() const {
+	return _use_affine_range_analysis;
+}
+
 void VoxelGeneratorGraph::set_debug_clipped_blocks(bool enabled) {
 	_debug_clipped_blocks = enabled;
 }
@@ -137,6 +158,65 @@ bool VoxelGeneratorGraph::is_using_xz_caching() const {
 	return _use_xz_caching;
 }
 
+void VoxelGeneratorGraph::set_xz_cache_max_memory_mb(int mb) {
+	ZN_ASSERT_RETURN(mb >= 0);
+	_xz_cache_max_memory_mb = mb;
+	_xz_cache.set_max_memory_usage(size_t(mb) * 1024 * 1024);
+}
+
+int VoxelGeneratorGraph::get_xz_cache_max_memory_mb() const {
+	return _xz_cache_max_memory_mb;
+}
+
+void VoxelGeneratorGraph::set_disk_cache_directory(String path) {
+	_disk_cache.set_directory(path);
+}
+
+String VoxelGeneratorGraph::get_disk_cache_directory() const {
+	return _disk_cache.get_directory();
+}
+
+void VoxelGeneratorGraph::set_disk_cache_max_size_mb(int mb) {
+	ZN_ASSERT_RETURN(mb >= 0);
+	_disk_cache_max_size_mb = mb;
+	_disk_cache.set_max_size(uint64_t(mb) * 1024 * 1024);
+}
+
+int VoxelGeneratorGraph::get_disk_cache_max_size_mb() const {
+	return _disk_cache_max_size_mb;
+}
+
+void VoxelGeneratorGraph::set_node_sampling_interval(int interval) {
+	ZN_ASSERT_RETURN(interval >= 0);
+	_node_sampling_interval = interval;
+	RWLockRead rlock(_runtime_lock);
+	if (_runtime != nullptr) {
+		pg::NodeSamplingProfiler *profiler = _runtime->runtime.get_sampling_profiler();
+		if (profiler != nullptr) {
+			profiler->set_sample_interval(interval);
+		}
+	}
+}
+
+int VoxelGeneratorGraph::get_node_sampling_interval() const {
+	return _node_sampling_interval;
+}
+
+uint64_t VoxelGeneratorGraph::get_disk_cache_hash(const Runtime &runtime_wrapper) const {
+	uint64_t h = hash_djb2_one_64(runtime_wrapper.graph_hash);
+	uint32_t clip_threshold_bits;
+	memcpy(&clip_threshold_bits, &_sdf_clip_threshold, sizeof(clip_threshold_bits));
+	h = hash_djb2_one_64(clip_threshold_bits, h);
+	h = hash_djb2_one_64(_use_subdivision, h);
+	h = hash_djb2_one_64(_subdivision_size, h);
+	h = hash_djb2_one_64(_use_adaptive_subdivision, h);
+	h = hash_djb2_one_64(_use_affine_range_analysis, h);
+	h = hash_djb2_one_64(_use_optimized_execution_map, h);
+	h = hash_djb2_one_64(_debug_clipped_blocks, h);
+	h = hash_djb2_one_64(_texture_mode, h);
+	return h;
+}
+
 void VoxelGeneratorGraph::set_texture_mode(const TextureMode mode) {
 	ZN_ASSERT_RETURN(mode >= 0 && mode < TEXTURE_MODE_COUNT);
 	_texture_mode = mode;
@@ -629,8 +709,49 @@ void fill_zx_integer_slice(
 	}
 }
 
+// Sections of blocks are not split below this size when using adaptive subdivision. Smaller sections would have too
+// much overhead when running the graph.
+const int ADAPTIVE_SUBDIVISION_MIN_SIZE = 8;
+
+inline bool can_split_section(const Vector3i size) {
+	return size.x >= 2 * ADAPTIVE_SUBDIVISION_MIN_SIZE && size.y >= 2 * ADAPTIVE_SUBDIVISION_MIN_SIZE &&
+			size.z >= 2 * ADAPTIVE_SUBDIVISION_MIN_SIZE && (size.x % 2) == 0 && (size.y % 2) == 0 &&
+			(size.z % 2) == 0;
+}
+
+inline Vector3i get_octant_offset(const unsigned int octant_index, const Vector3i octant_size) {
+	return Vector3i(
+			static_cast<int>(octant_index & 1) * octant_size.x,
+			static_cast<int>((octant_index >> 1) & 1) * octant_size.y,
+			static_cast<int>((octant_index >> 2) & 1) * octant_size.z
+	);
+}
+
+// Tells if SDF can be filled without computing voxels, same as in `generate_block`
+inline bool is_sdf_range_clipped(const math::Interval sdf_range, const float clip_threshold) {
+	return (sdf_range.min > clip_threshold && sdf_range.max > clip_threshold) ||
+			(sdf_range.min < -clip_threshold && sdf_range.max < -clip_threshold) || sdf_range.is_single_value();
+}
+
 } // namespace
 
+void VoxelGeneratorGraph::analyze_section_range(
+		pg::Runtime::State &state,
+		const Runtime &runtime_wrapper,
+		const Vector3i gmin,
+		const Vector3i gmax,
+		const math::Interval sdf_input_range
+) {
+	QueryInputs<math::Interval> range_inputs(
+			runtime_wrapper,
+			math::Interval(gmin.x, gmax.x),
+			math::Interval(gmin.y, gmax.y),
+			math::Interval(gmin.z, gmax.z),
+			sdf_input_range
+	);
+	runtime_wrapper.runtime.analyze_range(state, range_inputs.get());
+}
+
 VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::VoxelQueryData input) {
 	std::shared_ptr<Runtime> runtime_ptr;
 	{
@@ -646,6 +767,21 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 
 	VoxelBuffer &out_buffer = input.voxel_buffer;
 
+	// Blocks depending on existing voxels can't be cached
+	const bool use_disk_cache = _disk_cache.is_enabled() && runtime_ptr->sdf_input_index == -1;
+	uint64_t disk_cache_hash = 0;
+	if (use_disk_cache) {
+		disk_cache_hash = get_disk_cache_hash(*runtime_ptr);
+		// Generators sharing the same directory must not remove each other's blocks. Saved generators are told apart
+		// by their path, while those without a path store blocks directly in the directory.
+		const String path = get_path();
+		_disk_cache.set_owner_name(path.is_empty() ? String() : String("graph_") + String::num_uint64(path.hash(), 16));
+		const Vector3i block_origin = input.origin_in_voxels;
+		if (_disk_cache.try_load(disk_cache_hash, block_origin, input.lod, out_buffer, result.max_lod_hint)) {
+			return result;
+		}
+	}
+
 #ifdef TOOLS_ENABLED
 	switch (_texture_mode) {
 		case TEXTURE_MODE_MIXEL4: {
@@ -718,6 +854,7 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 	const unsigned int slice_buffer_size = section_size.x * section_size.z;
 	pg::Runtime &runtime = runtime_ptr->runtime;
 	runtime.prepare_state(cache.state, slice_buffer_size, false);
+	cache.state.set_use_affine_range_analysis(_use_affine_range_analysis);
 
 	cache.x_cache.resize(slice_buffer_size);
 	cache.y_cache.resize(slice_buffer_size);
@@ -758,202 +895,325 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 		}
 	}
 
+	// Sections can be split into smaller ones if range analysis finds that parts of them can be skipped, so they are
+	// processed from a stack.
+	struct Section {
+		Vector3i rmin;
+		Vector3i size;
+		// If true, range analysis results of the section are stored at its position in the stack
+		bool analyzed;
+	};
+	SmallVector<Section, 64> sections;
+
+	const unsigned int ranges_count = cache.state.get_ranges().size();
+	if (_use_adaptive_subdivision) {
+		cache.section_ranges.resize(sections.capacity() * ranges_count);
+		cache.parent_section_ranges.resize(ranges_count);
+	}
+
 	// For each subdivision of the block
 	for (int sz = 0; sz < bs.z; sz += section_size.z) {
 		for (int sy = 0; sy < bs.y; sy += section_size.y) {
 			for (int sx = 0; sx < bs.x; sx += section_size.x) {
-				ZN_PROFILE_SCOPE_NAMED("Section");
-
-				const Vector3i rmin(sx, sy, sz);
-				const Vector3i rmax = rmin + Vector3i(section_size);
-				const Vector3i gmin = origin + (rmin << input.lod);
-				const Vector3i gmax = origin + (rmax << input.lod);
-
-				// Do a quick analysis of the area. We'll only compute voxels if necessary.
-				{
-					QueryInputs<math::Interval> range_inputs(
-							*runtime_ptr,
-							math::Interval(gmin.x, gmax.x),
-							math::Interval(gmin.y, gmax.y),
-							math::Interval(gmin.z, gmax.z),
-							sdf_input_range
-					);
-					runtime.analyze_range(cache.state, range_inputs.get());
-				}
+				sections.push_back(Section{ Vector3i(sx, sy, sz), section_size, false });
 
-				SmallVector<unsigned int, pg::Runtime::MAX_OUTPUTS> required_outputs;
+				while (sections.size() > 0) {
+					ZN_PROFILE_SCOPE_NAMED("Section");
 
-				bool sdf_is_air = true;
-				bool sdf_is_uniform = true;
-				if (sdf_output_buffer_index != -1) {
-					const math::Interval sdf_range = cache.state.get_range(sdf_output_buffer_index);
-					bool sdf_is_matter = false;
+					const Section section = sections[sections.size() - 1];
+					sections.resize(sections.size() - 1);
 
-					if (sdf_range.min > clip_threshold && sdf_range.max > clip_threshold) {
-						out_buffer.fill_area_f(air_sdf, rmin, rmax, sdf_channel);
-						sdf_is_air = true;
-
-					} else if (sdf_range.min < -clip_threshold && sdf_range.max < -clip_threshold) {
-						out_buffer.fill_area_f(matter_sdf, rmin, rmax, sdf_channel);
-						sdf_is_air = false;
-						sdf_is_matter = true;
-
-					} else if (sdf_range.is_single_value()) {
-						out_buffer.fill_area_f(sdf_range.min, rmin, rmax, sdf_channel);
-						sdf_is_air = sdf_range.min > 0.f;
-						sdf_is_matter = !sdf_is_air;
+					const Vector3i rmin = section.rmin;
+					const Vector3i rmax = rmin + section.size;
+					const Vector3i gmin = origin + (rmin << input.lod);
+					const Vector3i gmax = origin + (rmax << input.lod);
 
+					if (section.analyzed) {
+						// Analyzed already when its parent section got split
+						cache.state.set_ranges(
+								to_span(cache.section_ranges).sub(sections.size() * ranges_count, ranges_count)
+						);
 					} else {
-						// SDF is not uniform, we'll need to compute it per voxel
-						required_outputs.push_back(runtime_ptr->sdf_output_index);
-						sdf_is_air = false;
-						sdf_is_uniform = false;
+						// Do a quick analysis of the area. We'll only compute voxels if necessary.
+						analyze_section_range(cache.state, *runtime_ptr, gmin, gmax, sdf_input_range);
 					}
 
-					all_sdf_is_air = all_sdf_is_air && sdf_is_air;
-					all_sdf_is_matter = all_sdf_is_matter && sdf_is_matter;
-				}
+					// The surface often crosses only a small part of a section. If range analysis finds that SDF can be
+					// clipped in some of its octants, or that fewer nodes need to run there, process octants
+					// separately.
+					if (_use_adaptive_subdivision && sdf_output_buffer_index != -1 && can_split_section(section.size) &&
+						sections.size() + 8 <= sections.capacity() &&
+						!is_sdf_range_clipped(cache.state.get_range(sdf_output_buffer_index), clip_threshold)) {
+						const unsigned int sdf_output_index = runtime_ptr->sdf_output_index;
+						const Span<const unsigned int> sdf_output(&sdf_output_index, 1);
+
+						unsigned int operation_count = 0;
+						if (_use_optimized_execution_map) {
+							runtime.generate_optimized_execution_map(
+									cache.state, cache.optimized_execution_map, sdf_output, false
+							);
+							operation_count = cache.optimized_execution_map.operations.size();
+						}
 
-				bool type_is_uniform = false;
-				if (type_output_buffer_index != -1) {
-					const math::Interval type_range = cache.state.get_range(type_output_buffer_index);
-					if (type_range.is_single_value()) {
-						out_buffer.fill_area(int(type_range.min), rmin, rmax, type_channel);
-						type_is_uniform = true;
-					} else {
-						// Types are not uniform, we'll need to compute them per voxel
-						required_outputs.push_back(runtime_ptr->type_output_index);
-					}
-				}
+						cache.state.get_ranges().copy_to(to_span(cache.parent_section_ranges));
 
-				if (runtime_ptr->weight_outputs_count > 0 && !sdf_is_air) {
-					// We can skip this when SDF is air because there won't be any matter to give a texture to
-					// TODO Range analysis on that?
-					// Not easy to do that from here, they would have to ALL be locally constant in order to use a
-					// short-circuit...
-					for (unsigned int i = 0; i < runtime_ptr->weight_outputs_count; ++i) {
-						required_outputs.push_back(runtime_ptr->weight_output_indices[i]);
-					}
-				}
+						const Vector3i octant_size = section.size / 2;
+						bool split = false;
 
-				// TODO Instead of filling this ourselves, can we leave this to the graph runtime?
-				// Because currently our logic seems redundant and more complicated, since we also have to not request
-				// those outputs later if any other output isn't uniform. Instead, the graph runtime can figure out
-				// that stuff is constant.
-				bool single_texture_is_uniform = false;
-				if (runtime_ptr->single_texture_output_index != -1 && !sdf_is_air) {
-					const math::Interval index_range =
-							cache.state.get_range(runtime_ptr->single_texture_output_buffer_index);
-
-					if (index_range.is_single_value()) {
-						single_texture_is_uniform = true;
-						fill_texturing_data_from_single_texture_index(
-								out_buffer, static_cast<int>(index_range.min), rmin, rmax, _texture_mode
-						);
-					} else {
-						required_outputs.push_back(runtime_ptr->single_texture_output_index);
-					}
-				}
+						// All octants are analyzed, so if the section gets split, they don't have to be analyzed again
+						// when popped
+						for (unsigned int octant_index = 0; octant_index < 8; ++octant_index) {
+							const Vector3i octant_rmin = rmin + get_octant_offset(octant_index, octant_size);
+							const Vector3i octant_gmin = origin + (octant_rmin << input.lod);
+							const Vector3i octant_gmax = origin + ((octant_rmin + octant_size) << input.lod);
 
-				if (required_outputs.size() == 0) {
-					// We found all we need with range analysis, no need to calculate per voxel.
-					continue;
-				}
+							analyze_section_range(cache.state, *runtime_ptr, octant_gmin, octant_gmax, sdf_input_range);
 
-				// At least one channel needs per-voxel computation.
+							const unsigned int stack_index = sections.size() + octant_index;
+							cache.state.get_ranges().copy_to(
+									to_span(cache.section_ranges).sub(stack_index * ranges_count, ranges_count)
+							);
 
-				if (_use_optimized_execution_map) {
-					runtime.generate_optimized_execution_map(
-							cache.state, cache.optimized_execution_map, to_span(required_outputs), false
-					);
-				}
+							if (split) {
+								continue;
+							}
 
-				{
-					unsigned int i = 0;
-					for (int rz = rmin.z, gz = gmin.z; rz < rmax.z; ++rz, gz += stride) {
-						for (int rx = rmin.x, gx = gmin.x; rx < rmax.x; ++rx, gx += stride) {
-							x_cache[i] = gx;
-							z_cache[i] = gz;
-							++i;
+							if (is_sdf_range_clipped(cache.state.get_range(sdf_output_buffer_index), clip_threshold)) {
+								split = true;
+
+							} else if (_use_optimized_execution_map) {
+								runtime.generate_optimized_execution_map(
+										cache.state, cache.optimized_execution_map, sdf_output, false
+								);
+								split = cache.optimized_execution_map.operations.size() < operation_count;
+							}
 						}
+
+						if (split) {
+							for (unsigned int octant_index = 0; octant_index < 8; ++octant_index) {
+								const Vector3i octant_rmin = rmin + get_octant_offset(octant_index, octant_size);
+								sections.push_back(Section{ octant_rmin, octant_size, true });
+							}
+							continue;
+						}
+
+						cache.state.set_ranges(to_span(cache.parent_section_ranges));
 					}
-				}
 
-				for (int ry = rmin.y, gy = gmin.y; ry < rmax.y; ++ry, gy += stride) {
-					ZN_PROFILE_SCOPE_NAMED("Full slice");
+					SmallVector<unsigned int, pg::Runtime::MAX_OUTPUTS> required_outputs;
+
+					bool sdf_is_air = true;
+					bool sdf_is_uniform = true;
+					if (sdf_output_buffer_index != -1) {
+						const math::Interval sdf_range = cache.state.get_range(sdf_output_buffer_index);
+						bool sdf_is_matter = false;
+
+						if (sdf_range.min > clip_threshold && sdf_range.max > clip_threshold) {
+							out_buffer.fill_area_f(air_sdf, rmin, rmax, sdf_channel);
+							sdf_is_air = true;
+
+						} else if (sdf_range.min < -clip_threshold && sdf_range.max < -clip_threshold) {
+							out_buffer.fill_area_f(matter_sdf, rmin, rmax, sdf_channel);
+							sdf_is_air = false;
+							sdf_is_matter = true;
+
+						} else if (sdf_range.is_single_value()) {
+							out_buffer.fill_area_f(sdf_range.min, rmin, rmax, sdf_channel);
+							sdf_is_air = sdf_range.min > 0.f;
+							sdf_is_matter = !sdf_is_air;
+
+						} else {
+							// SDF is not uniform, we'll need to compute it per voxel
+							required_outputs.push_back(runtime_ptr->sdf_output_index);
+							sdf_is_air = false;
+							sdf_is_uniform = false;
+						}
 
-					y_cache.fill(gy);
+						all_sdf_is_air = all_sdf_is_air && sdf_is_air;
+						all_sdf_is_matter = all_sdf_is_matter && sdf_is_matter;
+					}
 
-					if (input_sdf_full_cache.size() != 0) {
-						// Copy input SDF using expected coordinate convention.
-						// VoxelBuffer is ZXY, but the graph runs in YXZ.
-						unsigned int i = 0;
-						for (int rz = rmin.z; rz < rmax.z; ++rz) {
-							for (int rx = rmin.x; rx < rmax.x; ++rx) {
-								const unsigned int loc = Vector3iUtil::get_zxy_index(rx, ry, rz, bs.x, bs.y);
-								input_sdf_slice_cache[i] = input_sdf_full_cache[loc];
-								++i;
-							}
+					bool type_is_uniform = false;
+					if (type_output_buffer_index != -1) {
+						const math::Interval type_range = cache.state.get_range(type_output_buffer_index);
+						if (type_range.is_single_value()) {
+							out_buffer.fill_area(int(type_range.min), rmin, rmax, type_channel);
+							type_is_uniform = true;
+						} else {
+							// Types are not uniform, we'll need to compute them per voxel
+							required_outputs.push_back(runtime_ptr->type_output_index);
 						}
 					}
 
-					// Full query (unless using execution map)
-					{
-						QueryInputs<Span<const float>> query_inputs(
-								*runtime_ptr, x_cache, y_cache, z_cache, input_sdf_slice_cache
-						);
-						runtime.generate_set(
-								cache.state,
-								query_inputs.get(),
-								_use_xz_caching && ry != rmin.y,
-								_use_optimized_execution_map ? &cache.optimized_execution_map : nullptr
-						);
+					if (runtime_ptr->weight_outputs_count > 0 && !sdf_is_air) {
+						// We can skip this when SDF is air because there won't be any matter to give a texture to
+						// TODO Range analysis on that?
+						// Not easy to do that from here, they would have to ALL be locally constant in order to use a
+						// short-circuit...
+						for (unsigned int i = 0; i < runtime_ptr->weight_outputs_count; ++i) {
+							required_outputs.push_back(runtime_ptr->weight_output_indices[i]);
+						}
 					}
 
-					if (sdf_output_buffer_index != -1
-						// If SDF was found uniform, we already filled the results, and we did not require it in the
-						// query. But if another output exists, a query might still run (so we end up at this
-						// `if`), and we should not gather SDF results. Otherwise it would overwrite the slice with
-						// garbage since SDF was skipped.
-						// The same logic goes for other outputs: if they aren't in the query, we must not fill
-						// them.
-						&& !sdf_is_uniform) {
-						const pg::Runtime::Buffer &sdf_buffer = cache.state.get_buffer(sdf_output_buffer_index);
-						fill_zx_sdf_slice(
-								sdf_buffer, out_buffer, sdf_channel, sdf_channel_depth, sdf_scale, rmin, rmax, ry
-						);
+					// TODO Instead of filling this ourselves, can we leave this to the graph runtime?
+					// Because currently our logic seems redundant and more complicated, since we also have to not
+					// request those outputs later if any other output isn't uniform. Instead, the graph runtime can
+					// figure out that stuff is constant.
+					bool single_texture_is_uniform = false;
+					if (runtime_ptr->single_texture_output_index != -1 && !sdf_is_air) {
+						const math::Interval index_range =
+								cache.state.get_range(runtime_ptr->single_texture_output_buffer_index);
+
+						if (index_range.is_single_value()) {
+							single_texture_is_uniform = true;
+							fill_texturing_data_from_single_texture_index(
+									out_buffer, static_cast<int>(index_range.min), rmin, rmax, _texture_mode
+							);
+						} else {
+							required_outputs.push_back(runtime_ptr->single_texture_output_index);
+						}
 					}
 
-					if (type_output_buffer_index != -1 && !type_is_uniform) {
-						const pg::Runtime::Buffer &type_buffer = cache.state.get_buffer(type_output_buffer_index);
-						fill_zx_integer_slice(
-								type_buffer, out_buffer, type_channel, type_channel_depth, rmin, rmax, ry
-						);
+					if (required_outputs.size() == 0) {
+						// We found all we need with range analysis, no need to calculate per voxel.
+						continue;
 					}
 
-					if (runtime_ptr->single_texture_output_index != -1 && !single_texture_is_uniform) {
-						gather_texturing_data_from_single_texture_output(
-								runtime_ptr->single_texture_output_buffer_index,
-								cache.state,
-								rmin,
-								rmax,
-								ry,
-								out_buffer,
-								_texture_mode
+					// At least one channel needs per-voxel computation.
+
+					// Sections can be smaller than the first one after adaptive subdivision
+					const unsigned int section_slice_size = section.size.x * section.size.z;
+					if (cache.state.get_buffer_size() != section_slice_size) {
+						runtime.prepare_state(cache.state, section_slice_size, false);
+					}
+					Span<float> section_x_cache = x_cache.sub(0, section_slice_size);
+					Span<float> section_y_cache = y_cache.sub(0, section_slice_size);
+					Span<float> section_z_cache = z_cache.sub(0, section_slice_size);
+					Span<float> section_input_sdf_slice_cache = input_sdf_slice_cache.size() != 0
+							? input_sdf_slice_cache.sub(0, section_slice_size)
+							: input_sdf_slice_cache;
+
+					if (_use_optimized_execution_map) {
+						runtime.generate_optimized_execution_map(
+								cache.state, cache.optimized_execution_map, to_span(required_outputs), false
 						);
 					}
 
-					if (runtime_ptr->weight_outputs_count > 0) {
-						gather_texturing_data_from_weight_outputs(
-								to_span_const(runtime_ptr->weight_outputs, runtime_ptr->weight_outputs_count),
-								cache.state,
-								rmin,
-								rmax,
-								ry,
-								out_buffer,
-								spare_texture_indices,
-								_texture_mode
-						);
+					{
+						unsigned int i = 0;
+						for (int rz = rmin.z, gz = gmin.z; rz < rmax.z; ++rz, gz += stride) {
+							for (int rx = rmin.x, gx = gmin.x; rx < rmax.x; ++rx, gx += stride) {
+								section_x_cache[i] = gx;
+								section_z_cache[i] = gz;
+								++i;
+							}
+						}
+					}
+
+					// Values depending only on X and Z may have been computed already by blocks above or below
+					const bool use_shared_xz_cache = _use_xz_caching && _xz_cache_max_memory_mb > 0 &&
+							runtime.get_outer_group_buffer_addresses().size() > 0;
+					if (use_shared_xz_cache) {
+						pg::XZCache::Key key;
+						key.program_hash = runtime_ptr->program_hash;
+						key.origin = Vector2i(gmin.x, gmin.z);
+						key.size = Vector2i(section.size.x, section.size.z);
+						key.stride = stride;
+
+						if (!_xz_cache.try_load(key, runtime, cache.state)) {
+							// Y and SDF are not used by the outer group, they only need to be bound
+							QueryInputs<Span<const float>> query_inputs(
+									*runtime_ptr,
+									section_x_cache,
+									section_y_cache,
+									section_z_cache,
+									section_input_sdf_slice_cache
+							);
+							runtime.generate_outer_group(cache.state, query_inputs.get());
+							_xz_cache.store(key, runtime, cache.state);
+						}
+					}
+
+					for (int ry = rmin.y, gy = gmin.y; ry < rmax.y; ++ry, gy += stride) {
+						ZN_PROFILE_SCOPE_NAMED("Full slice");
+
+						section_y_cache.fill(gy);
+
+						if (input_sdf_full_cache.size() != 0) {
+							// Copy input SDF using expected coordinate convention.
+							// VoxelBuffer is ZXY, but the graph runs in YXZ.
+							unsigned int i = 0;
+							for (int rz = rmin.z; rz < rmax.z; ++rz) {
+								for (int rx = rmin.x; rx < rmax.x; ++rx) {
+									const unsigned int loc = Vector3iUtil::get_zxy_index(rx, ry, rz, bs.x, bs.y);
+									section_input_sdf_slice_cache[i] = input_sdf_full_cache[loc];
+									++i;
+								}
+							}
+						}
+
+						// Full query (unless using execution map)
+						{
+							QueryInputs<Span<const float>> query_inputs(
+									*runtime_ptr,
+									section_x_cache,
+									section_y_cache,
+									section_z_cache,
+									section_input_sdf_slice_cache
+							);
+							runtime.generate_set(
+									cache.state,
+									query_inputs.get(),
+									use_shared_xz_cache || (_use_xz_caching && ry != rmin.y),
+									_use_optimized_execution_map ? &cache.optimized_execution_map : nullptr
+							);
+						}
+
+						if (sdf_output_buffer_index != -1
+							// If SDF was found uniform, we already filled the results, and we did not require it in the
+							// query. But if another output exists, a query might still run (so we end up at this
+							// `if`), and we should not gather SDF results. Otherwise it would overwrite the slice with
+							// garbage since SDF was skipped.
+							// The same logic goes for other outputs: if they aren't in the query, we must not fill
+							// them.
+							&& !sdf_is_uniform) {
+							const pg::Runtime::Buffer &sdf_buffer = cache.state.get_buffer(sdf_output_buffer_index);
+							fill_zx_sdf_slice(
+									sdf_buffer, out_buffer, sdf_channel, sdf_channel_depth, sdf_scale, rmin, rmax, ry
+							);
+						}
+
+						if (type_output_buffer_index != -1 && !type_is_uniform) {
+							const pg::Runtime::Buffer &type_buffer = cache.state.get_buffer(type_output_buffer_index);
+							fill_zx_integer_slice(
+									type_buffer, out_buffer, type_channel, type_channel_depth, rmin, rmax, ry
+							);
+						}
+
+						if (runtime_ptr->single_texture_output_index != -1 && !single_texture_is_uniform) {
+							gather_texturing_data_from_single_texture_output(
+									runtime_ptr->single_texture_output_buffer_index,
+									cache.state,
+									rmin,
+									rmax,
+									ry,
+									out_buffer,
+									_texture_mode
+							);
+						}
+
+						if (runtime_ptr->weight_outputs_count > 0) {
+							gather_texturing_data_from_weight_outputs(
+									to_span_const(runtime_ptr->weight_outputs, runtime_ptr->weight_outputs_count),
+									cache.state,
+									rmin,
+									rmax,
+									ry,
+									out_buffer,
+									spare_texture_indices,
+									_texture_mode
+							);
+						}
 					}
 				}
 			}
@@ -979,6 +1239,10 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 		result.max_lod_hint = true;
 	}
 
+	if (use_disk_cache) {
+		_disk_cache.store(disk_cache_hash, input.origin_in_voxels, input.lod, out_buffer, result.max_lod_hint);
+	}
+
 	return result;
 }
 
@@ -1015,6 +1279,7 @@ bool VoxelGeneratorGraph::generate_broad_block(VoxelGenerator::VoxelQueryData in
 	// Slice is on the Y axis
 	pg::Runtime &runtime = runtime_ptr->runtime;
 	runtime.prepare_state(cache.state, 1, false);
+	cache.state.set_use_affine_range_analysis(_use_affine_range_analysis);
 
 	const float air_sdf = _debug_clipped_blocks ? constants::SDF_FAR_INSIDE : constants::SDF_FAR_OUTSIDE;
 	const float matter_sdf = _debug_clipped_blocks ? constants::SDF_FAR_OUTSIDE : constants::SDF_FAR_INSIDE;
@@ -1304,10 +1569,26 @@ pg::CompilationResult VoxelGeneratorGraph::compile(bool debug) {
 		r->spare_texture_indices = spare_indices;
 	}
 
+	if (r->sdf_output_index != -1) {
+		const unsigned int sdf_output_index = r->sdf_output_index;
+		runtime.generate_pruned_execution_map(r->sdf_execution_map, Span<const unsigned int>(&sdf_output_index, 1));
+	}
+
+	r->program_hash = runtime.get_program_hash();
+	r->graph_hash = _main_function->get_output_graph_hash();
+
+	pg::NodeSamplingProfiler *sampling_profiler = runtime.get_sampling_profiler();
+	if (sampling_profiler != nullptr) {
+		sampling_profiler->set_sample_interval(_node_sampling_interval);
+	}
+
 	// Store valid result
 	RWLockWrite wlock(_runtime_lock);
 	_runtime = r;
 
+	// Entries are keyed by program hash so they can't be mixed up with the new program, but they would remain unused
+	_xz_cache.clear();
+
 	const int64_t time_spent = Time::get_singleton()->get_ticks_usec() - time_before;
 	ZN_PRINT_VERBOSE(format("Voxel graph compiled in {} us", time_spent));
 
@@ -1842,7 +2123,11 @@ VoxelSingleValue VoxelGeneratorGraph::generate_single(Vector3i position, unsigne
 
 	switch (channel) {
 		case VoxelBuffer::CHANNEL_SDF: {
-			v.f = L::query(*runtime_ptr, position, runtime_ptr->sdf_output_buffer_index);
+			if (runtime_ptr->sdf_output_buffer_index != -1) {
+				v.f = query_sdf_single(runtime_ptr, to_vec3f(position));
+			} else {
+				v.f = 0.f;
+			}
 		} break;
 
 		case VoxelBuffer::CHANNEL_TYPE: {
@@ -1877,6 +2162,101 @@ VoxelSingleValue VoxelGeneratorGraph::generate_single(Vector3i position, unsigne
 	return v;
 }
 
+pg::Runtime::State &VoxelGeneratorGraph::get_point_query_state(
+		PointQueryState &pqs,
+		const std::shared_ptr<const Runtime> &runtime_ptr,
+		const unsigned int values_count
+) {
+	// Compare owners rather than addresses, so a new runtime allocated where an old one was can't be mistaken for it
+	if (pqs.runtime.owner_before(runtime_ptr) || runtime_ptr.owner_before(pqs.runtime)) {
+		runtime_ptr->runtime.prepare_state(pqs.state, values_count, false);
+		pqs.runtime = runtime_ptr;
+	}
+	return pqs.state;
+}
+
+float VoxelGeneratorGraph::query_sdf_single(const std::shared_ptr<const Runtime> &runtime_ptr, Vector3f position) {
+	Cache &cache = get_tls_cache();
+	pg::Runtime::State &state = get_point_query_state(cache.single_point_query, runtime_ptr, 1);
+
+	QueryInputs<float> inputs(*runtime_ptr, position.x, position.y, position.z, 0.f);
+	runtime_ptr->runtime.generate_single(state, inputs.get(), &runtime_ptr->sdf_execution_map);
+
+	const pg::Runtime::Buffer &buffer = state.get_buffer(runtime_ptr->sdf_output_buffer_index);
+	return buffer.data[0];
+}
+
+float VoxelGeneratorGraph::generate_sdf_single(Vector3f position) {
+	std::shared_ptr<const Runtime> runtime_ptr;
+	{
+		RWLockRead rlock(_runtime_lock);
+		runtime_ptr = _runtime;
+	}
+	if (runtime_ptr == nullptr) {
+		ZN_PRINT_ERROR_ONCE("No compiled graph available");
+		return constants::SDF_FAR_OUTSIDE;
+	}
+	if (runtime_ptr->sdf_output_buffer_index == -1) {
+		// The graph does not define such output
+		return constants::SDF_FAR_OUTSIDE;
+	}
+	return query_sdf_single(runtime_ptr, position);
+}
+
+void VoxelGeneratorGraph::generate_sdf_batch(Span<const Vector3f> positions, Span<float> out_sdf) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(positions.size() == out_sdf.size());
+
+	std::shared_ptr<const Runtime> runtime_ptr;
+	{
+		RWLockRead rlock(_runtime_lock);
+		runtime_ptr = _runtime;
+	}
+	if (runtime_ptr == nullptr) {
+		ZN_PRINT_ERROR_ONCE("No compiled graph available");
+		out_sdf.fill(constants::SDF_FAR_OUTSIDE);
+		return;
+	}
+	if (runtime_ptr->sdf_output_buffer_index == -1) {
+		// The graph does not define such output
+		out_sdf.fill(constants::SDF_FAR_OUTSIDE);
+		return;
+	}
+
+	Cache &cache = get_tls_cache();
+	pg::Runtime::State &state = get_point_query_state(cache.batch_point_query, runtime_ptr, SDF_BATCH_SIZE);
+	const pg::Runtime &runtime = runtime_ptr->runtime;
+	const pg::Runtime::Buffer &sdf_buffer = state.get_buffer(runtime_ptr->sdf_output_buffer_index);
+
+	FixedArray<float, SDF_BATCH_SIZE> x;
+	FixedArray<float, SDF_BATCH_SIZE> y;
+	FixedArray<float, SDF_BATCH_SIZE> z;
+	FixedArray<float, SDF_BATCH_SIZE> sdf;
+	fill(sdf, 0.f);
+
+	QueryInputs<Span<const float>> inputs(
+			*runtime_ptr, to_span_const(x), to_span_const(y), to_span_const(z), to_span_const(sdf)
+	);
+
+	for (unsigned int begin = 0; begin < positions.size(); begin += SDF_BATCH_SIZE) {
+		const unsigned int count = math::min(SDF_BATCH_SIZE, static_cast<unsigned int>(positions.size() - begin));
+
+		for (unsigned int i = 0; i < SDF_BATCH_SIZE; ++i) {
+			// The last batch may not be full, fill it up with its last position
+			const Vector3f pos = positions[begin + math::min(i, count - 1)];
+			x[i] = pos.x;
+			y[i] = pos.y;
+			z[i] = pos.z;
+		}
+
+		runtime.generate_set(state, inputs.get(), false, &runtime_ptr->sdf_execution_map);
+
+		for (unsigned int i = 0; i < count; ++i) {
+			out_sdf[begin + i] = sdf_buffer.data[i];
+		}
+	}
+}
+
 math::Interval get_range(const Span<const float> values) {
 	float minv = values[0];
 	float maxv = minv;
@@ -1917,6 +2297,7 @@ math::Interval VoxelGeneratorGraph::debug_analyze_range(
 
 	// Note, buffer size is irrelevant here, because range analysis doesn't use buffers
 	runtime.prepare_state(cache.state, 1, false);
+	cache.state.set_use_affine_range_analysis(_use_affine_range_analysis);
 	runtime.analyze_range(cache.state, query_inputs.get());
 	if (optimize_execution_map) {
 		runtime.generate_optimized_execution_map(cache.state, cache.optimized_execution_map, true);
@@ -2125,6 +2506,33 @@ float VoxelGeneratorGraph::debug_measure_microseconds_per_voxel(
 	return us;
 }
 
+bool VoxelGeneratorGraph::get_node_sampling_stats(
+		StdVector<pg::NodeSamplingProfiler::OperationStats> &out_stats
+) const {
+	std::shared_ptr<const Runtime> runtime_ptr;
+	{
+		RWLockRead rlock(_runtime_lock);
+		runtime_ptr = _runtime;
+	}
+	if (runtime_ptr == nullptr) {
+		return false;
+	}
+	const pg::NodeSamplingProfiler *profiler = runtime_ptr->runtime.get_sampling_profiler();
+	ZN_ASSERT_RETURN_V(profiler != nullptr, false);
+	profiler->get_stats(out_stats);
+	return true;
+}
+
+void VoxelGeneratorGraph::clear_node_sampling_stats() {
+	RWLockRead rlock(_runtime_lock);
+	if (_runtime == nullptr) {
+		return;
+	}
+	pg::NodeSamplingProfiler *profiler = _runtime->runtime.get_sampling_profiler();
+	ZN_ASSERT_RETURN(profiler != nullptr);
+	profiler->clear_stats();
+}
+
 // This may be used as template when creating new graphs
 void VoxelGeneratorGraph::load_plane_preset() {
 	using namespace pg;
@@ -2229,6 +2637,22 @@ float VoxelGeneratorGraph::_b_generate_single(Vector3 pos) {
 	return generate_single(math::floor_to_int(pos), VoxelBuffer::CHANNEL_SDF).f;
 }
 
+float VoxelGeneratorGraph::_b_generate_sdf_single(Vector3 position) {
+	return generate_sdf_single(to_vec3f(position));
+}
+
+PackedFloat32Array VoxelGeneratorGraph::_b_generate_sdf_batch(PackedVector3Array positions) {
+	StdVector<Vector3f> positions_f;
+	positions_f.resize(positions.size());
+	for (int i = 0; i < positions.size(); ++i) {
+		positions_f[i] = to_vec3f(positions[i]);
+	}
+	PackedFloat32Array sdf;
+	sdf.resize(positions.size());
+	generate_sdf_batch(to_span(positions_f), Span<float>(sdf.ptrw(), sdf.size()));
+	return sdf;
+}
+
 Vector2 VoxelGeneratorGraph::_b_debug_analyze_range(Vector3 min_pos, Vector3 max_pos) const {
 	ERR_FAIL_COND_V(min_pos.x > max_pos.x, Vector2());
 	ERR_FAIL_COND_V(min_pos.y > max_pos.y, Vector2());
@@ -2241,7 +2665,15 @@ Dictionary VoxelGeneratorGraph::_b_compile() {
 	pg::CompilationResult res = compile(false);
 	Dictionary d;
 	d["success"] = res.success;
-	if (!res.success) {
+	if (res.success) {
+		std::shared_ptr<const Runtime> runtime_ptr;
+		{
+			RWLockRead rlock(_runtime_lock);
+			runtime_ptr = _runtime;
+		}
+		ZN_ASSERT_RETURN_V(runtime_ptr != nullptr, d);
+		d["scratch_bytes_per_value"] = runtime_ptr->runtime.get_scratch_bytes_per_value();
+	} else {
 		d["message"] = res.message;
 		d["node_id"] = res.node_id;
 	}
@@ -2252,6 +2684,35 @@ float VoxelGeneratorGraph::_b_debug_measure_microseconds_per_voxel(bool singular
 	return debug_measure_microseconds_per_voxel(singular, nullptr);
 }
 
+Array VoxelGeneratorGraph::_b_get_node_sampling_stats() const {
+	StdVector<pg::NodeSamplingProfiler::OperationStats> stats;
+	Array result;
+	if (!get_node_sampling_stats(stats)) {
+		return result;
+	}
+	const pg::NodeTypeDB &type_db = pg::NodeTypeDB::get_singleton();
+	result.resize(stats.size());
+	for (unsigned int i = 0; i < stats.size(); ++i) {
+		const pg::NodeSamplingProfiler::OperationStats &op_stats = stats[i];
+
+		PackedInt64Array histogram;
+		histogram.resize(op_stats.histogram.size());
+		for (unsigned int bucket_index = 0; bucket_index < op_stats.histogram.size(); ++bucket_index) {
+			histogram.set(bucket_index, op_stats.histogram[bucket_index]);
+		}
+
+		Dictionary d;
+		d["node_id"] = op_stats.node_id;
+		d["node_type"] = type_db.get_type(op_stats.type_id).name;
+		d["sample_count"] = op_stats.sample_count;
+		d["total_nanoseconds"] = op_stats.total_nanoseconds;
+		d["total_values"] = op_stats.total_values;
+		d["histogram"] = histogram;
+		result[i] = d;
+	}
+	return result;
+}
+
 void VoxelGeneratorGraph::_on_subresource_changed() {
 	emit_changed();
 }
@@ -2291,15 +2752,35 @@ void VoxelGeneratorGraph::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_debug_clipped_blocks", "enabled"), &Self::set_debug_clipped_blocks);
 	ClassDB::bind_method(D_METHOD("is_debug_clipped_blocks"), &Self::is_debug_clipped_blocks);
 
+	ClassDB::bind_method(D_METHOD("set_use_adaptive_subdivision", "use"), &Self::set_use_adaptive_subdivision);
+	ClassDB::bind_method(D_METHOD("is_using_adaptive_subdivision"), &Self::is_using_adaptive_subdivision);
+
+	ClassDB::bind_method(D_METHOD("set_use_affine_range_analysis", "use"), &Self::set_use_affine_range_analysis);
+	ClassDB::bind_method(D_METHOD("is_using_affine_range_analysis"), &Self::is_using_affine_range_analysis);
+
 	ClassDB::bind_method(D_METHOD("set_use_xz_caching", "enabled"), &Self::set_use_xz_caching);
 	ClassDB::bind_method(D_METHOD("is_using_xz_caching"), &Self::is_using_xz_caching);
 
+	ClassDB::bind_method(D_METHOD("set_xz_cache_max_memory_mb", "mb"), &Self::set_xz_cache_max_memory_mb);
+	ClassDB::bind_method(D_METHOD("get_xz_cache_max_memory_mb"), &Self::get_xz_cache_max_memory_mb);
+
+	ClassDB::bind_method(D_METHOD("set_disk_cache_directory", "path"), &Self::set_disk_cache_directory);
+	ClassDB::bind_method(D_METHOD("get_disk_cache_directory"), &Self::get_disk_cache_directory);
+
+	ClassDB::bind_method(D_METHOD("set_disk_cache_max_size_mb", "mb"), &Self::set_disk_cache_max_size_mb);
+	ClassDB::bind_method(D_METHOD("get_disk_cache_max_size_mb"), &Self::get_disk_cache_max_size_mb);
+
+	ClassDB::bind_method(D_METHOD("set_node_sampling_interval", "interval"), &Self::set_node_sampling_interval);
+	ClassDB::bind_method(D_METHOD("get_node_sampling_interval"), &Self::get_node_sampling_interval);
+
 	ClassDB::bind_method(D_METHOD("set_texture_mode", "mode"), &Self::set_texture_mode);
 	ClassDB::bind_method(D_METHOD("get_texture_mode"), &Self::get_texture_mode);
 
 	ClassDB::bind_method(D_METHOD("compile"), &Self::_b_compile);
 
 	// ClassDB::bind_method(D_METHOD("generate_single"), &Self::_b_generate_single);
+	ClassDB::bind_method(D_METHOD("generate_sdf_single", "position"), &Self::_b_generate_sdf_single);
+	ClassDB::bind_method(D_METHOD("generate_sdf_batch", "positions"), &Self::_b_generate_sdf_batch);
 	ClassDB::bind_method(D_METHOD("debug_analyze_range", "min_pos", "max_pos"), &Self::_b_debug_analyze_range);
 
 	ClassDB::bind_method(
@@ -2315,6 +2796,9 @@ void VoxelGeneratorGraph::_bind_methods() {
 			&Self::_b_debug_measure_microseconds_per_voxel
 	);
 
+	ClassDB::bind_method(D_METHOD("get_node_sampling_stats"), &Self::_b_get_node_sampling_stats);
+	ClassDB::bind_method(D_METHOD("clear_node_sampling_stats"), &Self::clear_node_sampling_stats);
+
 	// Still present here for compatibility
 	ClassDB::bind_method(D_METHOD("_set_graph_data", "data"), &Self::load_graph_from_variant_data);
 	ClassDB::bind_method(D_METHOD("_get_graph_data"), &Self::get_graph_as_variant_data);
@@ -2353,7 +2837,37 @@ void VoxelGeneratorGraph::_bind_methods() {
 	);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_subdivision"), "set_use_subdivision", "is_using_subdivision");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "subdivision_size"), "set_subdivision_size", "get_subdivision_size");
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "use_adaptive_subdivision"),
+			"set_use_adaptive_subdivision",
+			"is_using_adaptive_subdivision"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "use_affine_range_analysis"),
+			"set_use_affine_range_analysis",
+			"is_using_affine_range_analysis"
+	);
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_xz_caching"), "set_use_xz_caching", "is_using_xz_caching");
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "xz_cache_max_memory_mb", PROPERTY_HINT_RANGE, "0,1024,1"),
+			"set_xz_cache_max_memory_mb",
+			"get_xz_cache_max_memory_mb"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::STRING, "disk_cache_directory", PROPERTY_HINT_DIR),
+			"set_disk_cache_directory",
+			"get_disk_cache_directory"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "disk_cache_max_size_mb", PROPERTY_HINT_RANGE, "0,65536,1"),
+			"set_disk_cache_max_size_mb",
+			"get_disk_cache_max_size_mb"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "node_sampling_interval", PROPERTY_HINT_RANGE, "0,1000000,1"),
+			"set_node_sampling_interval",
+			"get_node_sampling_interval"
+	);
 	ADD_PROPERTY(
 			PropertyInfo(Variant::BOOL, "debug_block_clipping"), "set_debug_clipped_blocks", "is_debug_clipped_blocks"
 	);
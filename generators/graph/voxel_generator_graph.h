@@ -11,10 +11,13 @@
 #include "../../util/math/vector3f.h"
 #include "../../util/math/vector3i.h"
 #include "../../util/thread/rw_lock.h"
+#include "../generated_block_disk_cache.h"
 #include "../voxel_generator.h"
+#include "node_sampling_profiler.h"
 #include "program_graph.h"
 #include "voxel_graph_function.h"
 #include "voxel_graph_runtime.h"
+#include "xz_cache.h"
 
 #include <memory>
 
@@ -61,12 +64,30 @@ public:
 	void set_subdivision_size(int size);
 	int get_subdivision_size() const;
 
+	void set_use_adaptive_subdivision(bool use);
+	bool is_using_adaptive_subdivision() const;
+
+	void set_use_affine_range_analysis(bool use);
+	bool is_using_affine_range_analysis() const;
+
 	void set_debug_clipped_blocks(bool enabled);
 	bool is_debug_clipped_blocks() const;
 
 	void set_use_xz_caching(bool enabled);
 	bool is_using_xz_caching() const;
 
+	void set_xz_cache_max_memory_mb(int mb);
+	int get_xz_cache_max_memory_mb() const;
+
+	void set_disk_cache_directory(String path);
+	String get_disk_cache_directory() const;
+
+	void set_disk_cache_max_size_mb(int mb);
+	int get_disk_cache_max_size_mb() const;
+
+	void set_node_sampling_interval(int interval);
+	int get_node_sampling_interval() const;
+
 	void set_texture_mode(const TextureMode mode);
 	TextureMode get_texture_mode() const;
 
@@ -97,6 +118,19 @@ public:
 
 	// Ref<Resource> duplicate(bool p_subresources) const ZN_OVERRIDE_UNLESS_GODOT_EXTENSION;
 
+	// Gameplay queries
+
+	// How many positions `generate_sdf_batch` evaluates with each run of the program
+	static const unsigned int SDF_BATCH_SIZE = 8;
+
+	// Gets the SDF at a single position. Meant for frequent gameplay queries (spawn points, pathfinding, AI...): only
+	// operations the SDF output depends on are run, using a state prepared once per thread.
+	float generate_sdf_single(Vector3f position);
+
+	// Gets the SDF at multiple positions, processing them `SDF_BATCH_SIZE` at a time. This is faster than as many
+	// single queries, since each operation then runs once for several values.
+	void generate_sdf_batch(Span<const Vector3f> positions, Span<float> out_sdf);
+
 	// Utility
 
 	void bake_sphere_bumpmap(Ref<Image> im, float ref_radius, float min_height, float max_height);
@@ -146,6 +180,11 @@ public:
 
 	float debug_measure_microseconds_per_voxel(bool singular, StdVector<NodeProfilingInfo> *node_profiling_info);
 
+	// Gets what the sampling profiler measured since the graph was compiled or since stats were cleared.
+	// Returns false if the graph is not compiled.
+	bool get_node_sampling_stats(StdVector<pg::NodeSamplingProfiler::OperationStats> &out_stats) const;
+	void clear_node_sampling_stats();
+
 	void debug_load_waves_preset();
 
 	// Editor
@@ -157,9 +196,12 @@ public:
 private:
 	void _on_subresource_changed();
 	float _b_generate_single(Vector3 pos);
+	float _b_generate_sdf_single(Vector3 position);
+	PackedFloat32Array _b_generate_sdf_batch(PackedVector3Array positions);
 	Vector2 _b_debug_analyze_range(Vector3 min_pos, Vector3 max_pos) const;
 	Dictionary _b_compile();
 	float _b_debug_measure_microseconds_per_voxel(bool singular);
+	Array _b_get_node_sampling_stats() const;
 #ifdef TOOLS_ENABLED
 	// This exists because some custom editors will edit an internal object instead of the resource itself
 	// (here the "main function" object). And because Godot determines wether or not a resource should be saved based on
@@ -201,6 +243,15 @@ private:
 	// Blocks size must be a multiple of the subdivision size.
 	bool _use_subdivision = true;
 	int _subdivision_size = 16;
+	// When enabled, sections are recursively split in octants if range analysis finds that parts of them can be
+	// clipped, or can run fewer nodes. Most sections crossed by the surface only have it in a small part of their
+	// volume.
+	// Off by default, because the benefit has not been measured on real terrains yet.
+	bool _use_adaptive_subdivision = false;
+	// When enabled, range analysis also uses affine arithmetic, which keeps track of correlations between values
+	// computed from the same coordinates. Ranges can be much tighter, so more areas can be clipped or run fewer
+	// nodes, but the analysis itself is more expensive.
+	bool _use_affine_range_analysis = false;
 	// When enabled, the generator will attempt to optimize out nodes that don't need to run in specific areas,
 	// if their output range is considered to not affect the final result.
 	bool _use_optimized_execution_map = true;
@@ -208,6 +259,15 @@ private:
 	// This prevents recalculating values that would otherwise be the same on each slice.
 	// It helps a lot when part of the graph is generating a heightmap for example.
 	bool _use_xz_caching = true;
+	// Values computed from X and Z only are also kept after a block is generated, up to this amount of memory, so
+	// blocks generated above or below can re-use them. Shared by all threads. 0 turns it off.
+	int _xz_cache_max_memory_mb = 16;
+	// When a directory is set, generated blocks are also saved there, so they can be loaded instead of being generated
+	// again, including after a restart. They are invalidated when the graph or settings change.
+	int _disk_cache_max_size_mb = 512;
+	// When above 0, one out of this many runs of the graph measures how long each node takes. This is cheap enough to
+	// be used in release builds, to find which nodes are the most expensive under real conditions.
+	int _node_sampling_interval = 0;
 	// If true, inverts clipped blocks so they create visual artifacts making the clipped area visible.
 	bool _debug_clipped_blocks = false;
 	TextureMode _texture_mode = TEXTURE_MODE_MIXEL4;
@@ -241,6 +301,13 @@ private:
 		// List of indices to feed queries. The order doesn't matter, can be different from `weight_outputs`.
 		FixedArray<unsigned int, 16> weight_output_indices;
 		unsigned int weight_outputs_count = 0;
+
+		// Only runs operations the SDF output depends on
+		pg::Runtime::ExecutionMap sdf_execution_map;
+
+		uint64_t program_hash = 0;
+		// Unlike `program_hash`, remains the same across runs
+		uint64_t graph_hash = 0;
 	};
 
 	// Helper to setup inputs for runtime queries
@@ -270,9 +337,40 @@ private:
 		}
 	};
 
+	// Gets a hash identifying blocks this generator produces, which changes when the graph or settings change
+	uint64_t get_disk_cache_hash(const Runtime &runtime_wrapper) const;
+
+	// Runs range analysis on a box of voxels in world space, `gmax` being excluded
+	static void analyze_section_range(
+			pg::Runtime::State &state,
+			const Runtime &runtime_wrapper,
+			const Vector3i gmin,
+			const Vector3i gmax,
+			const math::Interval sdf_input_range
+	);
+
 	std::shared_ptr<Runtime> _runtime = nullptr;
 	RWLock _runtime_lock;
 
+	pg::XZCache _xz_cache;
+	GeneratedBlockDiskCache _disk_cache;
+
+	// State dedicated to point queries. Preparing a state costs about as much as running a small query, so unlike
+	// `Cache::state`, it is only prepared again when it gets used with a different program.
+	struct PointQueryState {
+		pg::Runtime::State state;
+		std::weak_ptr<const Runtime> runtime;
+	};
+
+	static pg::Runtime::State &get_point_query_state(
+			PointQueryState &pqs,
+			const std::shared_ptr<const Runtime> &runtime_ptr,
+			unsigned int values_count
+	);
+
+	// Expects the runtime to have an SDF output
+	static float query_sdf_single(const std::shared_ptr<const Runtime> &runtime_ptr, Vector3f position);
+
 	struct Cache {
 		StdVector<float> x_cache;
 		StdVector<float> y_cache;
@@ -282,6 +380,12 @@ private:
 		// TODO Use the runtime and state from `VoxelGraphFunction`
 		pg::Runtime::State state;
 		pg::Runtime::ExecutionMap optimized_execution_map;
+		// Range analysis results of sections waiting in the stack of adaptive subdivision, indexed by stack position
+		StdVector<math::Interval> section_ranges;
+		// Range analysis results of the section being split, while its octants are analyzed
+		StdVector<math::Interval> parent_section_ranges;
+		PointQueryState single_point_query;
+		PointQueryState batch_point_query;
 	};
 
 	static Cache &get_tls_cache();
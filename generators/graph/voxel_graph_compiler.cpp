@@ -1,15 +1,20 @@
 #include "voxel_graph_compiler.h"
 #include "../../util/containers/container_funcs.h"
+#include "../../util/containers/fixed_array.h"
 #include "../../util/containers/std_unordered_map.h"
 #include "../../util/containers/std_unordered_set.h"
 #include "../../util/godot/core/array.h" // for `varray` in GDExtension builds
 #include "../../util/macros.h"
+#include "../../util/math/funcs.h"
+#include "../../util/memory/memory.h"
 #include "../../util/profiling.h"
 #include "../../util/string/expression_parser.h"
 #include "../../util/string/format.h"
+#include "node_sampling_profiler.h"
 #include "node_type_db.h"
 #include "voxel_graph_function.h"
 
+#include <algorithm>
 #include <limits>
 
 namespace zylann::voxel::pg {
@@ -1423,7 +1428,12 @@ CompilationResult expand_graph(
 	return expr_expand_result;
 }
 
-CompilationResult Runtime::compile(const VoxelGraphFunction &function, bool debug) {
+namespace {
+// Defined further down, next to other functions working with the execution order
+unsigned int fuse_elementwise_nodes(ProgramGraph &graph, const NodeTypeDB &type_db, GraphRemappingInfo &remap_info);
+} // namespace
+
+CompilationResult Runtime::compile(const VoxelGraphFunction &function, bool debug, bool enable_fusion) {
 	ZN_PROFILE_SCOPE();
 
 	const NodeTypeDB &type_db = NodeTypeDB::get_singleton();
@@ -1440,6 +1450,13 @@ CompilationResult Runtime::compile(const VoxelGraphFunction &function, bool debu
 		return expand_result;
 	}
 
+	const unsigned int expanded_nodes_count = expanded_graph.get_nodes_count();
+
+	unsigned int fused_nodes_count = 0;
+	if (enable_fusion && !debug) {
+		fused_nodes_count = fuse_elementwise_nodes(expanded_graph, type_db, remap_info);
+	}
+
 	CompilationResult result = compile_preprocessed_graph(
 			_program, expanded_graph, input_defs.size(), to_span(input_node_ids), debug, type_db
 	);
@@ -1463,24 +1480,41 @@ CompilationResult Runtime::compile(const VoxelGraphFunction &function, bool debu
 		}
 	}
 
+	if (result.success) {
+		const ExecutionMap &execution_map = _program.default_execution_map;
+		ZN_ASSERT(execution_map.operations.size() == execution_map.debug_nodes.size());
+		StdVector<NodeSamplingProfiler::OperationInfo> profiled_operations;
+		profiled_operations.reserve(execution_map.operations.size());
+		for (unsigned int i = 0; i < execution_map.operations.size(); ++i) {
+			NodeSamplingProfiler::OperationInfo op;
+			op.address = execution_map.operations[i].address;
+			op.type_id = _program.operations[op.address];
+			op.node_id = execution_map.debug_nodes[i];
+			profiled_operations.push_back(op);
+		}
+		_sampling_profiler = make_shared_instance<NodeSamplingProfiler>(
+				to_span(profiled_operations), _program.operations.size()
+		);
+	}
+
 	// debug_print_operations();
 
-	result.expanded_nodes_count = expanded_graph.get_nodes_count();
+	result.expanded_nodes_count = expanded_nodes_count;
+	result.fused_nodes_count = fused_nodes_count;
 	return result;
 }
 
 namespace {
 
-// Optimize parts of the graph that only depend on inputs tagged as "outer group",
-// so they can be moved in the outer loop when blocks are generated, running less times.
-// Moves them all at the beginning.
+// Finds nodes that only depend on inputs tagged as "outer group". When blocks are generated, they can run in the outer
+// loop, less times.
 // `order` is a previously computed order of execution of each node.
-uint32_t move_outer_group_operations_up(StdVector<uint32_t> &order, const ProgramGraph &graph) {
-	ZN_PROFILE_SCOPE();
+void find_outer_group_nodes(
+		Span<const uint32_t> order,
+		const ProgramGraph &graph,
+		StdUnorderedSet<uint32_t> &outer_group_node_ids
+) {
 	StdVector<uint32_t> immediate_deps;
-	StdUnorderedSet<uint32_t> outer_group_node_ids;
-	StdVector<uint32_t> order_outer_group;
-	StdVector<uint32_t> order_inner_group;
 
 	for (const uint32_t node_id : order) {
 		const ProgramGraph::Node &node = graph.get_node(node_id);
@@ -1504,8 +1538,26 @@ uint32_t move_outer_group_operations_up(StdVector<uint32_t> &order, const Progra
 		}
 
 		if (is_outer_group) {
-			order_outer_group.push_back(node_id);
 			outer_group_node_ids.insert(node_id);
+		}
+	}
+}
+
+// Optimize parts of the graph that only depend on inputs tagged as "outer group",
+// so they can be moved in the outer loop when blocks are generated, running less times.
+// Moves them all at the beginning.
+// `order` is a previously computed order of execution of each node.
+uint32_t move_outer_group_operations_up(StdVector<uint32_t> &order, const ProgramGraph &graph) {
+	ZN_PROFILE_SCOPE();
+	StdUnorderedSet<uint32_t> outer_group_node_ids;
+	StdVector<uint32_t> order_outer_group;
+	StdVector<uint32_t> order_inner_group;
+
+	find_outer_group_nodes(to_span(order), graph, outer_group_node_ids);
+
+	for (const uint32_t node_id : order) {
+		if (outer_group_node_ids.find(node_id) != outer_group_node_ids.end()) {
+			order_outer_group.push_back(node_id);
 		} else {
 			order_inner_group.push_back(node_id);
 		}
@@ -1525,6 +1577,97 @@ uint32_t move_outer_group_operations_up(StdVector<uint32_t> &order, const Progra
 	return inner_group_start_index;
 }
 
+// Finds dependencies of the given nodes in an order which reduces how many results have to be kept at the same time,
+// so the compiler can share buffer datas between more operations. When a node has multiple dependencies, the one
+// needing the most buffers runs first, so only its result is kept while the others are computed (like Sethi-Ullman
+// numbering). The number of buffers needed by each node is an estimate: it is exact for trees, but results shared by
+// multiple nodes are counted for each of them.
+void find_dependencies_reducing_live_buffers(
+		const ProgramGraph &graph,
+		Span<const uint32_t> terminal_nodes,
+		StdVector<uint32_t> &out_order
+) {
+	ZN_PROFILE_SCOPE();
+
+	// Any valid order allows to estimate needs of dependencies before the nodes using them
+	StdVector<uint32_t> default_order;
+	graph.find_dependencies(terminal_nodes, default_order);
+
+	StdUnorderedMap<uint32_t, uint32_t> buffer_needs;
+	StdVector<uint32_t> dependency_needs;
+
+	for (const uint32_t node_id : default_order) {
+		const ProgramGraph::Node &node = graph.get_node(node_id);
+
+		// Nodes without inputs are inputs or constants, which don't use buffer datas from the pool
+		uint32_t need = 0;
+
+		if (node.inputs.size() > 0) {
+			dependency_needs.clear();
+			for (const ProgramGraph::Port &port : node.inputs) {
+				for (const ProgramGraph::PortLocation src : port.connections) {
+					auto it = buffer_needs.find(src.node_id);
+					ZN_ASSERT_CONTINUE(it != buffer_needs.end());
+					if (it->second > 0) {
+						dependency_needs.push_back(it->second);
+					}
+				}
+			}
+			std::sort(dependency_needs.begin(), dependency_needs.end(), [](uint32_t a, uint32_t b) { return a > b; });
+
+			// Results of dependencies computed first are kept while the next ones are computed
+			for (unsigned int i = 0; i < dependency_needs.size(); ++i) {
+				need = math::max(need, dependency_needs[i] + i);
+			}
+			// Outputs are allocated while all inputs are still alive
+			need = math::max(need, static_cast<uint32_t>(dependency_needs.size() + node.outputs.size()));
+		}
+
+		buffer_needs.insert({ node_id, need });
+	}
+
+	StdUnorderedSet<uint32_t> visited_nodes;
+	StdVector<uint32_t> nodes_to_process;
+	nodes_to_process.resize(terminal_nodes.size());
+	terminal_nodes.copy_to(to_span(nodes_to_process));
+
+	while (nodes_to_process.size() > 0) {
+		const ProgramGraph::Node &node = graph.get_node(nodes_to_process.back());
+
+		// Pick the non-visited dependency needing the most buffers. The first one wins ties, which gives the same
+		// order as `find_dependencies` when needs are equal.
+		uint32_t next_node_id = ProgramGraph::NULL_ID;
+		uint32_t next_node_need = 0;
+		for (const ProgramGraph::Port &port : node.inputs) {
+			for (const ProgramGraph::PortLocation src : port.connections) {
+				if (visited_nodes.find(src.node_id) != visited_nodes.end()) {
+					continue;
+				}
+				const uint32_t need = buffer_needs[src.node_id];
+				if (next_node_id == ProgramGraph::NULL_ID || need > next_node_need) {
+					next_node_id = src.node_id;
+					next_node_need = need;
+				}
+			}
+		}
+
+		if (next_node_id != ProgramGraph::NULL_ID) {
+			nodes_to_process.push_back(next_node_id);
+			continue;
+		}
+
+		// No dependencies left to visit, process node
+		if (visited_nodes.insert(node.id).second) {
+			out_order.push_back(node.id);
+		}
+		nodes_to_process.pop_back();
+	}
+
+#if DEBUG_ENABLED
+	ZN_ASSERT(out_order.size() == default_order.size());
+#endif
+}
+
 void compute_node_execution_order(
 		StdVector<uint32_t> &order,
 		const ProgramGraph &graph,
@@ -1548,9 +1691,271 @@ void compute_node_execution_order(
 			const NodeType &type = type_db.get_type(node.type_id);
 			return type.debug_only;
 		});
+
+		find_dependencies_reducing_live_buffers(graph, to_span(terminal_nodes), order);
+
+	} else {
+		// Keep a simple order when debugging, buffers are not shared anyways
+		graph.find_dependencies(to_span(terminal_nodes), order);
 	}
+}
+
+// Gets sources from outside of a group of nodes, and how many of their inputs are constants.
+void get_fusion_group_inputs(
+		const ProgramGraph &graph,
+		const StdVector<uint32_t> &member_ids,
+		StdVector<ProgramGraph::PortLocation> &external_sources,
+		unsigned int &constant_count
+) {
+	external_sources.clear();
+	constant_count = 0;
+
+	for (const uint32_t node_id : member_ids) {
+		const ProgramGraph::Node &node = graph.get_node(node_id);
 
-	graph.find_dependencies(to_span(terminal_nodes), order);
+		for (const ProgramGraph::Port &port : node.inputs) {
+			if (port.connections.size() == 0) {
+				++constant_count;
+				continue;
+			}
+			const ProgramGraph::PortLocation src = port.connections[0];
+			size_t index;
+			if (!find(member_ids, src.node_id, index) && !find(external_sources, src, index)) {
+				external_sources.push_back(src);
+			}
+		}
+	}
+}
+
+// Replaces trees of elementwise nodes with fused nodes. Those run their operations one small tile of values at a time,
+// so intermediate results remain in cache instead of going through full buffers. See `FusedParams`.
+// Returns how many fused nodes were created.
+unsigned int fuse_elementwise_nodes(ProgramGraph &graph, const NodeTypeDB &type_db, GraphRemappingInfo &remap_info) {
+	ZN_PROFILE_SCOPE();
+
+	StdVector<uint32_t> order;
+	compute_node_execution_order(order, graph, false, type_db);
+
+	StdUnorderedMap<uint32_t, uint32_t> node_id_to_order_index;
+	for (uint32_t i = 0; i < order.size(); ++i) {
+		node_id_to_order_index.insert({ order[i], i });
+	}
+
+	// Nodes of the outer group must not be merged with nodes of the inner group, otherwise they would no longer run
+	// less times
+	StdUnorderedSet<uint32_t> outer_group_node_ids;
+	find_outer_group_nodes(to_span(order), graph, outer_group_node_ids);
+
+	StdUnorderedSet<uint32_t> visited_node_ids;
+	StdVector<uint32_t> member_ids;
+	StdVector<ProgramGraph::PortLocation> external_sources;
+	StdVector<Variant> params;
+	unsigned int fused_count = 0;
+
+	// Go from the end, so groups grow from the root of their tree
+	for (auto order_it = order.rbegin(); order_it != order.rend(); ++order_it) {
+		const uint32_t root_id = *order_it;
+
+		if (visited_node_ids.find(root_id) != visited_node_ids.end()) {
+			continue;
+		}
+		const ProgramGraph::Node &root = graph.get_node(root_id);
+		if (!FusedParams::is_supported_type(root.type_id)) {
+			continue;
+		}
+		visited_node_ids.insert(root_id);
+
+		const bool is_outer_group = outer_group_node_ids.find(root_id) != outer_group_node_ids.end();
+
+		member_ids.clear();
+		member_ids.push_back(root_id);
+
+		// Add nodes whose result is only used by the group, as long as it fits
+		for (unsigned int member_index = 0; member_index < member_ids.size(); ++member_index) {
+			const ProgramGraph::Node &member = graph.get_node(member_ids[member_index]);
+
+			for (const ProgramGraph::Port &port : member.inputs) {
+				if (member_ids.size() == FusedParams::MAX_OPERATIONS) {
+					break;
+				}
+				if (port.connections.size() == 0) {
+					continue;
+				}
+				const uint32_t src_node_id = port.connections[0].node_id;
+
+				size_t index;
+				if (find(member_ids, src_node_id, index) ||
+					visited_node_ids.find(src_node_id) != visited_node_ids.end()) {
+					continue;
+				}
+
+				const ProgramGraph::Node &src_node = graph.get_node(src_node_id);
+				if (!FusedParams::is_supported_type(src_node.type_id)) {
+					continue;
+				}
+				if ((outer_group_node_ids.find(src_node_id) != outer_group_node_ids.end()) != is_outer_group) {
+					continue;
+				}
+
+				bool used_outside = false;
+				for (const ProgramGraph::PortLocation dst : src_node.outputs[0].connections) {
+					if (dst.node_id != member.id) {
+						used_outside = true;
+						break;
+					}
+				}
+				if (used_outside) {
+					continue;
+				}
+
+				member_ids.push_back(src_node_id);
+
+				unsigned int constant_count;
+				get_fusion_group_inputs(graph, member_ids, external_sources, constant_count);
+				if (external_sources.size() > FusedParams::MAX_INPUTS || constant_count > FusedParams::MAX_CONSTANTS) {
+					member_ids.pop_back();
+				}
+			}
+		}
+
+		if (member_ids.size() < 2) {
+			// Nothing to gain
+			continue;
+		}
+
+		for (const uint32_t node_id : member_ids) {
+			visited_node_ids.insert(node_id);
+		}
+
+		// Operations must run in execution order. The root comes last, its result is the output.
+		std::sort(member_ids.begin(), member_ids.end(), [&node_id_to_order_index](uint32_t a, uint32_t b) {
+			return node_id_to_order_index[a] < node_id_to_order_index[b];
+		});
+		ZN_ASSERT(member_ids.back() == root_id);
+
+		unsigned int constant_count;
+		get_fusion_group_inputs(graph, member_ids, external_sources, constant_count);
+
+		const unsigned int constants_begin = external_sources.size();
+		const unsigned int operations_begin = constants_begin + constant_count;
+
+		// Encode params, see `FusedParams`
+
+		params.clear();
+		params.push_back(float(external_sources.size()));
+		params.push_back(float(constant_count));
+		params.push_back(float(member_ids.size()));
+
+		for (const uint32_t node_id : member_ids) {
+			const ProgramGraph::Node &node = graph.get_node(node_id);
+			for (unsigned int input_index = 0; input_index < node.inputs.size(); ++input_index) {
+				if (node.inputs[input_index].connections.size() == 0) {
+					params.push_back(node.default_inputs[input_index].operator float());
+				}
+			}
+		}
+
+		unsigned int constant_index = 0;
+
+		for (const uint32_t node_id : member_ids) {
+			const ProgramGraph::Node &node = graph.get_node(node_id);
+			ZN_ASSERT(node.inputs.size() <= FusedParams::MAX_ARGS);
+
+			params.push_back(float(node.type_id));
+
+			for (unsigned int arg_index = 0; arg_index < FusedParams::MAX_ARGS; ++arg_index) {
+				unsigned int register_index = 0;
+
+				if (arg_index < node.inputs.size()) {
+					const ProgramGraph::Port &port = node.inputs[arg_index];
+
+					if (port.connections.size() == 0) {
+						register_index = constants_begin + constant_index;
+						++constant_index;
+
+					} else {
+						const ProgramGraph::PortLocation src = port.connections[0];
+						size_t index;
+						if (find(member_ids, src.node_id, index)) {
+							register_index = operations_begin + index;
+						} else {
+							const bool found = find(external_sources, src, index);
+							ZN_ASSERT(found);
+							register_index = index;
+						}
+					}
+				}
+
+				params.push_back(float(register_index));
+			}
+
+			FixedArray<float, FusedParams::MAX_OPERATION_PARAMS> op_params;
+			fill(op_params, 0.f);
+
+			switch (node.type_id) {
+				case VoxelGraphFunction::NODE_CLAMP_C:
+				case VoxelGraphFunction::NODE_SMOOTHSTEP:
+					op_params[0] = node.params[0].operator float();
+					op_params[1] = node.params[1].operator float();
+					break;
+
+				case VoxelGraphFunction::NODE_REMAP: {
+					// Remap can be reduced to a linear function
+					const math::LinearFuncParams lin = math::remap_intervals_to_linear_params(
+							node.params[0].operator float(),
+							node.params[1].operator float(),
+							node.params[2].operator float(),
+							node.params[3].operator float()
+					);
+					op_params[0] = lin.a;
+					op_params[1] = lin.b;
+				} break;
+
+				default:
+					break;
+			}
+
+			for (const float v : op_params) {
+				params.push_back(v);
+			}
+		}
+
+		ProgramGraph::Node &fused_node =
+				create_node(graph, type_db, static_cast<VoxelGraphFunction::NodeTypeID>(INTERNAL_NODE_FUSED));
+		fused_node.params = params;
+
+		for (unsigned int input_index = 0; input_index < external_sources.size(); ++input_index) {
+			graph.connect(external_sources[input_index], ProgramGraph::PortLocation{ fused_node.id, input_index });
+		}
+
+		// Users of the root now use the fused node
+		const StdVector<ProgramGraph::PortLocation> root_destinations = root.outputs[0].connections;
+		for (const ProgramGraph::PortLocation dst : root_destinations) {
+			graph.disconnect(ProgramGraph::PortLocation{ root_id, 0 }, dst);
+			graph.connect(ProgramGraph::PortLocation{ fused_node.id, 0 }, dst);
+		}
+
+		for (const uint32_t node_id : member_ids) {
+			if (node_id != root_id) {
+				// Results of other members no longer exist
+				for (PortRemap &remap : remap_info.user_to_expanded_ports) {
+					if (remap.expanded.node_id == node_id) {
+						remap.expanded = ProgramGraph::PortLocation{ ProgramGraph::NULL_ID, 0 };
+					}
+				}
+			}
+		}
+
+		add_remap(remap_info, root_id, fused_node.id, 1);
+
+		for (const uint32_t node_id : member_ids) {
+			graph.remove_node(node_id);
+		}
+
+		++fused_count;
+	}
+
+	return fused_count;
 }
 
 } // namespace
@@ -1729,16 +2134,12 @@ CompilationResult Runtime::compile_preprocessed_graph(
 
 		ZN_ASSERT(node.type_id <= std::numeric_limits<uint16_t>::max());
 
-		if (order_index == inner_group_start_index) {
-			program.default_execution_map.inner_group_start_index = program.default_execution_map.operations.size();
-		}
 		program.default_execution_map.operations.push_back(
 				ExecutionMap::OperationInfo{ uint16_t(operations.size()), 0 }
 		);
-		if (debug) {
-			// Will be remapped later if the node is an expanded one
-			program.default_execution_map.debug_nodes.push_back(node_id);
-		}
+		// Will be remapped later if the node is an expanded one.
+		// Always stored for the default execution map, so operations can be profiled without a debug compilation.
+		program.default_execution_map.debug_nodes.push_back(node_id);
 
 		operations.push_back(node.type_id);
 
@@ -1872,6 +2273,19 @@ CompilationResult Runtime::compile_preprocessed_graph(
 #endif
 	}
 
+	if (inner_group_start_index == order.size()) {
+		program.inner_group_start_op_index = operations.size();
+	}
+	// Inputs and constants don't produce operations, so the first node of the inner group might not have one
+	{
+		const StdVector<ExecutionMap::OperationInfo> &op_infos = program.default_execution_map.operations;
+		unsigned int i = 0;
+		while (i < op_infos.size() && op_infos[i].address < program.inner_group_start_op_index) {
+			++i;
+		}
+		program.default_execution_map.inner_group_start_index = i;
+	}
+
 	program.buffer_count = mem.next_address;
 
 	// Pin buffers from the outer group that are read by operations of the inner group.
@@ -1911,6 +2325,28 @@ CompilationResult Runtime::compile_preprocessed_graph(
 				src_buffer_spec.is_pinned = true;
 			}
 		}
+
+		// List buffers holding the results of the outer group, so they can be cached by users.
+		// Outputs are never re-used by other operations, so they keep their values too.
+		for (unsigned int order_index = 0; order_index < inner_group_start_index; ++order_index) {
+			const uint32_t node_id = order[order_index];
+			const ProgramGraph::Node &node = graph.get_node(node_id);
+			const NodeType &type = type_db.get_type(node.type_id);
+
+			for (unsigned int port_index = 0; port_index < node.outputs.size(); ++port_index) {
+				auto address_it = program.output_port_addresses.find(ProgramGraph::PortLocation{ node_id, port_index });
+				if (address_it == program.output_port_addresses.end()) {
+					continue;
+				}
+				const BufferSpec &bs = buffer_specs[address_it->second];
+				if (bs.is_binding || bs.is_constant) {
+					continue;
+				}
+				if (bs.is_pinned || type.category == pg::CATEGORY_OUTPUT) {
+					program.outer_group_buffer_addresses.push_back(bs.address);
+				}
+			}
+		}
 	}
 
 	// Assign buffer datas
@@ -2045,10 +2481,11 @@ CompilationResult Runtime::compile_preprocessed_graph(
 	}
 
 	ZN_PRINT_VERBOSE(
-			format("Compiled voxel graph. Program size: {}b, ports: {}, buffers: {}",
+			format("Compiled voxel graph. Program size: {}b, ports: {}, buffers: {}, scratch memory: {}b per value",
 				   program.operations.size() * sizeof(uint16_t),
 				   program.buffer_count,
-				   program.buffer_data_count)
+				   program.buffer_data_count,
+				   program.buffer_data_count * sizeof(float))
 	);
 
 	CompilationResult result;
@@ -53,6 +53,10 @@ public:
 		return _params[i];
 	}
 
+	size_t get_param_count() const {
+		return _params.size();
+	}
+
 	// Stores compile-time parameters the node will need. T must be a POD struct.
 	template <typename T>
 	void set_params(T params) {
@@ -132,6 +136,60 @@ private:
 
 typedef void (*CompileFunc)(CompileContext &);
 
+// Parameters of a fused operation. It evaluates a small tree of elementwise operations one tile of values at a time,
+// instead of writing every intermediate result to a full buffer.
+// Values are referenced with register indices: first come the inputs of the fused node, then constants, then the
+// result of each operation in order. The result of the last operation is the output.
+// In the expanded graph, the fused node stores them as a flat list of float params:
+// [input_count, constant_count, operation_count, constants..., then for each operation: type_id, args..., params...]
+struct FusedParams {
+	static const unsigned int MAX_INPUTS = 8;
+	static const unsigned int MAX_CONSTANTS = 8;
+	static const unsigned int MAX_OPERATIONS = 16;
+	static const unsigned int MAX_REGISTERS = MAX_INPUTS + MAX_CONSTANTS + MAX_OPERATIONS;
+	static const unsigned int MAX_ARGS = 3;
+	static const unsigned int MAX_OPERATION_PARAMS = 2;
+
+	struct Operation {
+		// Type of the node this operation comes from
+		uint16_t type_id;
+		uint8_t args[MAX_ARGS];
+		// Compile-time parameters of the node, when it has any
+		float params[MAX_OPERATION_PARAMS];
+	};
+
+	uint8_t input_count;
+	uint8_t constant_count;
+	uint8_t operation_count;
+	float constants[MAX_CONSTANTS];
+	Operation operations[MAX_OPERATIONS];
+
+	// Node types that can be part of a fused operation. They must have one output, compute each value only from
+	// values at the same index, and must not ignore inputs during range analysis.
+	static inline bool is_supported_type(uint32_t type_id) {
+		switch (type_id) {
+			case VoxelGraphFunction::NODE_ADD:
+			case VoxelGraphFunction::NODE_SUBTRACT:
+			case VoxelGraphFunction::NODE_MULTIPLY:
+			case VoxelGraphFunction::NODE_DIVIDE:
+			case VoxelGraphFunction::NODE_SIN:
+			case VoxelGraphFunction::NODE_FLOOR:
+			case VoxelGraphFunction::NODE_ABS:
+			case VoxelGraphFunction::NODE_SQRT:
+			case VoxelGraphFunction::NODE_FRACT:
+			case VoxelGraphFunction::NODE_MIN:
+			case VoxelGraphFunction::NODE_MAX:
+			case VoxelGraphFunction::NODE_CLAMP:
+			case VoxelGraphFunction::NODE_CLAMP_C:
+			case VoxelGraphFunction::NODE_REMAP:
+			case VoxelGraphFunction::NODE_SMOOTHSTEP:
+				return true;
+			default:
+				return false;
+		}
+	}
+};
+
 } // namespace zylann::voxel::pg
 
 #endif // VOXEL_GRAPH_COMPILER_H
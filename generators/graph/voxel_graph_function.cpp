@@ -801,6 +801,8 @@ void VoxelGraphFunction::get_configuration_warnings(PackedStringArray &out_warni
 	}
 }
 
+#endif
+
 uint64_t VoxelGraphFunction::get_output_graph_hash() const {
 	const NodeTypeDB &type_db = NodeTypeDB::get_singleton();
 	StdVector<uint32_t> terminal_nodes;
@@ -853,8 +855,6 @@ uint64_t VoxelGraphFunction::get_output_graph_hash() const {
 	return hash;
 }
 
-#endif
-
 void VoxelGraphFunction::find_dependencies(uint32_t node_id, StdVector<uint32_t> &out_dependencies) const {
 	_graph.find_dependencies(to_single_element_span(node_id), out_dependencies);
 }
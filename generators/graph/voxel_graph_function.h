@@ -214,16 +214,17 @@ public:
 
 	unsigned int get_nodes_count() const;
 
-	// Editor
-
-#ifdef TOOLS_ENABLED
-	void get_configuration_warnings(PackedStringArray &out_warnings) const;
-
 	// Gets a hash that attempts to only change if the output of the graph is different.
 	// This is computed from the editable graph data, not the compiled result.
 	// Note: this is not guaranteed to work when comparing two graphs. This was designed initially to detect changes.
+	// Unlike `pg::Runtime::get_program_hash`, it remains the same across runs as long as the graph doesn't change.
 	uint64_t get_output_graph_hash() const;
 
+	// Editor
+
+#ifdef TOOLS_ENABLED
+	void get_configuration_warnings(PackedStringArray &out_warnings) const;
+
 	bool can_load_default_graph() const {
 		return _can_load_default_graph;
 	}
@@ -1,6 +1,7 @@
 #include "voxel_graph_runtime.h"
 #include "../../util/containers/container_funcs.h"
 #include "../../util/godot/core/string.h"
+#include "../../util/hash_funcs.h"
 #include "../../util/io/log.h"
 #include "../../util/macros.h"
 #include "../../util/profiling.h"
@@ -8,9 +9,11 @@
 #ifdef TOOLS_ENABLED
 #include "../../util/profiling_clock.h"
 #endif
+#include "node_sampling_profiler.h"
 #include "node_type_db.h"
 #include "voxel_generator_graph.h"
 
+#include <cstring>
 #include <sstream>
 #include <unordered_set>
 
@@ -30,6 +33,7 @@ Runtime::~Runtime() {
 
 void Runtime::clear() {
 	_program.clear();
+	_sampling_profiler.reset();
 }
 
 namespace {
@@ -96,6 +100,7 @@ void Runtime::generate_optimized_execution_map(
 	const DependencyGraph &graph = program.dependency_graph;
 
 	execution_map.clear();
+	execution_map.uses_range_analysis = true;
 
 	// if (program.default_execution_map.size() == 0) {
 	// 	// Can't reduce more than this
@@ -264,6 +269,64 @@ void Runtime::generate_optimized_execution_map(
 	}
 }
 
+void Runtime::generate_pruned_execution_map(
+		ExecutionMap &execution_map,
+		Span<const unsigned int> required_outputs
+) const {
+	const Program &program = _program;
+	const DependencyGraph &graph = program.dependency_graph;
+
+	execution_map.clear();
+
+	StdVector<uint16_t> to_process;
+	StdVector<bool> required;
+	required.resize(graph.nodes.size(), false);
+
+	for (const unsigned int output_index : required_outputs) {
+		ZN_ASSERT_CONTINUE(output_index < program.outputs_count);
+		const unsigned int dg_index = program.outputs[output_index].dependency_graph_node_index;
+		if (!required[dg_index]) {
+			required[dg_index] = true;
+			to_process.push_back(dg_index);
+		}
+	}
+
+	while (to_process.size() != 0) {
+		const DependencyGraph::Node &node = graph.nodes[to_process.back()];
+		to_process.pop_back();
+
+		for (uint32_t i = node.first_dependency; i < node.end_dependency; ++i) {
+			const uint32_t dep_node_index = graph.dependencies[i];
+			if (!required[dep_node_index]) {
+				required[dep_node_index] = true;
+				to_process.push_back(dep_node_index);
+			}
+		}
+	}
+
+	// Nodes are in the same order as the default execution map, so the outer group remains first
+	bool inner_group_start_not_assigned = true;
+
+	for (unsigned int node_index = 0; node_index < graph.nodes.size(); ++node_index) {
+		const DependencyGraph::Node &node = graph.nodes[node_index];
+
+		if (node.is_input || !required[node_index]) {
+			continue;
+		}
+
+		if (inner_group_start_not_assigned && node.op_address >= program.inner_group_start_op_index) {
+			execution_map.inner_group_start_index = execution_map.operations.size();
+			inner_group_start_not_assigned = false;
+		}
+
+		execution_map.operations.push_back(ExecutionMap::OperationInfo{ node.op_address, 0 });
+	}
+
+	if (inner_group_start_not_assigned) {
+		execution_map.inner_group_start_index = execution_map.operations.size();
+	}
+}
+
 void Runtime::generate_single(State &state, Span<const float> inputs, const ExecutionMap *execution_map) const {
 	FixedArray<Span<const float>, MAX_INPUTS> input_bindings;
 	ZN_ASSERT_RETURN_MSG(inputs.size() < input_bindings.size(), "Too many inputs, not supported");
@@ -318,6 +381,7 @@ void Runtime::prepare_state(State &state, unsigned int buffer_size, bool with_pr
 
 	state.buffers.resize(_program.buffer_count);
 	state.ranges.resize(_program.buffer_count);
+	state.affine_ranges.resize(_program.buffer_count);
 	// Note: this must be after we resize the vector.
 	// Doing this mainly because Godot doesn't compile with standard library boundary checks...
 	Span<Buffer> buffers = to_span(state.buffers);
@@ -395,6 +459,43 @@ void Runtime::generate_set(
 		Span<const Span<const float>> p_inputs,
 		bool skip_outer_group,
 		const ExecutionMap *p_execution_map
+) const {
+	ZN_PROFILE_SCOPE();
+
+	const ExecutionMap &execution_map = p_execution_map != nullptr ? *p_execution_map : _program.default_execution_map;
+	Span<const ExecutionMap::OperationInfo> operation_infos = to_span(execution_map.operations);
+	Span<const ExecutionMap::ConstantFill> constant_fills = to_span(execution_map.constant_fills);
+
+	if (skip_outer_group && operation_infos.size() > 0) {
+		const unsigned int offset = execution_map.inner_group_start_index;
+		// Constant fills are consumed with a cursor, so those of skipped operations must be skipped too
+		unsigned int skipped_constant_fills_count = 0;
+		for (unsigned int i = 0; i < offset; ++i) {
+			skipped_constant_fills_count += operation_infos[i].constant_fill_count;
+		}
+		operation_infos = operation_infos.sub(offset);
+		constant_fills = constant_fills.sub(skipped_constant_fills_count);
+	}
+
+	const bool using_execution_map = p_execution_map != nullptr && p_execution_map->uses_range_analysis;
+	run_operations(state, p_inputs, operation_infos, constant_fills, using_execution_map);
+}
+
+void Runtime::generate_outer_group(State &state, Span<const Span<const float>> p_inputs) const {
+	ZN_PROFILE_SCOPE();
+	const ExecutionMap &execution_map = _program.default_execution_map;
+	const Span<const ExecutionMap::OperationInfo> operation_infos =
+			to_span(execution_map.operations).sub(0, execution_map.inner_group_start_index);
+	// The default execution map has no constant fills
+	run_operations(state, p_inputs, operation_infos, Span<const ExecutionMap::ConstantFill>(), false);
+}
+
+void Runtime::run_operations(
+		State &state,
+		Span<const Span<const float>> p_inputs,
+		Span<const ExecutionMap::OperationInfo> operation_infos,
+		Span<const ExecutionMap::ConstantFill> constant_fills,
+		const bool using_execution_map
 ) const {
 	// I don't like putting private helper functions in headers.
 	struct L {
@@ -414,8 +515,6 @@ void Runtime::generate_set(
 		}
 	};
 
-	ZN_PROFILE_SCOPE();
-
 	ZN_ASSERT_RETURN(p_inputs.size() == _program.inputs.size());
 
 #ifdef DEBUG_ENABLED
@@ -453,17 +552,91 @@ void Runtime::generate_set(
 		L::bind_input_buffer(buffers, _program.inputs[i].buffer_address, p_inputs[i]);
 	}
 
-	const Span<const uint16_t> operations(_program.operations.data(), 0, _program.operations.size());
+	const unsigned int values_count = state.buffer_size;
+	const unsigned int tile_size = state.tile_size;
 
-	const ExecutionMap &execution_map = p_execution_map != nullptr ? *p_execution_map : _program.default_execution_map;
-	Span<const ExecutionMap::OperationInfo> operation_infos = to_span(execution_map.operations);
-	const Span<const ExecutionMap::ConstantFill> constant_fills = to_span(execution_map.constant_fills);
+	NodeSamplingProfiler *sampling_profiler = _sampling_profiler.get();
+	const bool sampling = sampling_profiler != nullptr && sampling_profiler->should_sample();
+	if (sampling) {
+		state.sampled_times.clear();
+		state.sampled_times.resize(operation_infos.size(), 0);
+	}
 
-	if (skip_outer_group && operation_infos.size() > 0) {
-		const unsigned int offset = execution_map.inner_group_start_index;
-		operation_infos = operation_infos.sub(offset);
+	if (tile_size == 0 || values_count <= tile_size) {
+		execute_operations(
+				state, buffers, operation_infos, constant_fills, 0, values_count, using_execution_map, sampling
+		);
+
+	} else {
+		// Every operation processes values independently from each other, so we can run the whole program on a few
+		// values at a time, by offsetting buffers. Buffer datas remain full-size, so outputs are the same as if we
+		// processed everything at once.
+		static thread_local StdVector<Buffer> tls_full_buffers;
+		tls_full_buffers.resize(buffers.size());
+		for (unsigned int i = 0; i < buffers.size(); ++i) {
+			tls_full_buffers[i] = buffers[i];
+		}
+
+		for (unsigned int tile_begin = 0; tile_begin < values_count; tile_begin += tile_size) {
+			const unsigned int tile_values_count = math::min(tile_size, values_count - tile_begin);
+
+			for (unsigned int i = 0; i < buffers.size(); ++i) {
+				const Buffer &full_buffer = tls_full_buffers[i];
+				Buffer &buffer = buffers[i];
+				if (full_buffer.data != nullptr) {
+					buffer.data = full_buffer.data + tile_begin;
+				}
+				buffer.size = tile_values_count;
+			}
+
+			const bool success = execute_operations(
+					state,
+					buffers,
+					operation_infos,
+					constant_fills,
+					tile_begin,
+					tile_values_count,
+					using_execution_map,
+					sampling
+			);
+			if (!success) {
+				break;
+			}
+		}
+
+		for (unsigned int i = 0; i < buffers.size(); ++i) {
+			const Buffer &full_buffer = tls_full_buffers[i];
+			Buffer &buffer = buffers[i];
+			buffer.data = full_buffer.data;
+			buffer.size = full_buffer.size;
+		}
+	}
+
+	// Unbind buffers
+	for (unsigned int i = 0; i < p_inputs.size(); ++i) {
+		L::unbind_buffer(buffers, _program.inputs[i].buffer_address);
 	}
 
+	if (sampling) {
+		// Submitted once per run, so with tiling, samples still represent a whole set of values
+		for (unsigned int i = 0; i < operation_infos.size(); ++i) {
+			sampling_profiler->add_sample(operation_infos[i].address, state.sampled_times[i], values_count);
+		}
+	}
+}
+
+bool Runtime::execute_operations(
+		State &state,
+		Span<Buffer> buffers,
+		Span<const ExecutionMap::OperationInfo> operation_infos,
+		Span<const ExecutionMap::ConstantFill> constant_fills,
+		const unsigned int values_begin,
+		const unsigned int values_count,
+		const bool using_execution_map,
+		const bool sampling
+) const {
+	const Span<const uint16_t> operations(_program.operations.data(), 0, _program.operations.size());
+
 #ifdef TOOLS_ENABLED
 	ProfilingClock profiling_clock;
 	const bool profile = state.debug_profiler_times.size() > 0;
@@ -477,8 +650,10 @@ void Runtime::generate_set(
 		for (unsigned int i = 0; i < op_info.constant_fill_count; ++i) {
 			const ExecutionMap::ConstantFill &cf = constant_fills[constant_fill_index];
 			ZN_ASSERT(cf.data != nullptr);
-			for (unsigned int j = 0; j < state.buffer_size; ++j) {
-				cf.data[j] = cf.value;
+			// Constant fills point to the beginning of buffer datas
+			float *data = cf.data + values_begin;
+			for (unsigned int j = 0; j < values_count; ++j) {
+				data[j] = cf.value;
 			}
 			++constant_fill_index;
 		}
@@ -498,10 +673,16 @@ void Runtime::generate_set(
 
 		Span<const uint8_t> op_params = read_params(operations, pc);
 
-		// TODO Buffers will stay bound if this error occurs!
-		ZN_ASSERT_RETURN(node_type.process_buffer_func != nullptr);
-		ProcessBufferContext ctx(op_inputs, op_outputs, op_params, buffers, p_execution_map != nullptr);
-		node_type.process_buffer_func(ctx);
+		ZN_ASSERT_RETURN_V(node_type.process_buffer_func != nullptr, false);
+		ProcessBufferContext ctx(op_inputs, op_outputs, op_params, buffers, using_execution_map);
+
+		if (sampling) {
+			const uint64_t time_before = NodeSamplingProfiler::get_time_nanoseconds();
+			node_type.process_buffer_func(ctx);
+			state.sampled_times[execution_map_index] += NodeSamplingProfiler::get_time_nanoseconds() - time_before;
+		} else {
+			node_type.process_buffer_func(ctx);
+		}
 
 #ifdef TOOLS_ENABLED
 		if (profile) {
@@ -512,10 +693,7 @@ void Runtime::generate_set(
 #endif
 	}
 
-	// Unbind buffers
-	for (unsigned int i = 0; i < p_inputs.size(); ++i) {
-		L::unbind_buffer(buffers, _program.inputs[i].buffer_address);
-	}
+	return true;
 }
 
 void Runtime::analyze_range(State &state, Span<const math::Interval> p_inputs) const {
@@ -528,18 +706,27 @@ void Runtime::analyze_range(State &state, Span<const math::Interval> p_inputs) c
 	ZN_ASSERT_RETURN(p_inputs.size() == _program.inputs.size());
 
 	Span<math::Interval> ranges = to_span(state.ranges);
+	Span<math::AffineInterval> affine_ranges = to_span(state.affine_ranges);
 	Span<Buffer> buffers = to_span(state.buffers);
+	const bool use_affine = state.use_affine_range_analysis;
 
 	// Reset users count, as they might be decreased during the analysis
 	for (auto it = _program.buffer_specs.cbegin(); it != _program.buffer_specs.cend(); ++it) {
 		const BufferSpec &bs = *it;
 		Buffer &b = buffers[bs.address];
 		b.local_users_count = bs.users_count;
+		if (use_affine && bs.is_constant) {
+			affine_ranges[bs.address] = math::AffineInterval::from_single_value(bs.constant_value);
+		}
 	}
 
 	for (unsigned int i = 0; i < p_inputs.size(); ++i) {
 		const unsigned int bi = _program.inputs[i].buffer_address;
 		ranges[bi] = p_inputs[i];
+		if (use_affine) {
+			// Each input gets its own symbol, so values computed from the same inputs remain correlated
+			affine_ranges[bi] = math::AffineInterval::from_symbol(p_inputs[i], i);
+		}
 	}
 
 	const Span<const uint16_t> operations(_program.operations.data(), 0, _program.operations.size());
@@ -565,6 +752,22 @@ void Runtime::analyze_range(State &state, Span<const math::Interval> p_inputs) c
 		RangeAnalysisContext ctx(op_inputs, op_outputs, op_params, ranges, buffers);
 		node_type.range_analysis_func(ctx);
 
+		if (use_affine) {
+			if (node_type.affine_range_analysis_func != nullptr) {
+				AffineRangeAnalysisContext actx(op_inputs, op_outputs, op_params, ranges, affine_ranges);
+				node_type.affine_range_analysis_func(actx);
+
+				// Both results are valid estimations, keep the tightest
+				for (const uint16_t address : op_outputs) {
+					ranges[address] = math::get_tightest_interval(ranges[address], affine_ranges[address]);
+				}
+			} else {
+				for (const uint16_t address : op_outputs) {
+					affine_ranges[address] = math::AffineInterval::from_interval(ranges[address]);
+				}
+			}
+		}
+
 #ifdef VOXEL_DEBUG_GRAPH_PROG_SENTINEL
 		// If this fails, the program is ill-formed
 		ZN_ASSERT(read<uint16_t>(_program, pc) == VOXEL_DEBUG_GRAPH_PROG_SENTINEL);
@@ -639,4 +842,27 @@ bool Runtime::try_get_output_port_address(ProgramGraph::PortLocation port, uint1
 	return true;
 }
 
+uint64_t Runtime::get_program_hash() const {
+	// Operations include parameters. Some of them can be pointers to data allocated at compilation time, so compiling
+	// the same graph twice may not produce the same hash.
+	uint64_t h = hash_djb2_one_64(_program.operations.size());
+	for (const uint16_t word : _program.operations) {
+		h = hash_djb2_one_64(word, h);
+	}
+	// Constants are not part of operations
+	for (const BufferSpec &bs : _program.buffer_specs) {
+		if (bs.is_constant) {
+			uint32_t bits;
+			std::memcpy(&bits, &bs.constant_value, sizeof(bits));
+			h = hash_djb2_one_64(bs.address, h);
+			h = hash_djb2_one_64(bits, h);
+		}
+	}
+	h = hash_djb2_one_64(_program.inputs.size(), h);
+	for (unsigned int i = 0; i < _program.outputs_count; ++i) {
+		h = hash_djb2_one_64(_program.outputs[i].buffer_address, h);
+	}
+	return h;
+}
+
 } // namespace zylann::voxel::pg
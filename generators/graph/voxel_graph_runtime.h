@@ -6,20 +6,25 @@
 #include "../../util/containers/std_unordered_map.h"
 #include "../../util/containers/std_vector.h"
 #include "../../util/godot/classes/ref_counted.h"
+#include "../../util/math/affine_interval.h"
 #include "../../util/math/interval.h"
 #include "../../util/math/vector3f.h"
 #include "../../util/math/vector3i.h"
 #include "program_graph.h"
 
+#include <memory>
+
 namespace zylann::voxel::pg {
 
 class VoxelGraphFunction;
 class NodeTypeDB;
+class NodeSamplingProfiler;
 
 struct CompilationResult {
 	bool success = false;
 	int node_id = -1;
 	int expanded_nodes_count = 0; // For testing and debugging
+	int fused_nodes_count = 0; // For testing and debugging
 	String message;
 
 	static CompilationResult make_success() {
@@ -44,6 +49,10 @@ class Runtime {
 public:
 	static const unsigned int MAX_INPUTS = 8;
 	static const unsigned int MAX_OUTPUTS = 24;
+	// Default amount of values processed by all operations before moving on to the next values. Intermediate buffers
+	// then only get written and read back within a range that remains in CPU cache, instead of round-tripping through
+	// main memory after each operation.
+	static const unsigned int DEFAULT_TILE_SIZE = 256;
 
 	struct BufferData {
 		// Owns the data.
@@ -108,11 +117,16 @@ public:
 		// buffers, or better, single values.
 		StdVector<ConstantFill> constant_fills;
 
+		// If true, the map was generated from range analysis. Some buffers are then left unfilled, so operations must
+		// check which of their inputs are ignored, and the map is only valid within the analyzed area.
+		bool uses_range_analysis = false;
+
 		void clear() {
 			operations.clear();
 			debug_nodes.clear();
 			inner_group_start_index = 0;
 			constant_fills.clear();
+			uses_range_analysis = false;
 		}
 	};
 
@@ -142,10 +156,41 @@ public:
 			return ranges[address];
 		}
 
+		// Results of the last range analysis. They can be saved and set back later, so an area doesn't have to be
+		// analyzed again.
+		inline Span<const math::Interval> get_ranges() const {
+			return to_span(ranges);
+		}
+
+		inline void set_ranges(Span<const math::Interval> src) {
+			src.copy_to(to_span(ranges));
+		}
+
 		inline uint32_t get_buffer_size() const {
 			return buffer_size;
 		}
 
+		// Sets how many values `generate_set` processes through the whole program at once.
+		// 0 disables tiling, so each operation processes the whole buffer before the next one runs.
+		inline void set_tile_size(unsigned int p_tile_size) {
+			tile_size = p_tile_size;
+		}
+
+		inline unsigned int get_tile_size() const {
+			return tile_size;
+		}
+
+		// When enabled, `analyze_range` also propagates affine ranges through nodes supporting them, and keeps the
+		// tightest of both results. This costs more, but values computed from the same inputs are no longer assumed
+		// to be independent, which otherwise makes some ranges much wider than they really are.
+		inline void set_use_affine_range_analysis(bool enabled) {
+			use_affine_range_analysis = enabled;
+		}
+
+		inline bool is_using_affine_range_analysis() const {
+			return use_affine_range_analysis;
+		}
+
 		void clear() {
 			buffer_size = 0;
 			// buffer_capacity = 0;
@@ -156,6 +201,7 @@ public:
 			buffer_datas.clear();
 			buffers.clear();
 			ranges.clear();
+			affine_ranges.clear();
 			debug_profiler_times.clear();
 		}
 
@@ -177,13 +223,19 @@ public:
 		friend class Runtime; // TODO Why is friend needed? This class is nested inside
 
 		StdVector<math::Interval> ranges;
+		// Only used when affine range analysis is enabled
+		StdVector<math::AffineInterval> affine_ranges;
 		StdVector<Buffer> buffers;
 		StdVector<BufferData> buffer_datas;
 		// [execution_map_index] => microseconds
 		StdVector<uint32_t> debug_profiler_times;
+		// [execution_map_index] => nanoseconds, while a run is measured by the sampling profiler
+		StdVector<uint64_t> sampled_times;
 
 		unsigned int buffer_size = 0;
 		unsigned int buffer_capacity = 0;
+		unsigned int tile_size = DEFAULT_TILE_SIZE;
+		bool use_affine_range_analysis = false;
 	};
 
 	struct InputInfo {
@@ -205,7 +257,10 @@ public:
 	~Runtime();
 
 	void clear();
-	CompilationResult compile(const VoxelGraphFunction &function, bool debug);
+	// Compiles a function into a program.
+	// In debug mode, nodes are kept as they are, so their outputs can be inspected.
+	// `enable_fusion` allows trees of elementwise operations to be executed as single operations when not debugging.
+	CompilationResult compile(const VoxelGraphFunction &function, bool debug, bool enable_fusion = true);
 
 	// Call this before you use a state with generation functions.
 	// You need to call it once, until you want to use a different graph, buffer size or buffer count.
@@ -216,6 +271,8 @@ public:
 	// TODO Evaluate needs for double-precision in pg::Runtime
 	void generate_single(State &state, Span<const float> inputs, const ExecutionMap *execution_map) const;
 
+	// Runs the program on a set of values. Each input must have the same size as the state's buffers.
+	// If the state has a tile size smaller than the set, all operations run on one tile of values before the next one.
 	void generate_set(
 			State &state,
 			Span<const Span<const float>> p_inputs,
@@ -223,6 +280,17 @@ public:
 			const ExecutionMap *p_execution_map
 	) const;
 
+	// Runs only the operations of the outer group, using the default execution map. After this, buffers returned by
+	// `get_outer_group_buffer_addresses` hold their values, and `generate_set` can be called with `skip_outer_group`.
+	void generate_outer_group(State &state, Span<const Span<const float>> p_inputs) const;
+
+	// Gets addresses of buffers computed by the outer group that the rest of the program reads from, or that are
+	// outputs. Their values only depend on X and Z, so they can be stored and restored later instead of running the
+	// outer group again.
+	inline Span<const uint16_t> get_outer_group_buffer_addresses() const {
+		return to_span(_program.outer_group_buffer_addresses);
+	}
+
 #ifdef DEBUG_ENABLED
 	void debug_print_operations();
 #endif
@@ -241,6 +309,12 @@ public:
 		return _program.outputs[i];
 	}
 
+	// Gets how many bytes intermediate buffers of a state take for each value processed at once. Operations share
+	// buffers when their results are not needed at the same time, so this is usually less than one per node output.
+	inline unsigned int get_scratch_bytes_per_value() const {
+		return _program.buffer_data_count * sizeof(float);
+	}
+
 	// Analyzes a specific region of inputs to find out what ranges of outputs we can expect.
 	// It can be used to speed up calls to `generate_set` thanks to execution mapping,
 	// so that operations can be optimized out if they don't contribute to the result.
@@ -259,6 +333,10 @@ public:
 	// Convenience function to require all outputs
 	void generate_optimized_execution_map(const State &state, ExecutionMap &execution_map, bool debug) const;
 
+	// Generates an execution map running only the operations the given outputs depend on. Unlike optimized execution
+	// maps, it doesn't depend on range analysis, so it can be computed once and used for any input.
+	void generate_pruned_execution_map(ExecutionMap &execution_map, Span<const unsigned int> required_outputs) const;
+
 	const ExecutionMap &get_default_execution_map() const;
 
 	// Gets the buffer address of a specific output port
@@ -266,6 +344,12 @@ public:
 
 	uint64_t get_program_hash() const;
 
+	// Gets the profiler measuring operations on a fraction of calls to `generate_set`. Sampling is off by default.
+	// Returns null if no program was compiled.
+	inline NodeSamplingProfiler *get_sampling_profiler() const {
+		return _sampling_profiler.get();
+	}
+
 	static inline Span<const uint8_t> read_params(Span<const uint16_t> operations, unsigned int &pc) {
 		const uint16_t params_size_in_words = operations[pc];
 		++pc;
@@ -406,8 +490,47 @@ public:
 		Span<Buffer> _buffers;
 	};
 
+	// Functions usable by node implementations during affine range analysis.
+	// It runs after regular range analysis of the same node, so interval ranges of inputs and outputs are available.
+	class AffineRangeAnalysisContext : public _ProcessContext {
+	public:
+		inline AffineRangeAnalysisContext(
+				const Span<const uint16_t> inputs,
+				const Span<const uint16_t> outputs,
+				const Span<const uint8_t> params,
+				Span<const math::Interval> ranges,
+				Span<math::AffineInterval> affine_ranges
+		) :
+				_ProcessContext(inputs, outputs, params), _ranges(ranges), _affine_ranges(affine_ranges) {}
+
+		inline const math::AffineInterval &get_input(uint32_t i) const {
+			const uint32_t address = get_input_address(i);
+			return _affine_ranges[address];
+		}
+
+		inline const math::Interval get_input_interval(uint32_t i) const {
+			const uint32_t address = get_input_address(i);
+			return _ranges[address];
+		}
+
+		inline const math::Interval get_output_interval(uint32_t i) const {
+			const uint32_t address = get_output_address(i);
+			return _ranges[address];
+		}
+
+		inline void set_output(uint32_t i, const math::AffineInterval &r) {
+			const uint32_t address = get_output_address(i);
+			_affine_ranges[address] = r;
+		}
+
+	private:
+		Span<const math::Interval> _ranges;
+		Span<math::AffineInterval> _affine_ranges;
+	};
+
 	typedef void (*ProcessBufferFunc)(ProcessBufferContext &);
 	typedef void (*RangeAnalysisFunc)(RangeAnalysisContext &);
+	typedef void (*AffineRangeAnalysisFunc)(AffineRangeAnalysisContext &);
 
 private:
 	struct Program;
@@ -423,6 +546,28 @@ private:
 
 	bool is_operation_constant(const State &state, uint16_t op_address) const;
 
+	// Binds inputs and runs the given operations on the whole set of values, tile by tile if needed
+	void run_operations(
+			State &state,
+			Span<const Span<const float>> p_inputs,
+			Span<const ExecutionMap::OperationInfo> operation_infos,
+			Span<const ExecutionMap::ConstantFill> constant_fills,
+			bool using_execution_map
+	) const;
+
+	// Runs operations on the range of values the buffers currently point to.
+	// Returns false if an operation could not run.
+	bool execute_operations(
+			State &state,
+			Span<Buffer> buffers,
+			Span<const ExecutionMap::OperationInfo> operation_infos,
+			Span<const ExecutionMap::ConstantFill> constant_fills,
+			unsigned int values_begin,
+			unsigned int values_count,
+			bool using_execution_map,
+			bool sampling
+	) const;
+
 	struct BufferSpec {
 		// Index the buffer should be stored at
 		uint16_t address = 0;
@@ -512,6 +657,9 @@ private:
 		// cases.
 		uint32_t inner_group_start_op_index;
 
+		// Buffers written by the outer group which must keep their values while the inner group runs
+		StdVector<uint16_t> outer_group_buffer_addresses;
+
 		StdVector<InputInfo> inputs;
 
 		FixedArray<OutputInfo, MAX_OUTPUTS> outputs;
@@ -541,6 +689,7 @@ private:
 			operations.clear();
 			buffer_specs.clear();
 			inner_group_start_op_index = 0;
+			outer_group_buffer_addresses.clear();
 			default_execution_map.clear();
 			output_port_addresses.clear();
 			user_port_to_expanded_port.clear();
@@ -560,6 +709,8 @@ private:
 	};
 
 	Program _program;
+	// Created after compiling, because its size depends on the program
+	std::shared_ptr<NodeSamplingProfiler> _sampling_profiler;
 };
 
 } // namespace zylann::voxel::pg
@@ -0,0 +1,115 @@
+#include "xz_cache.h"
+#include "../../util/profiling.h"
+#include <cstring>
+
+namespace zylann::voxel::pg {
+
+void XZCache::set_max_memory_usage(size_t bytes) {
+	MutexLock mlock(_mutex);
+	_max_memory_usage = bytes;
+	while (_memory_usage > _max_memory_usage && _entries.size() > 0) {
+		remove_least_recently_used();
+	}
+}
+
+size_t XZCache::get_max_memory_usage() const {
+	MutexLock mlock(_mutex);
+	return _max_memory_usage;
+}
+
+size_t XZCache::get_memory_usage() const {
+	MutexLock mlock(_mutex);
+	return _memory_usage;
+}
+
+unsigned int XZCache::get_entry_count() const {
+	MutexLock mlock(_mutex);
+	return _entries.size();
+}
+
+bool XZCache::try_load(const Key &key, const Runtime &runtime, Runtime::State &state) {
+	ZN_PROFILE_SCOPE();
+
+	const Span<const uint16_t> addresses = runtime.get_outer_group_buffer_addresses();
+	const unsigned int values_per_buffer = state.get_buffer_size();
+
+	MutexLock mlock(_mutex);
+
+	auto it = _entries.find(key);
+	if (it == _entries.end()) {
+		return false;
+	}
+	Entry &entry = it->second;
+	ZN_ASSERT_RETURN_V(entry.values.size() == addresses.size() * values_per_buffer, false);
+
+	const float *src = entry.values.data();
+	for (const uint16_t address : addresses) {
+		const Runtime::Buffer &buffer = state.get_buffer(address);
+		ZN_ASSERT_RETURN_V(buffer.data != nullptr, false);
+		memcpy(buffer.data, src, values_per_buffer * sizeof(float));
+		src += values_per_buffer;
+	}
+
+	++_time;
+	entry.last_used = _time;
+	return true;
+}
+
+void XZCache::store(const Key &key, const Runtime &runtime, const Runtime::State &state) {
+	ZN_PROFILE_SCOPE();
+
+	const Span<const uint16_t> addresses = runtime.get_outer_group_buffer_addresses();
+	const unsigned int values_per_buffer = state.get_buffer_size();
+	const size_t entry_memory_usage = addresses.size() * values_per_buffer * sizeof(float);
+
+	// Copy outside of the lock
+	Entry entry;
+	entry.values.resize(addresses.size() * values_per_buffer);
+	float *dst = entry.values.data();
+	for (const uint16_t address : addresses) {
+		const Runtime::Buffer &buffer = state.get_buffer(address);
+		ZN_ASSERT_RETURN(buffer.data != nullptr);
+		memcpy(dst, buffer.data, values_per_buffer * sizeof(float));
+		dst += values_per_buffer;
+	}
+
+	MutexLock mlock(_mutex);
+
+	if (entry_memory_usage > _max_memory_usage) {
+		return;
+	}
+	if (_entries.find(key) != _entries.end()) {
+		// Another thread computed the same values
+		return;
+	}
+
+	while (_memory_usage + entry_memory_usage > _max_memory_usage && _entries.size() > 0) {
+		remove_least_recently_used();
+	}
+
+	++_time;
+	entry.last_used = _time;
+	_entries.insert({ key, std::move(entry) });
+	_memory_usage += entry_memory_usage;
+}
+
+void XZCache::clear() {
+	MutexLock mlock(_mutex);
+	_entries.clear();
+	_memory_usage = 0;
+}
+
+void XZCache::remove_least_recently_used() {
+	// Linear search, the number of entries is expected to remain small since each of them is a whole area
+	auto oldest_it = _entries.begin();
+	for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+		if (it->second.last_used < oldest_it->second.last_used) {
+			oldest_it = it;
+		}
+	}
+	ZN_ASSERT_RETURN(oldest_it != _entries.end());
+	_memory_usage -= oldest_it->second.values.size() * sizeof(float);
+	_entries.erase(oldest_it);
+}
+
+} // namespace zylann::voxel::pg
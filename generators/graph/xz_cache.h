@@ -0,0 +1,78 @@
+#ifndef VOXEL_GRAPH_XZ_CACHE_H
+#define VOXEL_GRAPH_XZ_CACHE_H
+
+#include "../../util/containers/std_unordered_map.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/hash_funcs.h"
+#include "../../util/math/vector2i.h"
+#include "../../util/thread/mutex.h"
+#include "voxel_graph_runtime.h"
+
+namespace zylann::voxel::pg {
+
+// Stores values computed by the outer group of a graph (operations that only depend on X and Z), so blocks generated
+// on top of each other don't have to compute them again. Can be used by multiple threads.
+// When the cache is full, entries that were not used for the longest time are removed.
+class XZCache {
+public:
+	struct Key {
+		uint64_t program_hash;
+		// Position of the first value of the area, in voxels
+		Vector2i origin;
+		// How many values along each axis
+		Vector2i size;
+		// Distance between values, in voxels
+		int stride;
+
+		inline bool operator==(const Key &other) const {
+			return program_hash == other.program_hash && origin == other.origin && size == other.size &&
+					stride == other.stride;
+		}
+	};
+
+	struct KeyHasher {
+		inline size_t operator()(const Key &key) const {
+			uint64_t h = hash_djb2_one_64(key.program_hash);
+			h = hash_djb2_one_64(key.origin.x, h);
+			h = hash_djb2_one_64(key.origin.y, h);
+			h = hash_djb2_one_64(key.size.x, h);
+			h = hash_djb2_one_64(key.size.y, h);
+			return hash_djb2_one_64(key.stride, h);
+		}
+	};
+
+	// Maximum amount of memory values can take. 0 disables the cache.
+	void set_max_memory_usage(size_t bytes);
+	size_t get_max_memory_usage() const;
+
+	size_t get_memory_usage() const;
+	unsigned int get_entry_count() const;
+
+	// Copies cached values into the buffers of a state having the same size as the area.
+	// Returns false if they were not found.
+	bool try_load(const Key &key, const Runtime &runtime, Runtime::State &state);
+
+	// Stores values of buffers from a state on which the outer group of the program just ran.
+	void store(const Key &key, const Runtime &runtime, const Runtime::State &state);
+
+	void clear();
+
+private:
+	struct Entry {
+		StdVector<float> values;
+		uint64_t last_used = 0;
+	};
+
+	void remove_least_recently_used();
+
+	StdUnorderedMap<Key, Entry, KeyHasher> _entries;
+	size_t _memory_usage = 0;
+	size_t _max_memory_usage = 0;
+	// Incremented each time an entry is used
+	uint64_t _time = 0;
+	BinaryMutex _mutex;
+};
+
+} // namespace zylann::voxel::pg
+
+#endif // VOXEL_GRAPH_XZ_CACHE_H
@@ -230,6 +230,10 @@ bool GenerateBlockMultipassCBTask::is_cancelled() {
 	if (_stream_dependency->valid == false) {
 		return true;
 	}
+	if (_tracker != nullptr && _tracker->is_aborted()) {
+		// Another block the same edit depends on was aborted, so that edit won't happen
+		return true;
+	}
 	if (_cancellation_token.is_valid()) {
 		return _cancellation_token.is_cancelled();
 	}
@@ -85,6 +85,9 @@ struct BakedModel {
 		// Bits are indexed with the Cube::Side enum.
 		uint8_t empty_sides_mask = 0;
 		uint8_t full_sides_mask = 0;
+		// Sides made of a single quad covering the whole side, with a rectangular UV mapping. They can be merged with
+		// similar neighbor faces when greedy meshing is enabled.
+		uint8_t greedy_sides_mask = 0;
 
 		// Tells what is the "shape" of each side in order to cull them quickly when in contact with neighbors.
 		// Side patterns are still determined based on a combination of all surfaces.
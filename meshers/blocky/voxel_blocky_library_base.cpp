@@ -227,6 +227,70 @@ void to_3d(Span<const Vector2f> src, Span<Vector3f> dst, unsigned int side) {
 	}
 }
 
+// Tells if a side can be stretched over several voxels by greedy meshing. It must be a single quad covering the whole
+// side, and its UVs must be a rectangle aligned with it, so a shader can repeat them.
+bool is_side_greedy_mergeable(const blocky::BakedModel::Model &model, const unsigned int side) {
+	const blocky::BakedModel::SideSurface *side_surface = nullptr;
+
+	for (unsigned int surface_index = 0; surface_index < model.surface_count; ++surface_index) {
+		const blocky::BakedModel::SideSurface &ss = model.sides_surfaces[side][surface_index];
+		if (ss.positions.size() == 0) {
+			continue;
+		}
+		if (side_surface != nullptr) {
+			// Faces using more than one material are not supported
+			return false;
+		}
+		side_surface = &ss;
+	}
+
+	if (side_surface == nullptr || side_surface->uvs.size() != side_surface->positions.size()) {
+		return false;
+	}
+
+	const Vector3i normal = Cube::g_side_normals[side];
+	const unsigned int normal_axis = normal.x != 0 ? math::AXIS_X : (normal.y != 0 ? math::AXIS_Y : math::AXIS_Z);
+	const float plane_coordinate = normal[normal_axis] > 0 ? 1.f : 0.f;
+
+	for (const Vector3f &p : side_surface->positions) {
+		if (!Math::is_equal_approx(p[normal_axis], plane_coordinate)) {
+			return false;
+		}
+	}
+
+	FixedArray<Vector2f, 4> positions_2d;
+	if (side_surface->positions.size() != positions_2d.size()) {
+		return false;
+	}
+	to_2d(to_span(side_surface->positions), to_span(positions_2d), side);
+
+	QuadIndices quad;
+	if (!detect_single_quad(to_span(positions_2d), to_span(side_surface->indices), quad)) {
+		return false;
+	}
+
+	if (!math::is_equal_approx(positions_2d[quad.i0], Vector2f(0.f, 0.f)) ||
+		!math::is_equal_approx(positions_2d[quad.i2], Vector2f(1.f, 1.f))) {
+		return false;
+	}
+
+	const Span<const Vector2f> uvs = to_span(side_surface->uvs);
+	const Vector2f du = uvs[quad.i1] - uvs[quad.i0];
+	const Vector2f dv = uvs[quad.i3] - uvs[quad.i0];
+
+	if (!math::is_equal_approx(uvs[quad.i2] - uvs[quad.i3], du) ||
+		!math::is_equal_approx(uvs[quad.i2] - uvs[quad.i1], dv)) {
+		// Not a parallelogram
+		return false;
+	}
+
+	const bool aligned = (Math::is_zero_approx(du.y) && Math::is_zero_approx(dv.x)) ||
+			(Math::is_zero_approx(du.x) && Math::is_zero_approx(dv.y));
+	const bool degenerate = math::is_equal_approx(du, Vector2f()) || math::is_equal_approx(dv, Vector2f());
+
+	return aligned && !degenerate;
+}
+
 } // namespace
 
 namespace blocky {
@@ -728,6 +792,11 @@ void generate_side_culling_matrix(BakedLibrary &baked_data) {
 
 				if ((bitmap & full_bitmap) == full_bitmap) {
 					model_data.model.full_sides_mask |= (1 << side);
+
+					if (model_data.fluid_index == VoxelBlockyModel::NULL_FLUID_INDEX &&
+						!model_data.cutout_sides_enabled && is_side_greedy_mergeable(model_data.model, side)) {
+						model_data.model.greedy_sides_mask |= (1 << side);
+					}
 				}
 			}
 
@@ -3,10 +3,12 @@
 #include "../../storage/voxel_buffer.h"
 #include "../../util/containers/span.h"
 #include "../../util/godot/core/array.h"
+#include "../../util/godot/classes/rendering_server.h"
 #include "../../util/godot/core/packed_arrays.h"
 #include "../../util/macros.h"
 #include "../../util/math/conv.h"
 #include "../../util/math/funcs.h"
+#include "../../util/memory/memory.h"
 // TODO GDX: String has no `operator+=`
 #include "../../util/containers/container_funcs.h"
 #include "../../util/godot/core/string.h"
@@ -34,6 +36,418 @@ StdVector<int> &get_tls_index_offsets() {
 	return tls_index_offsets;
 }
 
+// Gets how much to darken a vertex of a side, given occlusion values baked at its corners
+inline float get_side_vertex_occlusion(
+		const int8_t *shaded_corner,
+		const unsigned int side,
+		const Vector3f vertex_pos,
+		const float baked_occlusion_darkness
+) {
+	// General purpose occlusion colouring.
+	// TODO Optimize for cubes
+	// TODO Fix occlusion inconsistency caused by triangles orientation? Not sure if worth it
+	float shade = 0;
+	for (unsigned int j = 0; j < 4; ++j) {
+		unsigned int corner = Cube::g_side_corners[side][j];
+		if (shaded_corner[corner] != 0) {
+			float s = baked_occlusion_darkness * static_cast<float>(shaded_corner[corner]);
+			// float k = 1.f - Cube::g_corner_position[corner].distance_to(v);
+			float k = 1.f - math::distance_squared(Cube::g_corner_position[corner], vertex_pos);
+			if (k < 0.0) {
+				k = 0.0;
+			}
+			s *= k;
+			if (s > shade) {
+				shade = s;
+			}
+		}
+	}
+	return shade;
+}
+
+// Side of a voxel recorded for greedy meshing. Neighbor faces can be merged if they are equal.
+struct GreedyFace {
+	uint32_t model_id;
+	// Baked occlusion of each corner of the side, 2 bits each, in the order of `Cube::g_side_corners`
+	uint8_t occlusion;
+	Color color;
+
+	inline bool operator==(const GreedyFace &other) const {
+		return model_id == other.model_id && occlusion == other.occlusion && color == other.color;
+	}
+};
+
+struct GreedyFaces {
+	// For each side, one cell per meshed voxel, in ZXY order. Each cell contains an index into `faces` plus one, or
+	// zero if there is no face. Cells are reset to zero as faces get merged, so they can be reused for the next mesh.
+	FixedArray<StdVector<uint32_t>, Cube::SIDE_COUNT> cells;
+	StdVector<GreedyFace> faces;
+};
+
+GreedyFaces &get_tls_greedy_faces() {
+	static thread_local GreedyFaces tls_greedy_faces;
+	return tls_greedy_faces;
+}
+
+inline bool is_same_greedy_face(const GreedyFaces &greedy_faces, const uint32_t cell, const GreedyFace &face) {
+	return cell != 0 && greedy_faces.faces[cell - 1] == face;
+}
+
+// Adds a side stretched over `size_u * size_v` voxels. UVs are stretched too, so the tile has to be repeated by the
+// shader, using the rectangle stored in `tile_rects`.
+void append_greedy_quad(
+		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
+		Span<int> index_offsets,
+		VoxelMesher::Output::CollisionSurface *collision_surface,
+		int &collision_surface_index_offset,
+		const GreedyFace &face,
+		const unsigned int side,
+		const Vector3f origin,
+		const unsigned int axis_u,
+		const unsigned int axis_v,
+		const int size_u,
+		const int size_v,
+		const BakedLibrary &library,
+		const bool bake_occlusion,
+		const float baked_occlusion_darkness
+) {
+	const BakedModel::Model &model = library.models[face.model_id].model;
+
+	int8_t shaded_corner[8] = { 0 };
+	for (unsigned int j = 0; j < 4; ++j) {
+		shaded_corner[Cube::g_side_corners[side][j]] = (face.occlusion >> (j * 2)) & 3;
+	}
+
+	for (unsigned int surface_index = 0; surface_index < model.surface_count; ++surface_index) {
+		const BakedModel::SideSurface &side_surface = model.sides_surfaces[side][surface_index];
+		if (side_surface.positions.size() == 0) {
+			continue;
+		}
+
+		const BakedModel::Surface &surface = model.surfaces[surface_index];
+
+		VoxelMesherBlocky::Arrays &arrays = out_arrays_per_material[surface.material_id];
+
+		ZN_ASSERT(surface.material_id < index_offsets.size());
+		int &index_offset = index_offsets[surface.material_id];
+
+		const StdVector<Vector3f> &side_positions = side_surface.positions;
+		const StdVector<Vector2f> &side_uvs = side_surface.uvs;
+		const StdVector<float> &side_tangents = side_surface.tangents;
+		const unsigned int vertex_count = side_positions.size();
+
+		// The side is a quad covering the whole face of the voxel, with rectangular UVs (checked when baking)
+		FixedArray<FixedArray<Vector2f, 2>, 2> corner_uvs;
+		Vector2f uv_min = side_uvs[0];
+		Vector2f uv_max = side_uvs[0];
+		for (unsigned int i = 0; i < vertex_count; ++i) {
+			const Vector3f p = side_positions[i];
+			corner_uvs[p[axis_u] > 0.5f ? 1 : 0][p[axis_v] > 0.5f ? 1 : 0] = side_uvs[i];
+			uv_min = math::min(uv_min, side_uvs[i]);
+			uv_max = math::max(uv_max, side_uvs[i]);
+		}
+		const Vector2f uv_du = corner_uvs[1][0] - corner_uvs[0][0];
+		const Vector2f uv_dv = corner_uvs[0][1] - corner_uvs[0][0];
+		const Vector2f uv_size = uv_max - uv_min;
+
+		const unsigned int first_vertex = arrays.positions.size();
+
+		arrays.positions.resize(first_vertex + vertex_count);
+		arrays.uvs.resize(first_vertex + vertex_count);
+		arrays.normals.resize(first_vertex + vertex_count);
+		arrays.colors.resize(first_vertex + vertex_count);
+		// Vertices that are not part of a merged face have no tile
+		arrays.tile_rects.resize((first_vertex + vertex_count) * 4, 0.f);
+
+		const Vector3f normal = to_vec3f(Cube::g_side_normals[side]);
+		const Color modulate_color = face.color;
+
+		for (unsigned int i = 0; i < vertex_count; ++i) {
+			const Vector3f side_pos = side_positions[i];
+			const float fu = side_pos[axis_u];
+			const float fv = side_pos[axis_v];
+
+			Vector3f p = side_pos;
+			p[axis_u] *= size_u;
+			p[axis_v] *= size_v;
+
+			const unsigned int vi = first_vertex + i;
+			arrays.positions[vi] = origin + p;
+			arrays.uvs[vi] = side_uvs[i] + uv_du * (fu * (size_u - 1)) + uv_dv * (fv * (size_v - 1));
+			arrays.normals[vi] = normal;
+
+			if (bake_occlusion) {
+				const float gs =
+						1.0 - get_side_vertex_occlusion(shaded_corner, side, side_pos, baked_occlusion_darkness);
+				arrays.colors[vi] = Color(gs, gs, gs) * modulate_color;
+			} else {
+				arrays.colors[vi] = modulate_color;
+			}
+
+			float *tile_rect = arrays.tile_rects.data() + vi * 4;
+			tile_rect[0] = uv_min.x;
+			tile_rect[1] = uv_min.y;
+			tile_rect[2] = uv_size.x;
+			tile_rect[3] = uv_size.y;
+		}
+
+		if (side_tangents.size() > 0) {
+			const int append_index = arrays.tangents.size();
+			arrays.tangents.resize(arrays.tangents.size() + vertex_count * 4);
+			memcpy(arrays.tangents.data() + append_index, side_tangents.data(), (vertex_count * 4) * sizeof(float));
+		}
+
+		const StdVector<int> &side_indices = side_surface.indices;
+		const unsigned int index_count = side_indices.size();
+
+		{
+			int i = arrays.indices.size();
+			arrays.indices.resize(arrays.indices.size() + index_count);
+			int *w = arrays.indices.data();
+			for (unsigned int j = 0; j < index_count; ++j) {
+				w[i++] = index_offset + side_indices[j];
+			}
+		}
+
+		if (collision_surface != nullptr && surface.collision_enabled) {
+			StdVector<Vector3f> &dst_positions = collision_surface->positions;
+			StdVector<int> &dst_indices = collision_surface->indices;
+
+			dst_positions.insert(
+					dst_positions.end(),
+					arrays.positions.begin() + first_vertex,
+					arrays.positions.begin() + first_vertex + vertex_count
+			);
+
+			{
+				int i = dst_indices.size();
+				dst_indices.resize(dst_indices.size() + index_count);
+				int *w = dst_indices.data();
+				for (unsigned int j = 0; j < index_count; ++j) {
+					w[i++] = collision_surface_index_offset + side_indices[j];
+				}
+			}
+
+			collision_surface_index_offset += vertex_count;
+		}
+
+		index_offset += vertex_count;
+	}
+}
+
+// Merges faces recorded during the main meshing pass into larger quads, slice by slice.
+// `area_origin` is the position of the first cell in the mesh.
+void append_greedy_faces(
+		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
+		Span<int> index_offsets,
+		VoxelMesher::Output::CollisionSurface *collision_surface,
+		int &collision_surface_index_offset,
+		GreedyFaces &greedy_faces,
+		const Vector3i area_origin,
+		const Vector3i size,
+		const BakedLibrary &library,
+		const bool bake_occlusion,
+		const float baked_occlusion_darkness
+) {
+	ZN_PROFILE_SCOPE();
+
+	// Distance between cells along each axis
+	const Vector3i strides(size.y, 1, size.x * size.y);
+
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		Span<uint32_t> cells = to_span(greedy_faces.cells[side]);
+
+		const Vector3i normal = Cube::g_side_normals[side];
+		const unsigned int axis_n = normal.x != 0 ? math::AXIS_X : (normal.y != 0 ? math::AXIS_Y : math::AXIS_Z);
+		const unsigned int axis_u = (axis_n + 1) % 3;
+		const unsigned int axis_v = (axis_n + 2) % 3;
+
+		const int stride_u = strides[axis_u];
+		const int stride_v = strides[axis_v];
+
+		for (int n = 0; n < size[axis_n]; ++n) {
+			for (int v = 0; v < size[axis_v]; ++v) {
+				for (int u = 0; u < size[axis_u]; ++u) {
+					const unsigned int cell_index = n * strides[axis_n] + u * stride_u + v * stride_v;
+					const uint32_t cell = cells[cell_index];
+					if (cell == 0) {
+						continue;
+					}
+					const GreedyFace &face = greedy_faces.faces[cell - 1];
+
+					int size_u = 1;
+					while (u + size_u < size[axis_u] &&
+						   is_same_greedy_face(greedy_faces, cells[cell_index + size_u * stride_u], face)) {
+						++size_u;
+					}
+
+					// Extend over the next rows as long as they match entirely
+					int size_v = 1;
+					for (; v + size_v < size[axis_v]; ++size_v) {
+						const unsigned int row_index = cell_index + size_v * stride_v;
+						bool row_matches = true;
+						for (int i = 0; i < size_u; ++i) {
+							if (!is_same_greedy_face(greedy_faces, cells[row_index + i * stride_u], face)) {
+								row_matches = false;
+								break;
+							}
+						}
+						if (!row_matches) {
+							break;
+						}
+					}
+
+					Vector3f origin;
+					origin[axis_n] = area_origin[axis_n] + n;
+					origin[axis_u] = area_origin[axis_u] + u;
+					origin[axis_v] = area_origin[axis_v] + v;
+
+					append_greedy_quad(
+							out_arrays_per_material,
+							index_offsets,
+							collision_surface,
+							collision_surface_index_offset,
+							face,
+							side,
+							origin,
+							axis_u,
+							axis_v,
+							size_u,
+							size_v,
+							library,
+							bake_occlusion,
+							baked_occlusion_darkness
+					);
+
+					for (int j = 0; j < size_v; ++j) {
+						for (int i = 0; i < size_u; ++i) {
+							cells[cell_index + i * stride_u + j * stride_v] = 0;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// Voxels are visited by tiles of this size to find regions that can't produce geometry
+static constexpr unsigned int SKIP_TILE_SIZE_PO2 = 2;
+static constexpr unsigned int SKIP_TILE_SIZE = 1 << SKIP_TILE_SIZE_PO2;
+
+StdVector<uint8_t> &get_tls_skippable_tiles() {
+	static thread_local StdVector<uint8_t> tls_skippable_tiles;
+	return tls_skippable_tiles;
+}
+
+// Tells if voxels of a tile can't produce any geometry: either they are all air, or they are all the same model that
+// has no geometry other than its sides, and all its sides are hidden by neighbors.
+template <typename Type_T>
+bool is_tile_skippable(
+		const Span<const Type_T> type_buffer,
+		const Vector3i tile_min,
+		const Vector3i tile_max,
+		const int row_size,
+		const int deck_size,
+		const BakedLibrary &library
+) {
+	const uint32_t voxel_id = type_buffer[tile_min.y + tile_min.x * row_size + tile_min.z * deck_size];
+
+	for (int z = tile_min.z; z < tile_max.z; ++z) {
+		for (int x = tile_min.x; x < tile_max.x; ++x) {
+			const unsigned int column_index = x * row_size + z * deck_size;
+			for (int y = tile_min.y; y < tile_max.y; ++y) {
+				if (type_buffer[y + column_index] != voxel_id) {
+					return false;
+				}
+			}
+		}
+	}
+
+	if (voxel_id == AIR_ID || !library.has_model(voxel_id)) {
+		return true;
+	}
+
+	const BakedModel &voxel = library.models[voxel_id];
+	if (voxel.fluid_index != NULL_FLUID_INDEX) {
+		return false;
+	}
+	for (unsigned int surface_index = 0; surface_index < voxel.model.surface_count; ++surface_index) {
+		if (voxel.model.surfaces[surface_index].positions.size() != 0) {
+			return false;
+		}
+	}
+
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		if ((voxel.model.empty_sides_mask & (1 << side)) != 0) {
+			continue;
+		}
+		// Sides between voxels of the tile
+		if (is_face_visible(library, voxel, voxel_id, side)) {
+			return false;
+		}
+
+		// Sides on the border of the tile, facing neighbor voxels
+		const Vector3i normal = Cube::g_side_normals[side];
+		Vector3i face_min = tile_min;
+		Vector3i face_max = tile_max;
+		for (unsigned int axis = 0; axis < Vector3iUtil::AXIS_COUNT; ++axis) {
+			if (normal[axis] > 0) {
+				face_min[axis] = tile_max[axis] - 1;
+			} else if (normal[axis] < 0) {
+				face_max[axis] = tile_min[axis] + 1;
+			}
+		}
+		const int neighbor_offset = normal.y + normal.x * row_size + normal.z * deck_size;
+
+		for (int z = face_min.z; z < face_max.z; ++z) {
+			for (int x = face_min.x; x < face_max.x; ++x) {
+				const unsigned int column_index = x * row_size + z * deck_size + neighbor_offset;
+				for (int y = face_min.y; y < face_max.y; ++y) {
+					const uint32_t neighbor_id = type_buffer[y + column_index];
+					if (neighbor_id != voxel_id && is_face_visible(library, voxel, neighbor_id, side)) {
+						return false;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+// Finds which tiles of the area to mesh can be skipped. Underground blocks are often almost entirely solid, and
+// blocks above ground are mostly air, so this saves visiting most of their voxels one by one.
+template <typename Type_T>
+void find_skippable_tiles(
+		StdVector<uint8_t> &skippable_tiles,
+		const Span<const Type_T> type_buffer,
+		const Vector3i min,
+		const Vector3i max,
+		const Vector3i tile_grid_size,
+		const int row_size,
+		const int deck_size,
+		const BakedLibrary &library
+) {
+	ZN_PROFILE_SCOPE();
+
+	skippable_tiles.resize(Vector3iUtil::get_volume_u64(tile_grid_size));
+	unsigned int tile_index = 0;
+
+	// Same order as voxels
+	Vector3i tile_pos;
+	for (tile_pos.z = 0; tile_pos.z < tile_grid_size.z; ++tile_pos.z) {
+		for (tile_pos.x = 0; tile_pos.x < tile_grid_size.x; ++tile_pos.x) {
+			for (tile_pos.y = 0; tile_pos.y < tile_grid_size.y; ++tile_pos.y) {
+				const Vector3i tile_min = min + tile_pos * SKIP_TILE_SIZE;
+				const Vector3i tile_max = math::min(tile_min + Vector3iUtil::create(SKIP_TILE_SIZE), max);
+				skippable_tiles[tile_index] =
+						is_tile_skippable(type_buffer, tile_min, tile_max, row_size, deck_size, library);
+				++tile_index;
+			}
+		}
+	}
+}
+
 template <typename Type_T>
 void generate_mesh(
 		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
@@ -43,7 +457,11 @@ void generate_mesh(
 		const BakedLibrary &library,
 		const bool bake_occlusion,
 		const float baked_occlusion_darkness,
-		const TintSampler tint_sampler
+		const TintSampler tint_sampler,
+		const bool greedy_meshing,
+		// Area to mesh, in padded coordinates. Voxels around it are only read as neighbors.
+		const Vector3i min,
+		const Vector3i max
 ) {
 	// TODO Optimization: not sure if this mandates a template function. There is so much more happening in this
 	// function other than reading voxels, although reading is on the hottest path. It needs to be profiled. If
@@ -55,22 +473,40 @@ void generate_mesh(
 			block_size.z < static_cast<int>(2 * VoxelMesherBlocky::PADDING)
 	);
 
+	// Data must be padded, so the neighbors of voxels in the area can be accessed without checks
+	const Vector3i padding = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+	ZN_ASSERT_RETURN(Box3i::from_min_max(padding, block_size - padding).contains(Box3i::from_min_max(min, max)));
+
 	// Build lookup tables so to speed up voxel access.
 	// These are values to add to an address in order to get given neighbor.
 
 	const int row_size = block_size.y;
 	const int deck_size = block_size.x * row_size;
 
-	// Data must be padded, hence the off-by-one
-	const Vector3i min = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
-	const Vector3i max = block_size - Vector3iUtil::create(VoxelMesherBlocky::PADDING);
-
 	StdVector<int> &index_offsets = get_tls_index_offsets();
 	index_offsets.clear();
 	index_offsets.resize(out_arrays_per_material.size(), 0);
 
 	int collision_surface_index_offset = 0;
 
+	// Faces that can be merged are not added right away, they are recorded and merged after all voxels were visited
+	const Vector3i inner_size = max - min;
+	GreedyFaces *greedy_faces = nullptr;
+	if (greedy_meshing) {
+		greedy_faces = &get_tls_greedy_faces();
+		greedy_faces->faces.clear();
+		const uint64_t inner_volume = Vector3iUtil::get_volume_u64(inner_size);
+		for (StdVector<uint32_t> &cells : greedy_faces->cells) {
+			if (cells.size() < inner_volume) {
+				cells.resize(inner_volume, 0);
+			}
+		}
+	}
+
+	const Vector3i tile_grid_size = math::ceildiv(inner_size, SKIP_TILE_SIZE);
+	StdVector<uint8_t> &skippable_tiles = get_tls_skippable_tiles();
+	find_skippable_tiles(skippable_tiles, type_buffer, min, max, tile_grid_size, row_size, deck_size, library);
+
 	FixedArray<int, Cube::SIDE_COUNT> side_neighbor_lut;
 	side_neighbor_lut[Cube::SIDE_LEFT] = row_size;
 	side_neighbor_lut[Cube::SIDE_RIGHT] = -row_size;
@@ -129,10 +565,21 @@ void generate_mesh(
 
 	for (unsigned int z = min.z; z < (unsigned int)max.z; ++z) {
 		for (unsigned int x = min.x; x < (unsigned int)max.x; ++x) {
+			const unsigned int tile_column_index =
+					((x - min.x) >> SKIP_TILE_SIZE_PO2) + ((z - min.z) >> SKIP_TILE_SIZE_PO2) * tile_grid_size.x;
+			const uint8_t *skippable_tiles_column = &skippable_tiles[tile_column_index * tile_grid_size.y];
+
 			for (unsigned int y = min.y; y < (unsigned int)max.y; ++y) {
 				// min and max are chosen such that you can visit 1 neighbor away from the current voxel without size
 				// check
 
+				const unsigned int tile_y = (y - min.y) >> SKIP_TILE_SIZE_PO2;
+				if (skippable_tiles_column[tile_y] != 0) {
+					// Go to the last voxel of the tile, the loop moves to the next one
+					y = min.y + ((tile_y + 1) << SKIP_TILE_SIZE_PO2) - 1;
+					continue;
+				}
+
 				const unsigned int voxel_index = y + x * row_size + z * deck_size;
 				const unsigned int voxel_id = type_buffer[voxel_index];
 
@@ -272,6 +719,18 @@ void generate_mesh(
 						}
 					}
 
+					if (greedy_faces != nullptr && (model.greedy_sides_mask & (1 << side)) != 0) {
+						uint8_t occlusion = 0;
+						for (unsigned int j = 0; j < 4; ++j) {
+							occlusion |= shaded_corner[Cube::g_side_corners[side][j]] << (j * 2);
+						}
+						const unsigned int cell_index = (y - min.y) + (x - min.x) * inner_size.y +
+								(z - min.z) * inner_size.y * inner_size.x;
+						greedy_faces->faces.push_back(GreedyFace{ voxel_id, occlusion, modulate_color });
+						greedy_faces->cells[side][cell_index] = greedy_faces->faces.size();
+						continue;
+					}
+
 					// Subtracting 1 because the data is padded
 					const Vector3f pos(x - 1, y - 1, z - 1);
 
@@ -333,30 +792,9 @@ void generate_mesh(
 
 							if (bake_occlusion) {
 								for (unsigned int i = 0; i < vertex_count; ++i) {
-									const Vector3f vertex_pos = side_positions[i];
-
-									// General purpose occlusion colouring.
-									// TODO Optimize for cubes
-									// TODO Fix occlusion inconsistency caused by triangles orientation? Not sure if
-									// worth it
-									float shade = 0;
-									for (unsigned int j = 0; j < 4; ++j) {
-										unsigned int corner = Cube::g_side_corners[side][j];
-										if (shaded_corner[corner] != 0) {
-											float s = baked_occlusion_darkness *
-													static_cast<float>(shaded_corner[corner]);
-											// float k = 1.f - Cube::g_corner_position[corner].distance_to(v);
-											float k = 1.f -
-													math::distance_squared(Cube::g_corner_position[corner], vertex_pos);
-											if (k < 0.0) {
-												k = 0.0;
-											}
-											s *= k;
-											if (s > shade) {
-												shade = s;
-											}
-										}
-									}
+									const float shade = get_side_vertex_occlusion(
+											shaded_corner, side, side_positions[i], baked_occlusion_darkness
+									);
 									const float gs = 1.0 - shade;
 									w[i] = Color(gs, gs, gs) * modulate_color;
 								}
@@ -473,6 +911,21 @@ void generate_mesh(
 			}
 		}
 	}
+
+	if (greedy_faces != nullptr) {
+		append_greedy_faces(
+				out_arrays_per_material,
+				to_span(index_offsets),
+				collision_surface,
+				collision_surface_index_offset,
+				*greedy_faces,
+				min - padding,
+				inner_size,
+				library,
+				bake_occlusion,
+				baked_occlusion_darkness
+		);
+	}
 }
 
 bool is_empty(const StdVector<VoxelMesherBlocky::Arrays> &arrays_per_material) {
@@ -484,6 +937,169 @@ bool is_empty(const StdVector<VoxelMesherBlocky::Arrays> &arrays_per_material) {
 	return true;
 }
 
+// Blocks meshed incrementally are split in sections of this size along each axis
+static constexpr int INCREMENTAL_SECTION_SIZE = 8;
+
+class IncrementalCache : public VoxelMesher::IncrementalCache {
+public:
+	// What sections were meshed with. If any of it changes, all sections have to be meshed again.
+	struct Settings {
+		Vector3i block_size;
+		const VoxelBlockyLibraryBase *library = nullptr;
+		unsigned int material_count = 0;
+		float baked_occlusion_darkness = 0.f;
+		bool bake_occlusion = false;
+		bool greedy_meshing = false;
+		bool collision = false;
+		VoxelMesherBlocky::TintMode tint_mode = VoxelMesherBlocky::TINT_NONE;
+
+		bool operator==(const Settings &other) const {
+			return block_size == other.block_size && library == other.library &&
+					material_count == other.material_count &&
+					baked_occlusion_darkness == other.baked_occlusion_darkness &&
+					bake_occlusion == other.bake_occlusion && greedy_meshing == other.greedy_meshing &&
+					collision == other.collision && tint_mode == other.tint_mode;
+		}
+	};
+
+	struct Section {
+		// Positions are relative to the block, without LOD scaling
+		StdVector<VoxelMesherBlocky::Arrays> arrays_per_material;
+		VoxelMesher::Output::CollisionSurface collision_surface;
+		bool valid = false;
+	};
+
+	Settings settings;
+	// In ZXY order
+	StdVector<Section> sections;
+};
+
+// Gets the cache to use for a block meshed incrementally. A new one is created if there was none or it can't be reused.
+IncrementalCache &get_or_create_incremental_cache(
+		std::shared_ptr<VoxelMesher::IncrementalCache> &cache_ptr,
+		const VoxelMesher &mesher,
+		const IncrementalCache::Settings &settings
+) {
+	if (cache_ptr == nullptr || cache_ptr->mesher != &mesher) {
+		cache_ptr = make_shared_instance<IncrementalCache>();
+		cache_ptr->mesher = &mesher;
+	}
+	IncrementalCache &cache = static_cast<IncrementalCache &>(*cache_ptr);
+	if (!(cache.settings == settings)) {
+		cache.settings = settings;
+		cache.sections.clear();
+	}
+	return cache;
+}
+
+void append_arrays(VoxelMesherBlocky::Arrays &dst, const VoxelMesherBlocky::Arrays &src) {
+	const int index_offset = dst.positions.size();
+	append_array(dst.positions, src.positions);
+	append_array(dst.normals, src.normals);
+	append_array(dst.uvs, src.uvs);
+	append_array(dst.colors, src.colors);
+	append_array(dst.tangents, src.tangents);
+	append_array(dst.tile_rects, src.tile_rects);
+	dst.indices.reserve(dst.indices.size() + src.indices.size());
+	for (const int i : src.indices) {
+		dst.indices.push_back(index_offset + i);
+	}
+}
+
+// Same as `generate_mesh` over the whole block, but done section by section. Sections are kept in the cache, and only
+// those near voxels that changed in `dirty_box` (relative to the block, without padding) are meshed again. Greedy
+// meshing doesn't merge faces across sections.
+template <typename Type_T>
+void generate_mesh_incremental(
+		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
+		VoxelMesher::Output::CollisionSurface *collision_surface,
+		IncrementalCache &cache,
+		const Box3i dirty_box,
+		const Span<const Type_T> type_buffer,
+		const Vector3i block_size,
+		const BakedLibrary &library,
+		const bool bake_occlusion,
+		const float baked_occlusion_darkness,
+		const TintSampler tint_sampler,
+		const bool greedy_meshing
+) {
+	ZN_PROFILE_SCOPE();
+
+	const Vector3i padding = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+	const Vector3i inner_size = block_size - padding * 2;
+	ERR_FAIL_COND(inner_size.x < 0 || inner_size.y < 0 || inner_size.z < 0);
+
+	const Vector3i section_grid_size = math::ceildiv(inner_size, INCREMENTAL_SECTION_SIZE);
+	cache.sections.resize(Vector3iUtil::get_volume_u64(section_grid_size));
+
+	// Faces of a voxel depend on its direct neighbors
+	const Box3i padded_dirty_box = dirty_box.padded(1);
+	const bool has_dirty_voxels = !dirty_box.is_empty();
+
+	unsigned int section_index = 0;
+	Vector3i section_pos;
+	for (section_pos.z = 0; section_pos.z < section_grid_size.z; ++section_pos.z) {
+		for (section_pos.x = 0; section_pos.x < section_grid_size.x; ++section_pos.x) {
+			for (section_pos.y = 0; section_pos.y < section_grid_size.y; ++section_pos.y) {
+				IncrementalCache::Section &section = cache.sections[section_index];
+				++section_index;
+
+				const Box3i section_box =
+						Box3i(section_pos * INCREMENTAL_SECTION_SIZE, Vector3iUtil::create(INCREMENTAL_SECTION_SIZE))
+								.clipped(inner_size);
+
+				if (section.valid && !(has_dirty_voxels && section_box.intersects(padded_dirty_box))) {
+					continue;
+				}
+
+				section.arrays_per_material.resize(out_arrays_per_material.size());
+				for (VoxelMesherBlocky::Arrays &arrays : section.arrays_per_material) {
+					arrays.clear();
+				}
+				section.collision_surface.positions.clear();
+				section.collision_surface.indices.clear();
+
+				generate_mesh(
+						section.arrays_per_material,
+						collision_surface != nullptr ? &section.collision_surface : nullptr,
+						type_buffer,
+						block_size,
+						library,
+						bake_occlusion,
+						baked_occlusion_darkness,
+						tint_sampler,
+						greedy_meshing,
+						padding + section_box.position,
+						padding + section_box.position + section_box.size
+				);
+
+				if (greedy_meshing) {
+					// Sections are concatenated, so each of them must have a tile rect for every vertex
+					for (VoxelMesherBlocky::Arrays &arrays : section.arrays_per_material) {
+						arrays.tile_rects.resize(arrays.positions.size() * 4, 0.f);
+					}
+				}
+
+				section.valid = true;
+			}
+		}
+	}
+
+	for (const IncrementalCache::Section &section : cache.sections) {
+		for (unsigned int material_index = 0; material_index < section.arrays_per_material.size(); ++material_index) {
+			append_arrays(out_arrays_per_material[material_index], section.arrays_per_material[material_index]);
+		}
+
+		if (collision_surface != nullptr) {
+			const int index_offset = collision_surface->positions.size();
+			append_array(collision_surface->positions, section.collision_surface.positions);
+			for (const int i : section.collision_surface.indices) {
+				collision_surface->indices.push_back(index_offset + i);
+			}
+		}
+	}
+}
+
 } // namespace blocky
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -529,6 +1145,16 @@ bool VoxelMesherBlocky::get_occlusion_enabled() const {
 	return _parameters.bake_occlusion;
 }
 
+void VoxelMesherBlocky::set_greedy_meshing_enabled(bool enable) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.greedy_meshing = enable;
+}
+
+bool VoxelMesherBlocky::is_greedy_meshing_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.greedy_meshing;
+}
+
 void VoxelMesherBlocky::set_shadow_occluder_side(Side side, bool enabled) {
 	RWLockWrite wlock(_parameters_lock);
 	if (enabled) {
@@ -588,12 +1214,12 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 	}
 
 	// The technique is Culled faces.
-	// Could be improved with greedy meshing: https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
-	// However I don't feel it's worth it yet:
+	// Optionally, sides of cubes can be merged with greedy meshing:
+	// https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
+	// It is not enabled by default:
 	// - Not so much gain for organic worlds with lots of texture variations
 	// - Works well with cubes but not with any shape
-	// - Slower
-	// => Could be implemented in a separate class?
+	// - Requires a shader that repeats textures over merged faces
 
 	const VoxelBuffer &voxels = input.voxels;
 
@@ -610,6 +1236,10 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		// TODO Handle edge case of uniform block with non-cubic voxels!
 		// If the type of voxel still produces geometry in this situation (which is an absurd use case but not an
 		// error), decompress into a backing array to still allow the use of the same algorithm.
+		if (input.incremental_cache != nullptr) {
+			// Cached sections don't match the voxels anymore
+			input.incremental_cache->reset();
+		}
 		return;
 
 	} else if (voxels.get_channel_compression(channel) != VoxelBuffer::COMPRESSION_NONE) {
@@ -648,18 +1278,53 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		const blocky::TintSampler tint_sampler =
 				blocky::TintSampler::create(voxels, static_cast<blocky::TintSampler::Mode>(params.tint_mode));
 
+		blocky::IncrementalCache *incremental_cache = nullptr;
+		if (input.incremental_cache != nullptr) {
+			blocky::IncrementalCache::Settings settings;
+			settings.block_size = block_size;
+			settings.library = params.library.ptr();
+			settings.material_count = material_count;
+			settings.baked_occlusion_darkness = baked_occlusion_darkness;
+			settings.bake_occlusion = params.bake_occlusion;
+			settings.greedy_meshing = params.greedy_meshing;
+			settings.collision = collision_surface != nullptr;
+			settings.tint_mode = params.tint_mode;
+			incremental_cache = &blocky::get_or_create_incremental_cache(*input.incremental_cache, *this, settings);
+		}
+
+		const Vector3i padding = Vector3iUtil::create(PADDING);
+
 		switch (channel_depth) {
 			case VoxelBuffer::DEPTH_8_BIT:
-				blocky::generate_mesh(
-						arrays_per_material,
-						collision_surface,
-						raw_channel,
-						block_size,
-						library_baked_data,
-						params.bake_occlusion,
-						baked_occlusion_darkness,
-						tint_sampler
-				);
+				if (incremental_cache != nullptr) {
+					blocky::generate_mesh_incremental(
+							arrays_per_material,
+							collision_surface,
+							*incremental_cache,
+							input.dirty_box,
+							raw_channel,
+							block_size,
+							library_baked_data,
+							params.bake_occlusion,
+							baked_occlusion_darkness,
+							tint_sampler,
+							params.greedy_meshing
+					);
+				} else {
+					blocky::generate_mesh(
+							arrays_per_material,
+							collision_surface,
+							raw_channel,
+							block_size,
+							library_baked_data,
+							params.bake_occlusion,
+							baked_occlusion_darkness,
+							tint_sampler,
+							params.greedy_meshing,
+							padding,
+							block_size - padding
+					);
+				}
 				if (input.lod_index > 0) {
 					blocky::append_skirts(
 							raw_channel, block_size, arrays_per_material, library_baked_data, tint_sampler
@@ -669,16 +1334,35 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 
 			case VoxelBuffer::DEPTH_16_BIT: {
 				Span<const uint16_t> model_ids = raw_channel.reinterpret_cast_to<const uint16_t>();
-				blocky::generate_mesh(
-						arrays_per_material,
-						collision_surface,
-						model_ids,
-						block_size,
-						library_baked_data,
-						params.bake_occlusion,
-						baked_occlusion_darkness,
-						tint_sampler
-				);
+				if (incremental_cache != nullptr) {
+					blocky::generate_mesh_incremental(
+							arrays_per_material,
+							collision_surface,
+							*incremental_cache,
+							input.dirty_box,
+							model_ids,
+							block_size,
+							library_baked_data,
+							params.bake_occlusion,
+							baked_occlusion_darkness,
+							tint_sampler,
+							params.greedy_meshing
+					);
+				} else {
+					blocky::generate_mesh(
+							arrays_per_material,
+							collision_surface,
+							model_ids,
+							block_size,
+							library_baked_data,
+							params.bake_occlusion,
+							baked_occlusion_darkness,
+							tint_sampler,
+							params.greedy_meshing,
+							padding,
+							block_size - padding
+					);
+				}
 				if (input.lod_index > 0) {
 					blocky::append_skirts(model_ids, block_size, arrays_per_material, library_baked_data, tint_sampler);
 				}
@@ -709,7 +1393,7 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 	// That API does not seem to exist yet though.
 
 	for (unsigned int material_index = 0; material_index < material_count; ++material_index) {
-		const Arrays &arrays = arrays_per_material[material_index];
+		Arrays &arrays = arrays_per_material[material_index];
 
 		if (arrays.positions.size() != 0) {
 			Array mesh_arrays;
@@ -739,6 +1423,14 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 					copy_to(tangents, to_span_const(arrays.tangents));
 					mesh_arrays[Mesh::ARRAY_TANGENT] = tangents;
 				}
+
+				if (params.greedy_meshing) {
+					// Every surface must have tile rects, including vertices added after the last merged face
+					arrays.tile_rects.resize(arrays.positions.size() * 4, 0.f);
+					PackedFloat32Array tile_rects;
+					copy_to(tile_rects, to_span_const(arrays.tile_rects));
+					mesh_arrays[Mesh::ARRAY_CUSTOM0] = tile_rects;
+				}
 			}
 
 			output.surfaces.push_back(Output::Surface());
@@ -799,6 +1491,10 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 	}
 
 	output.primitive_type = Mesh::PRIMITIVE_TRIANGLES;
+
+	if (params.greedy_meshing) {
+		output.mesh_flags = (RenderingServer::ARRAY_CUSTOM_RGBA_FLOAT << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT);
+	}
 }
 
 // Ref<Resource> VoxelMesherBlocky::duplicate(bool p_subresources) const {
@@ -887,6 +1583,11 @@ void VoxelMesherBlocky::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_occlusion_darkness", "value"), &VoxelMesherBlocky::set_occlusion_darkness);
 	ClassDB::bind_method(D_METHOD("get_occlusion_darkness"), &VoxelMesherBlocky::get_occlusion_darkness);
 
+	ClassDB::bind_method(
+			D_METHOD("set_greedy_meshing_enabled", "enable"), &VoxelMesherBlocky::set_greedy_meshing_enabled
+	);
+	ClassDB::bind_method(D_METHOD("is_greedy_meshing_enabled"), &VoxelMesherBlocky::is_greedy_meshing_enabled);
+
 	ClassDB::bind_method(
 			D_METHOD("set_shadow_occluder_side", "side", "enabled"), &VoxelMesherBlocky::set_shadow_occluder_side
 	);
@@ -921,6 +1622,11 @@ void VoxelMesherBlocky::_bind_methods() {
 			"set_tint_mode",
 			"get_tint_mode"
 	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "greedy_meshing_enabled"),
+			"set_greedy_meshing_enabled",
+			"is_greedy_meshing_enabled"
+	);
 
 	ADD_GROUP("Shadow Occluders", "shadow_occluder_");
 
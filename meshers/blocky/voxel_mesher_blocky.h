@@ -32,6 +32,9 @@ public:
 	void set_occlusion_enabled(bool enable);
 	bool get_occlusion_enabled() const;
 
+	void set_greedy_meshing_enabled(bool enable);
+	bool is_greedy_meshing_enabled() const;
+
 	enum Side {
 		SIDE_NEGATIVE_X = 0,
 		SIDE_POSITIVE_X,
@@ -85,6 +88,9 @@ public:
 		StdVector<Color> colors;
 		StdVector<int> indices;
 		StdVector<float> tangents;
+		// Only used with greedy meshing. For each vertex, 4 floats defining the UV rectangle of the tile to repeat
+		// (position and size), or zeros if the vertex is not part of a merged face.
+		StdVector<float> tile_rects;
 
 		void clear() {
 			positions.clear();
@@ -93,6 +99,7 @@ public:
 			colors.clear();
 			indices.clear();
 			tangents.clear();
+			tile_rects.clear();
 		}
 	};
 
@@ -111,6 +118,7 @@ private:
 	struct Parameters {
 		float baked_occlusion_darkness = 0.8;
 		bool bake_occlusion = true;
+		bool greedy_meshing = false;
 		uint8_t shadow_occluders_mask = 0;
 		Ref<VoxelBlockyLibraryBase> library;
 		TintMode tint_mode = TINT_NONE;
@@ -1,5 +1,6 @@
 #include "voxel_mesher_cubes.h"
 #include "../../storage/voxel_buffer.h"
+#include "../../util/containers/container_funcs.h"
 #include "../../util/godot/classes/array_mesh.h"
 #include "../../util/godot/classes/base_material_3d.h"
 #include "../../util/godot/classes/geometry_2d.h"
@@ -9,12 +10,11 @@
 #include "../../util/godot/core/packed_arrays.h"
 #include "../../util/godot/core/string.h"
 #include "../../util/math/conv.h"
+#include "../../util/math/funcs.h"
+#include "../../util/memory/memory.h"
 #include "../../util/profiling.h"
 #include "../../util/string/format.h"
 
-// TODO Binary greedy mesher optimization
-// https://www.youtube.com/watch?v=qnGoGq7DWMc
-
 namespace zylann::voxel {
 
 namespace {
@@ -64,6 +64,15 @@ enum FaceSide {
 	FACE_SIDE_NONE // Either means there is no face, or it was consumed
 };
 
+// Columns of voxels are stored as 64-bit masks in binary greedy meshing, so blocks must not be larger than this
+const unsigned int BINARY_GREEDY_MAX_SIZE = 64;
+
+inline bool can_use_binary_greedy_meshing(const Vector3i block_size) {
+	return block_size.x <= static_cast<int>(BINARY_GREEDY_MAX_SIZE) &&
+			block_size.y <= static_cast<int>(BINARY_GREEDY_MAX_SIZE) &&
+			block_size.z <= static_cast<int>(BINARY_GREEDY_MAX_SIZE);
+}
+
 } // namespace
 
 // Returns:
@@ -210,12 +219,283 @@ void build_voxel_mesh_as_simple_cubes(
 	}
 }
 
+// Greedy meshing using bitmasks, based on https://www.youtube.com/watch?v=qnGoGq7DWMc
+// Each column of voxels along an axis is stored as a 64-bit mask, so finding faces along that axis takes a few bitwise
+// operations per column instead of a comparison per voxel. Faces are then gathered into bitmask rows for each deck,
+// where runs of faces are found by counting bits. Colors are only compared where faces are.
+// Produces the same quads as `build_voxel_mesh_as_greedy_cubes`.
+template <typename Voxel_T, typename Color_F>
+void build_voxel_mesh_as_binary_greedy_cubes(
+		FixedArray<VoxelMesherCubes::Arrays, VoxelMesherCubes::MATERIAL_COUNT> &out_arrays_per_material,
+		const Span<const Voxel_T> voxel_buffer,
+		const Vector3i block_size,
+		StdVector<uint8_t> &mask_memory_pool,
+		Color_F color_func
+) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(can_use_binary_greedy_meshing(block_size));
+
+	// Note: voxel buffers are indexed in ZXY order
+	FixedArray<uint32_t, Vector3iUtil::AXIS_COUNT> strides;
+	strides[Vector3i::AXIS_X] = block_size.y;
+	strides[Vector3i::AXIS_Y] = 1;
+	strides[Vector3i::AXIS_Z] = block_size.x * block_size.y;
+
+	// Columns along an axis are indexed by their position on the two other axes, in the order of `g_face_axes_lut`.
+	// For each axis, there are two lists of columns: bits of the first one are set where voxels are not transparent,
+	// bits of the second one are set where voxels are opaque.
+	FixedArray<unsigned int, Vector3iUtil::AXIS_COUNT> column_counts;
+	column_counts[Vector3i::AXIS_X] = block_size.y * block_size.z;
+	column_counts[Vector3i::AXIS_Y] = block_size.x * block_size.z;
+	column_counts[Vector3i::AXIS_Z] = block_size.x * block_size.y;
+	const unsigned int total_column_count =
+			column_counts[Vector3i::AXIS_X] + column_counts[Vector3i::AXIS_Y] + column_counts[Vector3i::AXIS_Z];
+
+	// Rows of faces of all decks along one axis, for each side. Decks are between voxels, so there is one less of them
+	// than voxels.
+	unsigned int max_face_rows_count = 0;
+	for (unsigned int za = 0; za < Vector3iUtil::AXIS_COUNT; ++za) {
+		const unsigned int ya = g_face_axes_lut[za][1];
+		const unsigned int face_rows_count = (block_size[za] - 1) * (block_size[ya] - 2 * VoxelMesherCubes::PADDING);
+		max_face_rows_count = math::max(max_face_rows_count, face_rows_count);
+	}
+
+	// Using the vector as memory pool
+	const unsigned int masks_count = 2 * total_column_count + 2 * max_face_rows_count;
+	mask_memory_pool.resize(masks_count * sizeof(uint64_t));
+	Span<uint64_t> masks(reinterpret_cast<uint64_t *>(mask_memory_pool.data()), 0, masks_count);
+	masks.sub(0, 2 * total_column_count).fill(0);
+
+	FixedArray<Span<uint64_t>, Vector3iUtil::AXIS_COUNT> solid_columns;
+	FixedArray<Span<uint64_t>, Vector3iUtil::AXIS_COUNT> opaque_columns;
+	{
+		unsigned int offset = 0;
+		for (unsigned int axis = 0; axis < Vector3iUtil::AXIS_COUNT; ++axis) {
+			solid_columns[axis] = masks.sub(offset, column_counts[axis]);
+			offset += column_counts[axis];
+			opaque_columns[axis] = masks.sub(offset, column_counts[axis]);
+			offset += column_counts[axis];
+		}
+	}
+	Span<uint64_t> face_rows = masks.sub(2 * total_column_count, max_face_rows_count);
+	Span<uint64_t> back_face_rows = masks.sub(2 * total_column_count + max_face_rows_count, max_face_rows_count);
+
+	// Fill columns, going through voxels only once
+	{
+		ZN_PROFILE_SCOPE_NAMED("Columns");
+		unsigned int voxel_index = 0;
+		for (int z = 0; z < block_size.z; ++z) {
+			for (int x = 0; x < block_size.x; ++x) {
+				uint64_t solid_y_column = 0;
+				uint64_t opaque_y_column = 0;
+
+				for (int y = 0; y < block_size.y; ++y) {
+					const Color8 color = color_func(voxel_buffer[voxel_index]);
+					++voxel_index;
+
+					if (color.a == 0) {
+						continue;
+					}
+					const uint64_t opaque = color.a == 255;
+
+					solid_y_column |= uint64_t(1) << y;
+					opaque_y_column |= opaque << y;
+
+					const unsigned int x_column_index = y + z * block_size.y;
+					solid_columns[Vector3i::AXIS_X][x_column_index] |= uint64_t(1) << x;
+					opaque_columns[Vector3i::AXIS_X][x_column_index] |= opaque << x;
+
+					const unsigned int z_column_index = x + y * block_size.x;
+					solid_columns[Vector3i::AXIS_Z][z_column_index] |= uint64_t(1) << z;
+					opaque_columns[Vector3i::AXIS_Z][z_column_index] |= opaque << z;
+				}
+
+				const unsigned int y_column_index = x + z * block_size.x;
+				solid_columns[Vector3i::AXIS_Y][y_column_index] = solid_y_column;
+				opaque_columns[Vector3i::AXIS_Y][y_column_index] = opaque_y_column;
+			}
+		}
+	}
+
+	FixedArray<uint32_t, VoxelMesherCubes::MATERIAL_COUNT> index_offsets;
+	fill(index_offsets, uint32_t(0));
+
+	// For each axis
+	for (unsigned int za = 0; za < Vector3iUtil::AXIS_COUNT; ++za) {
+		const unsigned int xa = g_face_axes_lut[za][0];
+		const unsigned int ya = g_face_axes_lut[za][1];
+
+		const unsigned int mask_size_x = block_size[xa] - 2 * VoxelMesherCubes::PADDING;
+		const unsigned int mask_size_y = block_size[ya] - 2 * VoxelMesherCubes::PADDING;
+		const unsigned int deck_count = block_size[za] - 1;
+		// Bit `d` tells if there is a face between voxels `d` and `d + 1`
+		const uint64_t decks_mask = (uint64_t(1) << deck_count) - 1;
+
+		const Span<const uint64_t> axis_solid_columns = solid_columns[za];
+		const Span<const uint64_t> axis_opaque_columns = opaque_columns[za];
+
+		face_rows.sub(0, deck_count * mask_size_y).fill(0);
+		back_face_rows.sub(0, deck_count * mask_size_y).fill(0);
+
+		// Find faces in every column, and store them in rows of their deck
+		for (unsigned int fy = 0; fy < mask_size_y; ++fy) {
+			for (unsigned int fx = 0; fx < mask_size_x; ++fx) {
+				const unsigned int column_index =
+						(fx + VoxelMesherCubes::PADDING) + (fy + VoxelMesherCubes::PADDING) * block_size[xa];
+				const uint64_t solid = axis_solid_columns[column_index];
+				const uint64_t opaque = axis_opaque_columns[column_index];
+				const uint64_t next_solid = solid >> 1;
+				const uint64_t next_opaque = opaque >> 1;
+
+				// A face appears where a voxel is more opaque than the next one (back side), or the other way around
+				// (front side)
+				uint64_t back_faces = ((solid & ~next_solid) | (opaque & ~next_opaque)) & decks_mask;
+				uint64_t front_faces = ((next_solid & ~solid) | (next_opaque & ~opaque)) & decks_mask;
+
+				const uint64_t row_bit = uint64_t(1) << fx;
+
+				while (back_faces != 0) {
+					const unsigned int d = math::get_lowest_bit_index_64(back_faces);
+					back_faces &= back_faces - 1;
+					face_rows[d * mask_size_y + fy] |= row_bit;
+					back_face_rows[d * mask_size_y + fy] |= row_bit;
+				}
+				while (front_faces != 0) {
+					const unsigned int d = math::get_lowest_bit_index_64(front_faces);
+					front_faces &= front_faces - 1;
+					face_rows[d * mask_size_y + fy] |= row_bit;
+				}
+			}
+		}
+
+		// Greedy quads
+		for (unsigned int d = 0; d < deck_count; ++d) {
+			Span<uint64_t> deck_face_rows = face_rows.sub(d * mask_size_y, mask_size_y);
+			Span<uint64_t> deck_back_face_rows = back_face_rows.sub(d * mask_size_y, mask_size_y);
+
+			struct L {
+				static inline uint64_t get_side_row(
+						const Span<uint64_t> rows,
+						const Span<uint64_t> back_rows,
+						unsigned int fy,
+						bool back
+				) {
+					return back ? back_rows[fy] : rows[fy] & ~back_rows[fy];
+				}
+			};
+
+			for (unsigned int fy = 0; fy < mask_size_y; ++fy) {
+				while (deck_face_rows[fy] != 0) {
+					const unsigned int fx = math::get_lowest_bit_index_64(deck_face_rows[fy]);
+					const bool back = (deck_back_face_rows[fy] >> fx) & 1;
+					const FaceSide side = back ? FACE_SIDE_BACK : FACE_SIDE_FRONT;
+
+					// Faces belong to the voxel that is more opaque
+					const unsigned int face_voxel_index0 = (fx + VoxelMesherCubes::PADDING) * strides[xa] +
+							(fy + VoxelMesherCubes::PADDING) * strides[ya] + (back ? d : d + 1) * strides[za];
+					const Voxel_T raw_color = voxel_buffer[face_voxel_index0];
+
+					// Check if the next faces are the same along X. Faces of the same side are contiguous up to
+					// `run_end`, so colors only need to be compared within that run.
+					const uint64_t side_row = L::get_side_row(deck_face_rows, deck_back_face_rows, fy, back);
+					const unsigned int run_end = fx + math::get_lowest_bit_index_64(~(side_row >> fx));
+					unsigned int rx = fx + 1;
+					while (rx < run_end && voxel_buffer[face_voxel_index0 + (rx - fx) * strides[xa]] == raw_color) {
+						++rx;
+					}
+					const uint64_t quad_row_mask = ((uint64_t(1) << (rx - fx)) - 1) << fx;
+
+					// Check if the next rows of faces are the same along Y
+					unsigned int ry = fy + 1;
+					while (ry < mask_size_y) {
+						const uint64_t next_side_row = L::get_side_row(deck_face_rows, deck_back_face_rows, ry, back);
+						if ((next_side_row & quad_row_mask) != quad_row_mask) {
+							break;
+						}
+						const unsigned int row_voxel_index0 = face_voxel_index0 + (ry - fy) * strides[ya];
+						unsigned int i = 0;
+						while (i < rx - fx && voxel_buffer[row_voxel_index0 + i * strides[xa]] == raw_color) {
+							++i;
+						}
+						if (i < rx - fx) {
+							break;
+						}
+						++ry;
+					}
+
+					for (unsigned int j = fy; j < ry; ++j) {
+						deck_face_rows[j] &= ~quad_row_mask;
+						deck_back_face_rows[j] &= ~quad_row_mask;
+					}
+
+					// Commit face to the mesh
+
+					const Color colorf = color_func(raw_color);
+					const uint8_t material_index = colorf.a < 0.999f;
+					VoxelMesherCubes::Arrays &arrays = out_arrays_per_material[material_index];
+
+					Vector3f v0;
+					v0[xa] = fx;
+					v0[ya] = fy;
+					v0[za] = d;
+
+					Vector3f v1;
+					v1[xa] = rx;
+					v1[ya] = fy;
+					v1[za] = d;
+
+					Vector3f v2;
+					v2[xa] = fx;
+					v2[ya] = ry;
+					v2[za] = d;
+
+					Vector3f v3;
+					v3[xa] = rx;
+					v3[ya] = ry;
+					v3[za] = d;
+
+					Vector3f n;
+					n[za] = side == FACE_SIDE_FRONT ? -1 : 1;
+
+					// 2-----3
+					// |     |
+					// |     |
+					// 0-----1
+
+					arrays.positions.push_back(v0);
+					arrays.positions.push_back(v1);
+					arrays.positions.push_back(v2);
+					arrays.positions.push_back(v3);
+
+					arrays.colors.push_back(colorf);
+					arrays.colors.push_back(colorf);
+					arrays.colors.push_back(colorf);
+					arrays.colors.push_back(colorf);
+
+					arrays.normals.push_back(n);
+					arrays.normals.push_back(n);
+					arrays.normals.push_back(n);
+					arrays.normals.push_back(n);
+
+					const unsigned int index_offset = index_offsets[material_index];
+					const uint8_t *lut = g_indices_lut[za][side];
+					for (unsigned int i = 0; i < 6; ++i) {
+						arrays.indices.push_back(index_offset + lut[i]);
+					}
+					index_offsets[material_index] += 4;
+				}
+			}
+		}
+	}
+}
+
 template <typename Voxel_T, typename Color_F>
 void build_voxel_mesh_as_greedy_cubes(
 		FixedArray<VoxelMesherCubes::Arrays, VoxelMesherCubes::MATERIAL_COUNT> &out_arrays_per_material,
 		const Span<const Voxel_T> voxel_buffer,
 		const Vector3i block_size,
 		StdVector<uint8_t> &mask_memory_pool,
+		const bool binary_meshing_enabled,
 		Color_F color_func
 ) {
 	//
@@ -225,6 +505,13 @@ void build_voxel_mesh_as_greedy_cubes(
 			block_size.z < static_cast<int>(2 * VoxelMesherCubes::PADDING)
 	);
 
+	if (binary_meshing_enabled && can_use_binary_greedy_meshing(block_size)) {
+		build_voxel_mesh_as_binary_greedy_cubes(
+				out_arrays_per_material, voxel_buffer, block_size, mask_memory_pool, color_func
+		);
+		return;
+	}
+
 	struct MaskValue {
 		Voxel_T color;
 		uint8_t side;
@@ -746,55 +1033,99 @@ VoxelMesherCubes::Cache &VoxelMesherCubes::get_tls_cache() {
 	return cache;
 }
 
-void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Input &input) {
-	ZN_PROFILE_SCOPE();
-	const int channel = VoxelBuffer::CHANNEL_COLOR;
-	Cache &cache = get_tls_cache();
-
-	for (unsigned int i = 0; i < cache.arrays_per_material.size(); ++i) {
-		Arrays &a = cache.arrays_per_material[i];
-		a.clear();
-	}
+// Blocks meshed incrementally are split in sections of this size along each axis
+static constexpr int INCREMENTAL_SECTION_SIZE = 8;
+
+class VoxelMesherCubes::SectionCache : public VoxelMesher::IncrementalCache {
+public:
+	// What sections were meshed with. If any of it changes, all sections have to be meshed again.
+	struct Settings {
+		Vector3i block_size;
+		const VoxelColorPalette *palette = nullptr;
+		ColorMode color_mode = COLOR_RAW;
+		bool greedy_meshing = false;
+
+		bool operator==(const Settings &other) const {
+			return block_size == other.block_size && palette == other.palette && color_mode == other.color_mode &&
+					greedy_meshing == other.greedy_meshing;
+		}
+	};
 
-	const VoxelBuffer &voxels = input.voxels;
+	struct Section {
+		// Positions are relative to the block, without LOD scaling
+		FixedArray<Arrays, MATERIAL_COUNT> arrays_per_material;
+		bool valid = false;
+	};
 
-	// Iterate 3D padded data to extract voxel faces.
-	// This is the most intensive job in this class, so all required data should be as fit as possible.
+	Settings settings;
+	// In ZXY order
+	StdVector<Section> sections;
+};
 
-	// The buffer we receive MUST be dense (i.e not compressed, and channels allocated).
-	// That means we can use raw pointers to voxel data inside instead of using the higher-level getters,
-	// and then save a lot of time.
+namespace {
 
-	if (voxels.get_channel_compression(channel) == VoxelBuffer::COMPRESSION_UNIFORM) {
-		// All voxels have the same type.
-		// If it's all air, nothing to do. If it's all cubes, nothing to do either.
-		return;
+// Copies faces meshed from a section to the cache of that section, moving them to the position of the section in the
+// block. Faces lying on the positive sides of the section are also produced by the next section, so they are skipped,
+// unless the section is the last one along that axis.
+void append_section_faces(
+		FixedArray<VoxelMesherCubes::Arrays, VoxelMesherCubes::MATERIAL_COUNT> &dst_arrays_per_material,
+		const FixedArray<VoxelMesherCubes::Arrays, VoxelMesherCubes::MATERIAL_COUNT> &src_arrays_per_material,
+		const Vector3i section_origin,
+		const Vector3i section_size,
+		const Vector3i block_inner_size
+) {
+	const Vector3f offset = to_vec3f(section_origin);
+
+	for (unsigned int material_index = 0; material_index < VoxelMesherCubes::MATERIAL_COUNT; ++material_index) {
+		const VoxelMesherCubes::Arrays &src = src_arrays_per_material[material_index];
+		VoxelMesherCubes::Arrays &dst = dst_arrays_per_material[material_index];
+
+		// Faces are quads of 4 vertices and 6 indices
+		const unsigned int quad_count = src.positions.size() / 4;
+		for (unsigned int quad_index = 0; quad_index < quad_count; ++quad_index) {
+			const unsigned int src_vertex_index = quad_index * 4;
+			const Vector3f normal = src.normals[src_vertex_index];
+			const unsigned int axis =
+					normal.x != 0.f ? Vector3i::AXIS_X : (normal.y != 0.f ? Vector3i::AXIS_Y : Vector3i::AXIS_Z);
+
+			if (src.positions[src_vertex_index][axis] == section_size[axis] &&
+				section_origin[axis] + section_size[axis] < block_inner_size[axis]) {
+				continue;
+			}
 
-	} else if (voxels.get_channel_compression(channel) != VoxelBuffer::COMPRESSION_NONE) {
-		// No other form of compression is allowed
-		ERR_PRINT("VoxelMesherCubes received unsupported voxel compression");
-		return;
+			const unsigned int dst_vertex_index = dst.positions.size();
+			for (unsigned int i = 0; i < 4; ++i) {
+				dst.positions.push_back(src.positions[src_vertex_index + i] + offset);
+				dst.normals.push_back(src.normals[src_vertex_index + i]);
+				dst.colors.push_back(src.colors[src_vertex_index + i]);
+			}
+			for (unsigned int i = 0; i < 6; ++i) {
+				dst.indices.push_back(src.indices[quad_index * 6 + i] - src_vertex_index + dst_vertex_index);
+			}
+		}
 	}
+}
+
+} // namespace
+
+bool VoxelMesherCubes::build_arrays(
+		Cache &cache,
+		const VoxelBuffer &voxels,
+		const Parameters &params,
+		Ref<Image> &out_atlas_image
+) {
+	const int channel = VoxelBuffer::CHANNEL_COLOR;
 
 	Span<const uint8_t> raw_channel;
 	if (!voxels.get_channel_as_bytes_read_only(channel, raw_channel)) {
 		// Case supposedly handled before...
 		ERR_PRINT("Something wrong happened");
-		return;
+		return false;
 	}
 
 	const Vector3i block_size = voxels.get_size();
 	const VoxelBuffer::Depth channel_depth = voxels.get_channel_depth(channel);
 
-	Parameters params;
-	{
-		RWLockRead rlock(_parameters_lock);
-		params = _parameters;
-	}
-	// Note, we don't lock the palette because its data has fixed-size
-
-	Ref<Image> atlas_image;
-
 	switch (params.color_mode) {
 		case COLOR_RAW:
 			switch (channel_depth) {
@@ -805,6 +1136,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 								raw_channel,
 								block_size,
 								cache.mask_memory_pool,
+								params.binary_greedy_meshing,
 								Color8::from_u8
 						);
 					} else {
@@ -821,6 +1153,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 								raw_channel.reinterpret_cast_to<const uint16_t>(),
 								block_size,
 								cache.mask_memory_pool,
+								params.binary_greedy_meshing,
 								Color8::from_u16
 						);
 					} else {
@@ -840,6 +1173,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 								raw_channel.reinterpret_cast_to<const uint32_t>(),
 								block_size,
 								cache.mask_memory_pool,
+								params.binary_greedy_meshing,
 								Color8::from_u32
 						);
 					} else {
@@ -854,12 +1188,12 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 
 				default:
 					ERR_PRINT("Unsupported voxel depth");
-					return;
+					return false;
 			}
 			break;
 
 		case COLOR_MESHER_PALETTE: {
-			ERR_FAIL_COND_MSG(params.palette.is_null(), "Palette mode is used but no palette was specified");
+			ERR_FAIL_COND_V_MSG(params.palette.is_null(), false, "Palette mode is used but no palette was specified");
 
 			struct GetColorFromPalette {
 				VoxelColorPalette &palette;
@@ -884,7 +1218,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 									cache.mask_memory_pool,
 									get_color_from_palette
 							);
-							atlas_image =
+							out_atlas_image =
 									make_greedy_atlas(cache.greedy_atlas_data, to_span(cache.arrays_per_material));
 						} else {
 							build_voxel_mesh_as_greedy_cubes(
@@ -892,6 +1226,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 									raw_channel,
 									block_size,
 									cache.mask_memory_pool,
+									params.binary_greedy_meshing,
 									get_color_from_palette
 							);
 						}
@@ -909,6 +1244,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 								raw_channel.reinterpret_cast_to<const uint16_t>(),
 								block_size,
 								cache.mask_memory_pool,
+								params.binary_greedy_meshing,
 								get_color_from_palette
 						);
 					} else {
@@ -923,12 +1259,12 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 
 				default:
 					ERR_PRINT("Unsupported voxel depth");
-					return;
+					return false;
 			}
 		} break;
 
 		case COLOR_SHADER_PALETTE: {
-			ERR_FAIL_COND_MSG(params.palette.is_null(), "Palette mode is used but no palette was specified");
+			ERR_FAIL_COND_V_MSG(params.palette.is_null(), false, "Palette mode is used but no palette was specified");
 
 			struct GetIndexFromPalette {
 				VoxelColorPalette &palette;
@@ -947,6 +1283,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 								raw_channel,
 								block_size,
 								cache.mask_memory_pool,
+								params.binary_greedy_meshing,
 								get_index_from_palette
 						);
 					} else {
@@ -963,6 +1300,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 								raw_channel.reinterpret_cast_to<const uint16_t>(),
 								block_size,
 								cache.mask_memory_pool,
+								params.binary_greedy_meshing,
 								get_index_from_palette
 						);
 					} else {
@@ -977,7 +1315,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 
 				default:
 					ERR_PRINT("Unsupported voxel depth");
-					return;
+					return false;
 			}
 		} break;
 
@@ -986,6 +1324,174 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 			break;
 	}
 
+	return true;
+}
+
+bool VoxelMesherCubes::build_arrays_in_sections(
+		Cache &cache,
+		SectionCache &section_cache,
+		const VoxelBuffer &voxels,
+		const Box3i dirty_box,
+		const Parameters &params
+) {
+	ZN_PROFILE_SCOPE();
+	const int channel = VoxelBuffer::CHANNEL_COLOR;
+
+	const Vector3i padding = Vector3iUtil::create(PADDING);
+	const Vector3i inner_size = voxels.get_size() - padding * 2;
+	ERR_FAIL_COND_V(inner_size.x < 0 || inner_size.y < 0 || inner_size.z < 0, false);
+
+	const Vector3i section_grid_size = math::ceildiv(inner_size, INCREMENTAL_SECTION_SIZE);
+	section_cache.sections.resize(Vector3iUtil::get_volume_u64(section_grid_size));
+
+	// Faces between a voxel and its neighbors can change
+	const Box3i padded_dirty_box = dirty_box.padded(1);
+	const bool has_dirty_voxels = !dirty_box.is_empty();
+
+	VoxelBuffer section_voxels(VoxelBuffer::ALLOCATOR_POOL);
+	Ref<Image> unused_atlas_image;
+
+	unsigned int section_index = 0;
+	Vector3i section_pos;
+	for (section_pos.z = 0; section_pos.z < section_grid_size.z; ++section_pos.z) {
+		for (section_pos.x = 0; section_pos.x < section_grid_size.x; ++section_pos.x) {
+			for (section_pos.y = 0; section_pos.y < section_grid_size.y; ++section_pos.y) {
+				SectionCache::Section &section = section_cache.sections[section_index];
+				++section_index;
+
+				const Box3i section_box =
+						Box3i(section_pos * INCREMENTAL_SECTION_SIZE, Vector3iUtil::create(INCREMENTAL_SECTION_SIZE))
+								.clipped(inner_size);
+
+				if (section.valid && !(has_dirty_voxels && section_box.intersects(padded_dirty_box))) {
+					continue;
+				}
+
+				// Mesh a copy of the voxels of the section and their padding
+				section_voxels.create(section_box.size + padding * 2);
+				section_voxels.set_channel_depth(channel, voxels.get_channel_depth(channel));
+				section_voxels.copy_channel_from(
+						voxels,
+						section_box.position,
+						section_box.position + section_box.size + padding * 2,
+						Vector3i(),
+						channel
+				);
+
+				for (Arrays &arrays : cache.arrays_per_material) {
+					arrays.clear();
+				}
+				if (!build_arrays(cache, section_voxels, params, unused_atlas_image)) {
+					return false;
+				}
+
+				for (Arrays &arrays : section.arrays_per_material) {
+					arrays.clear();
+				}
+				append_section_faces(
+						section.arrays_per_material,
+						cache.arrays_per_material,
+						section_box.position,
+						section_box.size,
+						inner_size
+				);
+
+				section.valid = true;
+			}
+		}
+	}
+
+	for (Arrays &arrays : cache.arrays_per_material) {
+		arrays.clear();
+	}
+	for (const SectionCache::Section &section : section_cache.sections) {
+		for (unsigned int material_index = 0; material_index < MATERIAL_COUNT; ++material_index) {
+			const Arrays &src = section.arrays_per_material[material_index];
+			Arrays &dst = cache.arrays_per_material[material_index];
+
+			const int index_offset = dst.positions.size();
+			append_array(dst.positions, src.positions);
+			append_array(dst.normals, src.normals);
+			append_array(dst.colors, src.colors);
+			for (const int i : src.indices) {
+				dst.indices.push_back(index_offset + i);
+			}
+		}
+	}
+
+	return true;
+}
+
+void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Input &input) {
+	ZN_PROFILE_SCOPE();
+	const int channel = VoxelBuffer::CHANNEL_COLOR;
+	Cache &cache = get_tls_cache();
+
+	for (unsigned int i = 0; i < cache.arrays_per_material.size(); ++i) {
+		Arrays &a = cache.arrays_per_material[i];
+		a.clear();
+	}
+
+	const VoxelBuffer &voxels = input.voxels;
+
+	// Iterate 3D padded data to extract voxel faces.
+	// This is the most intensive job in this class, so all required data should be as fit as possible.
+
+	// The buffer we receive MUST be dense (i.e not compressed, and channels allocated).
+	// That means we can use raw pointers to voxel data inside instead of using the higher-level getters,
+	// and then save a lot of time.
+
+	if (voxels.get_channel_compression(channel) == VoxelBuffer::COMPRESSION_UNIFORM) {
+		// All voxels have the same type.
+		// If it's all air, nothing to do. If it's all cubes, nothing to do either.
+		if (input.incremental_cache != nullptr) {
+			// Cached sections don't match the voxels anymore
+			input.incremental_cache->reset();
+		}
+		return;
+
+	} else if (voxels.get_channel_compression(channel) != VoxelBuffer::COMPRESSION_NONE) {
+		// No other form of compression is allowed
+		ERR_PRINT("VoxelMesherCubes received unsupported voxel compression");
+		return;
+	}
+
+	Parameters params;
+	{
+		RWLockRead rlock(_parameters_lock);
+		params = _parameters;
+	}
+	// Note, we don't lock the palette because its data has fixed-size
+
+	Ref<Image> atlas_image;
+
+	// Colors stored in a texture are packed in an atlas made for the whole block, so they can't be meshed in sections
+	if (input.incremental_cache != nullptr && !params.store_colors_in_texture) {
+		SectionCache::Settings settings;
+		settings.block_size = voxels.get_size();
+		settings.palette = params.palette.ptr();
+		settings.color_mode = params.color_mode;
+		settings.greedy_meshing = params.greedy_meshing;
+
+		std::shared_ptr<VoxelMesher::IncrementalCache> &cache_ptr = *input.incremental_cache;
+		if (cache_ptr == nullptr || cache_ptr->mesher != this) {
+			cache_ptr = make_shared_instance<SectionCache>();
+			cache_ptr->mesher = this;
+		}
+		SectionCache &section_cache = static_cast<SectionCache &>(*cache_ptr);
+		if (!(section_cache.settings == settings)) {
+			section_cache.settings = settings;
+			section_cache.sections.clear();
+		}
+
+		if (!build_arrays_in_sections(cache, section_cache, voxels, input.dirty_box, params)) {
+			return;
+		}
+
+	} else if (!build_arrays(cache, voxels, params, atlas_image)) {
+		return;
+	}
+
 	if (input.lod_index > 0) {
 		// TODO This is very crude LOD, there will be cracks at the borders.
 		// One way would be to not cull faces on chunk borders if any neighbor face is air
@@ -1065,6 +1571,11 @@ bool VoxelMesherCubes::is_greedy_meshing_enabled() const {
 	return _parameters.greedy_meshing;
 }
 
+void VoxelMesherCubes::set_binary_greedy_meshing_enabled(bool enable) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.binary_greedy_meshing = enable;
+}
+
 void VoxelMesherCubes::set_palette(Ref<VoxelColorPalette> palette) {
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.palette = palette;
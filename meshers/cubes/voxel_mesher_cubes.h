@@ -45,6 +45,10 @@ public:
 	void set_greedy_meshing_enabled(bool enable);
 	bool is_greedy_meshing_enabled() const;
 
+	// Greedy meshing uses bitmasks on blocks up to 64 voxels wide. Turning this off forces the scanning path, which
+	// produces the same quads. Not exposed, only used to compare both.
+	void set_binary_greedy_meshing_enabled(bool enable);
+
 	void set_color_mode(ColorMode mode);
 	ColorMode get_color_mode() const;
 
@@ -124,6 +128,7 @@ private:
 		ColorMode color_mode = COLOR_RAW;
 		Ref<VoxelColorPalette> palette;
 		bool greedy_meshing = true;
+		bool binary_greedy_meshing = true;
 		bool store_colors_in_texture = false;
 	};
 
@@ -141,6 +146,26 @@ private:
 
 	// Work cache
 	static Cache &get_tls_cache();
+
+	class SectionCache;
+
+	// Meshes voxels into the arrays of `cache`, which must be empty. Returns false if an error occurred.
+	static bool build_arrays(
+			Cache &cache,
+			const VoxelBuffer &voxels,
+			const Parameters &params,
+			Ref<Image> &out_atlas_image
+	);
+
+	// Same as `build_arrays`, but meshes sections of the block separately and keeps them in `section_cache`, so only
+	// sections near voxels that changed in `dirty_box` have to be meshed again.
+	static bool build_arrays_in_sections(
+			Cache &cache,
+			SectionCache &section_cache,
+			const VoxelBuffer &voxels,
+			const Box3i dirty_box,
+			const Parameters &params
+	);
 };
 
 } // namespace zylann::voxel
@@ -60,7 +60,9 @@ CubicAreaInfo get_cubic_area_info_from_size(unsigned int size) {
 // Takes a list of blocks and interprets it as a cube of blocks centered around the area we want to create a mesh from.
 // Voxels from central blocks are copied, and part of side blocks are also copied so we get a temporary buffer
 // which includes enough neighbors for the mesher to avoid doing bound checks.
-void copy_block_and_neighbors(
+// Returns false if `wait_for_lock` is false and the area is currently locked for writing, in which case nothing is
+// copied.
+bool copy_block_and_neighbors(
 		Span<std::shared_ptr<VoxelBuffer>> blocks,
 		VoxelBuffer &dst,
 		int min_padding,
@@ -71,7 +73,8 @@ void copy_block_and_neighbors(
 		uint8_t lod_index,
 		Vector3i mesh_block_pos,
 		StdVector<Box3i> *out_boxes_to_generate,
-		Vector3i *out_origin_in_voxels
+		Vector3i *out_origin_in_voxels,
+		bool wait_for_lock
 ) {
 	ZN_DSTACK();
 	ZN_PROFILE_SCOPE();
@@ -81,13 +84,15 @@ void copy_block_and_neighbors(
 
 	// Determine size of the cube of blocks
 	const CubicAreaInfo area_info = get_cubic_area_info_from_size(blocks.size());
-	ERR_FAIL_COND(!area_info.is_valid());
+	ERR_FAIL_COND_V(!area_info.is_valid(), true);
 
 	std::shared_ptr<VoxelBuffer> &central_buffer = blocks[area_info.anchor_buffer_index];
-	ERR_FAIL_COND_MSG(central_buffer == nullptr && generator.is_null(), "Central buffer must be valid");
+	ERR_FAIL_COND_V_MSG(central_buffer == nullptr && generator.is_null(), true, "Central buffer must be valid");
 	if (central_buffer != nullptr) {
-		ERR_FAIL_COND_MSG(
-				Vector3iUtil::all_members_equal(central_buffer->get_size()) == false, "Central buffer must be cubic"
+		ERR_FAIL_COND_V_MSG(
+				Vector3iUtil::all_members_equal(central_buffer->get_size()) == false,
+				true,
+				"Central buffer must be cubic"
 		);
 	}
 	const int data_block_size = voxel_data.get_block_size();
@@ -132,8 +137,12 @@ void copy_block_and_neighbors(
 				voxel_data.get_spatial_lock(lod_index),
 				BoxBounds3i(
 						data_block_pos0 - Vector3i(1, 1, 1), data_block_pos0 + Vector3iUtil::create(area_info.edge_size)
-				)
+				),
+				wait_for_lock
 		);
+		if (!srlock.locked) {
+			return false;
+		}
 
 		// Using ZXY as convention to reconstruct positions with thread locking consistency
 		unsigned int block_index = 0;
@@ -228,6 +237,8 @@ void copy_block_and_neighbors(
 			}
 		}
 	}
+
+	return true;
 }
 
 } // namespace
@@ -262,9 +273,7 @@ Ref<ArrayMesh> build_mesh(
 			mesh.instantiate();
 		}
 
-		// TODO Use `add_surface`, it's about 20% faster after measuring in Tracy (though we may see if Godot 4 expects
-		// the same)
-		mesh->add_surface_from_arrays(primitive, arrays, Array(), Dictionary(), flags);
+		VoxelMesher::add_surface_to_mesh(**mesh, surface, primitive, flags);
 
 		mesh_material_indices.push_back(surface.material_index);
 	}
@@ -318,13 +327,14 @@ int MeshBlockTask::debug_get_running_count() {
 	return g_debug_mesh_tasks_count;
 }
 
-void MeshBlockTask::run(zylann::ThreadedTaskContext &ctx) {
+IResumableThreadedTask::StageResult MeshBlockTask::run_stage(uint8_t stage, zylann::ThreadedTaskContext &ctx) {
 	ZN_DSTACK();
 	ZN_PROFILE_SCOPE();
 	ZN_ASSERT(meshing_dependency != nullptr);
 #ifdef DEBUG_ENABLED
-	ZN_ASSERT_RETURN_MSG(
+	ZN_ASSERT_RETURN_V_MSG(
 			meshing_dependency->mesher.is_valid(),
+			STAGE_DONE,
 			"Meshing task started without a mesher. Maybe missing on the terrain node?"
 	);
 #endif
@@ -339,38 +349,50 @@ void MeshBlockTask::run(zylann::ThreadedTaskContext &ctx) {
 	// end up with a huge surface at the bottom facing down, since the default for chunks outside bounds is air.
 	// We would have to somehow expose a way to set what these areas default to as well...
 
+	switch (stage) {
+		case STAGE_GATHER_VOXELS: {
+			ZN_ASSERT(data != nullptr);
+			const VoxelFormat format = data->get_format();
+			format.configure_buffer(_voxels);
+
+			// Rather than holding a worker thread while the area is being edited, give it back and retry later
+			const bool wait_for_lock = get_yield_duration_usec(stage) >= MAX_SPATIAL_LOCK_YIELD_DURATION_USEC;
+
 #ifdef VOXEL_ENABLE_GPU
-	if (_stage == 0)
+			if (block_generation_use_gpu) {
+				return gather_voxels_gpu(wait_for_lock);
+			}
 #endif
-	{
-		ZN_ASSERT(data != nullptr);
-		const VoxelFormat format = data->get_format();
-		format.configure_buffer(_voxels);
-	}
+			if (!gather_voxels_cpu(wait_for_lock)) {
+				return STAGE_YIELD;
+			}
+			set_next_stage(STAGE_BUILD_MESH);
+			return STAGE_CONTINUE;
+		}
 
 #ifdef VOXEL_ENABLE_GPU
-	if (block_generation_use_gpu) {
-		if (_stage == 0) {
-			gather_voxels_gpu(ctx);
-		}
-		if (_stage == 1) {
+		case STAGE_CONVERT_GPU_VOXELS:
+			if (are_gpu_results_discarded()) {
+				// Finish as dropped
+				return STAGE_DONE;
+			}
 			GenerateBlockGPUTaskResult::convert_to_voxel_buffer(to_span(_gpu_generation_results), _voxels);
-			_stage = 2;
-		}
-		if (_stage == 2) {
-			build_mesh();
-		}
-	} else
+			return STAGE_CONTINUE;
 #endif
-	{
-		gather_voxels_cpu();
-		build_mesh();
+
+		case STAGE_BUILD_MESH:
+			build_mesh();
+			return STAGE_DONE;
+
+		default:
+			ZN_PRINT_ERROR("Unexpected stage");
+			return STAGE_DONE;
 	}
 }
 
 #ifdef VOXEL_ENABLE_GPU
 
-void MeshBlockTask::gather_voxels_gpu(zylann::ThreadedTaskContext &ctx) {
+IResumableThreadedTask::StageResult MeshBlockTask::gather_voxels_gpu(bool wait_for_lock) {
 	ZN_ASSERT(meshing_dependency != nullptr);
 	ZN_ASSERT(data != nullptr);
 
@@ -381,7 +403,7 @@ void MeshBlockTask::gather_voxels_gpu(zylann::ThreadedTaskContext &ctx) {
 	StdVector<Box3i> boxes_to_generate;
 	Vector3i origin_in_voxels;
 
-	copy_block_and_neighbors(
+	const bool copied = copy_block_and_neighbors(
 			to_span(blocks, blocks_count),
 			_voxels,
 			min_padding,
@@ -392,25 +414,29 @@ void MeshBlockTask::gather_voxels_gpu(zylann::ThreadedTaskContext &ctx) {
 			lod_index,
 			mesh_block_position,
 			&boxes_to_generate,
-			&origin_in_voxels
+			&origin_in_voxels,
+			wait_for_lock
 	);
+	if (!copied) {
+		return STAGE_YIELD;
+	}
 
 	if (boxes_to_generate.size() == 0) {
-		_stage = 2;
-		return;
+		set_next_stage(STAGE_BUILD_MESH);
+		return STAGE_CONTINUE;
 	}
 
 	Ref<VoxelGenerator> generator = meshing_dependency->generator;
-	ERR_FAIL_COND(generator.is_null());
+	ERR_FAIL_COND_V(generator.is_null(), STAGE_DONE);
 
 	VoxelGenerator::VoxelQueryData generator_query{ _voxels, origin_in_voxels, lod_index };
 	if (generator->generate_broad_block(generator_query)) {
-		_stage = 2;
-		return;
+		set_next_stage(STAGE_BUILD_MESH);
+		return STAGE_CONTINUE;
 	}
 
 	std::shared_ptr<ComputeShader> generator_shader = generator->get_block_rendering_shader();
-	ERR_FAIL_COND(generator_shader == nullptr);
+	ERR_FAIL_COND_V(generator_shader == nullptr, STAGE_DONE);
 
 	GenerateBlockGPUTask *gpu_task = ZN_NEW(GenerateBlockGPUTask);
 	gpu_task->boxes_to_generate = std::move(boxes_to_generate);
@@ -429,20 +455,20 @@ void MeshBlockTask::gather_voxels_gpu(zylann::ThreadedTaskContext &ctx) {
 	gpu_task->modifiers = std::move(modifiers_shader_data);
 #endif
 
-	ctx.status = ThreadedTaskContext::STATUS_TAKEN_OUT;
+	set_next_stage(STAGE_CONVERT_GPU_VOXELS);
 
 	// Start GPU task, we'll continue meshing after it
 	VoxelEngine::get_singleton().push_gpu_task(gpu_task);
+	return STAGE_SUSPEND;
 }
 
 void MeshBlockTask::set_gpu_results(StdVector<GenerateBlockGPUTaskResult> &&results) {
 	_gpu_generation_results = std::move(results);
-	_stage = 1;
 }
 
 #endif
 
-void MeshBlockTask::gather_voxels_cpu() {
+bool MeshBlockTask::gather_voxels_cpu(bool wait_for_lock) {
 	ZN_ASSERT(meshing_dependency != nullptr);
 	ZN_ASSERT(data != nullptr);
 
@@ -450,7 +476,7 @@ void MeshBlockTask::gather_voxels_cpu() {
 	const unsigned int min_padding = mesher->get_minimum_padding();
 	const unsigned int max_padding = mesher->get_maximum_padding();
 
-	copy_block_and_neighbors(
+	const bool copied = copy_block_and_neighbors(
 			to_span(blocks, blocks_count),
 			_voxels,
 			min_padding,
@@ -461,8 +487,12 @@ void MeshBlockTask::gather_voxels_cpu() {
 			lod_index,
 			mesh_block_position,
 			nullptr,
-			nullptr
+			nullptr,
+			wait_for_lock
 	);
+	if (!copied) {
+		return false;
+	}
 
 	// Could cache generator data from here if it was safe to write into the map
 	/*if (data != nullptr && cache_generated_blocks) {
@@ -496,6 +526,8 @@ void MeshBlockTask::gather_voxels_cpu() {
 			}
 		}
 	}*/
+
+	return true;
 }
 
 void MeshBlockTask::build_mesh() {
@@ -513,7 +545,10 @@ void MeshBlockTask::build_mesh() {
 		collision_hint,
 		lod_hint,
 		// TODO Gathering detail texture information is not always necessary
-		true // detail_texture_hint
+		true, // detail_texture_hint
+		true, // packed_surface_hint
+		incremental_meshing ? &incremental_cache : nullptr,
+		dirty_box
 	};
 	mesher->build(_surfaces_output, input);
 
@@ -568,6 +603,9 @@ void MeshBlockTask::build_mesh() {
 		nm_task->output_textures = detail_textures;
 		nm_task->detail_texture_settings = detail_texture_settings;
 		nm_task->priority_dependency = priority_dependency;
+		if (cancellation_token.is_valid()) {
+			nm_task->cancellation_token = cancellation_token.create_child();
+		}
 #ifdef VOXEL_ENABLE_GPU
 		nm_task->use_gpu =
 				(detail_texture_use_gpu && nm_task->generator.is_valid() && nm_task->generator->supports_shaders());
@@ -608,7 +646,16 @@ TaskPriority MeshBlockTask::get_priority() {
 	return p;
 }
 
+int MeshBlockTask::get_preferred_numa_node() const {
+	return data != nullptr ? data->get_numa_node_hint() : -1;
+}
+
 bool MeshBlockTask::is_cancelled() {
+#ifdef VOXEL_ENABLE_GPU
+	if (are_gpu_results_discarded()) {
+		return true;
+	}
+#endif
 	if (cancellation_token.is_valid()) {
 		return cancellation_token.is_cancelled();
 	}
@@ -639,6 +686,8 @@ void MeshBlockTask::apply_result() {
 			o.mesh_material_indices = std::move(_mesh_material_indices);
 			o.has_mesh_resource = _has_mesh_resource;
 			o.visual_was_required = require_visual;
+			o.incremental_cache = std::move(incremental_cache);
+			o.mesh_update_id = mesh_update_id;
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 			o.detail_textures = _detail_textures;
 #endif
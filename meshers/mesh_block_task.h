@@ -9,7 +9,7 @@
 #include "../util/containers/std_vector.h"
 #include "../util/godot/classes/array_mesh.h"
 #include "../util/tasks/cancellation_token.h"
-#include "../util/tasks/threaded_task.h"
+#include "../util/tasks/resumable_threaded_task.h"
 
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 #include "../engine/detail_rendering/detail_rendering.h"
@@ -28,7 +28,7 @@ class MeshBlockTask
 #ifdef VOXEL_ENABLE_GPU
 		: public IGeneratingVoxelsThreadedTask
 #else
-		: public IThreadedTask
+		: public IResumableThreadedTask
 #endif
 {
 public:
@@ -39,9 +39,9 @@ public:
 		return "MeshBlock";
 	}
 
-	void run(ThreadedTaskContext &ctx) override;
 	TaskPriority get_priority() override;
 	bool is_cancelled() override;
+	int get_preferred_numa_node() const override;
 	void apply_result() override;
 
 #ifdef VOXEL_ENABLE_GPU
@@ -79,20 +79,38 @@ public:
 #endif
 	Ref<VoxelGenerator> detail_texture_generator_override;
 	TaskCancellationToken cancellation_token;
+	// If true, the mesher may only re-mesh parts of the block near `dirty_box`, using what it kept in
+	// `incremental_cache` from the previous update. The cache is returned with the result.
+	bool incremental_meshing = false;
+	std::shared_ptr<VoxelMesher::IncrementalCache> incremental_cache;
+	// Voxels that changed since `incremental_cache` was filled, relative to the block
+	Box3i dirty_box;
+	// Returned with the result
+	uint32_t mesh_update_id = 0;
+
+protected:
+	StageResult run_stage(uint8_t stage, ThreadedTaskContext &ctx) override;
 
 private:
+	enum Stage : uint8_t {
+		STAGE_GATHER_VOXELS = 0,
+		STAGE_CONVERT_GPU_VOXELS,
+		STAGE_BUILD_MESH,
+	};
+
+	// How long gathering voxels can keep being postponed because the area is locked for writing, before the task waits
+	// for the lock instead. This prevents edits from occupying worker threads, without starving meshing either.
+	static constexpr uint64_t MAX_SPATIAL_LOCK_YIELD_DURATION_USEC = 4'000;
+
 #ifdef VOXEL_ENABLE_GPU
-	void gather_voxels_gpu(zylann::ThreadedTaskContext &ctx);
+	StageResult gather_voxels_gpu(bool wait_for_lock);
 #endif
-	void gather_voxels_cpu();
+	bool gather_voxels_cpu(bool wait_for_lock);
 	void build_mesh();
 
 	bool _has_run = false;
 	bool _too_far = false;
 	bool _has_mesh_resource = false;
-#ifdef VOXEL_ENABLE_GPU
-	uint8_t _stage = 0;
-#endif
 	VoxelBuffer _voxels;
 	VoxelMesher::Output _surfaces_output;
 	Ref<Mesh> _mesh;
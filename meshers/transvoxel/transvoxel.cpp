@@ -1,8 +1,9 @@
 #include "transvoxel.h"
 #include "../../constants/cube_tables.h"
 #include "../../storage/mixel4.h"
-#include "../../util/godot/core/sort_array.h"
+#include "../../util/containers/std_unordered_map.h"
 #include "../../util/math/conv.h"
+#include "../../util/math/float32x4.h" // For SIMD intrinsics
 #include "../../util/math/funcs.h"
 #include "../../util/profiling.h"
 #include "transvoxel_materials_mixel4.h"
@@ -10,6 +11,8 @@
 #include "transvoxel_materials_single_s4.h"
 #include "transvoxel_tables.cpp"
 
+#include <cstring>
+
 // Quality isn't great so not available for now.
 #ifdef VOXEL_ENABLE_TRANSVOXEL_MATERIAL_SINGLE_S2
 #include "transvoxel_materials_single_s2.h"
@@ -181,6 +184,161 @@ inline float get_isolevel<float>() {
 	return 0.f;
 }
 
+// Gets a bitmask where bit `i` is set if `src[i]` is above the isolevel. `count` must not exceed 64.
+// SIMD paths assume the isolevel is zero.
+template <typename TSdf>
+uint64_t get_above_isolevel_mask(const TSdf *src, const unsigned int count) = delete;
+
+template <>
+uint64_t get_above_isolevel_mask<int8_t>(const int8_t *src, const unsigned int count) {
+	uint64_t mask = 0;
+	unsigned int i = 0;
+#if defined(ZN_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= count; i += 16) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		mask |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, zero))) << i;
+	}
+#elif defined(ZN_SIMD_NEON)
+	static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	const uint8x16_t bits_v = vld1q_u8(bits);
+	for (; i + 16 <= count; i += 16) {
+		const uint8x16_t above = vandq_u8(vcgtq_s8(vld1q_s8(src + i), vdupq_n_s8(0)), bits_v);
+		const uint64_t lo = vaddv_u8(vget_low_u8(above));
+		const uint64_t hi = vaddv_u8(vget_high_u8(above));
+		mask |= (lo | (hi << 8)) << i;
+	}
+#endif
+	for (; i < count; ++i) {
+		mask |= static_cast<uint64_t>(src[i] > get_isolevel<int8_t>()) << i;
+	}
+	return mask;
+}
+
+template <>
+uint64_t get_above_isolevel_mask<int16_t>(const int16_t *src, const unsigned int count) {
+	uint64_t mask = 0;
+	unsigned int i = 0;
+#if defined(ZN_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 8 <= count; i += 8) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		// Comparison results are 0 or -1, packing them to 8-bit keeps that
+		const __m128i above = _mm_packs_epi16(_mm_cmpgt_epi16(v, zero), zero);
+		mask |= static_cast<uint64_t>(_mm_movemask_epi8(above)) << i;
+	}
+#elif defined(ZN_SIMD_NEON)
+	static const uint16_t bits[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+	const uint16x8_t bits_v = vld1q_u16(bits);
+	for (; i + 8 <= count; i += 8) {
+		const uint16x8_t above = vandq_u16(vcgtq_s16(vld1q_s16(src + i), vdupq_n_s16(0)), bits_v);
+		mask |= static_cast<uint64_t>(vaddvq_u16(above)) << i;
+	}
+#endif
+	for (; i < count; ++i) {
+		mask |= static_cast<uint64_t>(src[i] > get_isolevel<int16_t>()) << i;
+	}
+	return mask;
+}
+
+template <>
+uint64_t get_above_isolevel_mask<float>(const float *src, const unsigned int count) {
+	uint64_t mask = 0;
+	unsigned int i = 0;
+#if defined(ZN_SIMD_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4) {
+		mask |= static_cast<uint64_t>(_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(src + i), zero))) << i;
+	}
+#elif defined(ZN_SIMD_NEON)
+	static const uint32_t bits[4] = { 1, 2, 4, 8 };
+	const uint32x4_t bits_v = vld1q_u32(bits);
+	for (; i + 4 <= count; i += 4) {
+		const uint32x4_t above = vandq_u32(vcgtq_f32(vld1q_f32(src + i), vdupq_n_f32(0.f)), bits_v);
+		mask |= static_cast<uint64_t>(vaddvq_u32(above)) << i;
+	}
+#endif
+	for (; i < count; ++i) {
+		mask |= static_cast<uint64_t>(src[i] > get_isolevel<float>()) << i;
+	}
+	return mask;
+}
+
+// Iterates cells of a column along the Y axis, only stopping on those crossing the isolevel.
+// Signs of the 4 columns of voxels touching the cells are gathered into bitmasks, so cells that won't produce any
+// geometry are skipped in bulk. This matters because they are the vast majority.
+template <typename TSdf>
+class ActiveCellColumnIterator {
+public:
+	// Each chunk of cells needs the signs of one more voxel, which has to fit in the same 64-bit mask
+	static constexpr int MAX_CELLS_PER_CHUNK = 63;
+
+	ActiveCellColumnIterator(
+			Span<const TSdf> sdf_data,
+			const unsigned int column_data_index,
+			const unsigned int n100,
+			const unsigned int n001,
+			const int min_y,
+			const int max_y
+	) :
+			_sdf_data(sdf_data),
+			_column_data_index(column_data_index),
+			_n100(n100),
+			_n001(n001),
+			_next_chunk_y(min_y),
+			_max_y(max_y) {}
+
+	bool next(int &out_y) {
+		while (_active_cells == 0) {
+			if (_next_chunk_y >= _max_y) {
+				return false;
+			}
+			load_chunk();
+		}
+		out_y = _chunk_y + math::get_lowest_bit_index_64(_active_cells);
+		// Clear lowest bit
+		_active_cells &= _active_cells - 1;
+		return true;
+	}
+
+private:
+	void load_chunk() {
+		_chunk_y = _next_chunk_y;
+		const unsigned int cell_count = math::min(_max_y - _chunk_y, MAX_CELLS_PER_CHUNK);
+		_next_chunk_y += cell_count;
+
+		const unsigned int data_index = _column_data_index + _chunk_y;
+		const unsigned int voxel_count = cell_count + 1;
+#ifdef DEBUG_ENABLED
+		ZN_ASSERT(data_index + _n100 + _n001 + voxel_count <= _sdf_data.size());
+#endif
+		const TSdf *src = _sdf_data.data() + data_index;
+
+		const uint64_t s000 = get_above_isolevel_mask(src, voxel_count);
+		const uint64_t s100 = get_above_isolevel_mask(src + _n100, voxel_count);
+		const uint64_t s001 = get_above_isolevel_mask(src + _n001, voxel_count);
+		const uint64_t s101 = get_above_isolevel_mask(src + _n100 + _n001, voxel_count);
+
+		// Voxels above or below the isolevel in all 4 columns
+		const uint64_t above = s000 & s100 & s001 & s101;
+		const uint64_t below = ~(s000 | s100 | s001 | s101);
+
+		// A cell has corners at Y and Y+1. It won't produce geometry if all of them are on the same side.
+		const uint64_t uniform_cells = (above & (above >> 1)) | (below & (below >> 1));
+		const uint64_t cells_mask = (uint64_t(1) << cell_count) - 1;
+		_active_cells = ~uniform_cells & cells_mask;
+	}
+
+	Span<const TSdf> _sdf_data;
+	const unsigned int _column_data_index;
+	const unsigned int _n100;
+	const unsigned int _n001;
+	int _next_chunk_y;
+	const int _max_y;
+	int _chunk_y = 0;
+	uint64_t _active_cells = 0;
+};
+
 // This function is template so we avoid branches and checks when sampling voxels
 template <typename TSdf, typename TMaterialProcessor>
 void build_regular_mesh(
@@ -191,7 +349,9 @@ void build_regular_mesh(
 		Cache &cache,
 		MeshArrays &output,
 		StdVector<CellInfo> *cell_info,
-		const float edge_clamp_margin
+		const float edge_clamp_margin,
+		const int cell_z_begin,
+		const int cell_z_end
 ) {
 	ZN_PROFILE_SCOPE();
 
@@ -209,6 +369,9 @@ void build_regular_mesh(
 	// We also reach one voxel further to compute normals, so we adjust the iterated area
 	const Vector3i min_pos = Vector3iUtil::create(MIN_PADDING);
 	const Vector3i max_pos = block_size_with_padding - Vector3iUtil::create(MAX_PADDING);
+	// Only a slab of the block may be polygonized. Cells of its first deck can't reuse vertices of the previous one.
+	const int slab_min_z = min_pos.z + cell_z_begin;
+	const int slab_max_z = math::min(min_pos.z + cell_z_end, max_pos.z);
 
 	// How much to advance in the data array to get neighbor voxels
 	const unsigned int n010 = 1; // Y+1
@@ -219,41 +382,29 @@ void build_regular_mesh(
 	const unsigned int n011 = n010 + n001;
 	const unsigned int n111 = n100 + n010 + n001;
 
-	// Get direct representation of the isolevel (not always zero since we are not using signed integers yet)
-	const TSdf isolevel = get_isolevel<TSdf>();
-
-	// Iterate all cells with padding (expected to be neighbors)
+	// Iterate all cells with padding (expected to be neighbors), in the same order voxels are laid out in memory
+	// (Y is the deepest coordinate).
+	// Cells not crossing the isolevel won't produce any geometry. We must figure this out as fast as possible,
+	// because it will happen a lot.
+	// The chosen comparison here is very important. This relates to case selections where 4 samples
+	// are equal to the isolevel and 4 others are above or below:
+	// In one of these two cases, there has to be a surface to extract, otherwise no surface will be
+	// allowed to appear if it happens to line up with integer coordinates.
+	// If we used `<` instead of `>`, it would appear to work, but would break those edge cases.
+	// `>` is chosen because it must match the comparison we do with case selection (in Transvoxel
+	// it is inverted). See `get_above_isolevel_mask`.
 	Vector3i pos;
-	for (pos.z = min_pos.z; pos.z < max_pos.z; ++pos.z) {
-		for (pos.y = min_pos.y; pos.y < max_pos.y; ++pos.y) {
-			// TODO Optimization: change iteration to be ZXY? (Data is laid out with Y as deepest coordinate)
-			unsigned int data_index =
-					Vector3iUtil::get_zxy_index(Vector3i(min_pos.x, pos.y, pos.z), block_size_with_padding);
-
-			for (pos.x = min_pos.x; pos.x < max_pos.x; ++pos.x, data_index += block_size_with_padding.y) {
-				{
-					// The chosen comparison here is very important. This relates to case selections where 4 samples
-					// are equal to the isolevel and 4 others are above or below:
-					// In one of these two cases, there has to be a surface to extract, otherwise no surface will be
-					// allowed to appear if it happens to line up with integer coordinates.
-					// If we used `<` instead of `>`, it would appear to work, but would break those edge cases.
-					// `>` is chosen because it must match the comparison we do with case selection (in Transvoxel
-					// it is inverted).
-					const bool s = sdf_data[data_index] > isolevel;
-
-					if ( //
-							(sdf_data[data_index + n010] > isolevel) == s &&
-							(sdf_data[data_index + n100] > isolevel) == s &&
-							(sdf_data[data_index + n110] > isolevel) == s &&
-							(sdf_data[data_index + n001] > isolevel) == s &&
-							(sdf_data[data_index + n011] > isolevel) == s &&
-							(sdf_data[data_index + n101] > isolevel) == s &&
-							(sdf_data[data_index + n111] > isolevel) == s) {
-						// Not crossing the isolevel, this cell won't produce any geometry.
-						// We must figure this out as fast as possible, because it will happen a lot.
-						continue;
-					}
-				}
+	for (pos.z = slab_min_z; pos.z < slab_max_z; ++pos.z) {
+		for (pos.x = min_pos.x; pos.x < max_pos.x; ++pos.x) {
+			const unsigned int column_data_index =
+					Vector3iUtil::get_zxy_index(Vector3i(pos.x, 0, pos.z), block_size_with_padding);
+
+			ActiveCellColumnIterator<TSdf> cell_iterator(
+					sdf_data, column_data_index, n100, n001, min_pos.y, max_pos.y
+			);
+
+			while (cell_iterator.next(pos.y)) {
+				const unsigned int data_index = column_data_index + pos.y;
 
 				//    6-------7
 				//   /|      /|
@@ -327,7 +478,7 @@ void build_regular_mesh(
 				// While iterating through the cells in a block, a 3-bit mask is maintained whose bits indicate
 				// whether corresponding bits in a direction code are valid
 				const uint8_t direction_validity_mask = (pos.x > min_pos.x ? 1 : 0) |
-						((pos.y > min_pos.y ? 1 : 0) << 1) | ((pos.z > min_pos.z ? 1 : 0) << 2);
+						((pos.y > min_pos.y ? 1 : 0) << 1) | ((pos.z > slab_min_z ? 1 : 0) << 2);
 
 				const uint8_t regular_cell_class_index = tables::get_regular_cell_class(case_code);
 				const tables::RegularCellData &regular_cell_data =
@@ -595,8 +746,8 @@ void build_regular_mesh(
 					cell_info->push_back(CellInfo{ pos - min_pos, static_cast<uint8_t>(effective_triangle_count) });
 				}
 
-			} // x
-		} // y
+			} // y
+		} // x
 	} // z
 }
 
@@ -1173,7 +1324,9 @@ inline void build_regular_mesh_dispatch_sd(
 		Cache &cache,
 		MeshArrays &output,
 		StdVector<CellInfo> *cell_infos,
-		const float edge_clamp_margin
+		const float edge_clamp_margin,
+		const int cell_z_begin,
+		const int cell_z_end
 ) {
 	Span<const uint8_t> sdf_data_raw;
 	ZN_ASSERT(voxels.get_channel_as_bytes_read_only(sdf_channel, sdf_data_raw) == true);
@@ -1191,7 +1344,9 @@ inline void build_regular_mesh_dispatch_sd(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cell_z_begin,
+					cell_z_end
 			);
 		} break;
 
@@ -1205,7 +1360,9 @@ inline void build_regular_mesh_dispatch_sd(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cell_z_begin,
+					cell_z_end
 			);
 		} break;
 
@@ -1222,7 +1379,9 @@ inline void build_regular_mesh_dispatch_sd(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cell_z_begin,
+					cell_z_end
 			);
 		} break;
 
@@ -1250,7 +1409,9 @@ DefaultTextureIndicesData build_regular_mesh(
 		MeshArrays &output,
 		StdVector<CellInfo> *cell_infos,
 		const float edge_clamp_margin,
-		const bool textures_ignore_air_voxels
+		const bool textures_ignore_air_voxels,
+		const int cell_z_begin,
+		const int cell_z_end
 ) {
 	ZN_PROFILE_SCOPE();
 	// From this point, we expect the buffer to contain allocated data in the relevant channels.
@@ -1272,7 +1433,9 @@ DefaultTextureIndicesData build_regular_mesh(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cell_z_begin,
+					cell_z_end
 			);
 			break;
 
@@ -1308,7 +1471,9 @@ DefaultTextureIndicesData build_regular_mesh(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cell_z_begin,
+					cell_z_end
 			);
 		} break;
 
@@ -1329,7 +1494,9 @@ DefaultTextureIndicesData build_regular_mesh(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cell_z_begin,
+					cell_z_end
 			);
 		} break;
 
@@ -1351,7 +1518,9 @@ DefaultTextureIndicesData build_regular_mesh(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cell_z_begin,
+					cell_z_end
 			);
 		} break;
 #endif
@@ -1364,6 +1533,84 @@ DefaultTextureIndicesData build_regular_mesh(
 	return default_texture_indices;
 }
 
+namespace {
+
+// Vertices two slabs create on their seam are computed from the same samples, so their positions are bit-identical
+inline uint64_t get_seam_vertex_key(const Vector3f position) {
+	uint32_t x;
+	uint32_t y;
+	std::memcpy(&x, &position.x, sizeof(float));
+	std::memcpy(&y, &position.y, sizeof(float));
+	return (static_cast<uint64_t>(x) << 32) | y;
+}
+
+// Texturing data holds packed integers, so it is compared bitwise
+template <typename T>
+inline bool is_same_texturing_data(const StdVector<T> &a, unsigned int ai, const StdVector<T> &b, unsigned int bi) {
+	return a.size() == 0 || std::memcmp(&a[ai], &b[bi], sizeof(T)) == 0;
+}
+
+StdUnorderedMap<uint64_t, int> &get_tls_seam_vertices() {
+	static thread_local StdUnorderedMap<uint64_t, int> tls_seam_vertices;
+	return tls_seam_vertices;
+}
+
+StdVector<int> &get_tls_slab_vertex_remap() {
+	static thread_local StdVector<int> tls_slab_vertex_remap;
+	return tls_slab_vertex_remap;
+}
+
+} // namespace
+
+void append_regular_mesh_slab(MeshArrays &dst, const MeshArrays &src, const float seam_z) {
+	ZN_PROFILE_SCOPE();
+
+	StdUnorderedMap<uint64_t, int> &seam_vertices = get_tls_seam_vertices();
+	seam_vertices.clear();
+	for (unsigned int vi = 0; vi < dst.vertices.size(); ++vi) {
+		const Vector3f position = dst.vertices[vi];
+		if (position.z == seam_z) {
+			// Like vertex reuse, the first vertex created at a given position wins
+			seam_vertices.emplace(get_seam_vertex_key(position), vi);
+		}
+	}
+
+	StdVector<int> &remap = get_tls_slab_vertex_remap();
+	remap.resize(src.vertices.size());
+
+	for (unsigned int src_vi = 0; src_vi < src.vertices.size(); ++src_vi) {
+		const Vector3f position = src.vertices[src_vi];
+
+		if (position.z == seam_z) {
+			auto it = seam_vertices.find(get_seam_vertex_key(position));
+			if (it != seam_vertices.end()) {
+				const unsigned int dst_vi = it->second;
+				if (is_same_texturing_data(src.texturing_data_1f32, src_vi, dst.texturing_data_1f32, dst_vi) &&
+					is_same_texturing_data(src.texturing_data_2f32, src_vi, dst.texturing_data_2f32, dst_vi)) {
+					remap[src_vi] = dst_vi;
+					continue;
+				}
+			}
+		}
+
+		remap[src_vi] = dst.vertices.size();
+		dst.vertices.push_back(position);
+		dst.normals.push_back(src.normals[src_vi]);
+		dst.lod_data.push_back(src.lod_data[src_vi]);
+		if (src.texturing_data_1f32.size() > 0) {
+			dst.texturing_data_1f32.push_back(src.texturing_data_1f32[src_vi]);
+		}
+		if (src.texturing_data_2f32.size() > 0) {
+			dst.texturing_data_2f32.push_back(src.texturing_data_2f32[src_vi]);
+		}
+	}
+
+	dst.indices.reserve(dst.indices.size() + src.indices.size());
+	for (const int32_t src_vi : src.indices) {
+		dst.indices.push_back(remap[src_vi]);
+	}
+}
+
 template <typename TMaterialProcessor>
 inline void build_transition_mesh_dispatch_sd(
 		const VoxelBuffer &voxels,
@@ -53,6 +53,33 @@ struct LodAttrib {
 	uint8_t _pad;
 };
 
+// Smaller version of `LodAttrib` sent to the GPU when vertex compression is enabled (8 bytes instead of 16).
+// Bits are arranged so neither of the two words can be a NaN when reinterpreted as a float.
+struct LodAttribCompact {
+	// Same bits as the last 4 bytes of `LodAttrib`, with the LOD index in bits 24 to 28.
+	uint32_t masks;
+	// Offset from the vertex to its secondary position, divided by 2^lod_index (which is the maximum offset), and
+	// stored as 3 10-bit values in 0..1022 where 511 is zero.
+	uint32_t secondary_offset;
+};
+
+inline LodAttribCompact pack_lod_attrib(const LodAttrib &attrib, const Vector3f position, const uint8_t lod_index) {
+	LodAttribCompact packed;
+	packed.masks = attrib.cell_border_mask | (attrib.vertex_border_mask << 8) | (attrib.transition << 16) |
+			((lod_index & 31) << 24);
+	packed.secondary_offset = 511 | (511 << 10) | (511 << 20);
+	if (attrib.cell_border_mask != 0) {
+		// Secondary positions are only meaningful for vertices in border cells
+		const Vector3f offset = (attrib.secondary_position - position) * (511.f / float(1 << lod_index));
+		packed.secondary_offset = 0;
+		for (unsigned int i = 0; i < Vector3f::AXIS_COUNT; ++i) {
+			const int q = math::clamp(static_cast<int>(math::floor(offset[i] + 0.5f)), -511, 511) + 511;
+			packed.secondary_offset |= q << (i * 10);
+		}
+	}
+	return packed;
+}
+
 // struct TextureAttrib {
 // 	uint8_t index0;
 // 	uint8_t index1;
@@ -178,9 +205,16 @@ DefaultTextureIndicesData build_regular_mesh(
 		MeshArrays &output,
 		StdVector<CellInfo> *cell_infos,
 		const float edge_clamp_margin,
-		const bool textures_ignore_air_voxels
+		const bool textures_ignore_air_voxels,
+		// Range of cells to polygonize along Z, so large blocks can be split in slabs built separately
+		const int cell_z_begin,
+		const int cell_z_end
 );
 
+// Appends the regular mesh of a slab to the mesh of the slabs preceding it. Vertices both sides created on the seam
+// (the plane at `seam_z`, in mesh space) are merged, so the result is connected like a mesh built in one go.
+void append_regular_mesh_slab(MeshArrays &dst, const MeshArrays &src, const float seam_z);
+
 void build_transition_mesh(
 		const VoxelBuffer &voxels,
 		const unsigned int sdf_channel,
@@ -21,6 +21,73 @@ struct CellTextureDatas {
 	FixedArray<FixedArray<uint8_t, MAX_TEXTURE_BLENDS>, NVoxels> weights;
 };
 
+// Fast path of `select_textures_4_per_voxel`, when all corners that are not air share the same texture indices.
+// This is expected to be common, since indices usually only change in places where more than 4 textures meet.
+// Returns false if the generic path has to be used.
+template <unsigned int NVoxels, typename WeightSampler_T>
+bool select_textures_4_per_voxel_uniform(
+		CellTextureDatas<NVoxels> &cell_textures,
+		const FixedArray<unsigned int, NVoxels> &voxel_indices,
+		const Span<const uint16_t> indices_data,
+		const WeightSampler_T &weights_sampler,
+		const unsigned int case_code
+) {
+	bool found = false;
+	uint16_t encoded_indices = 0;
+	for (unsigned int ci = 0; ci < voxel_indices.size(); ++ci) {
+		if ((case_code & (1 << ci)) != 0) {
+			continue;
+		}
+		const uint16_t v = indices_data[voxel_indices[ci]];
+		if (!found) {
+			encoded_indices = v;
+			found = true;
+		} else if (v != encoded_indices) {
+			return false;
+		}
+	}
+	if (!found) {
+		return false;
+	}
+
+	const FixedArray<uint8_t, 4> indices = zylann::voxel::mixel4::decode_indices_from_packed_u16(encoded_indices);
+	if (indices[0] == indices[1] || indices[0] == indices[2] || indices[0] == indices[3] || //
+		indices[1] == indices[2] || indices[1] == indices[3] || indices[2] == indices[3]) {
+		// Duplicate indices have to be merged, which the generic path does
+		return false;
+	}
+
+	// Other textures have zero weight so the selection is already known. Only sort indices, keeping track of where
+	// they come from so weights can be read in the same order.
+	FixedArray<uint8_t, MAX_TEXTURE_BLENDS> keys;
+	for (unsigned int i = 0; i < keys.size(); ++i) {
+		keys[i] = (indices[i] << 2) | i;
+	}
+	math::sort(keys[0], keys[1], keys[2], keys[3]);
+
+	for (unsigned int i = 0; i < keys.size(); ++i) {
+		cell_textures.indices[i] = keys[i] >> 2;
+	}
+	cell_textures.packed_indices = pack_bytes(cell_textures.indices);
+
+	for (unsigned int ci = 0; ci < voxel_indices.size(); ++ci) {
+		FixedArray<uint8_t, MAX_TEXTURE_BLENDS> &dst_weights = cell_textures.weights[ci];
+
+		// Skip air voxels
+		if ((case_code & (1 << ci)) != 0) {
+			fill(dst_weights, uint8_t(0));
+			continue;
+		}
+
+		const FixedArray<uint8_t, 4> src_weights = weights_sampler.get_weights(voxel_indices[ci]);
+		for (unsigned int i = 0; i < keys.size(); ++i) {
+			dst_weights[i] = src_weights[keys[i] & 3];
+		}
+	}
+
+	return true;
+}
+
 template <unsigned int NVoxels, typename WeightSampler_T>
 CellTextureDatas<NVoxels> select_textures_4_per_voxel(
 		const FixedArray<unsigned int, NVoxels> &voxel_indices,
@@ -28,21 +95,17 @@ CellTextureDatas<NVoxels> select_textures_4_per_voxel(
 		const WeightSampler_T &weights_sampler,
 		const unsigned int case_code
 ) {
-	// TODO Optimization: this function takes almost half of the time when polygonizing non-empty cells.
-	// I wonder how it can be optimized further?
+	CellTextureDatas<NVoxels> cell_textures;
 
-	struct IndexAndWeight {
-		unsigned int index;
-		unsigned int weight;
-	};
+	if (select_textures_4_per_voxel_uniform(cell_textures, voxel_indices, indices_data, weights_sampler, case_code)) {
+		return cell_textures;
+	}
 
 	FixedArray<FixedArray<uint8_t, MAX_TEXTURES>, NVoxels> cell_texture_weights_temp;
-	FixedArray<IndexAndWeight, MAX_TEXTURES> indexed_weight_sums;
+	FixedArray<uint32_t, MAX_TEXTURES> weight_sums;
+	fill(weight_sums, uint32_t(0));
 
-	// Find 4 most-used indices in voxels
-	for (unsigned int i = 0; i < indexed_weight_sums.size(); ++i) {
-		indexed_weight_sums[i] = IndexAndWeight{ i, 0 };
-	}
+	// Sum weights of each texture in voxels
 	for (unsigned int ci = 0; ci < voxel_indices.size(); ++ci) {
 		// ZN_PROFILE_SCOPE();
 
@@ -62,23 +125,29 @@ CellTextureDatas<NVoxels> select_textures_4_per_voxel(
 
 		for (unsigned int j = 0; j < indices.size(); ++j) {
 			const unsigned int ti = indices[j];
-			indexed_weight_sums[ti].weight += weights[j];
+			weight_sums[ti] += weights[j];
 			weights_temp[ti] = weights[j];
 		}
 	}
-	struct IndexAndWeightComparator {
-		inline bool operator()(const IndexAndWeight &a, const IndexAndWeight &b) const {
-			return a.weight > b.weight;
-		}
-	};
-	SortArray<IndexAndWeight, IndexAndWeightComparator> sorter;
-	sorter.sort(indexed_weight_sums.data(), indexed_weight_sums.size());
 
-	CellTextureDatas<NVoxels> cell_textures;
+	// Find 4 most-used indices in voxels.
+	// Sums are combined with texture indices into keys, so a single integer comparison orders them by weight, then
+	// by lowest index when weights are equal. Keys are then pushed through 4 slots kept in descending order, using
+	// min/max only, which compiles without branches, instead of sorting all 16 textures.
+	FixedArray<uint32_t, MAX_TEXTURE_BLENDS> top_keys;
+	fill(top_keys, uint32_t(0));
+	for (unsigned int ti = 0; ti < weight_sums.size(); ++ti) {
+		uint32_t key = (weight_sums[ti] << 4) | (MAX_TEXTURES - 1 - ti);
+		for (unsigned int i = 0; i < top_keys.size(); ++i) {
+			const uint32_t top_key = top_keys[i];
+			top_keys[i] = math::max(top_key, key);
+			key = math::min(top_key, key);
+		}
+	}
 
 	// Assign indices
 	for (unsigned int i = 0; i < cell_textures.indices.size(); ++i) {
-		cell_textures.indices[i] = indexed_weight_sums[i].index;
+		cell_textures.indices[i] = MAX_TEXTURES - 1 - (top_keys[i] & 0xf);
 	}
 
 	// Sort indices to avoid cases that are ambiguous for blending, like 1,2,3,4 and 2,1,3,4
@@ -253,7 +322,7 @@ struct Processor {
 	}
 };
 
-TextureIndicesData get_texture_indices_data(
+inline TextureIndicesData get_texture_indices_data(
 		const VoxelBuffer &voxels,
 		const unsigned int indices_channel,
 		DefaultTextureIndicesData &out_default_texture_indices_data
@@ -1,4 +1,5 @@
 #include "voxel_mesher_transvoxel.h"
+#include "../../constants/voxel_constants.h"
 #include "../../engine/voxel_engine.h"
 #include "../../generators/voxel_generator.h"
 #include "../../shaders/transvoxel_minimal_shader.h"
@@ -94,21 +95,22 @@ bool VoxelMesherTransvoxel::is_generating_collision_surface() const {
 
 namespace {
 
-void fill_surface_arrays(Array &arrays, const transvoxel::MeshArrays &src) {
+// If `custom_attributes` is false, only vertices, normals and indices are filled.
+// If `compact_lod_data` is true, LOD attributes are sent as `LodAttribCompact` instead of `LodAttrib`.
+void fill_surface_arrays(
+		Array &arrays,
+		const transvoxel::MeshArrays &src,
+		const bool custom_attributes,
+		const bool compact_lod_data,
+		const uint8_t lod_index
+) {
 	PackedVector3Array vertices;
 	PackedVector3Array normals;
-	PackedFloat32Array lod_data; // 4*float32
+	PackedFloat32Array lod_data; // 4*float32, or 2*uint32 as 2*float32 if compact
 	PackedFloat32Array texturing_data; // 2*4*uint8 as 2*float32, or 3*uint8 as 1*float32
 	PackedInt32Array indices;
 
 	copy_to(vertices, to_span_const(src.vertices));
-
-	// raw_copy_to(lod_data, src.lod_data);
-	lod_data.resize(src.lod_data.size() * 4);
-	// Based on the layout, position is first 3 floats, and 4th float is actually a bitmask
-	static_assert(sizeof(transvoxel::LodAttrib) == 16);
-	memcpy(lod_data.ptrw(), src.lod_data.data(), lod_data.size() * sizeof(float));
-
 	copy_to(indices, to_span_const(src.indices));
 
 	arrays.resize(Mesh::ARRAY_MAX);
@@ -117,6 +119,29 @@ void fill_surface_arrays(Array &arrays, const transvoxel::MeshArrays &src) {
 		copy_to(normals, to_span_const(src.normals));
 		arrays[Mesh::ARRAY_NORMAL] = normals;
 	}
+	arrays[Mesh::ARRAY_INDEX] = indices;
+
+	if (!custom_attributes) {
+		return;
+	}
+
+	if (compact_lod_data) {
+		static_assert(sizeof(transvoxel::LodAttribCompact) == 8);
+		lod_data.resize(src.lod_data.size() * 2);
+		float *lod_data_w = lod_data.ptrw();
+		for (unsigned int i = 0; i < src.lod_data.size(); ++i) {
+			const transvoxel::LodAttribCompact attrib =
+					transvoxel::pack_lod_attrib(src.lod_data[i], src.vertices[i], lod_index);
+			memcpy(lod_data_w + i * 2, &attrib, sizeof(attrib));
+		}
+
+	} else {
+		// raw_copy_to(lod_data, src.lod_data);
+		lod_data.resize(src.lod_data.size() * 4);
+		// Based on the layout, position is first 3 floats, and 4th float is actually a bitmask
+		static_assert(sizeof(transvoxel::LodAttrib) == 16);
+		memcpy(lod_data.ptrw(), src.lod_data.data(), lod_data.size() * sizeof(float));
+	}
 
 	if (src.texturing_data_1f32.size() != 0) {
 		texturing_data.resize(src.texturing_data_1f32.size());
@@ -130,9 +155,46 @@ void fill_surface_arrays(Array &arrays, const transvoxel::MeshArrays &src) {
 	}
 
 	arrays[Mesh::ARRAY_CUSTOM0] = lod_data;
-	arrays[Mesh::ARRAY_INDEX] = indices;
 }
 
+#ifdef ZN_GODOT_PACKED_SURFACE_SUPPORTED
+
+bool can_pack_surface(const transvoxel::MeshArrays &src) {
+	// Single-float texturing data is not declared in mesh flags
+	return src.texturing_data_1f32.size() == 0;
+}
+
+void fill_packed_surface(PackedSurface &surface, const transvoxel::MeshArrays &src, const uint64_t mesh_flags) {
+	ZN_PROFILE_SCOPE();
+
+	surface.format = mesh_flags;
+	pack_surface_positions_and_normals(surface, to_span(src.vertices), to_span(src.normals));
+	pack_surface_indices(surface, to_span(src.indices));
+
+	// Custom attributes are interleaved in the attribute buffer
+	const bool has_texturing_data = src.texturing_data_2f32.size() != 0;
+	const unsigned int attribute_stride = sizeof(transvoxel::LodAttrib) + (has_texturing_data ? sizeof(Vector2f) : 0);
+	ZN_ASSERT_RETURN(src.lod_data.size() == src.vertices.size());
+	ZN_ASSERT_RETURN(!has_texturing_data || src.texturing_data_2f32.size() == src.vertices.size());
+
+	surface.format |= Mesh::ARRAY_FORMAT_CUSTOM0;
+	if (has_texturing_data) {
+		surface.format |= Mesh::ARRAY_FORMAT_CUSTOM1;
+	}
+
+	surface.attribute_data.resize(attribute_stride * src.vertices.size());
+	uint8_t *dst = surface.attribute_data.ptrw();
+	for (unsigned int i = 0; i < src.vertices.size(); ++i) {
+		memcpy(dst, &src.lod_data[i], sizeof(transvoxel::LodAttrib));
+		if (has_texturing_data) {
+			memcpy(dst + sizeof(transvoxel::LodAttrib), &src.texturing_data_2f32[i], sizeof(Vector2f));
+		}
+		dst += attribute_stride;
+	}
+}
+
+#endif
+
 template <typename T>
 void remap_vertex_array(
 		const StdVector<T> &src_data,
@@ -193,6 +255,12 @@ void simplify(
 		lod_indices.resize(lod_index_count);
 	}
 
+	// Reorder triangles so vertices are more likely to be found in the post-transform cache. Vertices are then
+	// reordered in the same order they are used, so they are fetched more linearly.
+	zylannmeshopt::meshopt_optimizeVertexCache(
+			lod_indices.data(), lod_indices.data(), lod_indices.size(), src_mesh.vertices.size()
+	);
+
 	// Produce output
 
 	Array surface;
@@ -222,6 +290,170 @@ void simplify(
 	);
 }
 
+// Regular meshes of large blocks can be built in slabs along Z, using threads of the pool that would otherwise be idle.
+// The thread building the block does its share and then picks up slabs no other thread has started, so it never waits
+// for tasks still sitting in the queue.
+struct RegularMeshSlabs {
+	// In cells. Thinner slabs would not be worth the cost of scheduling and stitching them.
+	static constexpr int MIN_SLAB_SIZE = 16;
+	static constexpr unsigned int MAX_SLABS = 8;
+
+	struct Slab {
+		transvoxel::MeshArrays mesh_arrays;
+		StdVector<transvoxel::CellInfo> cell_infos;
+		int cell_z_begin = 0;
+		int cell_z_end = 0;
+		// Set by whichever thread gets to build the slab first
+		std::atomic_bool taken = { false };
+	};
+
+	// Only accessed by threads that took a slab, which the thread building the block waits for
+	const VoxelBuffer *voxels = nullptr;
+	uint32_t lod_index = 0;
+	transvoxel::TexturingMode texturing_mode = transvoxel::TEXTURES_NONE;
+	float edge_clamp_margin = 0.f;
+	bool textures_ignore_air_voxels = false;
+	bool cell_infos_enabled = false;
+
+	FixedArray<Slab, MAX_SLABS> slabs;
+	unsigned int slab_count = 0;
+	// Posted each time a task completes a slab
+	Semaphore semaphore;
+
+	void build_slab(Slab &slab) {
+		static thread_local transvoxel::Cache tls_cache;
+		transvoxel::build_regular_mesh(
+				*voxels,
+				VoxelBuffer::CHANNEL_SDF,
+				lod_index,
+				texturing_mode,
+				tls_cache,
+				slab.mesh_arrays,
+				cell_infos_enabled ? &slab.cell_infos : nullptr,
+				edge_clamp_margin,
+				textures_ignore_air_voxels,
+				slab.cell_z_begin,
+				slab.cell_z_end
+		);
+	}
+};
+
+class RegularMeshSlabTask : public IThreadedTask {
+public:
+	RegularMeshSlabTask(std::shared_ptr<RegularMeshSlabs> slabs, unsigned int slab_index) :
+			_slabs(slabs), _slab_index(slab_index) {}
+
+	void run(ThreadedTaskContext &ctx) override {
+		RegularMeshSlabs::Slab &slab = _slabs->slabs[_slab_index];
+		if (slab.taken.exchange(true)) {
+			// The thread building the block got to it first
+			return;
+		}
+		_slabs->build_slab(slab);
+		_slabs->semaphore.post();
+	}
+
+	const char *get_debug_name() const override {
+		return "TransvoxelSlab";
+	}
+
+private:
+	std::shared_ptr<RegularMeshSlabs> _slabs;
+	unsigned int _slab_index;
+};
+
+unsigned int get_regular_mesh_slab_count(const VoxelBuffer &voxels) {
+	const int block_size_z = voxels.get_size().z - transvoxel::MIN_PADDING - transvoxel::MAX_PADDING;
+	const unsigned int max_slab_count = math::min(
+			static_cast<unsigned int>(block_size_z / RegularMeshSlabs::MIN_SLAB_SIZE), RegularMeshSlabs::MAX_SLABS
+	);
+	if (max_slab_count < 2) {
+		return 1;
+	}
+	// Only split if other threads have nothing to do, so throughput doesn't suffer when many blocks are pending
+	return math::min(max_slab_count, VoxelEngine::get_singleton().get_idle_thread_count() + 1);
+}
+
+transvoxel::DefaultTextureIndicesData build_regular_mesh_in_slabs(
+		const VoxelBuffer &voxels,
+		const uint32_t lod_index,
+		const transvoxel::TexturingMode texturing_mode,
+		const float edge_clamp_margin,
+		const bool textures_ignore_air_voxels,
+		const unsigned int slab_count,
+		transvoxel::Cache &cache,
+		transvoxel::MeshArrays &output,
+		StdVector<transvoxel::CellInfo> *cell_infos
+) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT(slab_count >= 2 && slab_count <= RegularMeshSlabs::MAX_SLABS);
+
+	std::shared_ptr<RegularMeshSlabs> slabs = make_shared_instance<RegularMeshSlabs>();
+	slabs->voxels = &voxels;
+	slabs->lod_index = lod_index;
+	slabs->texturing_mode = texturing_mode;
+	slabs->edge_clamp_margin = edge_clamp_margin;
+	slabs->textures_ignore_air_voxels = textures_ignore_air_voxels;
+	slabs->cell_infos_enabled = cell_infos != nullptr;
+	slabs->slab_count = slab_count;
+
+	const int block_size_z = voxels.get_size().z - transvoxel::MIN_PADDING - transvoxel::MAX_PADDING;
+	for (unsigned int i = 0; i < slab_count; ++i) {
+		RegularMeshSlabs::Slab &slab = slabs->slabs[i];
+		slab.cell_z_begin = (block_size_z * i) / slab_count;
+		slab.cell_z_end = (block_size_z * (i + 1)) / slab_count;
+	}
+
+	// The first slab is always built by the current thread
+	FixedArray<IThreadedTask *, RegularMeshSlabs::MAX_SLABS> tasks;
+	for (unsigned int i = 1; i < slab_count; ++i) {
+		tasks[i - 1] = ZN_NEW(RegularMeshSlabTask(slabs, i));
+	}
+	VoxelEngine::get_singleton().push_async_tasks(to_span(tasks, slab_count - 1));
+
+	const RegularMeshSlabs::Slab &first_slab = slabs->slabs[0];
+	const transvoxel::DefaultTextureIndicesData default_texture_indices_data = transvoxel::build_regular_mesh(
+			voxels,
+			VoxelBuffer::CHANNEL_SDF,
+			lod_index,
+			texturing_mode,
+			cache,
+			output,
+			cell_infos,
+			edge_clamp_margin,
+			textures_ignore_air_voxels,
+			first_slab.cell_z_begin,
+			first_slab.cell_z_end
+	);
+
+	// Build slabs no other thread has started, then wait for those that did
+	unsigned int slabs_taken_by_tasks = 0;
+	for (unsigned int i = 1; i < slab_count; ++i) {
+		RegularMeshSlabs::Slab &slab = slabs->slabs[i];
+		if (slab.taken.exchange(true)) {
+			++slabs_taken_by_tasks;
+		} else {
+			slabs->build_slab(slab);
+		}
+	}
+	for (; slabs_taken_by_tasks > 0; --slabs_taken_by_tasks) {
+		slabs->semaphore.wait();
+	}
+
+	{
+		ZN_PROFILE_SCOPE_NAMED("Stitch slabs");
+		for (unsigned int i = 1; i < slab_count; ++i) {
+			const RegularMeshSlabs::Slab &slab = slabs->slabs[i];
+			transvoxel::append_regular_mesh_slab(output, slab.mesh_arrays, float(slab.cell_z_begin << lod_index));
+			if (cell_infos != nullptr) {
+				append_array(*cell_infos, slab.cell_infos);
+			}
+		}
+	}
+
+	return default_texture_indices_data;
+}
+
 } // namespace
 
 // TODO Maybe we could auto-detect? It could become ambiguous tho
@@ -309,17 +541,35 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 
 	const TexturingMode texture_mode = check_texturing_mode(_texture_mode, voxels);
 
-	default_texture_indices_data = transvoxel::build_regular_mesh(
-			voxels,
-			sdf_channel,
-			input.lod_index,
-			static_cast<transvoxel::TexturingMode>(texture_mode),
-			tls_cache,
-			mesh_arrays,
-			cell_infos,
-			_edge_clamp_margin,
-			_textures_ignore_air_voxels
-	);
+	const unsigned int slab_count = _parallel_meshing_enabled ? get_regular_mesh_slab_count(voxels) : 1;
+
+	if (slab_count > 1) {
+		default_texture_indices_data = build_regular_mesh_in_slabs(
+				voxels,
+				input.lod_index,
+				static_cast<transvoxel::TexturingMode>(texture_mode),
+				_edge_clamp_margin,
+				_textures_ignore_air_voxels,
+				slab_count,
+				tls_cache,
+				mesh_arrays,
+				cell_infos
+		);
+	} else {
+		default_texture_indices_data = transvoxel::build_regular_mesh(
+				voxels,
+				sdf_channel,
+				input.lod_index,
+				static_cast<transvoxel::TexturingMode>(texture_mode),
+				tls_cache,
+				mesh_arrays,
+				cell_infos,
+				_edge_clamp_margin,
+				_textures_ignore_air_voxels,
+				0,
+				voxels.get_size().z - transvoxel::MIN_PADDING - transvoxel::MAX_PADDING
+		);
+	}
 
 	if (mesh_arrays.vertices.size() == 0) {
 		// The mesh can be empty
@@ -331,15 +581,17 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 	}
 
 	transvoxel::MeshArrays *combined_mesh_arrays = &mesh_arrays;
-	if (_mesh_optimization_params.enabled) {
+	if (_mesh_optimization_params.enabled && input.lod_index >= _mesh_optimization_params.begin_lod_index) {
 		// TODO When voxel texturing is enabled, this will decrease quality a lot.
 		// There is no support yet for taking textures into account when simplifying.
 		// See https://github.com/zeux/meshoptimizer/issues/158
+		// Vertices on the sides of the block are never moved (see MESHOPTIMIZER_ZYLANN_NEVER_COLLAPSE_BORDERS), so the
+		// mesh still connects with neighbors and transition meshes.
 		simplify(
 				mesh_arrays,
 				tls_simplified_mesh_arrays,
 				_mesh_optimization_params.target_ratio,
-				_mesh_optimization_params.error_threshold
+				_mesh_optimization_params.get_error_threshold(input.lod_index)
 		);
 
 		combined_mesh_arrays = &tls_simplified_mesh_arrays;
@@ -371,17 +623,21 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 		}
 	}
 
-	Array gd_arrays;
-	fill_surface_arrays(gd_arrays, *combined_mesh_arrays);
-	output.surfaces.push_back({ gd_arrays, 0 });
-
-	// const uint64_t time_spent = Time::get_singleton()->get_ticks_usec() - time_before;
-	// print_line(String("VoxelMesherTransvoxel spent {0} us").format(varray(time_spent)));
-
 	output.primitive_type = Mesh::PRIMITIVE_TRIANGLES;
 
+	// Far meshes can use a smaller vertex format, at the cost of precision
+	const bool compressed =
+			_vertex_compression_params.enabled && input.lod_index >= _vertex_compression_params.begin_lod_index;
+
 	// Transvoxel transitions data
-	output.mesh_flags = (RenderingServer::ARRAY_CUSTOM_RGBA_FLOAT << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT);
+	if (compressed) {
+		output.mesh_flags = (RenderingServer::ARRAY_CUSTOM_RG_FLOAT << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT);
+#ifdef ZN_GODOT_MESH_COMPRESSION_SUPPORTED
+		output.mesh_flags |= Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES;
+#endif
+	} else {
+		output.mesh_flags = (RenderingServer::ARRAY_CUSTOM_RGBA_FLOAT << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT);
+	}
 
 	// Texture data
 	switch (texture_mode) {
@@ -395,6 +651,24 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 			ZN_PRINT_ERROR("Unhandled texture mode");
 			break;
 	}
+
+	Output::Surface surface;
+
+#ifdef ZN_GODOT_PACKED_SURFACE_SUPPORTED
+	// Packed surfaces only use the uncompressed layout, compressed ones are left to Godot
+	if (input.packed_surface_hint && !compressed && can_pack_surface(*combined_mesh_arrays)) {
+		// Attributes only used for rendering are written directly in the layout of the RenderingServer, without
+		// going through arrays
+		fill_packed_surface(surface.packed, *combined_mesh_arrays, output.mesh_flags);
+	}
+#endif
+
+	fill_surface_arrays(surface.arrays, *combined_mesh_arrays, surface.packed.is_empty(), compressed, input.lod_index);
+
+	output.surfaces.push_back(surface);
+
+	// const uint64_t time_spent = Time::get_singleton()->get_ticks_usec() - time_before;
+	// print_line(String("VoxelMesherTransvoxel spent {0} us").format(varray(time_spent)));
 }
 
 // Only exists for testing
@@ -435,7 +709,7 @@ Ref<ArrayMesh> VoxelMesherTransvoxel::build_transition_mesh(Ref<godot::VoxelBuff
 	}
 
 	Array arrays;
-	fill_surface_arrays(arrays, s_mesh_arrays);
+	fill_surface_arrays(arrays, s_mesh_arrays, true, false, 0);
 	mesh.instantiate();
 	mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
 	return mesh;
@@ -485,6 +759,34 @@ float VoxelMesherTransvoxel::get_mesh_optimization_target_ratio() const {
 	return _mesh_optimization_params.target_ratio;
 }
 
+void VoxelMesherTransvoxel::set_mesh_optimization_begin_lod_index(int lod_index) {
+	ERR_FAIL_INDEX(lod_index, int(constants::MAX_LOD));
+	_mesh_optimization_params.begin_lod_index = lod_index;
+}
+
+int VoxelMesherTransvoxel::get_mesh_optimization_begin_lod_index() const {
+	return _mesh_optimization_params.begin_lod_index;
+}
+
+void VoxelMesherTransvoxel::set_mesh_optimization_lod_error_thresholds(PackedFloat32Array thresholds) {
+	ERR_FAIL_COND(thresholds.size() > int(constants::MAX_LOD));
+	MeshOptimizationParams &params = _mesh_optimization_params;
+	for (int i = 0; i < thresholds.size(); ++i) {
+		params.lod_error_thresholds[i] = math::clamp(thresholds[i], 0.f, 1.f);
+	}
+	params.lod_error_threshold_count = thresholds.size();
+}
+
+PackedFloat32Array VoxelMesherTransvoxel::get_mesh_optimization_lod_error_thresholds() const {
+	const MeshOptimizationParams &params = _mesh_optimization_params;
+	PackedFloat32Array thresholds;
+	thresholds.resize(params.lod_error_threshold_count);
+	for (unsigned int i = 0; i < params.lod_error_threshold_count; ++i) {
+		thresholds.set(i, params.lod_error_thresholds[i]);
+	}
+	return thresholds;
+}
+
 void VoxelMesherTransvoxel::set_transitions_enabled(bool enable) {
 	_transitions_enabled = enable;
 }
@@ -505,6 +807,31 @@ float VoxelMesherTransvoxel::get_edge_clamp_margin() const {
 	return _edge_clamp_margin;
 }
 
+void VoxelMesherTransvoxel::set_vertex_compression_enabled(bool enabled) {
+	_vertex_compression_params.enabled = enabled;
+}
+
+bool VoxelMesherTransvoxel::is_vertex_compression_enabled() const {
+	return _vertex_compression_params.enabled;
+}
+
+void VoxelMesherTransvoxel::set_vertex_compression_begin_lod_index(int lod_index) {
+	ERR_FAIL_INDEX(lod_index, int(constants::MAX_LOD));
+	_vertex_compression_params.begin_lod_index = lod_index;
+}
+
+int VoxelMesherTransvoxel::get_vertex_compression_begin_lod_index() const {
+	return _vertex_compression_params.begin_lod_index;
+}
+
+void VoxelMesherTransvoxel::set_parallel_meshing_enabled(bool enabled) {
+	_parallel_meshing_enabled = enabled;
+}
+
+bool VoxelMesherTransvoxel::is_parallel_meshing_enabled() const {
+	return _parallel_meshing_enabled;
+}
+
 void VoxelMesherTransvoxel::_bind_methods() {
 	using Self = VoxelMesherTransvoxel;
 
@@ -531,12 +858,41 @@ void VoxelMesherTransvoxel::_bind_methods() {
 	);
 	ClassDB::bind_method(D_METHOD("get_mesh_optimization_target_ratio"), &Self::get_mesh_optimization_target_ratio);
 
+	ClassDB::bind_method(
+			D_METHOD("set_mesh_optimization_begin_lod_index", "lod_index"), &Self::set_mesh_optimization_begin_lod_index
+	);
+	ClassDB::bind_method(
+			D_METHOD("get_mesh_optimization_begin_lod_index"), &Self::get_mesh_optimization_begin_lod_index
+	);
+
+	ClassDB::bind_method(
+			D_METHOD("set_mesh_optimization_lod_error_thresholds", "thresholds"),
+			&Self::set_mesh_optimization_lod_error_thresholds
+	);
+	ClassDB::bind_method(
+			D_METHOD("get_mesh_optimization_lod_error_thresholds"), &Self::get_mesh_optimization_lod_error_thresholds
+	);
+
 	ClassDB::bind_method(D_METHOD("set_transitions_enabled", "enabled"), &Self::set_transitions_enabled);
 	ClassDB::bind_method(D_METHOD("get_transitions_enabled"), &Self::get_transitions_enabled);
 
 	ClassDB::bind_method(D_METHOD("get_edge_clamp_margin"), &Self::get_edge_clamp_margin);
 	ClassDB::bind_method(D_METHOD("set_edge_clamp_margin", "margin"), &Self::set_edge_clamp_margin);
 
+	ClassDB::bind_method(D_METHOD("set_vertex_compression_enabled", "enabled"), &Self::set_vertex_compression_enabled);
+	ClassDB::bind_method(D_METHOD("is_vertex_compression_enabled"), &Self::is_vertex_compression_enabled);
+
+	ClassDB::bind_method(
+			D_METHOD("set_vertex_compression_begin_lod_index", "lod_index"),
+			&Self::set_vertex_compression_begin_lod_index
+	);
+	ClassDB::bind_method(
+			D_METHOD("get_vertex_compression_begin_lod_index"), &Self::get_vertex_compression_begin_lod_index
+	);
+
+	ClassDB::bind_method(D_METHOD("set_parallel_meshing_enabled", "enabled"), &Self::set_parallel_meshing_enabled);
+	ClassDB::bind_method(D_METHOD("is_parallel_meshing_enabled"), &Self::is_parallel_meshing_enabled);
+
 	ADD_GROUP("Materials", "");
 
 	ADD_PROPERTY(
@@ -568,6 +924,29 @@ void VoxelMesherTransvoxel::_bind_methods() {
 			"set_mesh_optimization_target_ratio",
 			"get_mesh_optimization_target_ratio"
 	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "mesh_optimization_begin_lod_index"),
+			"set_mesh_optimization_begin_lod_index",
+			"get_mesh_optimization_begin_lod_index"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "mesh_optimization_lod_error_thresholds"),
+			"set_mesh_optimization_lod_error_thresholds",
+			"get_mesh_optimization_lod_error_thresholds"
+	);
+
+	ADD_GROUP("Vertex compression", "vertex_compression_");
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "vertex_compression_enabled"),
+			"set_vertex_compression_enabled",
+			"is_vertex_compression_enabled"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "vertex_compression_begin_lod_index"),
+			"set_vertex_compression_begin_lod_index",
+			"get_vertex_compression_begin_lod_index"
+	);
 
 	ADD_GROUP("Advanced", "");
 
@@ -577,6 +956,12 @@ void VoxelMesherTransvoxel::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "edge_clamp_margin"), "set_edge_clamp_margin", "get_edge_clamp_margin");
 
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "parallel_meshing_enabled"),
+			"set_parallel_meshing_enabled",
+			"is_parallel_meshing_enabled"
+	);
+
 	BIND_ENUM_CONSTANT(TEXTURES_NONE);
 	BIND_ENUM_CONSTANT(TEXTURES_MIXEL4_S4);
 	BIND_ENUM_CONSTANT(TEXTURES_SINGLE_S4);
@@ -1,6 +1,7 @@
 #ifndef VOXEL_MESHER_TRANSVOXEL_H
 #define VOXEL_MESHER_TRANSVOXEL_H
 
+#include "../../constants/voxel_constants.h"
 #include "../../util/macros.h"
 #include "../voxel_mesher.h"
 #include "transvoxel.h"
@@ -52,12 +53,27 @@ public:
 	void set_mesh_optimization_target_ratio(float ratio);
 	float get_mesh_optimization_target_ratio() const;
 
+	void set_mesh_optimization_begin_lod_index(int lod_index);
+	int get_mesh_optimization_begin_lod_index() const;
+
+	void set_mesh_optimization_lod_error_thresholds(PackedFloat32Array thresholds);
+	PackedFloat32Array get_mesh_optimization_lod_error_thresholds() const;
+
 	void set_transitions_enabled(bool enable);
 	bool get_transitions_enabled() const;
 
 	void set_edge_clamp_margin(float margin);
 	float get_edge_clamp_margin() const;
 
+	void set_vertex_compression_enabled(bool enabled);
+	bool is_vertex_compression_enabled() const;
+
+	void set_vertex_compression_begin_lod_index(int lod_index);
+	int get_vertex_compression_begin_lod_index() const;
+
+	void set_parallel_meshing_enabled(bool enabled);
+	bool is_parallel_meshing_enabled() const;
+
 	Ref<ShaderMaterial> get_default_lod_material() const override;
 
 	// Internal
@@ -91,10 +107,27 @@ private:
 		bool enabled = false;
 		float error_threshold = 0.005;
 		float target_ratio = 0.0;
+		// Meshes of this LOD index and above are simplified
+		uint8_t begin_lod_index = 0;
+		// Overrides `error_threshold` for the first `lod_error_threshold_count` LOD indices
+		uint8_t lod_error_threshold_count = 0;
+		FixedArray<float, constants::MAX_LOD> lod_error_thresholds;
+
+		float get_error_threshold(const unsigned int lod_index) const {
+			return lod_index < lod_error_threshold_count ? lod_error_thresholds[lod_index] : error_threshold;
+		}
 	};
 
 	MeshOptimizationParams _mesh_optimization_params;
 
+	struct VertexCompressionParams {
+		bool enabled = false;
+		// Meshes of this LOD index and above are compressed
+		uint8_t begin_lod_index = 2;
+	};
+
+	VertexCompressionParams _vertex_compression_params;
+
 	// When a marching cube cell is computed, vertices may be placed anywhere on edges of the cell, including very close
 	// to corners. This can lead to very thin or small triangles, which can be a problem notably for collision. this
 	// margin is the minimum distance from corners, below which vertices will be clamped to it. Increasing this value
@@ -104,6 +137,9 @@ private:
 	bool _transitions_enabled = true;
 
 	bool _textures_ignore_air_voxels = false;
+
+	// Splits the regular mesh of large blocks in slabs, built in parallel when other threads are idle
+	bool _parallel_meshing_enabled = false;
 };
 
 } // namespace zylann::voxel
@@ -178,6 +178,22 @@ bool VoxelMesher::is_mesh_empty(const StdVector<Output::Surface> &surfaces) {
 	return true;
 }
 
+void VoxelMesher::add_surface_to_mesh(
+		ArrayMesh &mesh,
+		const Output::Surface &surface,
+		const Mesh::PrimitiveType primitive,
+		const uint32_t flags
+) {
+#ifdef ZN_GODOT_PACKED_SURFACE_SUPPORTED
+	if (!surface.packed.is_empty()) {
+		// Packed surfaces already contain flags in their format
+		add_packed_surface(mesh, primitive, surface.packed);
+		return;
+	}
+#endif
+	mesh.add_surface_from_arrays(primitive, surface.arrays, Array(), Dictionary(), flags);
+}
+
 Ref<ShaderMaterial> VoxelMesher::get_default_lod_material() const {
 	return Ref<ShaderMaterial>();
 }
@@ -5,9 +5,13 @@
 #include "../util/containers/fixed_array.h"
 #include "../util/containers/span.h"
 #include "../util/containers/std_vector.h"
+#include "../util/godot/classes/array_mesh.h"
 #include "../util/godot/classes/image.h"
 #include "../util/godot/classes/mesh.h"
 #include "../util/macros.h"
+#include "../util/math/box3i.h"
+
+#include <memory>
 
 ZN_GODOT_FORWARD_DECLARE(class ShaderMaterial)
 
@@ -25,6 +29,16 @@ class VoxelData;
 class VoxelMesher : public Resource {
 	GDCLASS(VoxelMesher, Resource)
 public:
+	// Data a mesher may keep from one update of a block to the next, so it only has to re-mesh the parts of the block
+	// where voxels changed. Its contents are specific to the mesher that created it.
+	class IncrementalCache {
+	public:
+		virtual ~IncrementalCache() {}
+
+		// Meshers must not reuse caches they didn't create
+		const VoxelMesher *mesher = nullptr;
+	};
+
 	struct Input {
 		// Voxels to be used as the primary source of data.
 		const VoxelBuffer &voxels;
@@ -45,11 +59,23 @@ public:
 		// If true, the mesher can collect some extra information which can be useful to speed up detail texture
 		// baking. Depends on the mesher.
 		bool detail_texture_hint = false;
+		// If true, the mesher may output surfaces already packed in the format used by the RenderingServer (see
+		// `Output::Surface::packed`), which is faster to turn into a mesh. Depends on the mesher.
+		bool packed_surface_hint = false;
+		// If not null, meshers supporting it can keep data in this cache to speed up the next update of the same
+		// block. It is created if it is null. Depends on the mesher.
+		std::shared_ptr<IncrementalCache> *incremental_cache = nullptr;
+		// Area where voxels changed since the last time `incremental_cache` was used, relative to the block (not
+		// counting padding). Ignored if the cache is new.
+		Box3i dirty_box;
 	};
 
 	struct Output {
 		struct Surface {
 			Array arrays;
+			// If not empty, this is what should be used to create the rendering mesh. `arrays` then only contains
+			// vertices, normals and indices, for use by collisions and instancing.
+			zylann::godot::PackedSurface packed;
 			uint16_t material_index = 0;
 		};
 		StdVector<Surface> surfaces;
@@ -78,6 +104,14 @@ public:
 
 	static bool is_mesh_empty(const StdVector<Output::Surface> &surfaces);
 
+	// Adds a surface from the output of a mesher to a mesh resource, using packed data if available.
+	static void add_surface_to_mesh(
+			ArrayMesh &mesh,
+			const Output::Surface &surface,
+			const Mesh::PrimitiveType primitive,
+			const uint32_t flags
+	);
+
 	// This can be called from multiple threads at once. Make sure member vars are protected or thread-local.
 	virtual void build(Output &output, const Input &voxels);
 
@@ -427,12 +427,14 @@ void initialize_voxel_module(ModuleInitializationLevel p_level) {
 #ifdef VOXEL_TESTS
 		const PackedStringArray command_line_arguments = zylann::godot::get_command_line_arguments();
 		const String tests_cmd = "--run_voxel_tests";
+		const String benchmarks_cmd = "--run_voxel_benchmarks";
 
 		for (int i = 0; i < command_line_arguments.size(); ++i) {
 			const String arg = command_line_arguments[i];
 			if (arg == tests_cmd) {
 				zylann::voxel::tests::run_voxel_tests(zylann::testing::TestOptions());
-				break;
+			} else if (arg == benchmarks_cmd) {
+				zylann::voxel::tests::run_voxel_benchmarks(zylann::testing::TestOptions());
 			}
 		}
 #endif
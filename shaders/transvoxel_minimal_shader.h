@@ -28,11 +28,23 @@ const char *g_transvoxel_minimal_shader =
 "}\n"
 "\n"
 "vec3 get_transvoxel_position(vec3 vertex_pos, vec4 fdata) {\n"
-"	int idata = floatBitsToInt(fdata.a);\n"
+"	int idata;\n"
+"	vec3 secondary_position;\n"
+"\n"
+"	if (fdata.w == 1.0) {\n"
+"		// Compact layout used when vertex compression is enabled. It only has 2 components so the last one is 1.0,\n"
+"		// which can't happen with the regular layout.\n"
+"		idata = floatBitsToInt(fdata.x);\n"
+"		int odata = floatBitsToInt(fdata.y);\n"
+"		vec3 offset = vec3(ivec3(odata, odata >> 10, odata >> 20) & ivec3(1023)) - vec3(511.0);\n"
+"		secondary_position = vertex_pos + offset * (exp2(float((idata >> 24) & 31)) / 511.0);\n"
+"	} else {\n"
+"		idata = floatBitsToInt(fdata.a);\n"
+"		secondary_position = fdata.xyz;\n"
+"	}\n"
 "\n"
 "	// Move vertices to smooth transitions\n"
 "	float secondary_factor = get_transvoxel_secondary_factor(idata);\n"
-"	vec3 secondary_position = fdata.xyz;\n"
 "	vec3 pos = mix(vertex_pos, secondary_position, secondary_factor);\n"
 "\n"
 "	// If the mesh combines transitions and the vertex belongs to a transition,\n"
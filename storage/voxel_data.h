@@ -58,6 +58,16 @@ public:
 
 	void set_bounds(Box3i bounds);
 
+	// Hints on which NUMA node threads working on this data should preferably run. -1 means no preference.
+	// Expected to be set once after creation, before tasks are scheduled.
+	inline void set_numa_node_hint(int8_t node_index) {
+		_numa_node_hint = node_index;
+	}
+
+	inline int8_t get_numa_node_hint() const {
+		return _numa_node_hint;
+	}
+
 	inline Box3i get_bounds() const {
 		MutexLock rlock(_settings_mutex);
 		return _bounds_in_voxels;
@@ -443,6 +453,8 @@ private:
 
 	uint8_t _lod_count = 1;
 
+	int8_t _numa_node_hint = -1;
+
 	// If enabled, some data blocks can have the "not loaded" and "loaded" status. Which means we can't assume what
 	// they contain, until we load them from the stream. If disabled, all edits are loaded in memory, and we know if
 	// a block isn't stored, it means we can use the generator and modifiers to obtain its data. This mostly changes
@@ -96,6 +96,11 @@ VoxelMemoryPool::~VoxelMemoryPool() {
 	clear();
 }
 
+void VoxelMemoryPool::set_numa_node_count(unsigned int count) {
+	ZN_ASSERT_RETURN(count >= 1);
+	_numa_node_count = math::min(count, cpu_topology::MAX_NUMA_NODES);
+}
+
 uint8_t *VoxelMemoryPool::allocate(size_t size) {
 	ZN_DSTACK();
 	ZN_PROFILE_SCOPE();
@@ -120,13 +125,20 @@ uint8_t *VoxelMemoryPool::allocate(size_t size) {
 	} else {
 		const unsigned int pot = get_pool_index_from_size(size);
 		Pool &pool = _pot_pools[pot];
-		pool.mutex.lock();
-		if (pool.blocks.size() > 0) {
-			block = pool.blocks.back();
-			pool.blocks.pop_back();
-			pool.mutex.unlock();
-		} else {
-			pool.mutex.unlock();
+		// New allocations get physically placed on the node of the thread that first touches them, which is usually
+		// the one allocating
+		const unsigned int node_index = get_current_thread_node_index();
+		// Take a free block from the node of the current thread first. Then from other nodes, so blocks recycled by
+		// threads of another node don't pile up.
+		for (unsigned int i = 0; i < _numa_node_count && block == nullptr; ++i) {
+			NodeBlocks &node_blocks = pool.nodes[(node_index + i) % _numa_node_count];
+			MutexLock lock(node_blocks.mutex);
+			if (node_blocks.blocks.size() > 0) {
+				block = node_blocks.blocks.back();
+				node_blocks.blocks.pop_back();
+			}
+		}
+		if (block == nullptr) {
 			ZN_PROFILE_SCOPE_NAMED("new alloc");
 			// All allocations done in this pool have the same size,
 			// which must be greater or equal to `size`
@@ -175,35 +187,49 @@ void VoxelMemoryPool::recycle(uint8_t *block, size_t size) {
 		// Make sure this allocation was done by this pool in this scenario
 		pool.debug_used_blocks.remove(block);
 #endif
-		MutexLock lock(pool.mutex);
-		pool.blocks.push_back(block);
+		NodeBlocks &node_blocks = pool.nodes[get_current_thread_node_index()];
+		MutexLock lock(node_blocks.mutex);
+		node_blocks.blocks.push_back(block);
 	}
 	--_used_blocks;
 	_used_memory -= size;
 }
 
+unsigned int VoxelMemoryPool::get_current_thread_node_index() const {
+	if (_numa_node_count <= 1) {
+		return 0;
+	}
+	return math::min(cpu_topology::get_current_thread_numa_node(), _numa_node_count - 1);
+}
+
 void VoxelMemoryPool::clear_unused_blocks() {
 	for (unsigned int pot = 0; pot < _pot_pools.size(); ++pot) {
 		Pool &pool = _pot_pools[pot];
-		MutexLock lock(pool.mutex);
-		for (unsigned int i = 0; i < pool.blocks.size(); ++i) {
-			void *block = pool.blocks[i];
-			ZN_FREE(block);
+		// All lists, in case the node count changed after blocks were recycled
+		for (NodeBlocks &node_blocks : pool.nodes) {
+			MutexLock lock(node_blocks.mutex);
+			for (unsigned int i = 0; i < node_blocks.blocks.size(); ++i) {
+				void *block = node_blocks.blocks[i];
+				ZN_FREE(block);
+			}
+			_total_memory -= get_size_from_pool_index(pot) * node_blocks.blocks.size();
+			node_blocks.blocks.clear();
 		}
-		_total_memory -= get_size_from_pool_index(pot) * pool.blocks.size();
-		pool.blocks.clear();
 	}
 }
 
 void VoxelMemoryPool::clear() {
 	for (unsigned int pot = 0; pot < _pot_pools.size(); ++pot) {
 		Pool &pool = _pot_pools[pot];
-		MutexLock lock(pool.mutex);
-		for (unsigned int i = 0; i < pool.blocks.size(); ++i) {
-			void *block = pool.blocks[i];
-			ZN_FREE(block);
+		// All lists, in case the node count changed after blocks were recycled
+		for (NodeBlocks &node_blocks : pool.nodes) {
+			MutexLock lock(node_blocks.mutex);
+			for (unsigned int i = 0; i < node_blocks.blocks.size(); ++i) {
+				void *block = node_blocks.blocks[i];
+				ZN_FREE(block);
+			}
+			node_blocks.blocks.clear();
 		}
-		pool.blocks.clear();
 	}
 	_used_memory = 0;
 	_total_memory = 0;
@@ -214,8 +240,17 @@ void VoxelMemoryPool::debug_print() {
 	print_line("-------- VoxelMemoryPool ----------");
 	for (unsigned int pot = 0; pot < _pot_pools.size(); ++pot) {
 		Pool &pool = _pot_pools[pot];
-		MutexLock lock(pool.mutex);
-		print_line(format("Pool {}: {} blocks (capacity {})", pot, pool.blocks.size(), pool.blocks.capacity()));
+		for (unsigned int node_index = 0; node_index < _numa_node_count; ++node_index) {
+			NodeBlocks &node_blocks = pool.nodes[node_index];
+			MutexLock lock(node_blocks.mutex);
+			print_line(
+					format("Pool {} node {}: {} blocks (capacity {})",
+						   pot,
+						   node_index,
+						   node_blocks.blocks.size(),
+						   node_blocks.blocks.capacity())
+			);
+		}
 	}
 }
 
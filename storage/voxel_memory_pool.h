@@ -8,6 +8,7 @@
 #include "../util/containers/std_vector.h"
 #include "../util/dstack.h"
 #include "../util/math/funcs.h"
+#include "../util/thread/cpu_topology.h"
 #include "../util/thread/mutex.h"
 
 #include <atomic>
@@ -45,10 +46,16 @@ private:
 	};
 #endif
 
-	struct Pool {
+	struct NodeBlocks {
 		Mutex mutex;
 		// Would a linked list be better?
 		StdVector<uint8_t *> blocks;
+	};
+
+	struct Pool {
+		// Free blocks are kept per NUMA node, so threads pinned to a node reuse memory that is local to them.
+		// Unless per-node lists are enabled, only the first list is used.
+		FixedArray<NodeBlocks, cpu_topology::MAX_NUMA_NODES> nodes;
 #ifdef DEBUG_ENABLED
 		DebugUsedBlocks debug_used_blocks;
 #endif
@@ -62,6 +69,10 @@ public:
 	VoxelMemoryPool();
 	~VoxelMemoryPool();
 
+	// Keeps free blocks in one list per NUMA node. Blocks go to the list of the thread recycling them. This is only
+	// useful when threads are pinned to NUMA nodes. Must be called before blocks are allocated from other threads.
+	void set_numa_node_count(unsigned int count);
+
 	uint8_t *allocate(size_t size);
 	void recycle(uint8_t *block, size_t size);
 
@@ -91,6 +102,8 @@ private:
 		return size_t(1) << i;
 	}
 
+	unsigned int get_current_thread_node_index() const;
+
 #ifdef DEBUG_ENABLED
 	void debug_print_used_blocks(unsigned int max_amount);
 #endif
@@ -100,6 +113,7 @@ private:
 	// Each slot in this array corresponds to allocations
 	// that contain 2^index bytes in them.
 	FixedArray<Pool, 21> _pot_pools;
+	unsigned int _numa_node_count = 1;
 #ifdef DEBUG_ENABLED
 	DebugUsedBlocks _debug_nonpooled_used_blocks;
 #endif
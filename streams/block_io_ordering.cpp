@@ -0,0 +1,46 @@
+#include "block_io_ordering.h"
+#include "../util/errors.h"
+
+namespace zylann::voxel {
+
+uint32_t BlockIOOrdering::acquire(Vector3i block_position, uint8_t lod_index) {
+	MutexLock mlock(_mutex);
+	const uint32_t ticket = _next_ticket;
+	++_next_ticket;
+	// Tickets only grow, so each list stays sorted
+	_pending_tickets[Key{ block_position, lod_index }].push_back(ticket);
+	return ticket;
+}
+
+bool BlockIOOrdering::is_next(Vector3i block_position, uint8_t lod_index, uint32_t ticket) const {
+	MutexLock mlock(_mutex);
+	auto it = _pending_tickets.find(Key{ block_position, lod_index });
+	ZN_ASSERT_RETURN_V(it != _pending_tickets.end(), true);
+	const StdVector<uint32_t> &tickets = it->second;
+	ZN_ASSERT_RETURN_V(tickets.size() > 0, true);
+	return tickets.front() == ticket;
+}
+
+void BlockIOOrdering::release(Vector3i block_position, uint8_t lod_index, uint32_t ticket) {
+	MutexLock mlock(_mutex);
+	auto it = _pending_tickets.find(Key{ block_position, lod_index });
+	ZN_ASSERT_RETURN(it != _pending_tickets.end());
+	StdVector<uint32_t> &tickets = it->second;
+	// Tasks can be cancelled before they run, so the ticket is not necessarily the first one
+	for (auto ticket_it = tickets.begin(); ticket_it != tickets.end(); ++ticket_it) {
+		if (*ticket_it == ticket) {
+			tickets.erase(ticket_it);
+			break;
+		}
+	}
+	if (tickets.size() == 0) {
+		_pending_tickets.erase(it);
+	}
+}
+
+unsigned int BlockIOOrdering::get_pending_block_count() const {
+	MutexLock mlock(_mutex);
+	return _pending_tickets.size();
+}
+
+} // namespace zylann::voxel
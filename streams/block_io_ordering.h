@@ -0,0 +1,47 @@
+#ifndef VOXEL_BLOCK_IO_ORDERING_H
+#define VOXEL_BLOCK_IO_ORDERING_H
+
+#include "../util/containers/std_unordered_map.h"
+#include "../util/containers/std_vector.h"
+#include "../util/math/vector3i.h"
+#include "../util/thread/mutex.h"
+
+namespace zylann::voxel {
+
+// Keeps I/O tasks on the same block running in the order they were created, even when I/O tasks run in parallel.
+// For example, a load scheduled after a save must see the saved data.
+// Each task takes a ticket when it is created. When it runs, it must postpone itself until its ticket is the next for
+// its block, and release it once done.
+class BlockIOOrdering {
+public:
+	uint32_t acquire(Vector3i block_position, uint8_t lod_index);
+	bool is_next(Vector3i block_position, uint8_t lod_index, uint32_t ticket) const;
+	void release(Vector3i block_position, uint8_t lod_index, uint32_t ticket);
+
+	unsigned int get_pending_block_count() const;
+
+private:
+	struct Key {
+		Vector3i position;
+		uint8_t lod_index;
+
+		inline bool operator==(const Key &other) const {
+			return position == other.position && lod_index == other.lod_index;
+		}
+	};
+
+	struct KeyHasher {
+		inline size_t operator()(const Key &key) const {
+			return hash_djb2_one_32(key.lod_index, Vector3iHasher::hash(key.position));
+		}
+	};
+
+	// Tickets not released yet, in the order they were acquired
+	StdUnorderedMap<Key, StdVector<uint32_t>, KeyHasher> _pending_tickets;
+	uint32_t _next_ticket = 0;
+	mutable Mutex _mutex;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_BLOCK_IO_ORDERING_H
@@ -42,11 +42,15 @@ LoadBlockDataTask::LoadBlockDataTask(
 		_stream_dependency(p_stream_dependency),
 		_voxel_data(vdata),
 		_cancellation_token(cancellation_token) {
-	//
+	_io_ticket = _stream_dependency->io_ordering.acquire(_position, _lod_index);
 	++g_debug_load_block_tasks_count;
 }
 
 LoadBlockDataTask::~LoadBlockDataTask() {
+	if (!_io_ticket_released) {
+		// Cancelled or failed before completion
+		_stream_dependency->io_ordering.release(_position, _lod_index, _io_ticket);
+	}
 	--g_debug_load_block_tasks_count;
 }
 
@@ -62,6 +66,13 @@ void LoadBlockDataTask::run(zylann::ThreadedTaskContext &ctx) {
 	Ref<VoxelStream> stream = _stream_dependency->stream;
 	CRASH_COND(stream.is_null());
 
+	if (!_stream_dependency->io_ordering.is_next(_position, _lod_index, _io_ticket)) {
+		// Another task on the same block was created before this one and hasn't finished yet. It may be saving data
+		// we have to load.
+		ctx.status = ThreadedTaskContext::STATUS_POSTPONED;
+		return;
+	}
+
 	ERR_FAIL_COND(_voxels != nullptr);
 	_voxels = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_POOL);
 	const VoxelFormat format = _voxel_data->get_format();
@@ -134,6 +145,8 @@ void LoadBlockDataTask::run(zylann::ThreadedTaskContext &ctx) {
 	}
 #endif
 
+	_stream_dependency->io_ordering.release(_position, _lod_index, _io_ticket);
+	_io_ticket_released = true;
 	_has_run = true;
 }
 
@@ -145,6 +158,10 @@ TaskPriority LoadBlockDataTask::get_priority() {
 	return p;
 }
 
+int LoadBlockDataTask::get_preferred_numa_node() const {
+	return _voxel_data != nullptr ? _voxel_data->get_numa_node_hint() : -1;
+}
+
 bool LoadBlockDataTask::is_cancelled() {
 	if (_stream_dependency->valid == false) {
 		return true;
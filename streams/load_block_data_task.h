@@ -36,6 +36,7 @@ public:
 	void run(ThreadedTaskContext &ctx) override;
 	TaskPriority get_priority() override;
 	bool is_cancelled() override;
+	int get_preferred_numa_node() const override;
 	void apply_result() override;
 
 	static int debug_get_running_count();
@@ -59,9 +60,11 @@ private:
 	bool _max_lod_hint = false;
 	bool _generate_cache_data = true;
 	bool _requested_generator_task = false;
+	bool _io_ticket_released = false;
 #ifdef VOXEL_ENABLE_GPU
 	bool _generator_use_gpu = false;
 #endif
+	uint32_t _io_ticket = 0;
 	std::shared_ptr<StreamingDependency> _stream_dependency;
 	std::shared_ptr<VoxelData> _voxel_data;
 	TaskCancellationToken _cancellation_token;
@@ -342,6 +342,25 @@ bool RegionFile::is_valid_block_position(const Vector3 position) const {
 }
 
 Error RegionFile::load_block(Vector3i position, VoxelBuffer &out_block) {
+	StdVector<uint8_t> &data = BlockSerializer::get_tls_compressed_data();
+	const Error err = load_block_data(position, data);
+	if (err != OK) {
+		return err;
+	}
+
+	configure_block(out_block);
+
+	ERR_FAIL_COND_V_MSG(
+			!BlockSerializer::decompress_and_deserialize(to_span(data), out_block),
+			ERR_PARSE_ERROR,
+			String("Failed to read block {0}").format(varray(position))
+	);
+
+	return OK;
+}
+
+Error RegionFile::load_block_data(Vector3i position, StdVector<uint8_t> &out_data) {
+	ZN_PROFILE_SCOPE();
 	ERR_FAIL_COND_V(_file_access.is_null(), ERR_FILE_CANT_READ);
 	FileAccess &f = **_file_access;
 
@@ -354,29 +373,32 @@ Error RegionFile::load_block(Vector3i position, VoxelBuffer &out_block) {
 		return ERR_DOES_NOT_EXIST;
 	}
 
-	ERR_FAIL_COND_V(out_block.get_size() != out_block.get_size(), ERR_INVALID_PARAMETER);
-	// Configure block format
-	for (unsigned int channel_index = 0; channel_index < _header.format.channel_depths.size(); ++channel_index) {
-		out_block.set_channel_depth(channel_index, _header.format.channel_depths[channel_index]);
-	}
-
 	const unsigned int sector_index = block_info.get_sector_index();
 	const unsigned int block_begin = _blocks_begin_offset + sector_index * _header.format.sector_size;
 
 	f.seek(block_begin);
 
-	unsigned int block_data_size = f.get_32();
+	const unsigned int block_data_size = f.get_32();
 	CRASH_COND(f.eof_reached());
 
-	ERR_FAIL_COND_V_MSG(
-			!BlockSerializer::decompress_and_deserialize(f, block_data_size, out_block),
-			ERR_PARSE_ERROR,
-			String("Failed to read block {0}").format(varray(position))
-	);
+#if defined(TOOLS_ENABLED) || defined(DEBUG_ENABLED)
+	const uint64_t remaining_file_size = f.get_length() - f.get_position();
+	ERR_FAIL_COND_V(block_data_size > remaining_file_size, ERR_FILE_CORRUPT);
+#endif
+
+	out_data.resize(block_data_size);
+	const uint64_t read_size = zylann::godot::get_buffer(f, to_span(out_data));
+	ERR_FAIL_COND_V(read_size != block_data_size, ERR_FILE_CORRUPT);
 
 	return OK;
 }
 
+void RegionFile::configure_block(VoxelBuffer &out_block) const {
+	for (unsigned int channel_index = 0; channel_index < _header.format.channel_depths.size(); ++channel_index) {
+		out_block.set_channel_depth(channel_index, _header.format.channel_depths[channel_index]);
+	}
+}
+
 Error RegionFile::save_block(Vector3i position, VoxelBuffer &block) {
 	ERR_FAIL_COND_V(_header.format.verify_block(block) == false, ERR_INVALID_PARAMETER);
 	ERR_FAIL_COND_V(!is_valid_block_position(position), ERR_INVALID_PARAMETER);
@@ -84,6 +84,11 @@ public:
 	const RegionFormat &get_format() const;
 
 	Error load_block(Vector3i position, VoxelBuffer &out_block);
+	// Reads the compressed data of a block without decoding it, so decoding can happen without holding on the file.
+	// Use `BlockSerializer::decompress_and_deserialize` to decode it, into a buffer configured with `configure_block`.
+	Error load_block_data(Vector3i position, StdVector<uint8_t> &out_data);
+	// Sets channel depths of a buffer to match the format of the region.
+	void configure_block(VoxelBuffer &out_block) const;
 	Error save_block(Vector3i position, VoxelBuffer &block);
 
 	unsigned int get_header_block_count() const;
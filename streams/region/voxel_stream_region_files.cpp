@@ -9,6 +9,7 @@
 #include "../../util/math/box3i.h"
 #include "../../util/profiling.h"
 #include "../../util/string/format.h"
+#include "../voxel_block_serializer.h"
 #include "file_utils.h"
 
 #include <algorithm>
@@ -131,53 +132,68 @@ VoxelStreamRegionFiles::EmergeResult VoxelStreamRegionFiles::_load_block(
 ) {
 	ZN_PROFILE_SCOPE();
 
-	MutexLock lock(_mutex);
+	StdVector<uint8_t> &block_data = BlockSerializer::get_tls_compressed_data();
 
-	if (_directory_path.is_empty()) {
-		return EMERGE_OK_FALLBACK;
-	}
+	{
+		// Only file access needs to be exclusive. Decoding happens after, so multiple I/O threads can overlap.
+		MutexLock lock(_mutex);
 
-	if (!_meta_loaded) {
-		const zylann::godot::FileResult load_res = load_meta();
-		if (load_res != zylann::godot::FILE_OK) {
-			// No block was ever saved
+		if (_directory_path.is_empty()) {
 			return EMERGE_OK_FALLBACK;
 		}
-	}
 
-	const Vector3i block_size = Vector3iUtil::create(1 << _meta.block_size_po2);
-	const Vector3i region_size = Vector3iUtil::create(1 << _meta.region_size_po2);
+		if (!_meta_loaded) {
+			const zylann::godot::FileResult load_res = load_meta();
+			if (load_res != zylann::godot::FILE_OK) {
+				// No block was ever saved
+				return EMERGE_OK_FALLBACK;
+			}
+		}
 
-	CRASH_COND(!_meta_loaded);
-	ERR_FAIL_COND_V(lod >= _meta.lod_count, EMERGE_FAILED);
-	ERR_FAIL_COND_V(block_size != out_buffer.get_size(), EMERGE_FAILED);
+		const Vector3i block_size = Vector3iUtil::create(1 << _meta.block_size_po2);
+		const Vector3i region_size = Vector3iUtil::create(1 << _meta.region_size_po2);
 
-	// Configure depths, as they might not be specified in old block data.
-	// Regions are expected to contain such depths, and use those in the buffer to know how much data to read.
-	for (unsigned int channel_index = 0; channel_index < _meta.channel_depths.size(); ++channel_index) {
-		out_buffer.set_channel_depth(channel_index, _meta.channel_depths[channel_index]);
-	}
+		CRASH_COND(!_meta_loaded);
+		ERR_FAIL_COND_V(lod >= _meta.lod_count, EMERGE_FAILED);
+		ERR_FAIL_COND_V(block_size != out_buffer.get_size(), EMERGE_FAILED);
 
-	const Vector3i region_pos = get_region_position_from_blocks(block_pos);
+		// Configure depths, as they might not be specified in old block data.
+		// Regions are expected to contain such depths, and use those in the buffer to know how much data to read.
+		for (unsigned int channel_index = 0; channel_index < _meta.channel_depths.size(); ++channel_index) {
+			out_buffer.set_channel_depth(channel_index, _meta.channel_depths[channel_index]);
+		}
 
-	CachedRegion *cache = open_region(region_pos, lod, false);
-	if (cache == nullptr || !cache->file_exists) {
-		return EMERGE_OK_FALLBACK;
-	}
+		const Vector3i region_pos = get_region_position_from_blocks(block_pos);
+
+		CachedRegion *cache = open_region(region_pos, lod, false);
+		if (cache == nullptr || !cache->file_exists) {
+			return EMERGE_OK_FALLBACK;
+		}
 
-	const Vector3i block_rpos = math::wrap(block_pos, region_size);
+		const Vector3i block_rpos = math::wrap(block_pos, region_size);
 
-	const Error err = cache->region.load_block(block_rpos, out_buffer);
-	switch (err) {
-		case OK:
-			return EMERGE_OK;
+		const Error err = cache->region.load_block_data(block_rpos, block_data);
+		switch (err) {
+			case OK:
+				break;
 
-		case ERR_DOES_NOT_EXIST:
-			return EMERGE_OK_FALLBACK;
+			case ERR_DOES_NOT_EXIST:
+				return EMERGE_OK_FALLBACK;
 
-		default:
-			return EMERGE_FAILED;
+			default:
+				return EMERGE_FAILED;
+		}
+
+		cache->region.configure_block(out_buffer);
 	}
+
+	ERR_FAIL_COND_V_MSG(
+			!BlockSerializer::decompress_and_deserialize(to_span(block_data), out_buffer),
+			EMERGE_FAILED,
+			String("Failed to read block {0}").format(varray(block_pos))
+	);
+
+	return EMERGE_OK;
 }
 
 void VoxelStreamRegionFiles::_save_block(VoxelBuffer &voxel_buffer, Vector3i block_pos, int lod) {
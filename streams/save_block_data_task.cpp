@@ -32,7 +32,7 @@ SaveBlockDataTask::SaveBlockDataTask(
 		_flush_on_last_tracked_task(flush_on_last_tracked_task),
 		_stream_dependency(p_stream_dependency),
 		_tracker(p_tracker) {
-	//
+	_io_ticket = _stream_dependency->io_ordering.acquire(_position, _lod);
 	++g_debug_save_block_tasks_count;
 }
 
@@ -56,13 +56,16 @@ SaveBlockDataTask::SaveBlockDataTask(
 		_flush_on_last_tracked_task(flush_on_last_tracked_task),
 		_stream_dependency(p_stream_dependency),
 		_tracker(p_tracker) {
-	//
+	_io_ticket = _stream_dependency->io_ordering.acquire(_position, _lod);
 	++g_debug_save_block_tasks_count;
 }
 
 #endif
 
 SaveBlockDataTask::~SaveBlockDataTask() {
+	if (!_io_ticket_released) {
+		_stream_dependency->io_ordering.release(_position, _lod, _io_ticket);
+	}
 	--g_debug_save_block_tasks_count;
 }
 
@@ -77,6 +80,12 @@ void SaveBlockDataTask::run(zylann::ThreadedTaskContext &ctx) {
 	Ref<VoxelStream> stream = _stream_dependency->stream;
 	ZN_ASSERT_RETURN_MSG(stream.is_valid(), "Save task was triggered without a stream, this is a bug");
 
+	if (!_stream_dependency->io_ordering.is_next(_position, _lod, _io_ticket)) {
+		// Another task on the same block was created before this one and hasn't finished yet
+		ctx.status = ThreadedTaskContext::STATUS_POSTPONED;
+		return;
+	}
+
 	if (_save_voxels) {
 		if (_voxels == nullptr) {
 			if (_tracker != nullptr) {
@@ -130,6 +139,8 @@ void SaveBlockDataTask::run(zylann::ThreadedTaskContext &ctx) {
 		_tracker->post_complete();
 	}
 
+	_stream_dependency->io_ordering.release(_position, _lod, _io_ticket);
+	_io_ticket_released = true;
 	_has_run = true;
 }
 
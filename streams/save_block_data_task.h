@@ -63,6 +63,8 @@ private:
 	bool _save_instances = false;
 	bool _save_voxels = false;
 	bool _flush_on_last_tracked_task = false;
+	bool _io_ticket_released = false;
+	uint32_t _io_ticket = 0;
 	std::shared_ptr<StreamingDependency> _stream_dependency;
 	// Optional tracking, can be null
 	std::shared_ptr<AsyncDependencyTracker> _tracker;
@@ -194,6 +194,10 @@ bool Connection::open(const char *fpath, const BlockLocation::CoordinateFormat p
 	// Note, SQLite uses UTF-8 encoding by default. We rely on that.
 	// https://www.sqlite.org/c3ref/open.html
 
+	// Connections are pooled and may be used by multiple I/O threads at once. Wait for the database to become
+	// available instead of failing right away if another connection is writing.
+	sqlite3_busy_timeout(_db, BUSY_TIMEOUT_MS);
+
 	sqlite3 *db = _db;
 	char *error_message = nullptr;
 
@@ -18,6 +18,9 @@ public:
 	static constexpr int VERSION_V1 = 1;
 	static constexpr int VERSION_LATEST = VERSION_V1;
 
+	// How long a query waits for a database locked by another connection before failing
+	static constexpr int BUSY_TIMEOUT_MS = 5000;
+
 	struct Meta {
 		int version = -1;
 		int block_size_po2 = 0;
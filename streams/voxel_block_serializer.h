@@ -38,7 +38,8 @@ SerializeResult serialize_and_compress(const VoxelBuffer &voxel_buffer);
 bool decompress_and_deserialize(Span<const uint8_t> p_data, VoxelBuffer &out_voxel_buffer);
 bool decompress_and_deserialize(FileAccess &f, unsigned int size_to_read, VoxelBuffer &out_voxel_buffer);
 
-// Temporary thread-local buffers for internal use
+// Temporary thread-local buffers. The compressed one may also be used to read data before passing it to
+// `decompress_and_deserialize`.
 StdVector<uint8_t> &get_tls_data();
 StdVector<uint8_t> &get_tls_compressed_data();
 
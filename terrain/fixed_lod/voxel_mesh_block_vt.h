@@ -1,6 +1,7 @@
 #ifndef VOXEL_MESH_BLOCK_VT_H
 #define VOXEL_MESH_BLOCK_VT_H
 
+#include "../../meshers/voxel_mesher.h"
 #include "../../util/godot/classes/material.h"
 #include "../voxel_mesh_block.h"
 
@@ -31,6 +32,15 @@ public:
 	// collision, it may be a better idea to use `is_area_editable` and not use mesh blocks
 	bool is_loaded = false;
 
+	// Used with incremental meshing. Null if the block was never meshed incrementally, or while a task is using it.
+	std::shared_ptr<VoxelMesher::IncrementalCache> incremental_cache;
+	// Voxels that changed since the last mesh update was scheduled, relative to the block
+	Box3i dirty_box;
+	// If true, the next mesh update has to re-mesh the whole block, not only `dirty_box`
+	bool fully_dirty = true;
+	// Incremented every time a mesh update is scheduled, so only the cache returned by the latest one is kept
+	uint32_t mesh_update_id = 0;
+
 	VoxelMeshBlockVT(const Vector3i bpos, unsigned int size) : VoxelMeshBlock(bpos) {
 		_position_in_voxels = bpos * size;
 	}
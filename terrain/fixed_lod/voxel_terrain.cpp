@@ -84,7 +84,9 @@ VoxelTerrain::VoxelTerrain() {
 		task->volume_id = self->_volume_id;
 		task->self = self;
 		task->data = std::move(ob);
-		VoxelEngine::get_singleton().push_main_thread_time_spread_task(task);
+		VoxelEngine::get_singleton().push_main_thread_time_spread_task(
+				task, TimeSpreadTaskRunner::PRIORITY_NORMAL, VoxelEngine::MAIN_THREAD_CATEGORY_MESH
+		);
 	};
 	callbacks.data_output_callback = [](void *cb_data, VoxelEngine::BlockDataOutput &ob) {
 		VoxelTerrain *self = reinterpret_cast<VoxelTerrain *>(cb_data);
@@ -92,6 +94,7 @@ VoxelTerrain::VoxelTerrain() {
 	};
 
 	_volume_id = VoxelEngine::get_singleton().add_volume(callbacks);
+	_data->set_numa_node_hint(VoxelEngine::get_singleton().get_volume_numa_node(_volume_id));
 
 	// TODO Can't setup a default mesher anymore due to a Godot 4 warning...
 	// For ease of use in editor
@@ -425,8 +428,40 @@ bool VoxelTerrain::is_automatic_loading_enabled() const {
 	return _automatic_loading_enabled;
 }
 
-void VoxelTerrain::try_schedule_mesh_update(VoxelMeshBlockVT &mesh_block) {
+void VoxelTerrain::set_incremental_meshing_enabled(bool enable) {
+	if (enable == _incremental_meshing_enabled) {
+		return;
+	}
+	_incremental_meshing_enabled = enable;
+	if (!enable) {
+		// Free caches kept by blocks
+		_mesh_map.for_each_block([](VoxelMeshBlockVT &block) { //
+			block.incremental_cache.reset();
+		});
+	}
+}
+
+bool VoxelTerrain::is_incremental_meshing_enabled() const {
+	return _incremental_meshing_enabled;
+}
+
+void VoxelTerrain::try_schedule_mesh_update(VoxelMeshBlockVT &mesh_block, const Box3i *dirty_box_in_voxels) {
 	ZN_PROFILE_SCOPE();
+
+	// Changes are recorded even if the update can't be scheduled yet, the next one will have to include them
+	if (dirty_box_in_voxels == nullptr) {
+		mesh_block.fully_dirty = true;
+	} else if (!mesh_block.fully_dirty) {
+		const Box3i dirty_box(
+				dirty_box_in_voxels->position - mesh_block.position * get_mesh_block_size(), dirty_box_in_voxels->size
+		);
+		if (mesh_block.dirty_box.is_empty()) {
+			mesh_block.dirty_box = dirty_box;
+		} else {
+			mesh_block.dirty_box.merge_with(dirty_box);
+		}
+	}
+
 	if (mesh_block.is_in_update_list) {
 		// Already in the list
 		return;
@@ -782,12 +817,12 @@ void VoxelTerrain::try_schedule_mesh_update_from_data(const Box3i &box_in_voxels
 	}
 	// We pad by 1 because neighbor blocks might be affected visually (for example, baked ambient occlusion)
 	const Box3i mesh_box = box_in_voxels.padded(1).downscaled(get_mesh_block_size());
-	mesh_box.for_each_cell([this](Vector3i pos) {
+	mesh_box.for_each_cell([this, &box_in_voxels](Vector3i pos) {
 		VoxelMeshBlockVT *block = _mesh_map.get_block(pos);
 		// There isn't necessarily a mesh block, if the edit happens in a boundary,
 		// or if it is done next to a viewer that doesn't need meshes
 		if (block != nullptr) {
-			try_schedule_mesh_update(*block);
+			try_schedule_mesh_update(*block, &box_in_voxels);
 		}
 	});
 }
@@ -1899,6 +1934,19 @@ void VoxelTerrain::process_meshing() {
 				volume_transform
 		);
 
+		if (_incremental_meshing_enabled) {
+			// Blocks start being meshed incrementally once they get edited. If the previous task still has the cache,
+			// the mesher will start a new one.
+			task->incremental_meshing = !mesh_block->fully_dirty || mesh_block->incremental_cache != nullptr;
+			task->incremental_cache = std::move(mesh_block->incremental_cache);
+			task->dirty_box = mesh_block->fully_dirty ? Box3i(Vector3i(), Vector3iUtil::create(get_mesh_block_size()))
+													  : mesh_block->dirty_box;
+		}
+		++mesh_block->mesh_update_id;
+		task->mesh_update_id = mesh_block->mesh_update_id;
+		mesh_block->dirty_box = Box3i();
+		mesh_block->fully_dirty = false;
+
 		scheduler.push_main_task(task);
 
 		mesh_block->is_in_update_list = false;
@@ -1934,6 +1982,11 @@ void VoxelTerrain::apply_mesh_update(const VoxelEngine::BlockMeshOutput &ob) {
 		return;
 	}
 
+	// The cache is only up to date if no other update was scheduled after this one
+	if (_incremental_meshing_enabled && ob.mesh_update_id == block->mesh_update_id) {
+		block->incremental_cache = ob.incremental_cache;
+	}
+
 	// There is a slim chance for some updates to come up just after setting the mesher to null. Avoids a crash.
 	if (_mesher.is_null()) {
 		++_stats.dropped_block_meshs;
@@ -2439,6 +2492,9 @@ void VoxelTerrain::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_automatic_loading_enabled", "enable"), &Self::set_automatic_loading_enabled);
 	ClassDB::bind_method(D_METHOD("is_automatic_loading_enabled"), &Self::is_automatic_loading_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_incremental_meshing_enabled", "enable"), &Self::set_incremental_meshing_enabled);
+	ClassDB::bind_method(D_METHOD("is_incremental_meshing_enabled"), &Self::is_incremental_meshing_enabled);
+
 #ifdef VOXEL_ENABLE_GPU
 	ClassDB::bind_method(D_METHOD("set_generator_use_gpu", "enable"), &Self::set_generator_use_gpu);
 	ClassDB::bind_method(D_METHOD("get_generator_use_gpu"), &Self::get_generator_use_gpu);
@@ -2541,6 +2597,11 @@ void VoxelTerrain::_bind_methods() {
 #ifdef VOXEL_ENABLE_GPU
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_gpu_generation"), "set_generator_use_gpu", "get_generator_use_gpu");
 #endif
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "incremental_meshing_enabled"),
+			"set_incremental_meshing_enabled",
+			"is_incremental_meshing_enabled"
+	);
 
 	ADD_GROUP("Debug", "debug_");
 
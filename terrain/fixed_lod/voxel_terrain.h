@@ -95,6 +95,9 @@ public:
 	void set_automatic_loading_enabled(bool enable);
 	bool is_automatic_loading_enabled() const;
 
+	void set_incremental_meshing_enabled(bool enable);
+	bool is_incremental_meshing_enabled() const;
+
 	void set_material_override(Ref<Material> material);
 	Ref<Material> get_material_override() const;
 
@@ -236,7 +239,8 @@ private:
 	// void unload_data_block(Vector3i bpos);
 	void unload_mesh_block(Vector3i bpos);
 	// void make_data_block_dirty(Vector3i bpos);
-	void try_schedule_mesh_update(VoxelMeshBlockVT &block);
+	// If only some voxels of the block changed, `dirty_box_in_voxels` can be given so only that part may be re-meshed
+	void try_schedule_mesh_update(VoxelMeshBlockVT &block, const Box3i *dirty_box_in_voxels = nullptr);
 	void try_schedule_mesh_update_from_data(const Box3i &box_in_voxels);
 
 	void save_all_modified_blocks(bool with_copy, std::shared_ptr<AsyncDependencyTracker> tracker);
@@ -367,6 +371,8 @@ private:
 	// If enabled, VoxelViewers will cause blocks to automatically load around them.
 	bool _automatic_loading_enabled = true;
 	bool _generator_use_gpu = false;
+	// If enabled, mesh blocks keep data from their last update, so after an edit only parts near it are re-meshed.
+	bool _incremental_meshing_enabled = false;
 
 	Ref<Material> _material_override;
 
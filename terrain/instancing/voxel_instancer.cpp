@@ -214,6 +214,8 @@ void VoxelInstancer::_notification(int p_what) {
 void VoxelInstancer::process() {
 	ZN_PROFILE_SCOPE();
 
+	const uint64_t time_before_usec = Time::get_singleton()->get_ticks_usec();
+
 	process_task_results();
 
 	if (_parent != nullptr) {
@@ -232,6 +234,11 @@ void VoxelInstancer::process() {
 	}
 
 	process_fading();
+
+	// Time-slicing above uses budgets of its own, but it still competes with other main thread work
+	VoxelEngine::get_singleton().report_main_thread_time_usage(
+			VoxelEngine::MAIN_THREAD_CATEGORY_INSTANCER, Time::get_singleton()->get_ticks_usec() - time_before_usec
+	);
 }
 
 void VoxelInstancer::process_task_results() {
@@ -111,6 +111,17 @@ void VoxelLodTerrain::ApplyMeshUpdateTask::run(TimeSpreadTaskContext &ctx) {
 	self->apply_mesh_update(data);
 }
 
+#ifdef VOXEL_ENABLE_SMOOTH_MESHING
+void VoxelLodTerrain::ApplyDetailTextureUpdateTask::run(TimeSpreadTaskContext &ctx) {
+	if (!VoxelEngine::get_singleton().is_volume_valid(volume_id)) {
+		// The node can have been destroyed while this task was still pending
+		ZN_PRINT_VERBOSE("Cancelling ApplyDetailTextureUpdateTask, volume_id is invalid");
+		return;
+	}
+	self->apply_detail_texture_update(data);
+}
+#endif
+
 VoxelLodTerrain::VoxelLodTerrain() {
 	// Note: don't do anything heavy in the constructor.
 	// Godot may create and destroy dozens of instances of all node types on startup,
@@ -143,7 +154,13 @@ VoxelLodTerrain::VoxelLodTerrain() {
 		task->volume_id = self->get_volume_id();
 		task->self = self;
 		task->data = std::move(ob);
-		VoxelEngine::get_singleton().push_main_thread_time_spread_task(task);
+		// Distant LODs are less noticeable, so let closer ones go first. They still get aged into normal priority if
+		// they wait too long.
+		VoxelEngine::get_singleton().push_main_thread_time_spread_task(
+				task,
+				ob.lod == 0 ? TimeSpreadTaskRunner::PRIORITY_NORMAL : TimeSpreadTaskRunner::PRIORITY_LOW,
+				VoxelEngine::MAIN_THREAD_CATEGORY_MESH
+		);
 
 		// If two tasks are queued for the same mesh, cancel the old ones.
 		// This is for cases where creating the mesh is slower than the speed at which it is generated,
@@ -162,11 +179,18 @@ VoxelLodTerrain::VoxelLodTerrain() {
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 	callbacks.detail_texture_output_callback = [](void *cb_data, VoxelEngine::BlockDetailTextureOutput &ob) {
 		VoxelLodTerrain *self = reinterpret_cast<VoxelLodTerrain *>(cb_data);
-		self->apply_detail_texture_update(ob);
+		ApplyDetailTextureUpdateTask *task = ZN_NEW(ApplyDetailTextureUpdateTask);
+		task->volume_id = self->get_volume_id();
+		task->self = self;
+		task->data = std::move(ob);
+		VoxelEngine::get_singleton().push_main_thread_time_spread_task(
+				task, TimeSpreadTaskRunner::PRIORITY_NORMAL, VoxelEngine::MAIN_THREAD_CATEGORY_DETAIL_TEXTURE
+		);
 	};
 #endif
 
 	_volume_id = VoxelEngine::get_singleton().add_volume(callbacks);
+	_data->set_numa_node_hint(VoxelEngine::get_singleton().get_volume_numa_node(_volume_id));
 	// VoxelEngine::get_singleton().set_volume_octree_lod_distance(_volume_id, get_lod_distance());
 
 	// TODO Being able to set a LOD smaller than the stream is probably a bad idea,
@@ -1250,8 +1274,9 @@ void VoxelLodTerrain::process(float delta) {
 	// It should only happen on first load, though.
 	// process_block_loading_responses();
 
-	// TODO This could go into time spread tasks too
-	process_deferred_collision_updates(VoxelEngine::get_singleton().get_main_thread_time_budget_usec());
+	// Collision is not capped to a share of the budget, so nearby physics doesn't wait for visuals. Time spent here is
+	// deducted from what time-spread tasks get on the next frame.
+	process_deferred_collision_updates(VoxelEngine::get_singleton().get_main_thread_available_budget_usec());
 
 #ifdef TOOLS_ENABLED
 	if (debug_is_draw_enabled() && is_visible_in_tree()) {
@@ -2342,12 +2367,22 @@ void VoxelLodTerrain::apply_detail_texture_update_to_block(
 
 #endif
 
-void VoxelLodTerrain::process_deferred_collision_updates(uint32_t timeout_msec) {
+void VoxelLodTerrain::process_deferred_collision_updates(uint32_t timeout_usec) {
 	ZN_PROFILE_SCOPE();
 
 	const unsigned int lod_count = get_lod_count();
-	// TODO We may move this in a time spread task somehow, the timeout does not account for them so could take longer
-	const uint64_t then = get_ticks_msec();
+	const uint64_t then_usec = Time::get_singleton()->get_ticks_usec();
+
+	struct UsageReporter {
+		uint64_t then_usec;
+		~UsageReporter() {
+			const uint64_t elapsed_usec = Time::get_singleton()->get_ticks_usec() - then_usec;
+			VoxelEngine::get_singleton().report_main_thread_time_usage(
+					VoxelEngine::MAIN_THREAD_CATEGORY_COLLISION, elapsed_usec
+			);
+		}
+	};
+	const UsageReporter usage_reporter{ then_usec };
 
 	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
 		VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map = _mesh_maps_per_lod[lod_index];
@@ -2380,7 +2415,7 @@ void VoxelLodTerrain::process_deferred_collision_updates(uint32_t timeout_msec)
 			}
 
 			// We always process at least one, then we check the timeout
-			if (get_ticks_msec() - then >= timeout_msec) {
+			if (Time::get_singleton()->get_ticks_usec() - then_usec >= timeout_usec) {
 				return;
 			}
 		}
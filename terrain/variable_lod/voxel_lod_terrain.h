@@ -337,7 +337,7 @@ private:
 
 	void save_all_modified_blocks(bool with_copy, std::shared_ptr<AsyncDependencyTracker> tracker);
 
-	void process_deferred_collision_updates(uint32_t timeout_msec);
+	void process_deferred_collision_updates(uint32_t timeout_usec);
 	void process_fading_blocks(float delta);
 
 	struct LocalCameraInfo {
@@ -446,6 +446,16 @@ private:
 
 	FixedArray<StdUnorderedMap<Vector3i, RefCount>, constants::MAX_LOD> _queued_main_thread_mesh_updates;
 
+#ifdef VOXEL_ENABLE_SMOOTH_MESHING
+	struct ApplyDetailTextureUpdateTask : public ITimeSpreadTask {
+		void run(TimeSpreadTaskContext &ctx) override;
+
+		VolumeID volume_id;
+		VoxelLodTerrain *self = nullptr;
+		VoxelEngine::BlockDetailTextureOutput data;
+	};
+#endif
+
 #ifdef TOOLS_ENABLED
 	bool _debug_draw_enabled = false;
 	uint8_t _edited_blocks_gizmos_lod_index = 0;
@@ -13,7 +13,9 @@
 #include "util/test_spatial_lock.h"
 #include "util/test_string_funcs.h"
 #include "util/test_threaded_task_runner.h"
+#include "util/test_time_spread_task_runner.h"
 
+#include "voxel/test_block_data_tasks.h"
 #include "voxel/test_block_serializer.h"
 #include "voxel/test_curve_range.h"
 #include "voxel/test_edition_funcs.h"
@@ -25,8 +27,13 @@
 #include "voxel/test_voxel_data_map.h"
 #include "voxel/test_voxel_graph.h"
 #include "voxel/test_voxel_instancer.h"
+#include "voxel/test_voxel_mesher_blocky.h"
 #include "voxel/test_voxel_mesher_cubes.h"
 
+#ifdef VOXEL_ENABLE_GPU
+#include "voxel/test_generate_block_gpu_task.h"
+#endif
+
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 #include "voxel/test_transvoxel.h"
 #ifdef VOXEL_ENABLE_GPU
@@ -60,6 +67,7 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	using namespace zylann::tests;
 
 	VOXEL_TEST(test_wrap);
+	VOXEL_TEST(test_float32x4);
 	VOXEL_TEST(test_int32_to_string_base10);
 	VOXEL_TEST(test_string_base10_to_int32);
 	VOXEL_TEST(test_voxel_buffer_metadata);
@@ -85,6 +93,11 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_voxel_graph_generator_texturing);
 	VOXEL_TEST(test_voxel_graph_equivalence_merging);
 	VOXEL_TEST(test_voxel_graph_generate_block_with_input_sdf);
+	VOXEL_TEST(test_voxel_graph_generate_block_adaptive_subdivision);
+	VOXEL_TEST(test_voxel_graph_affine_range_analysis);
+	VOXEL_TEST(test_voxel_graph_xz_cache);
+	VOXEL_TEST(test_voxel_graph_disk_cache);
+	VOXEL_TEST(test_voxel_graph_sampling_profiler);
 	VOXEL_TEST(test_voxel_graph_functions_pass_through);
 	VOXEL_TEST(test_voxel_graph_functions_nested_pass_through);
 	VOXEL_TEST(test_voxel_graph_functions_autoconnect);
@@ -125,6 +138,8 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_block_serializer_stream_peer);
 	VOXEL_TEST(test_region_file);
 	VOXEL_TEST(test_voxel_stream_region_files);
+	VOXEL_TEST(test_save_then_load_block_data_tasks_ordering);
+	VOXEL_TEST(test_save_then_load_block_data_tasks_serial);
 #ifdef VOXEL_ENABLE_FAST_NOISE_2
 	VOXEL_TEST(test_fast_noise_2_basic);
 	VOXEL_TEST(test_fast_noise_2_empty_encoded_node_tree);
@@ -133,9 +148,18 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_flat_map);
 	VOXEL_TEST(test_expression_parser);
 	VOXEL_TEST(test_voxel_mesher_cubes);
+	VOXEL_TEST(test_voxel_mesher_cubes_greedy);
+	VOXEL_TEST(test_voxel_mesher_cubes_incremental);
+	VOXEL_TEST(test_voxel_mesher_blocky_greedy);
+	VOXEL_TEST(test_voxel_mesher_blocky_skip_occluded);
+	VOXEL_TEST(test_voxel_mesher_blocky_incremental);
 	VOXEL_TEST(test_threaded_task_runner_misc);
 	VOXEL_TEST(test_threaded_task_runner_debug_names);
 	VOXEL_TEST(test_task_priority_values);
+	VOXEL_TEST(test_task_cancellation_token_hierarchy);
+#ifdef VOXEL_ENABLE_GPU
+	VOXEL_TEST(test_generate_block_gpu_task_discard);
+#endif
 #ifdef VOXEL_ENABLE_MESH_SDF
 	VOXEL_TEST(test_voxel_mesh_sdf_issue463);
 #endif
@@ -147,6 +171,10 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_slot_map);
 	VOXEL_TEST(test_box_blur);
 	VOXEL_TEST(test_threaded_task_postponing);
+	VOXEL_TEST(test_threaded_task_postponing_serial);
+	VOXEL_TEST(test_time_spread_task_runner_category_budgets);
+	VOXEL_TEST(test_time_spread_task_runner_aging);
+	VOXEL_TEST(test_adaptive_time_budget);
 	VOXEL_TEST(test_spatial_lock_misc);
 	VOXEL_TEST(test_spatial_lock_spam);
 	VOXEL_TEST(test_spatial_lock_dependent_map_chunks);
@@ -167,6 +195,11 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_voxel_graph_constant_reduction);
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 	VOXEL_TEST(test_transvoxel_issue772);
+	VOXEL_TEST(test_transvoxel_mixel4_texture_selection);
+	VOXEL_TEST(test_transvoxel_packed_surface);
+	VOXEL_TEST(test_transvoxel_vertex_compression);
+	VOXEL_TEST(test_transvoxel_mesh_optimization_lod);
+	VOXEL_TEST(test_transvoxel_regular_mesh_slabs);
 #endif
 #ifdef VOXEL_ENABLE_INSTANCER
 	VOXEL_TEST(test_instance_generator_material_filter_issue774);
@@ -175,8 +208,23 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_voxel_graph_multiple_function_instances);
 	VOXEL_TEST(test_voxel_graph_issue783);
 	VOXEL_TEST(test_voxel_graph_broad_block);
+	VOXEL_TEST(test_voxel_graph_tiled_execution);
+	VOXEL_TEST(test_voxel_graph_fusion);
+	VOXEL_TEST(test_voxel_graph_buffer_sharing);
+	VOXEL_TEST(test_voxel_graph_sdf_point_queries);
 
 	print_line("------------ Voxel tests end -------------");
 }
 
+void run_voxel_benchmarks(const testing::TestOptions &options) {
+	print_line("------------ Voxel benchmarks begin -------------");
+
+	VOXEL_TEST(test_voxel_graph_fusion_benchmark);
+	VOXEL_TEST(test_voxel_graph_node_throughput_benchmark);
+	VOXEL_TEST(test_voxel_graph_range_analysis_clipping_benchmark);
+	VOXEL_TEST(test_voxel_mesher_cubes_benchmark);
+
+	print_line("------------ Voxel benchmarks end -------------");
+}
+
 } // namespace zylann::voxel::tests
@@ -13,6 +13,8 @@ namespace voxel {
 
 namespace tests {
 void run_voxel_tests(const testing::TestOptions &options);
+// Only print timings, so they don't run with the tests
+void run_voxel_benchmarks(const testing::TestOptions &options);
 }
 
 namespace noise_tests {
@@ -1,6 +1,9 @@
 #include "test_math_funcs.h"
+#include "../../util/math/float32x4.h"
 #include "../../util/math/funcs.h"
 #include "../../util/testing/test_macros.h"
+#include <cstring>
+#include <limits>
 
 namespace zylann::tests {
 
@@ -30,4 +33,95 @@ void test_wrap() {
 	}
 }
 
+void test_float32x4() {
+	using namespace math;
+
+	// Packs of values must give exactly the same results as scalar code, including special values
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const float inf = std::numeric_limits<float>::infinity();
+	const float values[] = { 0.f, -0.f, 1.f, -1.f, 0.5f, -3.75f, 100.f, nan, inf, -inf };
+	const unsigned int values_count = sizeof(values) / sizeof(float);
+
+	struct L {
+		static bool same_result(float a, float b) {
+			// NaNs may have different payloads depending on how they were produced
+			if (Math::is_nan(a)) {
+				return Math::is_nan(b);
+			}
+			// Compare bits so signed zeros are distinguished
+			return std::memcmp(&a, &b, sizeof(float)) == 0;
+		}
+
+		static void check(const Float32x4 r, const float expected[Float32x4::SIZE]) {
+			float results[Float32x4::SIZE];
+			r.store(results);
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				ZN_TEST_ASSERT(same_result(results[i], expected[i]));
+			}
+		}
+	};
+
+	for (unsigned int ai = 0; ai < values_count; ++ai) {
+		for (unsigned int bi = 0; bi < values_count; ++bi) {
+			// Put different pairs in each component
+			float a[Float32x4::SIZE];
+			float b[Float32x4::SIZE];
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				a[i] = values[(ai + i) % values_count];
+				b[i] = values[(bi + i * 3) % values_count];
+			}
+			const Float32x4 va = Float32x4::load(a);
+			const Float32x4 vb = Float32x4::load(b);
+			const Float32x4 vc(0.25f);
+
+			float expected[Float32x4::SIZE];
+
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				expected[i] = math::min(a[i], b[i]);
+			}
+			L::check(math::min(va, vb), expected);
+
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				expected[i] = math::max(a[i], b[i]);
+			}
+			L::check(math::max(va, vb), expected);
+
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				expected[i] = math::clamp(a[i], b[i], 0.25f);
+			}
+			L::check(math::clamp(va, vb, vc), expected);
+
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				expected[i] = a[i] < b[i] ? a[i] : 0.25f;
+			}
+			L::check(select(va < vb, va, vc), expected);
+
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				expected[i] = b[i] == a[i] ? 0.25f : b[i];
+			}
+			L::check(select(vb == va, vc, vb), expected);
+
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				expected[i] = a[i] / b[i] - b[i] * 0.25f + a[i];
+			}
+			L::check(va / vb - vb * vc + va, expected);
+
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				expected[i] = -a[i];
+			}
+			L::check(-va, expected);
+
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				expected[i] = Math::abs(a[i]);
+			}
+			L::check(math::abs(va), expected);
+
+			for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+				expected[i] = Math::sqrt(Math::abs(a[i]));
+			}
+			L::check(math::sqrt(math::abs(va)), expected);
+		}
+	}
+}
+
 } // namespace zylann::tests
@@ -4,6 +4,7 @@
 namespace zylann::tests {
 
 void test_wrap();
+void test_float32x4();
 
 } // namespace zylann::tests
 
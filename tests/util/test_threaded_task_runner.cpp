@@ -10,6 +10,7 @@
 #include "../../util/profiling.h"
 #include "../../util/string/format.h"
 #include "../../util/string/std_stringstream.h"
+#include "../../util/tasks/cancellation_token.h"
 #include "../../util/tasks/threaded_task_runner.h"
 #include "../../util/testing/test_macros.h"
 
@@ -276,6 +277,42 @@ void test_task_priority_values() {
 	ZN_TEST_ASSERT(TaskPriority(10, 10, 0, 0) < TaskPriority(10, 10, 10, 0));
 }
 
+void test_task_cancellation_token_hierarchy() {
+	{
+		TaskCancellationToken parent = TaskCancellationToken::create();
+		TaskCancellationToken child = parent.create_child();
+		TaskCancellationToken grand_child = child.create_child();
+		ZN_TEST_ASSERT(!parent.is_cancelled());
+		ZN_TEST_ASSERT(!child.is_cancelled());
+		ZN_TEST_ASSERT(!grand_child.is_cancelled());
+
+		parent.cancel();
+		ZN_TEST_ASSERT(child.is_cancelled());
+		ZN_TEST_ASSERT(grand_child.is_cancelled());
+	}
+	{
+		// Cancelling a child doesn't cancel its parent
+		TaskCancellationToken parent = TaskCancellationToken::create();
+		TaskCancellationToken child = parent.create_child();
+		child.cancel();
+		ZN_TEST_ASSERT(child.is_cancelled());
+		ZN_TEST_ASSERT(!parent.is_cancelled());
+	}
+	{
+		TaskCancellationToken parent = TaskCancellationToken::create();
+		TaskCancellationToken child = parent.create_child();
+		const uint64_t now_usec = Time::get_singleton()->get_ticks_usec();
+
+		parent.set_deadline_usec(now_usec + 1'000'000'000);
+		ZN_TEST_ASSERT(!child.is_cancelled());
+
+		// Deadline in the past
+		parent.set_deadline_usec(1);
+		ZN_TEST_ASSERT(parent.is_cancelled());
+		ZN_TEST_ASSERT(child.is_cancelled());
+	}
+}
+
 // Simulates doing work in every chunk of a grid, where each task will want to access neighbors of each block. If any
 // neighbor fails to get locked, the task is postponed.
 void test_threaded_task_postponing() {
@@ -461,4 +498,70 @@ void test_threaded_task_postponing() {
 #endif
 }
 
+void test_threaded_task_postponing_serial() {
+	// Serial tasks may postpone themselves, like I/O tasks waiting for their turn on a block. When they are picked up
+	// again, they must still not run at the same time as another serial task.
+
+	struct TaskCounter {
+		std::atomic_uint32_t max_count = { 0 };
+		std::atomic_uint32_t current_count = { 0 };
+		std::atomic_uint32_t completed_count = { 0 };
+	};
+
+	class TestTask : public IThreadedTask {
+	public:
+		TaskCounter &counter;
+		unsigned int postpone_count;
+
+		TestTask(TaskCounter &p_counter, unsigned int p_postpone_count) :
+				counter(p_counter), postpone_count(p_postpone_count) {}
+
+		void run(ThreadedTaskContext &ctx) override {
+			ZN_PROFILE_SCOPE();
+
+			const unsigned int current_count = ++counter.current_count;
+			unsigned int prev_max = counter.max_count;
+			while (prev_max < current_count && !counter.max_count.compare_exchange_weak(prev_max, current_count)) {
+			}
+
+			if (postpone_count > 0) {
+				--postpone_count;
+				--counter.current_count;
+				ctx.status = ThreadedTaskContext::STATUS_POSTPONED;
+				return;
+			}
+
+			Thread::sleep_usec(1000);
+
+			--counter.current_count;
+			++counter.completed_count;
+		}
+
+		const char *get_debug_name() const override {
+			return "TestTask";
+		}
+	};
+
+	ThreadedTaskRunner runner;
+	runner.set_thread_count(4);
+	runner.set_name("Test");
+
+	TaskCounter counter;
+	const unsigned int task_count = 32;
+
+	for (unsigned int i = 0; i < task_count; ++i) {
+		TestTask *task = ZN_NEW(TestTask(counter, i % 3));
+		runner.enqueue(task, true);
+	}
+
+	runner.wait_for_all_tasks();
+	runner.dequeue_completed_tasks([](IThreadedTask *task) {
+		ZN_DELETE(task);
+	});
+
+	ZN_TEST_ASSERT(counter.completed_count == task_count);
+	ZN_TEST_ASSERT(counter.max_count == 1);
+	ZN_TEST_ASSERT(counter.current_count == 0);
+}
+
 } // namespace zylann::tests
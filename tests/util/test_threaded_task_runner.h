@@ -6,7 +6,9 @@ namespace zylann::tests {
 void test_threaded_task_runner_misc();
 void test_threaded_task_runner_debug_names();
 void test_task_priority_values();
+void test_task_cancellation_token_hierarchy();
 void test_threaded_task_postponing();
+void test_threaded_task_postponing_serial();
 
 } // namespace zylann::tests
 
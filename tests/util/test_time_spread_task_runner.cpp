@@ -0,0 +1,189 @@
+#include "test_time_spread_task_runner.h"
+#include "../../util/containers/container_funcs.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/memory/memory.h"
+#include "../../util/tasks/adaptive_time_budget.h"
+#include "../../util/tasks/time_spread_task_runner.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::tests {
+
+namespace {
+
+// Time only advances when tasks run, so budgets can be checked exactly
+uint64_t g_fake_time_usec = 0;
+
+uint64_t get_fake_ticks_usec() {
+	return g_fake_time_usec;
+}
+
+class FakeTask : public ITimeSpreadTask {
+public:
+	FakeTask(int p_id, uint32_t p_cost_usec, StdVector<int> *p_run_order) :
+			id(p_id), cost_usec(p_cost_usec), run_order(p_run_order) {}
+
+	void run(TimeSpreadTaskContext &ctx) override {
+		g_fake_time_usec += cost_usec;
+		if (run_order != nullptr) {
+			run_order->push_back(id);
+		}
+	}
+
+	int id;
+	uint32_t cost_usec;
+	StdVector<int> *run_order;
+};
+
+void push_fake_tasks(
+		TimeSpreadTaskRunner &runner,
+		unsigned int count,
+		uint8_t category,
+		TimeSpreadTaskRunner::Priority priority = TimeSpreadTaskRunner::PRIORITY_NORMAL,
+		StdVector<int> *run_order = nullptr,
+		int id = 0
+) {
+	for (unsigned int i = 0; i < count; ++i) {
+		runner.push(ZN_NEW(FakeTask(id, 100, run_order)), priority, category);
+	}
+}
+
+void init_fake_runner(TimeSpreadTaskRunner &runner) {
+	runner.set_clock(get_fake_ticks_usec);
+	runner.set_category_weight(0, 1.f);
+	runner.set_category_weight(1, 1.f);
+	// Category 2 has no weight, it only gets time left over by the others
+}
+
+} // namespace
+
+void test_time_spread_task_runner_category_budgets() {
+	{
+		// All categories have work: weighted ones split the budget, and nothing is left for the last one
+		TimeSpreadTaskRunner runner;
+		init_fake_runner(runner);
+		push_fake_tasks(runner, 20, 0);
+		push_fake_tasks(runner, 20, 1);
+		push_fake_tasks(runner, 20, 2);
+
+		runner.process(1000);
+
+		ZN_TEST_ASSERT(runner.get_category_stats(0).last_run_count == 5);
+		ZN_TEST_ASSERT(runner.get_category_stats(1).last_run_count == 5);
+		ZN_TEST_ASSERT(runner.get_category_stats(2).last_run_count == 0);
+		ZN_TEST_ASSERT(runner.get_category_stats(0).last_time_usec == 500);
+		ZN_TEST_ASSERT(runner.get_category_stats(2).pending_count == 20);
+	}
+	{
+		// Time left unused in the first pass goes to the next categories in the second pass
+		TimeSpreadTaskRunner runner;
+		init_fake_runner(runner);
+		push_fake_tasks(runner, 2, 0);
+		push_fake_tasks(runner, 2, 1);
+		push_fake_tasks(runner, 20, 2);
+
+		runner.process(1000);
+
+		ZN_TEST_ASSERT(runner.get_category_stats(0).last_run_count == 2);
+		ZN_TEST_ASSERT(runner.get_category_stats(1).last_run_count == 2);
+		ZN_TEST_ASSERT(runner.get_category_stats(2).last_run_count == 6);
+		ZN_TEST_ASSERT(runner.get_category_stats(2).last_budget_usec == 600);
+	}
+	{
+		// Time reported outside of tasks is deducted from the budget of the next call
+		TimeSpreadTaskRunner runner;
+		init_fake_runner(runner);
+		push_fake_tasks(runner, 20, 0);
+		push_fake_tasks(runner, 20, 1);
+		runner.add_external_time_usage(2, 600);
+
+		runner.process(1000);
+
+		ZN_TEST_ASSERT(runner.get_category_stats(0).last_run_count == 2);
+		ZN_TEST_ASSERT(runner.get_category_stats(1).last_run_count == 2);
+		ZN_TEST_ASSERT(runner.get_category_stats(2).last_time_usec == 600);
+
+		// Even without budget left, categories with a weight run at least one task
+		runner.add_external_time_usage(2, 2000);
+
+		runner.process(1000);
+
+		ZN_TEST_ASSERT(runner.get_category_stats(0).last_run_count == 1);
+		ZN_TEST_ASSERT(runner.get_category_stats(1).last_run_count == 1);
+	}
+}
+
+void test_time_spread_task_runner_aging() {
+	const int low_priority_task_id = -1;
+	const uint32_t aging_threshold = 3;
+
+	for (const bool aging : { true, false }) {
+		// Declared before the runner, because remaining tasks run when it gets destroyed
+		StdVector<int> run_order;
+
+		TimeSpreadTaskRunner runner;
+		init_fake_runner(runner);
+		runner.set_aging_threshold(aging ? aging_threshold : 1000);
+
+		push_fake_tasks(runner, 1, 0, TimeSpreadTaskRunner::PRIORITY_LOW, &run_order, low_priority_task_id);
+
+		// A steady stream of normal-priority tasks, with only enough budget for one task per call
+		for (int i = 0; i < 10; ++i) {
+			push_fake_tasks(runner, 1, 0, TimeSpreadTaskRunner::PRIORITY_NORMAL, &run_order, i);
+			runner.process(0);
+		}
+
+		ZN_TEST_ASSERT(run_order.size() == 10);
+		const bool low_priority_task_ran =
+				contains(run_order, [low_priority_task_id](int id) { return id == low_priority_task_id; });
+		if (aging) {
+			// Promoted after waiting `aging_threshold` calls, then it runs after the normal task pushed before it
+			ZN_TEST_ASSERT(low_priority_task_ran);
+			ZN_TEST_ASSERT(run_order[aging_threshold] == low_priority_task_id);
+		} else {
+			ZN_TEST_ASSERT(!low_priority_task_ran);
+		}
+	}
+}
+
+void test_adaptive_time_budget() {
+	AdaptiveTimeBudget budget;
+	budget.set_max_usec(8000);
+	budget.set_target_frame_time_usec(16000);
+
+	uint64_t now_usec = 1000;
+	budget.update(now_usec);
+	ZN_TEST_ASSERT(budget.get_usec() == 8000);
+
+	// Frames longer than the target shrink the budget
+	now_usec += 30000;
+	budget.update(now_usec);
+	ZN_TEST_ASSERT(budget.get_usec() == 6000);
+	now_usec += 30000;
+	budget.update(now_usec);
+	ZN_TEST_ASSERT(budget.get_usec() == 4500);
+
+	// Down to a minimum
+	for (unsigned int i = 0; i < 20; ++i) {
+		now_usec += 30000;
+		budget.update(now_usec);
+	}
+	ZN_TEST_ASSERT(budget.get_usec() == 1000);
+
+	// Shorter frames grow it back slowly, up to the maximum
+	now_usec += 10000;
+	budget.update(now_usec);
+	ZN_TEST_ASSERT(budget.get_usec() == 1500);
+	for (unsigned int i = 0; i < 20; ++i) {
+		now_usec += 10000;
+		budget.update(now_usec);
+	}
+	ZN_TEST_ASSERT(budget.get_usec() == 8000);
+
+	// Without target, the budget stays at its maximum
+	budget.set_target_frame_time_usec(0);
+	now_usec += 30000;
+	budget.update(now_usec);
+	ZN_TEST_ASSERT(budget.get_usec() == 8000);
+}
+
+} // namespace zylann::tests
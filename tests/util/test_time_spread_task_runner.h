@@ -0,0 +1,12 @@
+#ifndef ZN_TEST_TIME_SPREAD_TASK_RUNNER_H
+#define ZN_TEST_TIME_SPREAD_TASK_RUNNER_H
+
+namespace zylann::tests {
+
+void test_time_spread_task_runner_category_budgets();
+void test_time_spread_task_runner_aging();
+void test_adaptive_time_budget();
+
+} // namespace zylann::tests
+
+#endif // ZN_TEST_TIME_SPREAD_TASK_RUNNER_H
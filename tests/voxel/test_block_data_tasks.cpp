@@ -0,0 +1,184 @@
+#include "test_block_data_tasks.h"
+#include "../../engine/voxel_engine.h"
+#include "../../storage/voxel_data.h"
+#include "../../streams/load_block_data_task.h"
+#include "../../streams/save_block_data_task.h"
+#include "../../streams/voxel_stream_memory.h"
+#include "../../util/containers/std_unordered_map.h"
+#include "../../util/tasks/threaded_task_runner.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::voxel::tests {
+
+void test_save_then_load_block_data_tasks_ordering() {
+	// When I/O tasks run in parallel, threads can pick them up in any order. A load created after a save on the same
+	// block must still see the saved data.
+
+	struct Output {
+		std::shared_ptr<VoxelBuffer> loaded_voxels;
+
+		static void on_data(void *cb_data, VoxelEngine::BlockDataOutput &ob) {
+			Output *self = static_cast<Output *>(cb_data);
+			if (ob.type == VoxelEngine::BlockDataOutput::TYPE_LOADED) {
+				self->loaded_voxels = ob.voxels;
+			}
+		}
+
+		static void on_mesh(void *cb_data, VoxelEngine::BlockMeshOutput &ob) {}
+	};
+
+	Output output;
+
+	VoxelEngine::VolumeCallbacks callbacks;
+	callbacks.data_output_callback = Output::on_data;
+	callbacks.mesh_output_callback = Output::on_mesh;
+	callbacks.data = &output;
+	const VolumeID volume_id = VoxelEngine::get_singleton().add_volume(callbacks);
+
+	Ref<VoxelStreamMemory> stream;
+	stream.instantiate();
+
+	std::shared_ptr<StreamingDependency> stream_dependency = make_shared_instance<StreamingDependency>();
+	stream_dependency->stream = stream;
+
+	std::shared_ptr<VoxelData> voxel_data = make_shared_instance<VoxelData>();
+
+	const Vector3i block_position(1, 2, 3);
+	const unsigned int block_size = 16;
+	const uint64_t saved_value = 42;
+
+	std::shared_ptr<VoxelBuffer> saved_voxels = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_DEFAULT);
+	saved_voxels->create(Vector3iUtil::create(block_size));
+	saved_voxels->fill(saved_value, VoxelBuffer::CHANNEL_TYPE);
+
+	{
+		SaveBlockDataTask save_task(volume_id, block_position, 0, saved_voxels, stream_dependency, nullptr, false);
+
+		LoadBlockDataTask load_task(
+				volume_id,
+				block_position,
+				0,
+				block_size,
+				false,
+				stream_dependency,
+				PriorityDependency(),
+				false,
+				false,
+				voxel_data,
+				TaskCancellationToken()
+		);
+
+		// Run the load first, as if another thread picked it up before the save
+		{
+			ThreadedTaskContext ctx(0, TaskPriority());
+			load_task.run(ctx);
+			ZN_TEST_ASSERT(ctx.status == ThreadedTaskContext::STATUS_POSTPONED);
+		}
+		{
+			ThreadedTaskContext ctx(0, TaskPriority());
+			save_task.run(ctx);
+			ZN_TEST_ASSERT(ctx.status == ThreadedTaskContext::STATUS_COMPLETE);
+		}
+		{
+			ThreadedTaskContext ctx(0, TaskPriority());
+			load_task.run(ctx);
+			ZN_TEST_ASSERT(ctx.status == ThreadedTaskContext::STATUS_COMPLETE);
+		}
+
+		load_task.apply_result();
+	}
+
+	ZN_TEST_ASSERT(output.loaded_voxels != nullptr);
+	ZN_TEST_ASSERT(output.loaded_voxels->get_voxel(Vector3i(1, 2, 3), VoxelBuffer::CHANNEL_TYPE) == saved_value);
+	ZN_TEST_ASSERT(stream_dependency->io_ordering.get_pending_block_count() == 0);
+
+	VoxelEngine::get_singleton().remove_volume(volume_id);
+}
+
+void test_save_then_load_block_data_tasks_serial() {
+	// Without a dedicated I/O thread pool, I/O tasks run in serial on the general pool. Loads have higher priority than
+	// saves, so they get picked first and have to postpone themselves until the save on the same block is done.
+
+	struct Output {
+		StdUnorderedMap<Vector3i, std::shared_ptr<VoxelBuffer>> loaded_voxels;
+
+		static void on_data(void *cb_data, VoxelEngine::BlockDataOutput &ob) {
+			Output *self = static_cast<Output *>(cb_data);
+			if (ob.type == VoxelEngine::BlockDataOutput::TYPE_LOADED) {
+				self->loaded_voxels[ob.position] = ob.voxels;
+			}
+		}
+
+		static void on_mesh(void *cb_data, VoxelEngine::BlockMeshOutput &ob) {}
+	};
+
+	Output output;
+
+	VoxelEngine::VolumeCallbacks callbacks;
+	callbacks.data_output_callback = Output::on_data;
+	callbacks.mesh_output_callback = Output::on_mesh;
+	callbacks.data = &output;
+	const VolumeID volume_id = VoxelEngine::get_singleton().add_volume(callbacks);
+
+	Ref<VoxelStreamMemory> stream;
+	stream.instantiate();
+
+	std::shared_ptr<StreamingDependency> stream_dependency = make_shared_instance<StreamingDependency>();
+	stream_dependency->stream = stream;
+
+	std::shared_ptr<VoxelData> voxel_data = make_shared_instance<VoxelData>();
+
+	const unsigned int block_size = 16;
+	const int block_count = 8;
+
+	ThreadedTaskRunner runner;
+	runner.set_thread_count(4);
+	runner.set_name("Test");
+
+	for (int i = 0; i < block_count; ++i) {
+		const Vector3i block_position(i, 0, 0);
+
+		std::shared_ptr<VoxelBuffer> saved_voxels = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_DEFAULT);
+		saved_voxels->create(Vector3iUtil::create(block_size));
+		saved_voxels->fill(i + 1, VoxelBuffer::CHANNEL_TYPE);
+
+		SaveBlockDataTask *save_task = ZN_NEW(
+				SaveBlockDataTask(volume_id, block_position, 0, saved_voxels, stream_dependency, nullptr, false)
+		);
+		runner.enqueue(save_task, true);
+
+		LoadBlockDataTask *load_task = ZN_NEW(LoadBlockDataTask(
+				volume_id,
+				block_position,
+				0,
+				block_size,
+				false,
+				stream_dependency,
+				PriorityDependency(),
+				false,
+				false,
+				voxel_data,
+				TaskCancellationToken()
+		));
+		runner.enqueue(load_task, true);
+	}
+
+	runner.wait_for_all_tasks();
+	runner.dequeue_completed_tasks([](IThreadedTask *task) {
+		task->apply_result();
+		ZN_DELETE(task);
+	});
+
+	ZN_TEST_ASSERT(output.loaded_voxels.size() == size_t(block_count));
+	for (int i = 0; i < block_count; ++i) {
+		auto it = output.loaded_voxels.find(Vector3i(i, 0, 0));
+		ZN_TEST_ASSERT(it != output.loaded_voxels.end());
+		ZN_TEST_ASSERT(it->second != nullptr);
+		ZN_TEST_ASSERT(it->second->get_voxel(Vector3i(1, 2, 3), VoxelBuffer::CHANNEL_TYPE) == uint64_t(i + 1));
+	}
+	ZN_TEST_ASSERT(stream_dependency->io_ordering.get_pending_block_count() == 0);
+
+	VoxelEngine::get_singleton().remove_volume(volume_id);
+}
+
+} // namespace zylann::voxel::tests
@@ -0,0 +1,11 @@
+#ifndef VOXEL_TEST_BLOCK_DATA_TASKS_H
+#define VOXEL_TEST_BLOCK_DATA_TASKS_H
+
+namespace zylann::voxel::tests {
+
+void test_save_then_load_block_data_tasks_ordering();
+void test_save_then_load_block_data_tasks_serial();
+
+} // namespace zylann::voxel::tests
+
+#endif // VOXEL_TEST_BLOCK_DATA_TASKS_H
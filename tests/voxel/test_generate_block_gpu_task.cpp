@@ -0,0 +1,77 @@
+#include "test_generate_block_gpu_task.h"
+#include "../../engine/voxel_engine.h"
+#include "../../generators/generate_block_gpu_task.h"
+#include "../../generators/generate_block_task.h"
+#include "../../generators/graph/voxel_generator_graph.h"
+#include "../../util/godot/classes/time.h"
+#include "../../util/testing/test_macros.h"
+#include "../../util/thread/thread.h"
+
+namespace zylann::voxel::tests {
+
+void test_generate_block_gpu_task_discard() {
+	// When a GPU task is discarded, its consumer must complete as dropped, even if it doesn't consider itself
+	// cancelled otherwise
+
+	struct Output {
+		bool received = false;
+		bool dropped = false;
+
+		static void on_data(void *cb_data, VoxelEngine::BlockDataOutput &ob) {
+			Output *self = static_cast<Output *>(cb_data);
+			self->received = true;
+			self->dropped = ob.dropped;
+		}
+
+		static void on_mesh(void *cb_data, VoxelEngine::BlockMeshOutput &ob) {}
+	};
+
+	Output output;
+
+	VoxelEngine::VolumeCallbacks callbacks;
+	callbacks.data_output_callback = Output::on_data;
+	callbacks.mesh_output_callback = Output::on_mesh;
+	callbacks.data = &output;
+	const VolumeID volume_id = VoxelEngine::get_singleton().add_volume(callbacks);
+
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	generator->load_plane_preset();
+
+	// The only viewer is right next to the block, so it is never too far to be generated
+	std::shared_ptr<PriorityDependency::ViewersData> viewers = make_shared_instance<PriorityDependency::ViewersData>();
+	viewers->viewers.push_back(Vector3f());
+	viewers->viewers_count = 1;
+
+	VoxelGenerator::BlockTaskParams params;
+	params.volume_id = volume_id;
+	params.block_size = 16;
+	params.priority_dependency.shared = viewers;
+	params.priority_dependency.drop_distance_squared = 1000000.f;
+	params.stream_dependency = make_shared_instance<StreamingDependency>();
+	params.stream_dependency->generator = generator;
+
+	GenerateBlockTask *task = ZN_NEW(GenerateBlockTask(params));
+	ZN_TEST_ASSERT(!task->is_cancelled());
+
+	{
+		GenerateBlockGPUTask gpu_task;
+		gpu_task.consumer_task = task;
+		// Gives the consumer back to the engine
+		gpu_task.discard();
+		ZN_TEST_ASSERT(gpu_task.consumer_task == nullptr);
+	}
+
+	const uint64_t time_before = Time::get_singleton()->get_ticks_msec();
+	while (!output.received) {
+		ZN_TEST_ASSERT(Time::get_singleton()->get_ticks_msec() - time_before < 5000);
+		Thread::sleep_usec(1000);
+		VoxelEngine::get_singleton().process();
+	}
+
+	ZN_TEST_ASSERT(output.dropped);
+
+	VoxelEngine::get_singleton().remove_volume(volume_id);
+}
+
+} // namespace zylann::voxel::tests
@@ -0,0 +1,10 @@
+#ifndef VOXEL_TEST_GENERATE_BLOCK_GPU_TASK_H
+#define VOXEL_TEST_GENERATE_BLOCK_GPU_TASK_H
+
+namespace zylann::voxel::tests {
+
+void test_generate_block_gpu_task_discard();
+
+} // namespace zylann::voxel::tests
+
+#endif // VOXEL_TEST_GENERATE_BLOCK_GPU_TASK_H
@@ -1,5 +1,9 @@
 #include "test_transvoxel.h"
+#include "../../meshers/transvoxel/transvoxel_materials_mixel4.h"
 #include "../../meshers/transvoxel/voxel_mesher_transvoxel.h"
+#include "../../util/godot/classes/rendering_server.h"
+#include "../../util/godot/core/random_pcg.h"
+#include "../../util/math/conv.h"
 #include "../../util/testing/test_macros.h"
 
 namespace zylann::voxel::tests {
@@ -40,4 +44,422 @@ void test_transvoxel_issue772() {
 	ZN_TEST_ASSERT(!VoxelMesher::is_mesh_empty(output.surfaces));
 }
 
+void test_transvoxel_mixel4_texture_selection() {
+	using namespace transvoxel::materials::mixel4;
+
+	static const unsigned int CORNER_COUNT = 8;
+	static const unsigned int CELL_COUNT = 1000;
+
+	StdVector<uint16_t> indices_data;
+	StdVector<uint16_t> weights_data;
+	StdVector<unsigned int> case_codes;
+
+	RandomPCG rng;
+	rng.seed(131183);
+
+	for (unsigned int cell_index = 0; cell_index < CELL_COUNT; ++cell_index) {
+		// Most cells share the same indices in all their corners, which has a fast path. Sometimes they don't, or
+		// contain duplicate indices.
+		const unsigned int cell_kind = rng.rand() % 4;
+		const uint16_t shared_indices = mixel4::encode_indices_to_packed_u16(
+				rng.rand() % 4, 4 + rng.rand() % 4, 8 + rng.rand() % 4, 12 + rng.rand() % 4
+		);
+		for (unsigned int ci = 0; ci < CORNER_COUNT; ++ci) {
+			switch (cell_kind) {
+				case 0:
+				case 1:
+					indices_data.push_back(shared_indices);
+					break;
+				case 2:
+					indices_data.push_back(mixel4::encode_indices_to_packed_u16(
+							rng.rand() % 16, rng.rand() % 16, rng.rand() % 16, rng.rand() % 16
+					));
+					break;
+				default:
+					indices_data.push_back(mixel4::encode_indices_to_packed_u16(3, 3, 7, rng.rand() % 16));
+					break;
+			}
+			weights_data.push_back(rng.rand() & 0xffff);
+		}
+		case_codes.push_back(cell_kind == 0 ? 0 : rng.rand() & 0xff);
+	}
+
+	const WeightSamplerPackedU16 weights_sampler{ to_span(weights_data) };
+	const auto greater = [](unsigned int a, unsigned int b) { return a > b; };
+
+	for (unsigned int cell_index = 0; cell_index < CELL_COUNT; ++cell_index) {
+		FixedArray<unsigned int, CORNER_COUNT> voxel_indices;
+		for (unsigned int ci = 0; ci < CORNER_COUNT; ++ci) {
+			voxel_indices[ci] = cell_index * CORNER_COUNT + ci;
+		}
+		const unsigned int case_code = case_codes[cell_index];
+
+		const CellTextureDatas<CORNER_COUNT> cell_textures = select_textures_4_per_voxel(
+				voxel_indices, to_span_const(indices_data), weights_sampler, case_code
+		);
+
+		// Expected result: the 4 textures with the highest sum of weights over solid corners. Ties are not
+		// checked, since textures are interchangeable if they have the same weights.
+		FixedArray<FixedArray<uint8_t, MAX_TEXTURES>, CORNER_COUNT> expected_weights;
+		FixedArray<unsigned int, MAX_TEXTURES> weight_sums;
+		fill(weight_sums, 0u);
+		for (unsigned int ci = 0; ci < CORNER_COUNT; ++ci) {
+			fill(expected_weights[ci], uint8_t(0));
+			if ((case_code & (1 << ci)) != 0) {
+				continue;
+			}
+			const FixedArray<uint8_t, 4> indices =
+					mixel4::decode_indices_from_packed_u16(indices_data[voxel_indices[ci]]);
+			const FixedArray<uint8_t, 4> weights = weights_sampler.get_weights(voxel_indices[ci]);
+			for (unsigned int i = 0; i < indices.size(); ++i) {
+				weight_sums[indices[i]] += weights[i];
+				expected_weights[ci][indices[i]] = weights[i];
+			}
+		}
+		FixedArray<unsigned int, MAX_TEXTURES> sorted_weight_sums = weight_sums;
+		std::sort(sorted_weight_sums.begin(), sorted_weight_sums.end(), greater);
+
+		// Indices must be sorted, without duplicates
+		ZN_TEST_ASSERT(cell_textures.indices[0] < cell_textures.indices[1]);
+		ZN_TEST_ASSERT(cell_textures.indices[1] < cell_textures.indices[2]);
+		ZN_TEST_ASSERT(cell_textures.indices[2] < cell_textures.indices[3]);
+		ZN_TEST_ASSERT(cell_textures.indices[3] < MAX_TEXTURES);
+		ZN_TEST_ASSERT(cell_textures.packed_indices == transvoxel::materials::pack_bytes(cell_textures.indices));
+
+		FixedArray<unsigned int, MAX_TEXTURE_BLENDS> selected_weight_sums;
+		for (unsigned int i = 0; i < MAX_TEXTURE_BLENDS; ++i) {
+			selected_weight_sums[i] = weight_sums[cell_textures.indices[i]];
+		}
+		std::sort(selected_weight_sums.begin(), selected_weight_sums.end(), greater);
+		for (unsigned int i = 0; i < MAX_TEXTURE_BLENDS; ++i) {
+			ZN_TEST_ASSERT(selected_weight_sums[i] == sorted_weight_sums[i]);
+		}
+
+		for (unsigned int ci = 0; ci < CORNER_COUNT; ++ci) {
+			for (unsigned int i = 0; i < MAX_TEXTURE_BLENDS; ++i) {
+				ZN_TEST_ASSERT(cell_textures.weights[ci][i] == expected_weights[ci][cell_textures.indices[i]]);
+			}
+		}
+	}
+}
+
+void test_transvoxel_packed_surface() {
+#ifdef ZN_GODOT_PACKED_SURFACE_SUPPORTED
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3iUtil::create(20));
+	{
+		const Vector3 center = to_vec3(voxels.get_size()) * 0.5f;
+		Vector3i pos;
+		for (pos.z = 0; pos.z < voxels.get_size().z; ++pos.z) {
+			for (pos.x = 0; pos.x < voxels.get_size().x; ++pos.x) {
+				for (pos.y = 0; pos.y < voxels.get_size().y; ++pos.y) {
+					const float sd = to_vec3(pos).distance_to(center) - 7.5f;
+					voxels.set_voxel_f(sd, pos, VoxelBuffer::CHANNEL_SDF);
+				}
+			}
+		}
+	}
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+
+	VoxelMesher::Output output;
+	mesher->build(output, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 0, false, true, false, false });
+
+	VoxelMesher::Output packed_output;
+	mesher->build(packed_output, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 0, false, true, false, true });
+
+	ZN_TEST_ASSERT(output.surfaces.size() == 1);
+	ZN_TEST_ASSERT(packed_output.surfaces.size() == 1);
+	ZN_TEST_ASSERT(output.surfaces[0].packed.is_empty());
+
+	const Array &arrays = output.surfaces[0].arrays;
+	const zylann::godot::PackedSurface &packed = packed_output.surfaces[0].packed;
+
+	const PackedVector3Array positions = arrays[Mesh::ARRAY_VERTEX];
+	const PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+	const PackedFloat32Array lod_data = arrays[Mesh::ARRAY_CUSTOM0];
+	const PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
+	const unsigned int vertex_count = positions.size();
+
+	ZN_TEST_ASSERT(vertex_count > 0 && vertex_count <= 65536);
+	ZN_TEST_ASSERT(packed.vertex_count == vertex_count);
+	ZN_TEST_ASSERT(packed.index_count == static_cast<uint32_t>(indices.size()));
+	ZN_TEST_ASSERT((packed.format & Mesh::ARRAY_FORMAT_NORMAL) != 0);
+	ZN_TEST_ASSERT((packed.format & Mesh::ARRAY_FORMAT_CUSTOM0) != 0);
+	ZN_TEST_ASSERT((packed.format & Mesh::ARRAY_FORMAT_CUSTOM1) == 0);
+	ZN_TEST_ASSERT((packed.format & output.mesh_flags) == output.mesh_flags);
+
+	// Arrays are still filled with what collisions and instancing need
+	const Array &packed_arrays = packed_output.surfaces[0].arrays;
+	ZN_TEST_ASSERT(packed_arrays[Mesh::ARRAY_VERTEX] == arrays[Mesh::ARRAY_VERTEX]);
+	ZN_TEST_ASSERT(packed_arrays[Mesh::ARRAY_NORMAL] == arrays[Mesh::ARRAY_NORMAL]);
+	ZN_TEST_ASSERT(packed_arrays[Mesh::ARRAY_INDEX] == arrays[Mesh::ARRAY_INDEX]);
+	ZN_TEST_ASSERT(packed_arrays[Mesh::ARRAY_CUSTOM0].get_type() == Variant::NIL);
+
+	// Positions first, then octahedral normals
+	ZN_TEST_ASSERT(packed.vertex_data.size() == static_cast<int64_t>(vertex_count * (12 + 4)));
+	const float *packed_positions = reinterpret_cast<const float *>(packed.vertex_data.ptr());
+	const uint16_t *packed_normals = reinterpret_cast<const uint16_t *>(packed.vertex_data.ptr() + vertex_count * 12);
+	for (unsigned int i = 0; i < vertex_count; ++i) {
+		const Vector3 pos(packed_positions[i * 3], packed_positions[i * 3 + 1], packed_positions[i * 3 + 2]);
+		ZN_TEST_ASSERT(pos == positions[i]);
+		ZN_TEST_ASSERT(packed.aabb.grow(0.001).has_point(pos));
+
+		const Vector2 encoded_normal(packed_normals[i * 2] / 65535.f, packed_normals[i * 2 + 1] / 65535.f);
+		const Vector3 normal = Vector3::octahedron_decode(encoded_normal);
+		ZN_TEST_ASSERT(normal.distance_to(normals[i].normalized()) < 0.001f);
+	}
+
+	// Custom attributes
+	ZN_TEST_ASSERT(packed.attribute_data.size() == static_cast<int64_t>(lod_data.size() * sizeof(float)));
+	ZN_TEST_ASSERT(memcmp(packed.attribute_data.ptr(), lod_data.ptr(), packed.attribute_data.size()) == 0);
+
+	// 16-bit indices
+	ZN_TEST_ASSERT(packed.index_data.size() == static_cast<int64_t>(indices.size() * sizeof(uint16_t)));
+	const uint16_t *packed_indices = reinterpret_cast<const uint16_t *>(packed.index_data.ptr());
+	for (int i = 0; i < indices.size(); ++i) {
+		ZN_TEST_ASSERT(packed_indices[i] == indices[i]);
+	}
+
+	// Compare with how Godot converts arrays, if the RenderingServer is available
+	RenderingServer *rs = RenderingServer::get_singleton();
+	if (rs != nullptr) {
+		RenderingServer::SurfaceData surface_data;
+		const Error err = rs->mesh_create_surface_data_from_arrays(
+				&surface_data, RenderingServer::PRIMITIVE_TRIANGLES, arrays, Array(), Dictionary(), output.mesh_flags
+		);
+		ZN_TEST_ASSERT(err == OK);
+		ZN_TEST_ASSERT(surface_data.format == (packed.format | RenderingServer::ARRAY_FLAG_FORMAT_CURRENT_VERSION));
+		ZN_TEST_ASSERT(surface_data.vertex_data == packed.vertex_data);
+		ZN_TEST_ASSERT(surface_data.attribute_data == packed.attribute_data);
+		ZN_TEST_ASSERT(surface_data.index_data == packed.index_data);
+	}
+#endif
+}
+
+namespace {
+
+// Bumpy sloped ground, so the surface crosses the sides of the block
+void generate_sloped_ground(VoxelBuffer &voxels) {
+	voxels.create(Vector3iUtil::create(20));
+	Vector3i pos;
+	for (pos.z = 0; pos.z < voxels.get_size().z; ++pos.z) {
+		for (pos.x = 0; pos.x < voxels.get_size().x; ++pos.x) {
+			for (pos.y = 0; pos.y < voxels.get_size().y; ++pos.y) {
+				const float sd = pos.y - 8.2f - 0.3f * pos.x + 0.2f * pos.z + Math::sin(pos.x * 0.7f) * 0.5f;
+				voxels.set_voxel_f(sd, pos, VoxelBuffer::CHANNEL_SDF);
+			}
+		}
+	}
+}
+
+} // namespace
+
+void test_transvoxel_vertex_compression() {
+	struct L {
+		static unsigned int get_custom0_format(uint32_t mesh_flags) {
+			return (mesh_flags >> Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT) & Mesh::ARRAY_FORMAT_CUSTOM_MASK;
+		}
+	};
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	generate_sloped_ground(voxels);
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+	mesher->set_vertex_compression_enabled(true);
+	mesher->set_vertex_compression_begin_lod_index(2);
+
+	// Below the first compressed LOD, the regular layout is used
+	{
+		VoxelMesher::Output output;
+		mesher->build(output, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 1, false, true, false, false });
+		ZN_TEST_ASSERT(output.surfaces.size() == 1);
+		const Array &arrays = output.surfaces[0].arrays;
+		const PackedVector3Array positions = arrays[Mesh::ARRAY_VERTEX];
+		const PackedFloat32Array lod_data = arrays[Mesh::ARRAY_CUSTOM0];
+		ZN_TEST_ASSERT(lod_data.size() == positions.size() * 4);
+		ZN_TEST_ASSERT(L::get_custom0_format(output.mesh_flags) == RenderingServer::ARRAY_CUSTOM_RGBA_FLOAT);
+	}
+
+	const uint8_t lod_index = 3;
+	VoxelMesher::Output output;
+	mesher->build(output, VoxelMesher::Input{ voxels, nullptr, Vector3i(), lod_index, false, true, false, true });
+	ZN_TEST_ASSERT(output.surfaces.size() == 1);
+	ZN_TEST_ASSERT(L::get_custom0_format(output.mesh_flags) == RenderingServer::ARRAY_CUSTOM_RG_FLOAT);
+#ifdef ZN_GODOT_MESH_COMPRESSION_SUPPORTED
+	ZN_TEST_ASSERT((output.mesh_flags & Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES) != 0);
+#endif
+	// Compressed surfaces are not packed by the mesher
+	ZN_TEST_ASSERT(output.surfaces[0].packed.is_empty());
+
+	const transvoxel::MeshArrays &src = VoxelMesherTransvoxel::get_mesh_cache_from_current_thread();
+	const Array &arrays = output.surfaces[0].arrays;
+	const PackedVector3Array positions = arrays[Mesh::ARRAY_VERTEX];
+	const PackedFloat32Array lod_data = arrays[Mesh::ARRAY_CUSTOM0];
+	ZN_TEST_ASSERT(positions.size() > 0);
+	ZN_TEST_ASSERT(positions.size() == static_cast<int64_t>(src.lod_data.size()));
+	ZN_TEST_ASSERT(lod_data.size() == positions.size() * 2);
+
+	// Decode the same way shaders do
+	const float max_offset = 1 << lod_index;
+	unsigned int border_vertex_count = 0;
+	for (int i = 0; i < positions.size(); ++i) {
+		int32_t idata;
+		int32_t odata;
+		memcpy(&idata, &lod_data[i * 2], sizeof(idata));
+		memcpy(&odata, &lod_data[i * 2 + 1], sizeof(odata));
+
+		const transvoxel::LodAttrib &expected = src.lod_data[i];
+		ZN_TEST_ASSERT((idata & 63) == expected.cell_border_mask);
+		ZN_TEST_ASSERT(((idata >> 8) & 63) == expected.vertex_border_mask);
+		ZN_TEST_ASSERT(((idata >> 16) & 0xff) == expected.transition);
+		ZN_TEST_ASSERT(((idata >> 24) & 31) == lod_index);
+
+		if (expected.cell_border_mask == 0) {
+			continue;
+		}
+		++border_vertex_count;
+		const Vector3 offset(
+				float((odata & 1023) - 511), float(((odata >> 10) & 1023) - 511), float(((odata >> 20) & 1023) - 511)
+		);
+		const Vector3 secondary_position = positions[i] + offset * (max_offset / 511.f);
+		const Vector3 expected_secondary_position = to_vec3(expected.secondary_position);
+		ZN_TEST_ASSERT(secondary_position.distance_to(expected_secondary_position) < max_offset / 511.f);
+	}
+	ZN_TEST_ASSERT(border_vertex_count > 0);
+}
+
+void test_transvoxel_mesh_optimization_lod() {
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	generate_sloped_ground(voxels);
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+
+	VoxelMesher::Output output;
+	mesher->build(output, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 1, false, false, false, false });
+	ZN_TEST_ASSERT(output.surfaces.size() == 1);
+	const PackedInt32Array indices = output.surfaces[0].arrays[Mesh::ARRAY_INDEX];
+
+	// Vertices on the sides of the block
+	StdVector<Vector3f> border_positions;
+	{
+		const transvoxel::MeshArrays &mesh_arrays = VoxelMesherTransvoxel::get_mesh_cache_from_current_thread();
+		for (unsigned int i = 0; i < mesh_arrays.lod_data.size(); ++i) {
+			if (mesh_arrays.lod_data[i].vertex_border_mask != 0) {
+				border_positions.push_back(mesh_arrays.vertices[i]);
+			}
+		}
+	}
+	ZN_TEST_ASSERT(border_positions.size() > 0);
+
+	VoxelMesher::Output output_lod0;
+	mesher->build(output_lod0, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 0, false, false, false, false });
+	ZN_TEST_ASSERT(output_lod0.surfaces.size() == 1);
+	const PackedInt32Array indices_lod0 = output_lod0.surfaces[0].arrays[Mesh::ARRAY_INDEX];
+
+	mesher->set_mesh_optimization_enabled(true);
+	mesher->set_mesh_optimization_begin_lod_index(1);
+	PackedFloat32Array lod_error_thresholds;
+	lod_error_thresholds.push_back(0.f);
+	lod_error_thresholds.push_back(0.05f);
+	mesher->set_mesh_optimization_lod_error_thresholds(lod_error_thresholds);
+	ZN_TEST_ASSERT(mesher->get_mesh_optimization_lod_error_thresholds() == lod_error_thresholds);
+
+	// Not simplified below the first LOD
+	{
+		VoxelMesher::Output output_lod0_2;
+		mesher->build(output_lod0_2, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 0, false, false, false, false });
+		ZN_TEST_ASSERT(output_lod0_2.surfaces.size() == 1);
+		ZN_TEST_ASSERT(output_lod0_2.surfaces[0].arrays[Mesh::ARRAY_INDEX] == indices_lod0);
+	}
+
+	VoxelMesher::Output simplified_output;
+	mesher->build(simplified_output, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 1, false, false, false, false });
+	ZN_TEST_ASSERT(simplified_output.surfaces.size() == 1);
+	const Array &arrays = simplified_output.surfaces[0].arrays;
+	const PackedVector3Array simplified_positions = arrays[Mesh::ARRAY_VERTEX];
+	const PackedInt32Array simplified_indices = arrays[Mesh::ARRAY_INDEX];
+	ZN_TEST_ASSERT(simplified_indices.size() > 0);
+	ZN_TEST_ASSERT(simplified_indices.size() < indices.size());
+
+	// Border vertices must not move, otherwise seams would appear with neighbor blocks
+	for (const Vector3f border_position : border_positions) {
+		ZN_TEST_ASSERT(simplified_positions.has(to_vec3(border_position)));
+	}
+}
+
+void test_transvoxel_regular_mesh_slabs() {
+	// Sphere crossing the seam between slabs
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.set_channel_depth(VoxelBuffer::CHANNEL_SDF, VoxelBuffer::DEPTH_32_BIT);
+	voxels.create(Vector3iUtil::create(32 + transvoxel::MIN_PADDING + transvoxel::MAX_PADDING));
+	{
+		const Vector3f center(17.3f, 16.1f, 16.7f);
+		Vector3i pos;
+		for (pos.z = 0; pos.z < voxels.get_size().z; ++pos.z) {
+			for (pos.x = 0; pos.x < voxels.get_size().x; ++pos.x) {
+				for (pos.y = 0; pos.y < voxels.get_size().y; ++pos.y) {
+					const float sd = math::distance(to_vec3f(pos), center) - 11.2f;
+					voxels.set_voxel_f(sd, pos, VoxelBuffer::CHANNEL_SDF);
+				}
+			}
+		}
+	}
+
+	for (uint32_t lod_index = 0; lod_index < 2; ++lod_index) {
+		transvoxel::Cache cache;
+
+		transvoxel::MeshArrays expected_mesh;
+		transvoxel::build_regular_mesh(
+				voxels,
+				VoxelBuffer::CHANNEL_SDF,
+				lod_index,
+				transvoxel::TEXTURES_NONE,
+				cache,
+				expected_mesh,
+				nullptr,
+				0.02f,
+				false,
+				0,
+				32
+		);
+		ZN_TEST_ASSERT(expected_mesh.indices.size() > 0);
+
+		transvoxel::MeshArrays mesh;
+		// Slabs of uneven sizes
+		const int slab_bounds[] = { 0, 12, 20, 32 };
+		for (unsigned int slab_index = 0; slab_index < 3; ++slab_index) {
+			transvoxel::MeshArrays slab_mesh;
+			transvoxel::build_regular_mesh(
+					voxels,
+					VoxelBuffer::CHANNEL_SDF,
+					lod_index,
+					transvoxel::TEXTURES_NONE,
+					cache,
+					slab_index == 0 ? mesh : slab_mesh,
+					nullptr,
+					0.02f,
+					false,
+					slab_bounds[slab_index],
+					slab_bounds[slab_index + 1]
+			);
+			if (slab_index > 0) {
+				transvoxel::append_regular_mesh_slab(mesh, slab_mesh, slab_bounds[slab_index] << lod_index);
+			}
+		}
+
+		// Vertices duplicated on seams must have been merged, so the mesh is connected like the one built in one go
+		ZN_TEST_ASSERT(mesh.vertices.size() == expected_mesh.vertices.size());
+		ZN_TEST_ASSERT(mesh.indices.size() == expected_mesh.indices.size());
+		for (unsigned int i = 0; i < mesh.indices.size(); ++i) {
+			const Vector3f p = mesh.vertices[mesh.indices[i]];
+			const Vector3f expected_p = expected_mesh.vertices[expected_mesh.indices[i]];
+			ZN_TEST_ASSERT(p == expected_p);
+		}
+	}
+}
+
 } // namespace zylann::voxel::tests
@@ -4,6 +4,11 @@
 namespace zylann::voxel::tests {
 
 void test_transvoxel_issue772();
+void test_transvoxel_mixel4_texture_selection();
+void test_transvoxel_packed_surface();
+void test_transvoxel_vertex_compression();
+void test_transvoxel_mesh_optimization_lod();
+void test_transvoxel_regular_mesh_slabs();
 
 } // namespace zylann::voxel::tests
 
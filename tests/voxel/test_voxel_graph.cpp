@@ -1,4 +1,5 @@
 #include "test_voxel_graph.h"
+#include "../../constants/voxel_constants.h"
 #include "../../generators/graph/curve_utility.h"
 #include "../../generators/graph/image_range_grid.h"
 #include "../../generators/graph/image_utility.h"
@@ -8,14 +9,17 @@
 #include "../../storage/voxel_buffer.h"
 #include "../../util/containers/container_funcs.h"
 #include "../../util/containers/std_vector.h"
+#include "../../util/godot/classes/directory.h"
 #include "../../util/godot/classes/fast_noise_lite.h"
 #include "../../util/godot/classes/image.h"
 #include "../../util/godot/core/random_pcg.h"
 #include "../../util/math/conv.h"
 #include "../../util/math/sdf.h"
 #include "../../util/noise/fast_noise_lite/fast_noise_lite.h"
+#include "../../util/profiling_clock.h"
 #include "../../util/string/format.h"
 #include "../../util/string/std_string.h"
+#include "../../util/testing/test_directory.h"
 #include "../../util/testing/test_macros.h"
 #include "test_util.h"
 #include <sstream>
@@ -806,6 +810,405 @@ void test_voxel_graph_generate_block_with_input_sdf() {
 	L::test(true, BLOCK_SIZE / 2);
 }
 
+void test_voxel_graph_generate_block_adaptive_subdivision() {
+	static const int BLOCK_SIZE = 32;
+	static const float SPHERE_RADIUS = 20;
+
+	struct L {
+		static void generate(VoxelBuffer &buffer, bool adaptive_subdivision) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			{
+				// X --- SdfSphere --- OutSDF
+				// Y ---/
+				// Z --/
+				VoxelGraphFunction &g = **generator->get_main_function();
+				const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2());
+				const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2());
+				const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2());
+				const uint32_t n_sphere = g.create_node(VoxelGraphFunction::NODE_SDF_SPHERE, Vector2());
+				const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+				g.set_node_default_input(n_sphere, 3, SPHERE_RADIUS);
+				g.add_connection(n_x, 0, n_sphere, 0);
+				g.add_connection(n_y, 0, n_sphere, 1);
+				g.add_connection(n_z, 0, n_sphere, 2);
+				g.add_connection(n_sphere, 0, n_out_sdf, 0);
+			}
+			const pg::CompilationResult compilation_result = generator->compile(false);
+			ZN_TEST_ASSERT(compilation_result.success);
+
+			generator->set_use_subdivision(true);
+			generator->set_subdivision_size(BLOCK_SIZE);
+			generator->set_use_adaptive_subdivision(adaptive_subdivision);
+
+			buffer.create(Vector3i(BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE));
+			buffer.set_channel_depth(VoxelBuffer::CHANNEL_SDF, VoxelBuffer::DEPTH_32_BIT);
+			generator->generate_block(VoxelGenerator::VoxelQueryData{ buffer, Vector3i(), 0 });
+		}
+	};
+
+	// The whole block crosses the surface of the sphere, but its far corner doesn't
+	VoxelBuffer buffer_full(VoxelBuffer::ALLOCATOR_DEFAULT);
+	L::generate(buffer_full, false);
+
+	VoxelBuffer buffer_adaptive(VoxelBuffer::ALLOCATOR_DEFAULT);
+	L::generate(buffer_adaptive, true);
+
+	const float clip_threshold = 1.5f;
+	unsigned int clipped_count = 0;
+
+	Vector3i pos;
+	for (pos.z = 0; pos.z < BLOCK_SIZE; ++pos.z) {
+		for (pos.x = 0; pos.x < BLOCK_SIZE; ++pos.x) {
+			for (pos.y = 0; pos.y < BLOCK_SIZE; ++pos.y) {
+				const float sd_full = buffer_full.get_voxel_f(pos, VoxelBuffer::CHANNEL_SDF);
+				const float sd_adaptive = buffer_adaptive.get_voxel_f(pos, VoxelBuffer::CHANNEL_SDF);
+
+				if (sd_adaptive == constants::SDF_FAR_OUTSIDE) {
+					++clipped_count;
+				}
+
+				// Values can only differ where they are far enough from the surface to be clipped
+				const bool both_outside = sd_full > clip_threshold && sd_adaptive > clip_threshold;
+				const bool both_inside = sd_full < -clip_threshold && sd_adaptive < -clip_threshold;
+				ZN_TEST_ASSERT(Math::is_equal_approx(sd_full, sd_adaptive) || both_outside || both_inside);
+			}
+		}
+	}
+
+	ZN_TEST_ASSERT(clipped_count > 0);
+}
+
+void test_voxel_graph_affine_range_analysis() {
+	struct L {
+		static Ref<VoxelGeneratorGraph> create_generator(bool affine) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			{
+				// X --- Distance2D ---------- Subtract --- Add --- OutSDF
+				// Z --/                     /             /
+				// X --- Multiply(0.5) -----              /
+				// X --- Add --- Subtract ----------------
+				// Y --/        /
+				// X -----------
+				VoxelGraphFunction &g = **generator->get_main_function();
+				const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2());
+				const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2());
+				const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2());
+				const uint32_t n_distance = g.create_node(VoxelGraphFunction::NODE_DISTANCE_2D, Vector2());
+				const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY, Vector2());
+				const uint32_t n_sub0 = g.create_node(VoxelGraphFunction::NODE_SUBTRACT, Vector2());
+				const uint32_t n_add0 = g.create_node(VoxelGraphFunction::NODE_ADD, Vector2());
+				const uint32_t n_sub1 = g.create_node(VoxelGraphFunction::NODE_SUBTRACT, Vector2());
+				const uint32_t n_add1 = g.create_node(VoxelGraphFunction::NODE_ADD, Vector2());
+				const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+				g.add_connection(n_x, 0, n_distance, 2);
+				g.add_connection(n_z, 0, n_distance, 3);
+				g.add_connection(n_x, 0, n_mul, 0);
+				g.set_node_default_input(n_mul, 1, 0.5f);
+				g.add_connection(n_distance, 0, n_sub0, 0);
+				g.add_connection(n_mul, 0, n_sub0, 1);
+				g.add_connection(n_x, 0, n_add0, 0);
+				g.add_connection(n_y, 0, n_add0, 1);
+				g.add_connection(n_add0, 0, n_sub1, 0);
+				g.add_connection(n_x, 0, n_sub1, 1);
+				g.add_connection(n_sub0, 0, n_add1, 0);
+				g.add_connection(n_sub1, 0, n_add1, 1);
+				g.add_connection(n_add1, 0, n_out_sdf, 0);
+			}
+			const pg::CompilationResult compilation_result = generator->compile(false);
+			ZN_TEST_ASSERT(compilation_result.success);
+			generator->set_use_affine_range_analysis(affine);
+			return generator;
+		}
+	};
+
+	Ref<VoxelGeneratorGraph> generator_interval = L::create_generator(false);
+	Ref<VoxelGeneratorGraph> generator_affine = L::create_generator(true);
+
+	const Vector3i min_pos(100, -8, 50);
+	const Vector3i max_pos(116, 8, 66);
+
+	const math::Interval range_interval = generator_interval->debug_analyze_range(min_pos, max_pos, false);
+	const math::Interval range_affine = generator_affine->debug_analyze_range(min_pos, max_pos, false);
+
+	// Both are conservative, but affine arithmetic doesn't lose the correlation between uses of X
+	ZN_TEST_ASSERT(range_interval.contains(range_affine));
+	ZN_TEST_ASSERT(range_affine.length() < range_interval.length() * 0.5f);
+
+	// Values must still be within the estimated range
+	Vector3i pos;
+	for (pos.z = min_pos.z; pos.z <= max_pos.z; pos.z += 4) {
+		for (pos.x = min_pos.x; pos.x <= max_pos.x; pos.x += 4) {
+			for (pos.y = min_pos.y; pos.y <= max_pos.y; pos.y += 4) {
+				const float sd = generator_affine->generate_single(pos, VoxelBuffer::CHANNEL_SDF).f;
+				ZN_TEST_ASSERT(range_affine.padded(0.001f).contains(sd));
+			}
+		}
+	}
+}
+
+void test_voxel_graph_xz_cache() {
+	static const int BLOCK_SIZE = 16;
+
+	struct L {
+		static Ref<VoxelGeneratorGraph> create_generator(int xz_cache_max_memory_mb) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			{
+				// X --- Distance2D --- Multiply(0.5) --- Subtract --- OutSDF
+				// Z --/                                 /
+				// Y ------------------------------------
+				VoxelGraphFunction &g = **generator->get_main_function();
+				const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2());
+				const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2());
+				const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2());
+				const uint32_t n_distance = g.create_node(VoxelGraphFunction::NODE_DISTANCE_2D, Vector2());
+				const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY, Vector2());
+				const uint32_t n_sub = g.create_node(VoxelGraphFunction::NODE_SUBTRACT, Vector2());
+				const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+				g.add_connection(n_x, 0, n_distance, 2);
+				g.add_connection(n_z, 0, n_distance, 3);
+				g.add_connection(n_distance, 0, n_mul, 0);
+				g.set_node_default_input(n_mul, 1, 0.5f);
+				g.add_connection(n_y, 0, n_sub, 0);
+				g.add_connection(n_mul, 0, n_sub, 1);
+				g.add_connection(n_sub, 0, n_out_sdf, 0);
+			}
+			const pg::CompilationResult compilation_result = generator->compile(false);
+			ZN_TEST_ASSERT(compilation_result.success);
+			// Compute every voxel, so every section goes through the cache
+			generator->set_sdf_clip_threshold(10000.f);
+			generator->set_xz_cache_max_memory_mb(xz_cache_max_memory_mb);
+			return generator;
+		}
+
+		static void generate(VoxelGeneratorGraph &generator, VoxelBuffer &buffer, Vector3i origin, uint32_t lod) {
+			buffer.create(Vector3i(BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE));
+			buffer.set_channel_depth(VoxelBuffer::CHANNEL_SDF, VoxelBuffer::DEPTH_32_BIT);
+			generator.generate_block(VoxelGenerator::VoxelQueryData{ buffer, origin, lod });
+		}
+
+		static void check_equal(const VoxelBuffer &a, const VoxelBuffer &b) {
+			Vector3i pos;
+			for (pos.z = 0; pos.z < BLOCK_SIZE; ++pos.z) {
+				for (pos.x = 0; pos.x < BLOCK_SIZE; ++pos.x) {
+					for (pos.y = 0; pos.y < BLOCK_SIZE; ++pos.y) {
+						const float sd_a = a.get_voxel_f(pos, VoxelBuffer::CHANNEL_SDF);
+						const float sd_b = b.get_voxel_f(pos, VoxelBuffer::CHANNEL_SDF);
+						ZN_TEST_ASSERT(sd_a == sd_b);
+					}
+				}
+			}
+		}
+	};
+
+	Ref<VoxelGeneratorGraph> generator_uncached = L::create_generator(0);
+	Ref<VoxelGeneratorGraph> generator_cached = L::create_generator(1);
+
+	// Blocks of the same column re-use values computed by the first one
+	for (int i = 0; i < 3; ++i) {
+		const Vector3i origin(-8, (i - 1) * BLOCK_SIZE, 4);
+
+		VoxelBuffer buffer_uncached(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator_uncached, buffer_uncached, origin, 0);
+
+		VoxelBuffer buffer_cached(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator_cached, buffer_cached, origin, 0);
+
+		L::check_equal(buffer_uncached, buffer_cached);
+	}
+
+	// Values computed at another LOD must not be mixed up
+	{
+		VoxelBuffer buffer_uncached(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator_uncached, buffer_uncached, Vector3i(-8, 0, 4), 1);
+
+		VoxelBuffer buffer_cached(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator_cached, buffer_cached, Vector3i(-8, 0, 4), 1);
+
+		L::check_equal(buffer_uncached, buffer_cached);
+	}
+}
+
+void test_voxel_graph_disk_cache() {
+	static const int BLOCK_SIZE = 16;
+
+	zylann::testing::TestDirectory test_dir;
+	ZN_TEST_ASSERT(test_dir.is_valid());
+	const String cache_dir = test_dir.get_path().path_join("generated_blocks");
+	const String GENERATOR_PATH = "res://test_voxel_graph_disk_cache_generator.tres";
+	const String OTHER_GENERATOR_PATH = "res://test_voxel_graph_disk_cache_other_generator.tres";
+
+	struct L {
+		static Ref<VoxelGeneratorGraph> create_generator(float radius, String cache_dir, String resource_path) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			{
+				// X --- SdfSphere --- OutSDF
+				// Y --/
+				// Z -/
+				VoxelGraphFunction &g = **generator->get_main_function();
+				const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2());
+				const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2());
+				const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2());
+				const uint32_t n_sphere = g.create_node(VoxelGraphFunction::NODE_SDF_SPHERE, Vector2());
+				const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+				g.add_connection(n_x, 0, n_sphere, 0);
+				g.add_connection(n_y, 0, n_sphere, 1);
+				g.add_connection(n_z, 0, n_sphere, 2);
+				g.set_node_default_input(n_sphere, 3, radius);
+				g.add_connection(n_sphere, 0, n_out_sdf, 0);
+			}
+			const pg::CompilationResult compilation_result = generator->compile(false);
+			ZN_TEST_ASSERT(compilation_result.success);
+			generator->set_disk_cache_directory(cache_dir);
+			// Tells generators apart in the cache directory, as if they were saved as resources
+			generator->set_path(resource_path);
+			return generator;
+		}
+
+		static void generate(VoxelGeneratorGraph &generator, VoxelBuffer &buffer, Vector3i origin) {
+			buffer.create(Vector3i(BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE));
+			buffer.set_channel_depth(VoxelBuffer::CHANNEL_SDF, VoxelBuffer::DEPTH_32_BIT);
+			generator.generate_block(VoxelGenerator::VoxelQueryData{ buffer, origin, 0 });
+		}
+
+		static bool is_equal(const VoxelBuffer &a, const VoxelBuffer &b) {
+			Vector3i pos;
+			for (pos.z = 0; pos.z < BLOCK_SIZE; ++pos.z) {
+				for (pos.x = 0; pos.x < BLOCK_SIZE; ++pos.x) {
+					for (pos.y = 0; pos.y < BLOCK_SIZE; ++pos.y) {
+						const float sd_a = a.get_voxel_f(pos, VoxelBuffer::CHANNEL_SDF);
+						const float sd_b = b.get_voxel_f(pos, VoxelBuffer::CHANNEL_SDF);
+						if (sd_a != sd_b) {
+							return false;
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		static int count_cached_blocks(String dir) {
+			int count = DirAccess::get_files_at(dir).size();
+			const PackedStringArray sub_dir_names = DirAccess::get_directories_at(dir);
+			for (const String &sub_dir_name : sub_dir_names) {
+				count += count_cached_blocks(dir.path_join(sub_dir_name));
+			}
+			return count;
+		}
+	};
+
+	const Vector3i origin0(-8, -8, -8);
+	const Vector3i origin1(8, -8, -8);
+
+	VoxelBuffer expected_buffer0(VoxelBuffer::ALLOCATOR_DEFAULT);
+	VoxelBuffer expected_buffer1(VoxelBuffer::ALLOCATOR_DEFAULT);
+	{
+		Ref<VoxelGeneratorGraph> generator = L::create_generator(5.f, "", "");
+		L::generate(**generator, expected_buffer0, origin0);
+		L::generate(**generator, expected_buffer1, origin1);
+	}
+
+	{
+		Ref<VoxelGeneratorGraph> generator = L::create_generator(5.f, cache_dir, GENERATOR_PATH);
+		VoxelBuffer buffer0(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator, buffer0, origin0);
+		ZN_TEST_ASSERT(L::is_equal(expected_buffer0, buffer0));
+		VoxelBuffer buffer1(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator, buffer1, origin1);
+		ZN_TEST_ASSERT(L::is_equal(expected_buffer1, buffer1));
+	}
+	ZN_TEST_ASSERT(L::count_cached_blocks(cache_dir) == 2);
+
+	// Another instance of the same graph, as if the game was restarted, gets the same results from the cache
+	{
+		Ref<VoxelGeneratorGraph> generator = L::create_generator(5.f, cache_dir, GENERATOR_PATH);
+		VoxelBuffer buffer0(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator, buffer0, origin0);
+		ZN_TEST_ASSERT(L::is_equal(expected_buffer0, buffer0));
+	}
+	ZN_TEST_ASSERT(L::count_cached_blocks(cache_dir) == 2);
+
+	// A different graph must not get results of the previous one, which are removed
+	{
+		VoxelBuffer other_expected_buffer(VoxelBuffer::ALLOCATOR_DEFAULT);
+		{
+			Ref<VoxelGeneratorGraph> generator = L::create_generator(6.f, "", "");
+			L::generate(**generator, other_expected_buffer, origin0);
+		}
+		ZN_TEST_ASSERT(!L::is_equal(expected_buffer0, other_expected_buffer));
+
+		Ref<VoxelGeneratorGraph> generator = L::create_generator(6.f, cache_dir, GENERATOR_PATH);
+		VoxelBuffer buffer0(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator, buffer0, origin0);
+		ZN_TEST_ASSERT(L::is_equal(other_expected_buffer, buffer0));
+	}
+	ZN_TEST_ASSERT(L::count_cached_blocks(cache_dir) == 1);
+
+	// Another generator sharing the same directory must not remove blocks of the previous one
+	{
+		Ref<VoxelGeneratorGraph> generator = L::create_generator(7.f, cache_dir, OTHER_GENERATOR_PATH);
+		VoxelBuffer buffer0(VoxelBuffer::ALLOCATOR_DEFAULT);
+		L::generate(**generator, buffer0, origin0);
+	}
+	ZN_TEST_ASSERT(L::count_cached_blocks(cache_dir) == 2);
+}
+
+void test_voxel_graph_sampling_profiler() {
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	{
+		VoxelGraphFunction &g = **generator->get_main_function();
+		load_graph_with_sphere_on_plane(g, 6.f);
+	}
+	const pg::CompilationResult compilation_result = generator->compile(false);
+	ZN_TEST_ASSERT(compilation_result.success);
+	// Run every operation, so they all get samples
+	generator->set_use_optimized_execution_map(false);
+
+	struct L {
+		static void generate(VoxelGeneratorGraph &generator) {
+			VoxelBuffer buffer(VoxelBuffer::ALLOCATOR_DEFAULT);
+			buffer.create(Vector3i(16, 16, 16));
+			generator.generate_block(VoxelGenerator::VoxelQueryData{ buffer, Vector3i(-8, -8, -8), 0 });
+		}
+	};
+
+	StdVector<pg::NodeSamplingProfiler::OperationStats> stats;
+
+	// Off by default
+	L::generate(**generator);
+	ZN_TEST_ASSERT(generator->get_node_sampling_stats(stats));
+	ZN_TEST_ASSERT(stats.size() > 0);
+	for (const pg::NodeSamplingProfiler::OperationStats &op_stats : stats) {
+		ZN_TEST_ASSERT(op_stats.sample_count == 0);
+	}
+
+	// Measure every run
+	generator->set_node_sampling_interval(1);
+	L::generate(**generator);
+	ZN_TEST_ASSERT(generator->get_node_sampling_stats(stats));
+	for (const pg::NodeSamplingProfiler::OperationStats &op_stats : stats) {
+		ZN_TEST_ASSERT(op_stats.sample_count > 0);
+		ZN_TEST_ASSERT(op_stats.total_values > 0);
+		uint64_t histogram_count = 0;
+		for (const uint64_t count : op_stats.histogram) {
+			histogram_count += count;
+		}
+		ZN_TEST_ASSERT(histogram_count == op_stats.sample_count);
+	}
+
+	generator->set_node_sampling_interval(0);
+	generator->clear_node_sampling_stats();
+	L::generate(**generator);
+	ZN_TEST_ASSERT(generator->get_node_sampling_stats(stats));
+	for (const pg::NodeSamplingProfiler::OperationStats &op_stats : stats) {
+		ZN_TEST_ASSERT(op_stats.sample_count == 0);
+	}
+}
+
 Ref<VoxelGraphFunction> create_pass_through_function() {
 	Ref<VoxelGraphFunction> func;
 	func.instantiate();
@@ -2583,4 +2986,586 @@ void test_voxel_graph_broad_block() {
 	ZN_TEST_ASSERT(sd > 0.f);
 }
 
+// Random X, Y and Z values to run programs with directly. Values are the same each time.
+struct RandomXYZInputs {
+	StdVector<float> x_buffer;
+	StdVector<float> y_buffer;
+	StdVector<float> z_buffer;
+	// Pointing at the buffers above
+	Span<const float> spans[3];
+
+	RandomXYZInputs(unsigned int values_count) {
+		x_buffer.resize(values_count);
+		y_buffer.resize(values_count);
+		z_buffer.resize(values_count);
+
+		RandomPCG rng;
+		rng.seed(131183);
+		for (unsigned int i = 0; i < values_count; ++i) {
+			x_buffer[i] = rng.random(-100.f, 100.f);
+			y_buffer[i] = rng.random(-100.f, 100.f);
+			z_buffer[i] = rng.random(-100.f, 100.f);
+		}
+
+		spans[0] = to_span(x_buffer);
+		spans[1] = to_span(y_buffer);
+		spans[2] = to_span(z_buffer);
+	}
+
+	RandomXYZInputs(const RandomXYZInputs &) = delete;
+	RandomXYZInputs &operator=(const RandomXYZInputs &) = delete;
+
+	unsigned int size() const {
+		return x_buffer.size();
+	}
+
+	Span<const Span<const float>> get_inputs() const {
+		return Span<const Span<const float>>(spans, 3);
+	}
+
+	// Prepares the state, runs the program once and returns its first output
+	const pg::Runtime::Buffer &run(pg::Runtime &runtime, pg::Runtime::State &state) const {
+		runtime.prepare_state(state, size(), false);
+		runtime.generate_set(state, get_inputs(), false, nullptr);
+		return state.get_buffer(runtime.get_output_info(0).buffer_address);
+	}
+};
+
+void test_voxel_graph_tiled_execution() {
+	// Running the program tile by tile must give the same results as running each operation on the whole buffer.
+
+	Ref<VoxelGraphFunction> function;
+	function.instantiate();
+	load_graph_with_expression_and_noises(**function, nullptr);
+	function->auto_pick_inputs_and_outputs();
+
+	pg::Runtime runtime;
+	const CompilationResult result = runtime.compile(**function, false);
+	ZN_TEST_ASSERT(result.success);
+	ZN_TEST_ASSERT(runtime.get_input_count() == 3);
+	ZN_TEST_ASSERT(runtime.get_output_count() == 1);
+
+	// Not a multiple of the tile size, so the last tile is smaller
+	const unsigned int values_count = 1000;
+	const unsigned int tile_size = 96;
+
+	const RandomXYZInputs inputs(values_count);
+
+	pg::Runtime::State untiled_state;
+	untiled_state.set_tile_size(0);
+	const pg::Runtime::Buffer &untiled_output = inputs.run(runtime, untiled_state);
+	ZN_TEST_ASSERT(untiled_output.data != nullptr);
+
+	pg::Runtime::State tiled_state;
+	tiled_state.set_tile_size(tile_size);
+	const pg::Runtime::Buffer &tiled_output = inputs.run(runtime, tiled_state);
+	// Buffers must be restored after running
+	ZN_TEST_ASSERT(tiled_output.size == values_count);
+	ZN_TEST_ASSERT(tiled_output.data != nullptr);
+
+	for (unsigned int i = 0; i < values_count; ++i) {
+		ZN_TEST_ASSERT(tiled_output.data[i] == untiled_output.data[i]);
+	}
+}
+
+void load_graph_with_elementwise_chain(VoxelGraphFunction &g) {
+	//   X --- + --- * --- ClampC --- Remap --- Smoothstep --- - --- OutSDF
+	//        /     /                                         /
+	//   Y --+     Z                                         /
+	//        \                                             /
+	//         Abs ---------------------------------- / 3 -
+
+	const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2());
+	const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2());
+	const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2());
+	const uint32_t n_add = g.create_node(VoxelGraphFunction::NODE_ADD, Vector2());
+	const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY, Vector2());
+	const uint32_t n_clamp = g.create_node(VoxelGraphFunction::NODE_CLAMP_C, Vector2());
+	const uint32_t n_remap = g.create_node(VoxelGraphFunction::NODE_REMAP, Vector2());
+	const uint32_t n_smoothstep = g.create_node(VoxelGraphFunction::NODE_SMOOTHSTEP, Vector2());
+	const uint32_t n_abs = g.create_node(VoxelGraphFunction::NODE_ABS, Vector2());
+	const uint32_t n_div = g.create_node(VoxelGraphFunction::NODE_DIVIDE, Vector2());
+	const uint32_t n_sub = g.create_node(VoxelGraphFunction::NODE_SUBTRACT, Vector2());
+	const uint32_t n_out = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+
+	g.set_node_param(n_clamp, 0, -50.f);
+	g.set_node_param(n_clamp, 1, 50.f);
+	g.set_node_param(n_remap, 0, -50.f);
+	g.set_node_param(n_remap, 1, 50.f);
+	g.set_node_param(n_remap, 2, 0.f);
+	g.set_node_param(n_remap, 3, 1.f);
+	g.set_node_param(n_smoothstep, 0, 0.2f);
+	g.set_node_param(n_smoothstep, 1, 0.8f);
+	g.set_node_default_input(n_div, 1, 3.f);
+
+	g.add_connection(n_x, 0, n_add, 0);
+	g.add_connection(n_y, 0, n_add, 1);
+	g.add_connection(n_add, 0, n_mul, 0);
+	g.add_connection(n_z, 0, n_mul, 1);
+	g.add_connection(n_mul, 0, n_clamp, 0);
+	g.add_connection(n_clamp, 0, n_remap, 0);
+	g.add_connection(n_remap, 0, n_smoothstep, 0);
+	g.add_connection(n_smoothstep, 0, n_sub, 0);
+	g.add_connection(n_y, 0, n_abs, 0);
+	g.add_connection(n_abs, 0, n_div, 0);
+	g.add_connection(n_div, 0, n_sub, 1);
+	g.add_connection(n_sub, 0, n_out, 0);
+}
+
+void test_voxel_graph_fusion() {
+	// Fused nodes must give the same results as the nodes they replace.
+
+	struct L {
+		static void compare_function(VoxelGraphFunction &function, int expected_fused_nodes_count) {
+			pg::Runtime runtime;
+			const CompilationResult result = runtime.compile(function, false, true);
+			ZN_TEST_ASSERT(result.success);
+			ZN_TEST_ASSERT(result.fused_nodes_count == expected_fused_nodes_count);
+
+			pg::Runtime unfused_runtime;
+			const CompilationResult unfused_result = unfused_runtime.compile(function, false, false);
+			ZN_TEST_ASSERT(unfused_result.success);
+			ZN_TEST_ASSERT(unfused_result.fused_nodes_count == 0);
+			ZN_TEST_ASSERT(unfused_result.expanded_nodes_count == result.expanded_nodes_count);
+
+			ZN_TEST_ASSERT(runtime.get_input_count() == 3);
+			ZN_TEST_ASSERT(unfused_runtime.get_input_count() == 3);
+
+			// Not a multiple of the tile size of fused nodes
+			const unsigned int values_count = 1000;
+
+			const RandomXYZInputs inputs(values_count);
+
+			pg::Runtime::State state;
+			const pg::Runtime::Buffer &output = inputs.run(runtime, state);
+			const uint16_t output_address = runtime.get_output_info(0).buffer_address;
+
+			pg::Runtime::State unfused_state;
+			const pg::Runtime::Buffer &unfused_output = inputs.run(unfused_runtime, unfused_state);
+			const uint16_t unfused_output_address = unfused_runtime.get_output_info(0).buffer_address;
+
+			for (unsigned int i = 0; i < values_count; ++i) {
+				ZN_TEST_ASSERT(output.data[i] == unfused_output.data[i]);
+			}
+
+			const math::Interval range_inputs[3] = {
+				math::Interval(-10.f, 20.f), math::Interval(-5.f, 5.f), math::Interval(10.f, 30.f)
+			};
+
+			runtime.analyze_range(state, Span<const math::Interval>(range_inputs, 3));
+			unfused_runtime.analyze_range(unfused_state, Span<const math::Interval>(range_inputs, 3));
+
+			const math::Interval range = state.get_range(output_address);
+			const math::Interval unfused_range = unfused_state.get_range(unfused_output_address);
+			ZN_TEST_ASSERT(range.min == unfused_range.min && range.max == unfused_range.max);
+		}
+
+		static void compare(void (*load_func)(VoxelGraphFunction &), int expected_fused_nodes_count) {
+			Ref<VoxelGraphFunction> function;
+			function.instantiate();
+			load_func(**function);
+			function->auto_pick_inputs_and_outputs();
+			compare_function(**function, expected_fused_nodes_count);
+		}
+	};
+
+	L::compare(load_graph_with_elementwise_chain, 1);
+	// The expression contains operations on X and Z, which can run in the outer loop, and others on Y. They must not
+	// be fused together.
+	L::compare(load_graph_with_expression, 2);
+	L::compare([](VoxelGraphFunction &g) { load_graph_with_clamp(g, 4.f); }, 0);
+	L::compare([](VoxelGraphFunction &g) { load_graph_with_sphere_on_plane(g, 10.f); }, 0);
+	L::compare([](VoxelGraphFunction &g) { load_graph_with_expression_and_noises(g, nullptr); }, 0);
+}
+
+void test_voxel_graph_buffer_sharing() {
+	// Y --- Sin ------------------------ Add --- OutSDF
+	// X --- Add --- Multiply ----------/
+	// Y --/        /
+	// Y --- Sub --
+	// Z --/
+	//
+	// Computing the Multiply branch first only requires to keep its result while Sin runs. Running Sin first would
+	// require to keep its result while the Multiply branch runs, which needs more buffers.
+	Ref<VoxelGraphFunction> function;
+	function.instantiate();
+	{
+		VoxelGraphFunction &g = **function;
+		const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2());
+		const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2());
+		const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2());
+		const uint32_t n_sin = g.create_node(VoxelGraphFunction::NODE_SIN, Vector2());
+		const uint32_t n_add1 = g.create_node(VoxelGraphFunction::NODE_ADD, Vector2());
+		const uint32_t n_sub = g.create_node(VoxelGraphFunction::NODE_SUBTRACT, Vector2());
+		const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY, Vector2());
+		const uint32_t n_add2 = g.create_node(VoxelGraphFunction::NODE_ADD, Vector2());
+		const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+		g.add_connection(n_y, 0, n_sin, 0);
+		g.add_connection(n_x, 0, n_add1, 0);
+		g.add_connection(n_y, 0, n_add1, 1);
+		g.add_connection(n_y, 0, n_sub, 0);
+		g.add_connection(n_z, 0, n_sub, 1);
+		g.add_connection(n_add1, 0, n_mul, 0);
+		g.add_connection(n_sub, 0, n_mul, 1);
+		// Sin is connected first, so a plain depth-first order would run it first
+		g.add_connection(n_sin, 0, n_add2, 0);
+		g.add_connection(n_mul, 0, n_add2, 1);
+		g.add_connection(n_add2, 0, n_out_sdf, 0);
+	}
+	function->auto_pick_inputs_and_outputs();
+
+	pg::Runtime runtime;
+	// Without fusion, so each node gets its own buffer
+	const CompilationResult result = runtime.compile(**function, false, false);
+	ZN_TEST_ASSERT(result.success);
+	ZN_TEST_ASSERT(runtime.get_input_count() == 3);
+
+	// Multiply needs 3 buffers at once (its 2 inputs and its output), and every other result can re-use one of them
+	ZN_TEST_ASSERT(runtime.get_scratch_bytes_per_value() == 3 * sizeof(float));
+
+	// Sharing buffers must not change results
+	const unsigned int values_count = 100;
+	const RandomXYZInputs inputs(values_count);
+
+	pg::Runtime::State state;
+	const pg::Runtime::Buffer &output = inputs.run(runtime, state);
+
+	for (unsigned int i = 0; i < values_count; ++i) {
+		const float x = inputs.x_buffer[i];
+		const float y = inputs.y_buffer[i];
+		const float z = inputs.z_buffer[i];
+		const float expected = Math::sin(y) + (x + y) * (y - z);
+		ZN_TEST_ASSERT(Math::is_equal_approx(output.data[i], expected));
+	}
+}
+
+void test_voxel_graph_sdf_point_queries() {
+	struct L {
+		static Ref<VoxelGeneratorGraph> create_generator(float x_factor) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			{
+				// X --- Multiply --- Subtract --- OutSDF
+				//                  /
+				// Y ---------------
+				// Z --- Sin --- OutType
+				VoxelGraphFunction &g = **generator->get_main_function();
+				const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2());
+				const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2());
+				const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2());
+				const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY, Vector2());
+				const uint32_t n_sub = g.create_node(VoxelGraphFunction::NODE_SUBTRACT, Vector2());
+				const uint32_t n_sin = g.create_node(VoxelGraphFunction::NODE_SIN, Vector2());
+				const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+				const uint32_t n_out_type = g.create_node(VoxelGraphFunction::NODE_OUTPUT_TYPE, Vector2());
+				g.add_connection(n_x, 0, n_mul, 0);
+				g.set_node_default_input(n_mul, 1, x_factor);
+				g.add_connection(n_y, 0, n_sub, 0);
+				g.add_connection(n_mul, 0, n_sub, 1);
+				g.add_connection(n_sub, 0, n_out_sdf, 0);
+				g.add_connection(n_z, 0, n_sin, 0);
+				g.add_connection(n_sin, 0, n_out_type, 0);
+			}
+			const pg::CompilationResult compilation_result = generator->compile(false);
+			ZN_TEST_ASSERT(compilation_result.success);
+			return generator;
+		}
+
+		static void test(VoxelGeneratorGraph &generator, float x_factor) {
+			// Not a multiple of the batch size, so the last batch is partial
+			const unsigned int positions_count = 2 * VoxelGeneratorGraph::SDF_BATCH_SIZE + 3;
+
+			const RandomXYZInputs inputs(positions_count);
+			StdVector<Vector3f> positions;
+			positions.resize(positions_count);
+			for (unsigned int i = 0; i < positions_count; ++i) {
+				positions[i] = Vector3f(inputs.x_buffer[i], inputs.y_buffer[i], inputs.z_buffer[i]);
+			}
+
+			StdVector<float> batch_sdf;
+			batch_sdf.resize(positions_count);
+			generator.generate_sdf_batch(to_span(positions), to_span(batch_sdf));
+
+			for (unsigned int i = 0; i < positions_count; ++i) {
+				const Vector3f pos = positions[i];
+				const float expected_sdf = pos.y - pos.x * x_factor;
+
+				const float single_sdf = generator.generate_sdf_single(pos);
+				ZN_TEST_ASSERT(Math::is_equal_approx(single_sdf, expected_sdf));
+				ZN_TEST_ASSERT(single_sdf == batch_sdf[i]);
+
+				// Regular single queries go through the same path
+				const Vector3i posi = math::floor_to_int(pos);
+				const float generic_sdf = generator.generate_single(posi, VoxelBuffer::CHANNEL_SDF).f;
+				ZN_TEST_ASSERT(Math::is_equal_approx(generic_sdf, posi.y - posi.x * x_factor));
+			}
+		}
+	};
+
+	Ref<VoxelGeneratorGraph> generator = L::create_generator(0.5f);
+	L::test(**generator, 0.5f);
+
+	// Point query states are prepared once per program, so they must be prepared again for a different program
+	Ref<VoxelGeneratorGraph> generator2 = L::create_generator(2.f);
+	L::test(**generator2, 2.f);
+	L::test(**generator, 0.5f);
+}
+
+void test_voxel_graph_fusion_benchmark() {
+	Ref<VoxelGraphFunction> function;
+	function.instantiate();
+	load_graph_with_elementwise_chain(**function);
+	function->auto_pick_inputs_and_outputs();
+
+	const unsigned int values_count = 4096;
+	const unsigned int iterations = 200;
+
+	const RandomXYZInputs inputs(values_count);
+
+	for (const bool enable_fusion : { false, true }) {
+		pg::Runtime runtime;
+		const CompilationResult result = runtime.compile(**function, false, enable_fusion);
+		ZN_TEST_ASSERT(result.success);
+
+		pg::Runtime::State state;
+		runtime.prepare_state(state, values_count, false);
+
+		ProfilingClock profiling_clock;
+		for (unsigned int i = 0; i < iterations; ++i) {
+			runtime.generate_set(state, inputs.get_inputs(), false, nullptr);
+		}
+		const uint64_t elapsed_us = profiling_clock.get_elapsed_microseconds();
+
+		print_line(
+				format("Fusion {}: {} sets of {} values in {} us",
+					   enable_fusion ? "on" : "off",
+					   iterations,
+					   values_count,
+					   elapsed_us)
+		);
+	}
+}
+
+void test_voxel_graph_node_throughput_benchmark() {
+	// Measures how many values per second single nodes can process, when their inputs are X, Y and Z
+	const VoxelGraphFunction::NodeTypeID node_types[] = {
+		VoxelGraphFunction::NODE_ADD, //
+		VoxelGraphFunction::NODE_SUBTRACT, //
+		VoxelGraphFunction::NODE_MULTIPLY, //
+		VoxelGraphFunction::NODE_DIVIDE, //
+		VoxelGraphFunction::NODE_MIN, //
+		VoxelGraphFunction::NODE_MAX, //
+		VoxelGraphFunction::NODE_CLAMP, //
+		VoxelGraphFunction::NODE_CLAMP_C, //
+		VoxelGraphFunction::NODE_SELECT, //
+		VoxelGraphFunction::NODE_SDF_PLANE, //
+		VoxelGraphFunction::NODE_SDF_BOX, //
+		VoxelGraphFunction::NODE_SDF_SPHERE, //
+		VoxelGraphFunction::NODE_SDF_SMOOTH_UNION, //
+		VoxelGraphFunction::NODE_SDF_SMOOTH_SUBTRACT, //
+		VoxelGraphFunction::NODE_NORMALIZE_3D, //
+	};
+
+	const unsigned int values_count = 4096;
+	const unsigned int iterations = 200;
+
+	const RandomXYZInputs inputs(values_count);
+
+	const NodeTypeDB &type_db = NodeTypeDB::get_singleton();
+
+	for (const VoxelGraphFunction::NodeTypeID node_type_id : node_types) {
+		const NodeType &node_type = type_db.get_type(node_type_id);
+
+		Ref<VoxelGraphFunction> function;
+		function.instantiate();
+		{
+			VoxelGraphFunction &g = **function;
+			const uint32_t n_inputs[3] = {
+				g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2()),
+				g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2()),
+				g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2()),
+			};
+			const uint32_t n = g.create_node(node_type_id, Vector2());
+			const uint32_t n_out = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+
+			const unsigned int connected_inputs_count =
+					math::min(static_cast<unsigned int>(node_type.inputs.size()), 3u);
+			for (unsigned int i = 0; i < connected_inputs_count; ++i) {
+				g.add_connection(n_inputs[i], 0, n, i);
+			}
+			if (node_type_id == VoxelGraphFunction::NODE_SDF_SMOOTH_UNION ||
+					node_type_id == VoxelGraphFunction::NODE_SDF_SMOOTH_SUBTRACT) {
+				// Zero smoothness falls back on the hard version
+				g.set_node_param(n, 0, 10.f);
+			}
+			g.add_connection(n, 0, n_out, 0);
+
+			g.auto_pick_inputs_and_outputs();
+		}
+
+		pg::Runtime runtime;
+		// Fusion would replace some of these nodes
+		const CompilationResult result = runtime.compile(**function, false, false);
+		ZN_TEST_ASSERT(result.success);
+
+		pg::Runtime::State state;
+		runtime.prepare_state(state, values_count, false);
+
+		ProfilingClock profiling_clock;
+		for (unsigned int i = 0; i < iterations; ++i) {
+			runtime.generate_set(state, inputs.get_inputs(), false, nullptr);
+		}
+		const uint64_t elapsed_us = math::max(profiling_clock.get_elapsed_microseconds(), uint64_t(1));
+
+		const uint64_t values_per_second = (uint64_t(iterations) * values_count * 1000000) / elapsed_us;
+
+		print_line(format("Node {}: {} values/s", node_type.name, values_per_second));
+	}
+}
+
+void test_voxel_graph_range_analysis_clipping_benchmark() {
+	// Prints how many sections of terrain range analysis can clip, with and without affine arithmetic. The graphs
+	// below are small stand-ins for a heightmap and a planet, not actual project terrains, so numbers only give an
+	// idea of the difference.
+	struct L {
+		static void load_heightmap_graph(VoxelGraphFunction &g) {
+			// X --- FastNoise2D --- Multiply(20) --- SdfPlane --- OutSDF
+			// Z --/                                /
+			// Y -----------------------------------
+			const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2());
+			const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2());
+			const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2());
+			const uint32_t n_noise = g.create_node(VoxelGraphFunction::NODE_FAST_NOISE_2D, Vector2());
+			const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY, Vector2());
+			const uint32_t n_plane = g.create_node(VoxelGraphFunction::NODE_SDF_PLANE, Vector2());
+			const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+			Ref<ZN_FastNoiseLite> noise;
+			noise.instantiate();
+			g.set_node_param(n_noise, 0, noise);
+			g.set_node_default_input(n_mul, 1, 20.f);
+			g.add_connection(n_x, 0, n_noise, 0);
+			g.add_connection(n_z, 0, n_noise, 1);
+			g.add_connection(n_noise, 0, n_mul, 0);
+			g.add_connection(n_y, 0, n_plane, 0);
+			g.add_connection(n_mul, 0, n_plane, 1);
+			g.add_connection(n_plane, 0, n_out_sdf, 0);
+		}
+
+		static void load_planet_graph(VoxelGraphFunction &g, float radius) {
+			// Noise is sampled on the surface of the sphere, so features don't stretch with altitude.
+			//
+			// X --- Normalize --- Multiply(r) --- FastNoise3D --- Multiply(10) --- Add --- OutSDF
+			// Y --/          \-- Multiply(r) --/                                 /
+			// Z --/           \- Multiply(r) -/                                 /
+			// X --- SdfSphere(r) -----------------------------------------------
+			// Y --/
+			// Z --/
+			const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X, Vector2());
+			const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y, Vector2());
+			const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z, Vector2());
+			const uint32_t n_normalize = g.create_node(VoxelGraphFunction::NODE_NORMALIZE_3D, Vector2());
+			const uint32_t n_noise = g.create_node(VoxelGraphFunction::NODE_FAST_NOISE_3D, Vector2());
+			const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY, Vector2());
+			const uint32_t n_sphere = g.create_node(VoxelGraphFunction::NODE_SDF_SPHERE, Vector2());
+			const uint32_t n_add = g.create_node(VoxelGraphFunction::NODE_ADD, Vector2());
+			const uint32_t n_out_sdf = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF, Vector2());
+			Ref<ZN_FastNoiseLite> noise;
+			noise.instantiate();
+			g.set_node_param(n_noise, 0, noise);
+			g.add_connection(n_x, 0, n_normalize, 0);
+			g.add_connection(n_y, 0, n_normalize, 1);
+			g.add_connection(n_z, 0, n_normalize, 2);
+			for (unsigned int i = 0; i < 3; ++i) {
+				const uint32_t n_scale = g.create_node(VoxelGraphFunction::NODE_MULTIPLY, Vector2());
+				g.set_node_default_input(n_scale, 1, radius);
+				g.add_connection(n_normalize, i, n_scale, 0);
+				g.add_connection(n_scale, 0, n_noise, i);
+			}
+			g.add_connection(n_noise, 0, n_mul, 0);
+			g.set_node_default_input(n_mul, 1, 10.f);
+			g.add_connection(n_x, 0, n_sphere, 0);
+			g.add_connection(n_y, 0, n_sphere, 1);
+			g.add_connection(n_z, 0, n_sphere, 2);
+			g.set_node_default_input(n_sphere, 3, radius);
+			g.add_connection(n_sphere, 0, n_add, 0);
+			g.add_connection(n_mul, 0, n_add, 1);
+			g.add_connection(n_add, 0, n_out_sdf, 0);
+		}
+
+		static unsigned int count_clipped_sections(
+				const VoxelGeneratorGraph &generator,
+				const Vector3i min_pos,
+				const Vector3i max_pos,
+				const int section_size,
+				unsigned int &out_sections_count
+		) {
+			const float clip_threshold = generator.get_sdf_clip_threshold();
+			unsigned int clipped_count = 0;
+			out_sections_count = 0;
+			Vector3i pos;
+			for (pos.z = min_pos.z; pos.z < max_pos.z; pos.z += section_size) {
+				for (pos.x = min_pos.x; pos.x < max_pos.x; pos.x += section_size) {
+					for (pos.y = min_pos.y; pos.y < max_pos.y; pos.y += section_size) {
+						const math::Interval range =
+								generator.debug_analyze_range(pos, pos + Vector3iUtil::create(section_size), false);
+						if (range.min > clip_threshold || range.max < -clip_threshold) {
+							++clipped_count;
+						}
+						++out_sections_count;
+					}
+				}
+			}
+			return clipped_count;
+		}
+
+		static void compare(
+				const char *name,
+				void (*load_graph)(VoxelGraphFunction &),
+				const Vector3i min_pos,
+				const Vector3i max_pos
+		) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			load_graph(**generator->get_main_function());
+			const pg::CompilationResult compilation_result = generator->compile(false);
+			ZN_TEST_ASSERT(compilation_result.success);
+
+			const int section_size = 16;
+			unsigned int sections_count = 0;
+
+			generator->set_use_affine_range_analysis(false);
+			ProfilingClock profiling_clock;
+			const unsigned int clipped_interval =
+					count_clipped_sections(**generator, min_pos, max_pos, section_size, sections_count);
+			const uint64_t interval_us = profiling_clock.restart();
+
+			generator->set_use_affine_range_analysis(true);
+			const unsigned int clipped_affine =
+					count_clipped_sections(**generator, min_pos, max_pos, section_size, sections_count);
+			const uint64_t affine_us = profiling_clock.restart();
+
+			// Affine ranges are only used when they are tighter
+			ZN_TEST_ASSERT(clipped_affine >= clipped_interval);
+
+			print_line(
+					format("{}: {} sections, clipped with intervals: {} ({} us), with affine arithmetic: {} ({} us)",
+						   name,
+						   sections_count,
+						   clipped_interval,
+						   interval_us,
+						   clipped_affine,
+						   affine_us)
+			);
+		}
+	};
+
+	L::compare("Heightmap", L::load_heightmap_graph, Vector3i(-256, -64, -256), Vector3i(256, 64, 256));
+	L::compare(
+			"Planet",
+			[](VoxelGraphFunction &g) { L::load_planet_graph(g, 500.f); },
+			Vector3i(-256, 384, -256),
+			Vector3i(256, 576, 256)
+	);
+}
+
 } // namespace zylann::voxel::tests
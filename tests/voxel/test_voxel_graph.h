@@ -12,6 +12,11 @@ void test_voxel_graph_generator_expressions_2();
 void test_voxel_graph_generator_texturing();
 void test_voxel_graph_equivalence_merging();
 void test_voxel_graph_generate_block_with_input_sdf();
+void test_voxel_graph_generate_block_adaptive_subdivision();
+void test_voxel_graph_affine_range_analysis();
+void test_voxel_graph_xz_cache();
+void test_voxel_graph_disk_cache();
+void test_voxel_graph_sampling_profiler();
 void test_voxel_graph_functions_pass_through();
 void test_voxel_graph_functions_nested_pass_through();
 void test_voxel_graph_functions_autoconnect();
@@ -45,6 +50,13 @@ void test_voxel_graph_constant_reduction();
 void test_voxel_graph_multiple_function_instances();
 void test_voxel_graph_issue783();
 void test_voxel_graph_broad_block();
+void test_voxel_graph_tiled_execution();
+void test_voxel_graph_fusion();
+void test_voxel_graph_buffer_sharing();
+void test_voxel_graph_sdf_point_queries();
+void test_voxel_graph_fusion_benchmark();
+void test_voxel_graph_node_throughput_benchmark();
+void test_voxel_graph_range_analysis_clipping_benchmark();
 
 } // namespace zylann::voxel::tests
 
@@ -0,0 +1,282 @@
+#include "test_voxel_mesher_blocky.h"
+#include "../../meshers/blocky/voxel_blocky_library.h"
+#include "../../meshers/blocky/voxel_blocky_model_cube.h"
+#include "../../meshers/blocky/voxel_blocky_model_empty.h"
+#include "../../meshers/blocky/voxel_mesher_blocky.h"
+#include "../../storage/voxel_buffer.h"
+#include "../../util/godot/core/packed_arrays.h"
+#include "../../util/math/funcs.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::voxel::tests {
+
+namespace {
+
+struct BlockyMeshStats {
+	// Area of triangles facing each direction, indexed with `axis * 2 + (normal > 0)`
+	FixedArray<float, 6> areas;
+	float collision_area = 0.f;
+	unsigned int vertex_count = 0;
+	unsigned int tile_rect_count = 0;
+	unsigned int merged_vertex_count = 0;
+	bool tiled_uvs_valid = true;
+};
+
+float get_triangle_area(const Vector3 a, const Vector3 b, const Vector3 c) {
+	return 0.5f * (b - a).cross(c - a).length();
+}
+
+BlockyMeshStats get_blocky_mesh_stats(const VoxelMesher::Output &output) {
+	BlockyMeshStats stats;
+	fill(stats.areas, 0.f);
+
+	for (const VoxelMesher::Output::Surface &surface : output.surfaces) {
+		const PackedVector3Array positions = surface.arrays[Mesh::ARRAY_VERTEX];
+		const PackedVector3Array normals = surface.arrays[Mesh::ARRAY_NORMAL];
+		const PackedVector2Array uvs = surface.arrays[Mesh::ARRAY_TEX_UV];
+		const PackedInt32Array indices = surface.arrays[Mesh::ARRAY_INDEX];
+
+		stats.vertex_count += positions.size();
+
+		for (int i = 0; i + 2 < indices.size(); i += 3) {
+			const Vector3 normal = normals[indices[i]];
+			const Vector3::Axis axis = normal.abs().max_axis_index();
+			const unsigned int area_index = axis * 2 + (normal[axis] > 0 ? 1 : 0);
+			stats.areas[area_index] +=
+					get_triangle_area(positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]]);
+		}
+
+		if (surface.arrays[Mesh::ARRAY_CUSTOM0].get_type() != Variant::NIL) {
+			const PackedFloat32Array tile_rects = surface.arrays[Mesh::ARRAY_CUSTOM0];
+			stats.tile_rect_count += tile_rects.size() / 4;
+
+			for (int vi = 0; vi < positions.size() && vi * 4 + 3 < tile_rects.size(); ++vi) {
+				const Vector2 tile_origin(tile_rects[vi * 4], tile_rects[vi * 4 + 1]);
+				const Vector2 tile_size(tile_rects[vi * 4 + 2], tile_rects[vi * 4 + 3]);
+				if (tile_size == Vector2()) {
+					continue;
+				}
+				++stats.merged_vertex_count;
+				// Merged faces have their corners at a whole number of tiles from the origin of the tile
+				const Vector2 t = (uvs[vi] - tile_origin) / tile_size;
+				if (!Math::is_equal_approx(t.x, Math::round(t.x), 0.001f) ||
+					!Math::is_equal_approx(t.y, Math::round(t.y), 0.001f)) {
+					stats.tiled_uvs_valid = false;
+				}
+			}
+		}
+	}
+
+	const StdVector<Vector3f> &collision_positions = output.collision_surface.positions;
+	const StdVector<int> &collision_indices = output.collision_surface.indices;
+	for (unsigned int i = 0; i + 2 < collision_indices.size(); i += 3) {
+		const Vector3f a = collision_positions[collision_indices[i]];
+		const Vector3f b = collision_positions[collision_indices[i + 1]];
+		const Vector3f c = collision_positions[collision_indices[i + 2]];
+		stats.collision_area +=
+				get_triangle_area(Vector3(a.x, a.y, a.z), Vector3(b.x, b.y, b.z), Vector3(c.x, c.y, c.z));
+	}
+
+	return stats;
+}
+
+// Models of the library made by `make_test_library`
+const int AIR_ID = 0;
+const int CUBE_ID = 1;
+// Same as `CUBE_ID` with a different tile on its top side, so its faces can't be merged with those of `CUBE_ID`
+const int CUBE2_ID = 2;
+// Half-height cube, not mergeable on its sides
+const int SLAB_ID = 3;
+
+Ref<VoxelBlockyLibrary> make_test_library() {
+	Ref<VoxelBlockyLibrary> library;
+	library.instantiate();
+	{
+		Ref<VoxelBlockyModelEmpty> air;
+		air.instantiate();
+		library->add_model(air);
+	}
+	{
+		Ref<VoxelBlockyModelCube> cube;
+		cube.instantiate();
+		library->add_model(cube);
+	}
+	{
+		Ref<VoxelBlockyModelCube> cube;
+		cube.instantiate();
+		cube->set_tile(VoxelBlockyModel::SIDE_POSITIVE_Y, Vector2i(1, 0));
+		library->add_model(cube);
+	}
+	{
+		Ref<VoxelBlockyModelCube> slab;
+		slab.instantiate();
+		slab->set_height(0.5f);
+		library->add_model(slab);
+	}
+	library->bake();
+	return library;
+}
+
+} // namespace
+
+void test_voxel_mesher_blocky_greedy() {
+	Ref<VoxelBlockyLibrary> library = make_test_library();
+
+	// Ground with a few different voxels on top, so there are areas of faces that can be merged, and some that can't
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(Vector3i(18, 18, 18));
+	vb.fill_area(CUBE_ID, Vector3i(0, 0, 0), Vector3i(18, 6, 18), VoxelBuffer::CHANNEL_TYPE);
+	vb.fill_area(CUBE2_ID, Vector3i(3, 5, 3), Vector3i(8, 6, 10), VoxelBuffer::CHANNEL_TYPE);
+	vb.fill_area(CUBE_ID, Vector3i(10, 6, 4), Vector3i(14, 9, 7), VoxelBuffer::CHANNEL_TYPE);
+	vb.set_voxel(SLAB_ID, Vector3i(12, 6, 12), VoxelBuffer::CHANNEL_TYPE);
+	vb.set_voxel(SLAB_ID, Vector3i(13, 6, 12), VoxelBuffer::CHANNEL_TYPE);
+	vb.set_voxel(AIR_ID, Vector3i(5, 5, 14), VoxelBuffer::CHANNEL_TYPE);
+
+	Ref<VoxelMesherBlocky> mesher;
+	mesher.instantiate();
+	mesher->set_library(library);
+	mesher->set_shadow_occluder_side(VoxelMesherBlocky::SIDE_NEGATIVE_Y, true);
+
+	// Meshes at LOD 1 as well, which adds skirts
+	for (uint8_t lod_index = 0; lod_index < 2; ++lod_index) {
+		VoxelMesher::Input input{ vb, nullptr, Vector3i(), lod_index, true };
+
+		mesher->set_greedy_meshing_enabled(false);
+		VoxelMesher::Output output;
+		mesher->build(output, input);
+
+		mesher->set_greedy_meshing_enabled(true);
+		VoxelMesher::Output greedy_output;
+		mesher->build(greedy_output, input);
+
+		const BlockyMeshStats stats = get_blocky_mesh_stats(output);
+		const BlockyMeshStats greedy_stats = get_blocky_mesh_stats(greedy_output);
+
+		ZN_TEST_ASSERT(output.surfaces.size() == greedy_output.surfaces.size());
+		ZN_TEST_ASSERT(stats.vertex_count > 0);
+		ZN_TEST_ASSERT(greedy_stats.vertex_count < stats.vertex_count);
+
+		// Merged faces must cover exactly the same surface
+		for (unsigned int i = 0; i < stats.areas.size(); ++i) {
+			ZN_TEST_ASSERT(Math::is_equal_approx(stats.areas[i], greedy_stats.areas[i], 0.01f));
+		}
+		ZN_TEST_ASSERT(Math::is_equal_approx(stats.collision_area, greedy_stats.collision_area, 0.01f));
+
+		// Every vertex has a tile rect, including those of faces that were not merged and skirts
+		ZN_TEST_ASSERT(stats.tile_rect_count == 0);
+		ZN_TEST_ASSERT(greedy_stats.tile_rect_count == greedy_stats.vertex_count);
+		ZN_TEST_ASSERT(greedy_stats.merged_vertex_count > 0);
+		ZN_TEST_ASSERT(greedy_stats.tiled_uvs_valid);
+		ZN_TEST_ASSERT(greedy_output.mesh_flags != 0);
+
+		// Shadow occluders don't depend on how faces are meshed
+		ZN_TEST_ASSERT(output.shadow_occluder.size() > 0);
+		const PackedVector3Array occluder_vertices = output.shadow_occluder[Mesh::ARRAY_VERTEX];
+		const PackedVector3Array greedy_occluder_vertices = greedy_output.shadow_occluder[Mesh::ARRAY_VERTEX];
+		ZN_TEST_ASSERT(occluder_vertices == greedy_occluder_vertices);
+	}
+}
+
+void test_voxel_mesher_blocky_skip_occluded() {
+	// Faces hidden by a neighbor are culled the same way whatever the texture of the cube is, so a checkerboard of two
+	// cube models produces the same geometry as a single one
+	Ref<VoxelBlockyLibrary> library = make_test_library();
+
+	// Mostly solid block with a cave, a slab hiding only part of a side of its neighbors, and ground on top
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(Vector3i(18, 18, 18));
+	vb.fill_area(CUBE_ID, Vector3i(0, 0, 0), Vector3i(18, 14, 18), VoxelBuffer::CHANNEL_TYPE);
+	vb.fill_area(AIR_ID, Vector3i(6, 6, 6), Vector3i(10, 10, 10), VoxelBuffer::CHANNEL_TYPE);
+	vb.set_voxel(SLAB_ID, Vector3i(13, 3, 3), VoxelBuffer::CHANNEL_TYPE);
+
+	// Same voxels, but no region is uniform, so none of them can be skipped
+	VoxelBuffer checkerboard_vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	checkerboard_vb.create(vb.get_size());
+	checkerboard_vb.copy_channel_from(vb, VoxelBuffer::CHANNEL_TYPE);
+	Vector3i pos;
+	for (pos.z = 0; pos.z < vb.get_size().z; ++pos.z) {
+		for (pos.x = 0; pos.x < vb.get_size().x; ++pos.x) {
+			for (pos.y = 0; pos.y < vb.get_size().y; ++pos.y) {
+				if (vb.get_voxel(pos, VoxelBuffer::CHANNEL_TYPE) == CUBE_ID && ((pos.x + pos.y + pos.z) & 1) != 0) {
+					checkerboard_vb.set_voxel(CUBE2_ID, pos, VoxelBuffer::CHANNEL_TYPE);
+				}
+			}
+		}
+	}
+
+	Ref<VoxelMesherBlocky> mesher;
+	mesher.instantiate();
+	mesher->set_library(library);
+
+	VoxelMesher::Output output;
+	mesher->build(output, VoxelMesher::Input{ vb, nullptr, Vector3i(), 0, true });
+
+	VoxelMesher::Output checkerboard_output;
+	mesher->build(checkerboard_output, VoxelMesher::Input{ checkerboard_vb, nullptr, Vector3i(), 0, true });
+
+	const BlockyMeshStats stats = get_blocky_mesh_stats(output);
+	const BlockyMeshStats checkerboard_stats = get_blocky_mesh_stats(checkerboard_output);
+
+	ZN_TEST_ASSERT(stats.vertex_count > 0);
+	ZN_TEST_ASSERT(stats.vertex_count == checkerboard_stats.vertex_count);
+	for (unsigned int i = 0; i < stats.areas.size(); ++i) {
+		ZN_TEST_ASSERT(Math::is_equal_approx(stats.areas[i], checkerboard_stats.areas[i], 0.01f));
+	}
+	ZN_TEST_ASSERT(Math::is_equal_approx(stats.collision_area, checkerboard_stats.collision_area, 0.01f));
+}
+
+void test_voxel_mesher_blocky_incremental() {
+	Ref<VoxelBlockyLibrary> library = make_test_library();
+
+	Ref<VoxelMesherBlocky> mesher;
+	mesher.instantiate();
+	mesher->set_library(library);
+
+	for (const bool greedy : { false, true }) {
+		mesher->set_greedy_meshing_enabled(greedy);
+
+		// Ground crossing several sections
+		VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+		vb.create(Vector3i(18, 18, 18));
+		vb.fill_area(CUBE_ID, Vector3i(0, 0, 0), Vector3i(18, 10, 18), VoxelBuffer::CHANNEL_TYPE);
+		vb.fill_area(CUBE2_ID, Vector3i(3, 9, 3), Vector3i(14, 10, 10), VoxelBuffer::CHANNEL_TYPE);
+
+		std::shared_ptr<VoxelMesher::IncrementalCache> cache;
+		VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, true };
+		input.incremental_cache = &cache;
+
+		VoxelMesher::Output first_output;
+		mesher->build(first_output, input);
+		ZN_TEST_ASSERT(cache != nullptr);
+		const VoxelMesher::IncrementalCache *first_cache = cache.get();
+
+		// Edits next to a section boundary, which changes faces of voxels in the neighbor section too
+		vb.set_voxel(AIR_ID, Vector3i(9, 9, 5), VoxelBuffer::CHANNEL_TYPE);
+		vb.set_voxel(SLAB_ID, Vector3i(8, 10, 12), VoxelBuffer::CHANNEL_TYPE);
+		// Relative to the block without padding
+		input.dirty_box = Box3i::from_min_max(Vector3i(7, 8, 4), Vector3i(9, 10, 12));
+
+		VoxelMesher::Output incremental_output;
+		mesher->build(incremental_output, input);
+		ZN_TEST_ASSERT(cache.get() == first_cache);
+
+		VoxelMesher::Output full_output;
+		mesher->build(full_output, VoxelMesher::Input{ vb, nullptr, Vector3i(), 0, true });
+
+		const BlockyMeshStats stats = get_blocky_mesh_stats(incremental_output);
+		const BlockyMeshStats full_stats = get_blocky_mesh_stats(full_output);
+
+		ZN_TEST_ASSERT(incremental_output.surfaces.size() == full_output.surfaces.size());
+		ZN_TEST_ASSERT(full_stats.vertex_count > 0);
+		if (!greedy) {
+			ZN_TEST_ASSERT(stats.vertex_count == full_stats.vertex_count);
+		}
+		for (unsigned int i = 0; i < stats.areas.size(); ++i) {
+			ZN_TEST_ASSERT(Math::is_equal_approx(stats.areas[i], full_stats.areas[i], 0.01f));
+		}
+		ZN_TEST_ASSERT(Math::is_equal_approx(stats.collision_area, full_stats.collision_area, 0.01f));
+		ZN_TEST_ASSERT(stats.tiled_uvs_valid);
+	}
+}
+
+} // namespace zylann::voxel::tests
@@ -1,6 +1,10 @@
 #include "test_voxel_mesher_cubes.h"
 #include "../../meshers/cubes/voxel_mesher_cubes.h"
 #include "../../storage/voxel_buffer.h"
+#include "../../util/godot/core/random_pcg.h"
+#include "../../util/io/log.h"
+#include "../../util/profiling_clock.h"
+#include "../../util/string/format.h"
 #include "../../util/testing/test_macros.h"
 
 namespace zylann::voxel::tests {
@@ -51,4 +55,215 @@ void test_voxel_mesher_cubes() {
 	ZN_TEST_ASSERT(surface1_vertices_count == 20);
 }
 
+namespace {
+
+// Makes a block with hills of a few colors, some of them transparent, with caves carved in it
+void make_cubes_test_block(VoxelBuffer &vb, int size) {
+	vb.create(size, size, size);
+	vb.set_channel_depth(VoxelBuffer::CHANNEL_COLOR, VoxelBuffer::DEPTH_16_BIT);
+
+	const uint16_t colors[] = {
+		Color8(0, 255, 0, 255).to_u16(), //
+		Color8(128, 64, 0, 255).to_u16(), //
+		Color8(128, 128, 128, 255).to_u16(), //
+		Color8(0, 0, 255, 128).to_u16(), //
+	};
+
+	RandomPCG rng;
+	rng.seed(131183);
+
+	Vector3i pos;
+	for (pos.z = 0; pos.z < size; ++pos.z) {
+		for (pos.x = 0; pos.x < size; ++pos.x) {
+			const int height = size / 2 + (pos.x / 5 + pos.z / 7) % 6;
+			for (pos.y = 0; pos.y < height; ++pos.y) {
+				const unsigned int color_index = pos.y + 1 == height ? 0 : (pos.y / 4) % 3;
+				if (rng.rand(20) == 0) {
+					// Cave
+					continue;
+				}
+				if (rng.rand(50) == 0) {
+					vb.set_voxel(colors[3], pos, VoxelBuffer::CHANNEL_COLOR);
+				} else {
+					vb.set_voxel(colors[color_index], pos, VoxelBuffer::CHANNEL_COLOR);
+				}
+			}
+		}
+	}
+}
+
+struct CubesFaceAreas {
+	// [material][axis * 2 + (normal > 0)]
+	FixedArray<FixedArray<float, 6>, VoxelMesherCubes::MATERIAL_COUNT> areas;
+	unsigned int quad_count = 0;
+};
+
+CubesFaceAreas get_cubes_face_areas(const VoxelMesher::Output &output) {
+	CubesFaceAreas res;
+	for (FixedArray<float, 6> &areas : res.areas) {
+		fill(areas, 0.f);
+	}
+
+	for (const VoxelMesher::Output::Surface &surface : output.surfaces) {
+		const Array &arrays = surface.arrays;
+		if (arrays.size() == 0) {
+			continue;
+		}
+		const PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+		const PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+		ZN_TEST_ASSERT(vertices.size() % 4 == 0);
+
+		for (int i = 0; i < vertices.size(); i += 4) {
+			// 2-----3
+			// |     |
+			// 0-----1
+			const float area = (vertices[i + 1] - vertices[i]).length() * (vertices[i + 2] - vertices[i]).length();
+			const Vector3 normal = normals[i];
+			const unsigned int axis = normal.abs().max_axis_index();
+			res.areas[surface.material_index][axis * 2 + (normal[axis] > 0)] += area;
+			++res.quad_count;
+		}
+	}
+
+	return res;
+}
+
+} // namespace
+
+void test_voxel_mesher_cubes_greedy() {
+	// Greedy meshing must cover the same faces as meshing each face separately, with less quads
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	make_cubes_test_block(vb, 34);
+
+	Ref<VoxelMesherCubes> mesher;
+	mesher.instantiate();
+	mesher->set_color_mode(VoxelMesherCubes::COLOR_RAW);
+
+	VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false };
+
+	mesher->set_greedy_meshing_enabled(false);
+	VoxelMesher::Output simple_output;
+	mesher->build(simple_output, input);
+
+	mesher->set_greedy_meshing_enabled(true);
+	VoxelMesher::Output greedy_output;
+	mesher->build(greedy_output, input);
+
+	// The bitmask kernel must produce the same quads as the scanning path
+	mesher->set_binary_greedy_meshing_enabled(false);
+	VoxelMesher::Output scanning_greedy_output;
+	mesher->build(scanning_greedy_output, input);
+
+	const CubesFaceAreas simple_areas = get_cubes_face_areas(simple_output);
+	const CubesFaceAreas greedy_areas = get_cubes_face_areas(greedy_output);
+	const CubesFaceAreas scanning_greedy_areas = get_cubes_face_areas(scanning_greedy_output);
+
+	ZN_TEST_ASSERT(simple_areas.quad_count > 0);
+	ZN_TEST_ASSERT(greedy_areas.quad_count < simple_areas.quad_count);
+	ZN_TEST_ASSERT(greedy_areas.quad_count == scanning_greedy_areas.quad_count);
+
+	for (unsigned int material_index = 0; material_index < simple_areas.areas.size(); ++material_index) {
+		for (unsigned int side = 0; side < 6; ++side) {
+			ZN_TEST_ASSERT(simple_areas.areas[material_index][side] == greedy_areas.areas[material_index][side]);
+			ZN_TEST_ASSERT(
+					scanning_greedy_areas.areas[material_index][side] == greedy_areas.areas[material_index][side]
+			);
+		}
+	}
+}
+
+void test_voxel_mesher_cubes_incremental() {
+	// Meshing only sections around edited voxels must give the same faces as meshing the whole block
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	make_cubes_test_block(vb, 34);
+
+	Ref<VoxelMesherCubes> mesher;
+	mesher.instantiate();
+	mesher->set_color_mode(VoxelMesherCubes::COLOR_RAW);
+
+	for (const bool greedy : { false, true }) {
+		mesher->set_greedy_meshing_enabled(greedy);
+
+		std::shared_ptr<VoxelMesher::IncrementalCache> cache;
+		VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false };
+		input.incremental_cache = &cache;
+
+		VoxelMesher::Output first_output;
+		mesher->build(first_output, input);
+		ZN_TEST_ASSERT(cache != nullptr);
+		const VoxelMesher::IncrementalCache *first_cache = cache.get();
+
+		// Dig a hole crossing a section boundary, and add a transparent voxel
+		vb.fill_area(0, Vector3i(7, 10, 7), Vector3i(11, 20, 9), VoxelBuffer::CHANNEL_COLOR);
+		vb.set_voxel(Color8(0, 0, 255, 128).to_u16(), Vector3i(20, 30, 20), VoxelBuffer::CHANNEL_COLOR);
+		// Relative to the block without padding
+		input.dirty_box = Box3i::from_min_max(Vector3i(6, 9, 6), Vector3i(20, 30, 20));
+
+		VoxelMesher::Output incremental_output;
+		mesher->build(incremental_output, input);
+		ZN_TEST_ASSERT(cache.get() == first_cache);
+
+		VoxelMesher::Output full_output;
+		mesher->build(full_output, VoxelMesher::Input{ vb, nullptr, Vector3i(), 0, false });
+
+		const CubesFaceAreas incremental_areas = get_cubes_face_areas(incremental_output);
+		const CubesFaceAreas full_areas = get_cubes_face_areas(full_output);
+
+		ZN_TEST_ASSERT(full_areas.quad_count > 0);
+		if (!greedy) {
+			ZN_TEST_ASSERT(incremental_areas.quad_count == full_areas.quad_count);
+		}
+		for (unsigned int material_index = 0; material_index < full_areas.areas.size(); ++material_index) {
+			for (unsigned int side = 0; side < 6; ++side) {
+				ZN_TEST_ASSERT(
+						incremental_areas.areas[material_index][side] == full_areas.areas[material_index][side]
+				);
+			}
+		}
+
+		make_cubes_test_block(vb, 34);
+	}
+}
+
+void test_voxel_mesher_cubes_benchmark() {
+	const unsigned int iterations = 100;
+
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	// 32x32x32 block with padding
+	make_cubes_test_block(vb, 34);
+
+	Ref<VoxelMesherCubes> mesher;
+	mesher.instantiate();
+	mesher->set_color_mode(VoxelMesherCubes::COLOR_RAW);
+
+	VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false };
+
+	struct Mode {
+		const char *name;
+		bool greedy;
+		bool binary;
+	};
+	// Scanning greedy meshing is what was used before the bitmask kernel
+	const Mode modes[] = {
+		{ "greedy off", false, false }, //
+		{ "greedy with scanning", true, false }, //
+		{ "greedy with bitmasks", true, true }, //
+	};
+
+	for (const Mode &mode : modes) {
+		mesher->set_greedy_meshing_enabled(mode.greedy);
+		mesher->set_binary_greedy_meshing_enabled(mode.binary);
+		VoxelMesher::Output output;
+
+		ProfilingClock profiling_clock;
+		for (unsigned int i = 0; i < iterations; ++i) {
+			output = VoxelMesher::Output();
+			mesher->build(output, input);
+		}
+		const uint64_t elapsed_us = profiling_clock.get_elapsed_microseconds();
+
+		print_line(format("Cubes mesher, {}: {} us per 32x32x32 block", mode.name, elapsed_us / iterations));
+	}
+}
+
 } // namespace zylann::voxel::tests
@@ -2,10 +2,96 @@
 #include "../../containers/std_map.h"
 #include "../../containers/std_unordered_map.h"
 #include "../../containers/std_vector.h"
+#include "../../math/vector2f.h"
 #include "../core/packed_arrays.h"
+#include "rendering_server.h"
 
 namespace zylann::godot {
 
+#ifdef ZN_GODOT_PACKED_SURFACE_SUPPORTED
+
+void pack_surface_positions_and_normals(
+		PackedSurface &surface,
+		Span<const Vector3f> positions,
+		Span<const Vector3f> normals
+) {
+	ZN_ASSERT_RETURN(normals.size() == 0 || normals.size() == positions.size());
+
+	const unsigned int vertex_count = positions.size();
+	const unsigned int position_stride = sizeof(Vector3f);
+	// Encoded the same way as `RenderingServer::mesh_create_surface_data_from_arrays`
+	const unsigned int normal_stride = 2 * sizeof(uint16_t);
+
+	surface.vertex_count = vertex_count;
+	surface.format |= Mesh::ARRAY_FORMAT_VERTEX;
+	if (normals.size() > 0) {
+		surface.format |= Mesh::ARRAY_FORMAT_NORMAL;
+	}
+
+	surface.vertex_data.resize((position_stride + (normals.size() > 0 ? normal_stride : 0)) * vertex_count);
+	uint8_t *dst = surface.vertex_data.ptrw();
+
+	static_assert(sizeof(Vector3f) == 3 * sizeof(float));
+	memcpy(dst, positions.data(), position_stride * vertex_count);
+
+	if (vertex_count > 0) {
+		Vector3f min_pos = positions[0];
+		Vector3f max_pos = positions[0];
+		for (const Vector3f pos : positions) {
+			min_pos = math::min(min_pos, pos);
+			max_pos = math::max(max_pos, pos);
+		}
+		const Vector3f size = max_pos - min_pos;
+		surface.aabb = AABB(Vector3(min_pos.x, min_pos.y, min_pos.z), Vector3(size.x, size.y, size.z));
+	}
+
+	uint16_t *dst_normals = reinterpret_cast<uint16_t *>(dst + position_stride * vertex_count);
+	for (const Vector3f normal : normals) {
+		Vector2f res(0.5f, 0.5f);
+		// Zero normals would produce NaNs
+		if (normal != Vector3f()) {
+			const Vector2 encoded = Vector3(normal.x, normal.y, normal.z).octahedron_encode();
+			res = Vector2f(encoded.x, encoded.y);
+		}
+		dst_normals[0] = static_cast<uint16_t>(math::clamp(res.x * 65535.f, 0.f, 65535.f));
+		dst_normals[1] = static_cast<uint16_t>(math::clamp(res.y * 65535.f, 0.f, 65535.f));
+		dst_normals += 2;
+	}
+}
+
+void pack_surface_indices(PackedSurface &surface, Span<const int32_t> indices) {
+	surface.index_count = indices.size();
+	surface.format |= Mesh::ARRAY_FORMAT_INDEX;
+
+	// Must match the rule RenderingServer uses to pick the size of indices
+	if (surface.vertex_count <= 65536 && surface.vertex_count > 0) {
+		surface.index_data.resize(indices.size() * sizeof(uint16_t));
+		uint16_t *dst = reinterpret_cast<uint16_t *>(surface.index_data.ptrw());
+		for (unsigned int i = 0; i < indices.size(); ++i) {
+			dst[i] = indices[i];
+		}
+	} else {
+		surface.index_data.resize(indices.size() * sizeof(int32_t));
+		memcpy(surface.index_data.ptrw(), indices.data(), surface.index_data.size());
+	}
+}
+
+void add_packed_surface(ArrayMesh &mesh, const Mesh::PrimitiveType primitive, const PackedSurface &surface) {
+	mesh.add_surface(
+			surface.format | RenderingServer::ARRAY_FLAG_FORMAT_CURRENT_VERSION,
+			primitive,
+			surface.vertex_data,
+			surface.attribute_data,
+			PackedByteArray(),
+			surface.vertex_count,
+			surface.index_data,
+			surface.index_count,
+			surface.aabb
+	);
+}
+
+#endif // ZN_GODOT_PACKED_SURFACE_SUPPORTED
+
 #ifdef TOOLS_ENABLED
 
 Array generate_debug_seams_wireframe_surface(const ArrayMesh &src_mesh, int surface_index) {
@@ -8,8 +8,58 @@
 using namespace godot;
 #endif
 
+#include "../../containers/span.h"
+#include "../../math/vector3f.h"
+#include "../core/version.h"
+
+// Surfaces can be given to the RenderingServer in the layout it stores them in, without going through arrays.
+// This is only possible in module builds, the extension API doesn't expose `ArrayMesh::add_surface`. The layout
+// handled here is the one introduced in Godot 4.2.
+#if defined(ZN_GODOT) && GODOT_VERSION_MAJOR == 4 && GODOT_VERSION_MINOR >= 2
+#define ZN_GODOT_PACKED_SURFACE_SUPPORTED
+#endif
+
+// `Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES` (16-bit positions relative to the AABB, packed normals) appeared in Godot 4.2
+#if GODOT_VERSION_MAJOR == 4 && GODOT_VERSION_MINOR >= 2
+#define ZN_GODOT_MESH_COMPRESSION_SUPPORTED
+#endif
+
 namespace zylann::godot {
 
+// Vertex data of a surface, in the uncompressed format used by RenderingServer.
+struct PackedSurface {
+	// Positions of all vertices as 3 floats, followed by normals of all vertices as 2 octahedral 16-bit unorms
+	PackedByteArray vertex_data;
+	// Color, UV and custom attributes of each vertex, interleaved in the order of `Mesh::ArrayType`
+	PackedByteArray attribute_data;
+	// 16-bit indices if there are no more than 65536 vertices, 32-bit otherwise
+	PackedByteArray index_data;
+	// Combination of `Mesh::ArrayFormat` flags describing which attributes are present
+	uint64_t format = 0;
+	uint32_t vertex_count = 0;
+	uint32_t index_count = 0;
+	AABB aabb;
+
+	inline bool is_empty() const {
+		return vertex_count == 0;
+	}
+};
+
+#ifdef ZN_GODOT_PACKED_SURFACE_SUPPORTED
+
+// Fills vertex data and AABB of the surface. If normals are provided, there must be as many as positions.
+void pack_surface_positions_and_normals(
+		PackedSurface &surface,
+		Span<const Vector3f> positions,
+		Span<const Vector3f> normals
+);
+
+void pack_surface_indices(PackedSurface &surface, Span<const int32_t> indices);
+
+void add_packed_surface(ArrayMesh &mesh, const Mesh::PrimitiveType primitive, const PackedSurface &surface);
+
+#endif
+
 // TODO The following functions should be able to work on `Mesh`,
 // but the script/extension API exposes some methods only on `ArrayMesh`, even though they exist on `Mesh` internally...
 
@@ -12,6 +12,7 @@ using namespace godot;
 #endif
 
 #include "../../containers/span.h"
+#include "../core/version.h"
 
 namespace zylann::godot {
 
@@ -49,6 +50,23 @@ inline void store_buffer(FileAccess &f, Span<const uint8_t> src) {
 #endif
 }
 
+// Returns -1 if the file could not be accessed.
+inline int64_t get_file_size(const String &path) {
+#if GODOT_VERSION_MAJOR == 4 && GODOT_VERSION_MINOR >= 4
+	if (!FileAccess::exists(path)) {
+		return -1;
+	}
+	return FileAccess::get_size(path);
+#else
+	Error err;
+	Ref<FileAccess> f = open_file(path, FileAccess::READ, err);
+	if (f.is_null()) {
+		return -1;
+	}
+	return f->get_length();
+#endif
+}
+
 inline String get_as_text(FileAccess &f) {
 #if defined(ZN_GODOT)
 	return f.get_as_utf8_string();
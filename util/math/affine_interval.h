@@ -0,0 +1,253 @@
+#ifndef ZN_AFFINE_INTERVAL_H
+#define ZN_AFFINE_INTERVAL_H
+
+#include "interval.h"
+#include <cmath>
+
+namespace zylann::math {
+
+// For affine arithmetic, an alternative to interval arithmetic.
+// Represents a range as `center + sum(coefficients[i] * e[i]) + error * e_extra`, where each `e` is an unknown value
+// in [-1, 1]. `e[i]` are symbols shared by all ranges computed from the same inputs, so linear correlations between
+// them are not lost. For example, `x - x` is exactly 0, while intervals would give twice the width of `x`.
+// Non-linear operations are approximated with a linear function, and their approximation error goes into `error`,
+// which is not correlated with anything. This keeps the size fixed, at the cost of some precision compared to adding
+// a new symbol for each of them.
+// Computations are not rounded outwards, so like `Interval` this is meant for estimations, not exact proofs.
+struct AffineInterval {
+	// Typically X, Y, Z and SDF inputs of a graph
+	static const unsigned int SYMBOL_COUNT = 4;
+
+	real_t center = 0;
+	real_t coefficients[SYMBOL_COUNT] = { 0, 0, 0, 0 };
+	// Always positive
+	real_t error = 0;
+
+	inline static AffineInterval from_single_value(real_t v) {
+		AffineInterval a;
+		a.center = v;
+		return a;
+	}
+
+	// Creates a range not correlated with anything
+	inline static AffineInterval from_interval(const Interval i) {
+		AffineInterval a;
+		if (std::isfinite(i.min) && std::isfinite(i.max)) {
+			a.center = (i.min + i.max) * real_t(0.5);
+			a.error = (i.max - i.min) * real_t(0.5);
+		} else {
+			a.error = std::numeric_limits<real_t>::infinity();
+		}
+		return a;
+	}
+
+	// Creates a range spanning the given interval, using a symbol that other ranges may share
+	inline static AffineInterval from_symbol(const Interval i, unsigned int symbol_index) {
+		if (symbol_index >= SYMBOL_COUNT) {
+			return from_interval(i);
+		}
+		AffineInterval a = from_interval(i);
+		a.coefficients[symbol_index] = a.error;
+		a.error = 0;
+		return a;
+	}
+
+	inline real_t get_radius() const {
+		real_t r = error;
+		for (unsigned int i = 0; i < SYMBOL_COUNT; ++i) {
+			r += math::abs(coefficients[i]);
+		}
+		return r;
+	}
+
+	// Infinite and undefined ranges can't be converted into an interval
+	inline bool is_bounded() const {
+		return std::isfinite(center) && std::isfinite(get_radius());
+	}
+
+	inline Interval get_interval() const {
+		const real_t r = get_radius();
+		return Interval(center - r, center + r);
+	}
+
+	inline AffineInterval operator+(const AffineInterval &other) const {
+		AffineInterval a;
+		a.center = center + other.center;
+		for (unsigned int i = 0; i < SYMBOL_COUNT; ++i) {
+			a.coefficients[i] = coefficients[i] + other.coefficients[i];
+		}
+		a.error = error + other.error;
+		return a;
+	}
+
+	inline AffineInterval operator-(const AffineInterval &other) const {
+		AffineInterval a;
+		a.center = center - other.center;
+		for (unsigned int i = 0; i < SYMBOL_COUNT; ++i) {
+			a.coefficients[i] = coefficients[i] - other.coefficients[i];
+		}
+		// Errors are not correlated, so they never cancel out
+		a.error = error + other.error;
+		return a;
+	}
+
+	inline AffineInterval operator-() const {
+		AffineInterval a;
+		a.center = -center;
+		for (unsigned int i = 0; i < SYMBOL_COUNT; ++i) {
+			a.coefficients[i] = -coefficients[i];
+		}
+		a.error = error;
+		return a;
+	}
+
+	inline AffineInterval operator+(real_t x) const {
+		AffineInterval a = *this;
+		a.center += x;
+		return a;
+	}
+
+	inline AffineInterval operator*(real_t x) const {
+		AffineInterval a;
+		a.center = center * x;
+		for (unsigned int i = 0; i < SYMBOL_COUNT; ++i) {
+			a.coefficients[i] = coefficients[i] * x;
+		}
+		a.error = error * math::abs(x);
+		return a;
+	}
+
+	inline AffineInterval operator*(const AffineInterval &other) const {
+		// The product of the two deviations is not linear. It is bounded by the product of their radii.
+		AffineInterval a;
+		a.center = center * other.center;
+		for (unsigned int i = 0; i < SYMBOL_COUNT; ++i) {
+			a.coefficients[i] = center * other.coefficients[i] + other.center * coefficients[i];
+		}
+		a.error = math::abs(center) * other.error + math::abs(other.center) * error + get_radius() * other.get_radius();
+		return a;
+	}
+};
+
+// Returns `alpha * x + zeta`, with an additional error of `delta`
+inline AffineInterval affine_approximation(const AffineInterval &x, real_t alpha, real_t zeta, real_t delta) {
+	AffineInterval a = x * alpha;
+	a.center += zeta;
+	a.error += delta;
+	return a;
+}
+
+// Prefer this over x*x, this will provide a more optimal result
+inline AffineInterval squared(const AffineInterval &x) {
+	const real_t r = x.get_radius();
+	const real_t lo = x.center - r;
+	const real_t hi = x.center + r;
+	// Chebyshev approximation: the line parallel to the chord of the parabola, halfway between the chord and the
+	// tangent. `x^2 - alpha * x` ranges from `-alpha^2 / 4` to `-lo * hi`.
+	const real_t alpha = lo + hi;
+	const real_t zeta = -(alpha * alpha * real_t(0.25) + lo * hi) * real_t(0.5);
+	const real_t delta = (hi - lo) * (hi - lo) * real_t(0.125);
+	return affine_approximation(x, alpha, zeta, delta);
+}
+
+// Same as the `sqrt` of `Interval`, negative values are treated as zero
+inline AffineInterval sqrt(const AffineInterval &x) {
+	if (!x.is_bounded()) {
+		return AffineInterval::from_interval(Interval::from_infinity());
+	}
+	const real_t r = x.get_radius();
+	const real_t lo = x.center - r;
+	const real_t hi = x.center + r;
+	if (hi <= 0) {
+		return AffineInterval::from_single_value(0);
+	}
+	if (lo < 0 || r == 0) {
+		// The clamped part is flat, a single line can't approximate it well
+		return AffineInterval::from_interval(sqrt(Interval(lo, hi)));
+	}
+	// Chebyshev approximation. The curve is concave, so it is above the chord and below the tangent parallel to it.
+	const real_t sqrt_lo = Math::sqrt(lo);
+	const real_t sqrt_hi = Math::sqrt(hi);
+	const real_t alpha = real_t(1) / (sqrt_lo + sqrt_hi);
+	// Distance of the chord and of the tangent to the line `alpha * x`
+	const real_t d_chord = sqrt_lo - alpha * lo;
+	const real_t d_tangent = real_t(0.25) / alpha;
+	return affine_approximation(x, alpha, (d_chord + d_tangent) * real_t(0.5), (d_tangent - d_chord) * real_t(0.5));
+}
+
+// Same as `1 / x`. Infinite if `x` contains zero.
+inline AffineInterval reciprocal(const AffineInterval &x) {
+	if (!x.is_bounded()) {
+		return AffineInterval::from_interval(Interval::from_infinity());
+	}
+	const real_t r = x.get_radius();
+	const real_t lo = x.center - r;
+	const real_t hi = x.center + r;
+	if (lo <= 0 && hi >= 0) {
+		return AffineInterval::from_interval(Interval::from_infinity());
+	}
+	if (hi < 0) {
+		return -reciprocal(-x);
+	}
+	// Chebyshev approximation. The curve is convex, so it is below the chord and above the tangent parallel to it.
+	// `1 / x - alpha * x` ranges from `2 / sqrt(lo * hi)` to `1 / lo + 1 / hi`.
+	const real_t alpha = real_t(-1) / (lo * hi);
+	const real_t d_chord = real_t(1) / lo + real_t(1) / hi;
+	const real_t d_tangent = real_t(2) / Math::sqrt(lo * hi);
+	return affine_approximation(x, alpha, (d_chord + d_tangent) * real_t(0.5), (d_chord - d_tangent) * real_t(0.5));
+}
+
+// When ranges overlap, the result is not a linear function of the inputs anymore, so it loses correlations
+inline AffineInterval min_interval(const AffineInterval &a, const AffineInterval &b) {
+	if (!a.is_bounded() || !b.is_bounded()) {
+		return AffineInterval::from_interval(Interval::from_infinity());
+	}
+	const Interval ai = a.get_interval();
+	const Interval bi = b.get_interval();
+	if (ai.max <= bi.min) {
+		return a;
+	}
+	if (bi.max <= ai.min) {
+		return b;
+	}
+	return AffineInterval::from_interval(min_interval(ai, bi));
+}
+
+inline AffineInterval max_interval(const AffineInterval &a, const AffineInterval &b) {
+	return -min_interval(-a, -b);
+}
+
+inline AffineInterval clamp(const AffineInterval &x, const AffineInterval &p_min, const AffineInterval &p_max) {
+	return min_interval(max_interval(x, p_min), p_max);
+}
+
+inline AffineInterval lerp(const AffineInterval &a, const AffineInterval &b, const AffineInterval &t) {
+	return a + (b - a) * t;
+}
+
+// Both ranges are estimations of the same values, so their intersection is too
+inline Interval get_tightest_interval(const Interval i, const AffineInterval &a) {
+	if (!a.is_bounded()) {
+		return i;
+	}
+	const Interval ai = a.get_interval();
+	const real_t minv = math::max(i.min, ai.min);
+	const real_t maxv = math::min(i.max, ai.max);
+	if (minv > maxv) {
+		// Can happen due to rounding errors when both are very close to a single value
+		return i;
+	}
+	return Interval(minv, maxv);
+}
+
+inline AffineInterval get_length(const AffineInterval &x, const AffineInterval &y) {
+	return sqrt(squared(x) + squared(y));
+}
+
+inline AffineInterval get_length(const AffineInterval &x, const AffineInterval &y, const AffineInterval &z) {
+	return sqrt(squared(x) + squared(y) + squared(z));
+}
+
+} // namespace zylann::math
+
+#endif // ZN_AFFINE_INTERVAL_H
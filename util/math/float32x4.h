@@ -0,0 +1,327 @@
+#ifndef ZN_MATH_FLOAT32X4_H
+#define ZN_MATH_FLOAT32X4_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// SSE2 and NEON are part of the base instruction sets of x86_64 and ARM64, so they can be used without checking the
+// CPU at runtime.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZN_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ZN_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zylann::math {
+
+// Pack of 4 floats processed with single instructions when the platform supports it.
+// Functions have the same semantics as their scalar versions in `funcs.h`, so the same operations done in the same
+// order give the same results. For example, `min(a, b)` is `a < b ? a : b`, including with NaNs and signed zeros.
+// This allows to write some math functions as templates and use them with either `float` or `Float32x4`.
+struct Float32x4 {
+	static const unsigned int SIZE = 4;
+
+#if defined(ZN_SIMD_SSE2)
+	__m128 v;
+#elif defined(ZN_SIMD_NEON)
+	float32x4_t v;
+#else
+	float v[SIZE];
+#endif
+
+	Float32x4() = default;
+
+	// Same value in all components
+	explicit inline Float32x4(float f) {
+#if defined(ZN_SIMD_SSE2)
+		v = _mm_set1_ps(f);
+#elif defined(ZN_SIMD_NEON)
+		v = vdupq_n_f32(f);
+#else
+		for (unsigned int i = 0; i < SIZE; ++i) {
+			v[i] = f;
+		}
+#endif
+	}
+
+	// Pointers don't need to be aligned
+	static inline Float32x4 load(const float *src) {
+		Float32x4 r;
+#if defined(ZN_SIMD_SSE2)
+		r.v = _mm_loadu_ps(src);
+#elif defined(ZN_SIMD_NEON)
+		r.v = vld1q_f32(src);
+#else
+		for (unsigned int i = 0; i < SIZE; ++i) {
+			r.v[i] = src[i];
+		}
+#endif
+		return r;
+	}
+
+	inline void store(float *dst) const {
+#if defined(ZN_SIMD_SSE2)
+		_mm_storeu_ps(dst, v);
+#elif defined(ZN_SIMD_NEON)
+		vst1q_f32(dst, v);
+#else
+		for (unsigned int i = 0; i < SIZE; ++i) {
+			dst[i] = v[i];
+		}
+#endif
+	}
+};
+
+// Result of a comparison, one boolean per component
+struct Float32x4Mask {
+#if defined(ZN_SIMD_SSE2)
+	__m128 v;
+#elif defined(ZN_SIMD_NEON)
+	uint32x4_t v;
+#else
+	bool v[Float32x4::SIZE];
+#endif
+};
+
+#if defined(ZN_SIMD_SSE2)
+
+inline Float32x4 make_float32x4(__m128 v) {
+	Float32x4 r;
+	r.v = v;
+	return r;
+}
+
+inline Float32x4Mask make_float32x4_mask(__m128 v) {
+	Float32x4Mask r;
+	r.v = v;
+	return r;
+}
+
+inline Float32x4 operator+(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(_mm_add_ps(a.v, b.v));
+}
+
+inline Float32x4 operator-(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(_mm_sub_ps(a.v, b.v));
+}
+
+inline Float32x4 operator*(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(_mm_mul_ps(a.v, b.v));
+}
+
+inline Float32x4 operator/(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(_mm_div_ps(a.v, b.v));
+}
+
+inline Float32x4 operator-(const Float32x4 a) {
+	// Flips the sign bit, like scalar negation
+	return make_float32x4(_mm_xor_ps(a.v, _mm_set1_ps(-0.f)));
+}
+
+inline Float32x4Mask operator<(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4_mask(_mm_cmplt_ps(a.v, b.v));
+}
+
+inline Float32x4Mask operator>(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4_mask(_mm_cmpgt_ps(a.v, b.v));
+}
+
+inline Float32x4Mask operator==(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4_mask(_mm_cmpeq_ps(a.v, b.v));
+}
+
+// Component-wise `mask ? a : b`
+inline Float32x4 select(const Float32x4Mask mask, const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)));
+}
+
+inline Float32x4 min(const Float32x4 a, const Float32x4 b) {
+	// Returns the second operand if values are equal or if any is NaN, which matches `a < b ? a : b`
+	return make_float32x4(_mm_min_ps(a.v, b.v));
+}
+
+inline Float32x4 max(const Float32x4 a, const Float32x4 b) {
+	// Returns the second operand if values are equal or if any is NaN, which matches `a > b ? a : b`
+	return make_float32x4(_mm_max_ps(a.v, b.v));
+}
+
+inline Float32x4 abs(const Float32x4 a) {
+	return make_float32x4(_mm_andnot_ps(_mm_set1_ps(-0.f), a.v));
+}
+
+inline Float32x4 sqrt(const Float32x4 a) {
+	return make_float32x4(_mm_sqrt_ps(a.v));
+}
+
+#elif defined(ZN_SIMD_NEON)
+
+inline Float32x4 make_float32x4(float32x4_t v) {
+	Float32x4 r;
+	r.v = v;
+	return r;
+}
+
+inline Float32x4Mask make_float32x4_mask(uint32x4_t v) {
+	Float32x4Mask r;
+	r.v = v;
+	return r;
+}
+
+inline Float32x4 operator+(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(vaddq_f32(a.v, b.v));
+}
+
+inline Float32x4 operator-(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(vsubq_f32(a.v, b.v));
+}
+
+inline Float32x4 operator*(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(vmulq_f32(a.v, b.v));
+}
+
+inline Float32x4 operator/(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(vdivq_f32(a.v, b.v));
+}
+
+inline Float32x4 operator-(const Float32x4 a) {
+	return make_float32x4(vnegq_f32(a.v));
+}
+
+inline Float32x4Mask operator<(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4_mask(vcltq_f32(a.v, b.v));
+}
+
+inline Float32x4Mask operator>(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4_mask(vcgtq_f32(a.v, b.v));
+}
+
+inline Float32x4Mask operator==(const Float32x4 a, const Float32x4 b) {
+	return make_float32x4_mask(vceqq_f32(a.v, b.v));
+}
+
+// Component-wise `mask ? a : b`
+inline Float32x4 select(const Float32x4Mask mask, const Float32x4 a, const Float32x4 b) {
+	return make_float32x4(vbslq_f32(mask.v, a.v, b.v));
+}
+
+// Not using `vminq_f32` and `vmaxq_f32`, they handle NaNs and signed zeros differently from scalar code
+
+inline Float32x4 min(const Float32x4 a, const Float32x4 b) {
+	return select(a < b, a, b);
+}
+
+inline Float32x4 max(const Float32x4 a, const Float32x4 b) {
+	return select(a > b, a, b);
+}
+
+inline Float32x4 abs(const Float32x4 a) {
+	return make_float32x4(vabsq_f32(a.v));
+}
+
+inline Float32x4 sqrt(const Float32x4 a) {
+	return make_float32x4(vsqrtq_f32(a.v));
+}
+
+#else
+
+// Fallback processing components one by one
+
+template <typename F>
+inline Float32x4 map_float32x4(const Float32x4 a, const Float32x4 b, F f) {
+	Float32x4 r;
+	for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+		r.v[i] = f(a.v[i], b.v[i]);
+	}
+	return r;
+}
+
+template <typename F>
+inline Float32x4Mask compare_float32x4(const Float32x4 a, const Float32x4 b, F f) {
+	Float32x4Mask r;
+	for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+		r.v[i] = f(a.v[i], b.v[i]);
+	}
+	return r;
+}
+
+inline Float32x4 operator+(const Float32x4 a, const Float32x4 b) {
+	return map_float32x4(a, b, [](float x, float y) { return x + y; });
+}
+
+inline Float32x4 operator-(const Float32x4 a, const Float32x4 b) {
+	return map_float32x4(a, b, [](float x, float y) { return x - y; });
+}
+
+inline Float32x4 operator*(const Float32x4 a, const Float32x4 b) {
+	return map_float32x4(a, b, [](float x, float y) { return x * y; });
+}
+
+inline Float32x4 operator/(const Float32x4 a, const Float32x4 b) {
+	return map_float32x4(a, b, [](float x, float y) { return x / y; });
+}
+
+inline Float32x4 operator-(const Float32x4 a) {
+	return map_float32x4(a, a, [](float x, float) { return -x; });
+}
+
+inline Float32x4Mask operator<(const Float32x4 a, const Float32x4 b) {
+	return compare_float32x4(a, b, [](float x, float y) { return x < y; });
+}
+
+inline Float32x4Mask operator>(const Float32x4 a, const Float32x4 b) {
+	return compare_float32x4(a, b, [](float x, float y) { return x > y; });
+}
+
+inline Float32x4Mask operator==(const Float32x4 a, const Float32x4 b) {
+	return compare_float32x4(a, b, [](float x, float y) { return x == y; });
+}
+
+// Component-wise `mask ? a : b`
+inline Float32x4 select(const Float32x4Mask mask, const Float32x4 a, const Float32x4 b) {
+	Float32x4 r;
+	for (unsigned int i = 0; i < Float32x4::SIZE; ++i) {
+		r.v[i] = mask.v[i] ? a.v[i] : b.v[i];
+	}
+	return r;
+}
+
+inline Float32x4 min(const Float32x4 a, const Float32x4 b) {
+	return map_float32x4(a, b, [](float x, float y) { return x < y ? x : y; });
+}
+
+inline Float32x4 max(const Float32x4 a, const Float32x4 b) {
+	return map_float32x4(a, b, [](float x, float y) { return x > y ? x : y; });
+}
+
+inline Float32x4 abs(const Float32x4 a) {
+	return map_float32x4(a, a, [](float x, float) {
+		// Clears the sign bit, without depending on engine headers
+		uint32_t bits;
+		std::memcpy(&bits, &x, sizeof(float));
+		bits &= 0x7fffffff;
+		std::memcpy(&x, &bits, sizeof(float));
+		return x;
+	});
+}
+
+inline Float32x4 sqrt(const Float32x4 a) {
+	return map_float32x4(a, a, [](float x, float) { return std::sqrt(x); });
+}
+
+#endif
+
+inline Float32x4 clamp(const Float32x4 x, const Float32x4 min_value, const Float32x4 max_value) {
+	return min(max(x, min_value), max_value);
+}
+
+inline Float32x4 lerp(const Float32x4 a, const Float32x4 b, const Float32x4 t) {
+	// Same as `Math::lerp`
+	return a + (b - a) * t;
+}
+
+} // namespace zylann::math
+
+#endif // ZN_MATH_FLOAT32X4_H
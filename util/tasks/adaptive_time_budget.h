@@ -0,0 +1,67 @@
+#ifndef ZYLANN_ADAPTIVE_TIME_BUDGET_H
+#define ZYLANN_ADAPTIVE_TIME_BUDGET_H
+
+#include "../math/funcs.h"
+#include <cstdint>
+
+namespace zylann {
+
+// Time budget per frame that shrinks when frames take longer than a target duration, and grows back up to its
+// maximum when they are shorter.
+class AdaptiveTimeBudget {
+public:
+	void set_max_usec(uint32_t usec) {
+		_max_usec = usec;
+		_usec = usec;
+	}
+
+	uint32_t get_max_usec() const {
+		return _max_usec;
+	}
+
+	// If zero, the budget stays at its maximum.
+	void set_target_frame_time_usec(uint32_t usec) {
+		_target_frame_time_usec = usec;
+		_usec = _max_usec;
+	}
+
+	uint32_t get_target_frame_time_usec() const {
+		return _target_frame_time_usec;
+	}
+
+	// Must be called once per frame, with the current time.
+	void update(uint64_t now_usec) {
+		const uint64_t frame_time_usec = now_usec - _last_update_time_usec;
+		const bool first_frame = !_has_last_update_time;
+		_last_update_time_usec = now_usec;
+		_has_last_update_time = true;
+
+		if (_target_frame_time_usec == 0 || first_frame) {
+			_usec = _max_usec;
+			return;
+		}
+
+		// Shrink quickly when frames are too long, and grow back slowly so we don't oscillate
+		const uint32_t min_usec = _max_usec / 8;
+		if (frame_time_usec > _target_frame_time_usec) {
+			_usec = math::max((_usec * 3) / 4, min_usec);
+		} else {
+			_usec = math::min(_usec + math::max(_max_usec / 16, uint32_t(1)), _max_usec);
+		}
+	}
+
+	uint32_t get_usec() const {
+		return _usec;
+	}
+
+private:
+	uint32_t _max_usec = 0;
+	uint32_t _target_frame_time_usec = 0;
+	uint32_t _usec = 0;
+	uint64_t _last_update_time_usec = 0;
+	bool _has_last_update_time = false;
+};
+
+} // namespace zylann
+
+#endif // ZYLANN_ADAPTIVE_TIME_BUDGET_H
@@ -0,0 +1,37 @@
+#include "cancellation_token.h"
+#include "../godot/classes/time.h"
+
+namespace zylann {
+
+void TaskCancellationToken::set_timeout_usec(uint64_t duration_usec) {
+	set_deadline_usec(Time::get_singleton()->get_ticks_usec() + duration_usec);
+}
+
+bool TaskCancellationToken::is_cancelled() const {
+#ifdef TOOLS_ENABLED
+	ZN_ASSERT(_state != nullptr);
+#endif
+	// Only query time if there is a deadline
+	uint64_t now_usec = 0;
+
+	for (State *state = _state.get(); state != nullptr; state = state->parent.get()) {
+		if (state->cancelled) {
+			return true;
+		}
+		const uint64_t deadline_usec = state->deadline_usec;
+		if (deadline_usec != 0) {
+			if (now_usec == 0) {
+				now_usec = Time::get_singleton()->get_ticks_usec();
+			}
+			if (now_usec >= deadline_usec) {
+				// Remember it so next checks don't need to query time
+				state->cancelled = true;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+} // namespace zylann
@@ -4,11 +4,15 @@
 #include "../errors.h"
 #include "../memory/memory.h"
 #include <atomic>
+#include <cstdint>
 
 namespace zylann {
 
 // Simple object shared between a task and the requester of the task. Allows the requester to cancel the task before it
 // runs or finishes.
+//
+// Tokens can have children, so tasks spawned by another task can be cancelled along with it. They can also have a
+// deadline, after which they are considered cancelled, so work that would come too late can be skipped.
 class TaskCancellationToken {
 public:
 	// TODO Could be optimized
@@ -17,30 +21,52 @@ public:
 
 	static TaskCancellationToken create() {
 		TaskCancellationToken token;
-		token._cancelled = make_shared_instance<std::atomic_bool>(false);
+		token._state = make_shared_instance<State>();
+		return token;
+	}
+
+	// Creates a token that will also be cancelled when this one is (or when its deadline is reached). Cancelling the
+	// child doesn't cancel its parent. If this token is not valid, the child has no parent.
+	TaskCancellationToken create_child() const {
+		TaskCancellationToken token = create();
+		token._state->parent = _state;
 		return token;
 	}
 
 	inline bool is_valid() const {
-		return _cancelled != nullptr;
+		return _state != nullptr;
 	}
 
 	inline void cancel() {
 #ifdef TOOLS_ENABLED
-		ZN_ASSERT(_cancelled != nullptr);
+		ZN_ASSERT(_state != nullptr);
 #endif
-		*_cancelled = true;
+		_state->cancelled = true;
 	}
 
-	inline bool is_cancelled() const {
+	// Sets a time after which the token will be considered cancelled, in microseconds, in the same time base as
+	// `Time.get_ticks_usec()`. 0 means no deadline.
+	inline void set_deadline_usec(uint64_t time_usec) {
 #ifdef TOOLS_ENABLED
-		ZN_ASSERT(_cancelled != nullptr);
+		ZN_ASSERT(_state != nullptr);
 #endif
-		return *_cancelled;
+		_state->deadline_usec = time_usec;
 	}
 
+	// Same as `set_deadline_usec`, relative to the current time.
+	void set_timeout_usec(uint64_t duration_usec);
+
+	// Returns `true` if the token, or any of its parents, was cancelled or reached its deadline.
+	bool is_cancelled() const;
+
 private:
-	std::shared_ptr<std::atomic_bool> _cancelled;
+	struct State {
+		std::atomic_bool cancelled = { false };
+		std::atomic_uint64_t deadline_usec = { 0 };
+		std::shared_ptr<State> parent;
+	};
+
+	std::shared_ptr<State> _state;
 };
 
 } // namespace zylann
@@ -0,0 +1,54 @@
+#include "resumable_threaded_task.h"
+#include "../errors.h"
+#include "../godot/classes/time.h"
+#include "../io/log.h"
+
+namespace zylann {
+
+void IResumableThreadedTask::run(ThreadedTaskContext &ctx) {
+	while (true) {
+		const uint8_t stage = _stage;
+		ZN_ASSERT_RETURN(stage != NO_STAGE);
+
+		// Set the default next stage before running, because once a stage suspends, the task may already be resumed by
+		// another thread and must not be modified by this one.
+		_stage = stage + 1;
+
+		const StageResult result = run_stage(stage, ctx);
+
+		switch (result) {
+			case STAGE_CONTINUE:
+				_yield_stage = NO_STAGE;
+				break;
+
+			case STAGE_YIELD:
+				_stage = stage;
+				if (_yield_stage != stage) {
+					_yield_stage = stage;
+					_first_yield_time_usec = Time::get_singleton()->get_ticks_usec();
+				}
+				ctx.status = ThreadedTaskContext::STATUS_POSTPONED;
+				return;
+
+			case STAGE_SUSPEND:
+				ctx.status = ThreadedTaskContext::STATUS_TAKEN_OUT;
+				return;
+
+			case STAGE_DONE:
+				return;
+
+			default:
+				ZN_PRINT_ERROR("Unexpected stage result");
+				return;
+		}
+	}
+}
+
+uint64_t IResumableThreadedTask::get_yield_duration_usec(uint8_t stage) const {
+	if (_yield_stage != stage) {
+		return 0;
+	}
+	return Time::get_singleton()->get_ticks_usec() - _first_yield_time_usec;
+}
+
+} // namespace zylann
@@ -0,0 +1,57 @@
+#ifndef ZN_RESUMABLE_THREADED_TASK_H
+#define ZN_RESUMABLE_THREADED_TASK_H
+
+#include "threaded_task.h"
+
+namespace zylann {
+
+// Threaded task split into a sequence of stages. Between two stages, the task can give its thread back to the runner,
+// for example while it waits for a busy spatial lock, GPU results or I/O, and continue later from any thread, without
+// blocking a worker in the meantime.
+//
+// This is a hand-written alternative to coroutines: anything that must survive until a later stage has to be stored
+// in members of the task, which then act as its own arena.
+class IResumableThreadedTask : public IThreadedTask {
+public:
+	enum StageResult : uint8_t {
+		// Proceeds to the next stage right away, on the same thread.
+		STAGE_CONTINUE,
+		// The current stage can't proceed yet. The task is given back to the runner, and the same stage will be run
+		// again later, possibly on another thread.
+		STAGE_YIELD,
+		// The task was handed over to something else (like a GPU task), which is responsible for scheduling it again
+		// once it is ready to continue. The runner drops its pointer in the meantime.
+		// The stage must not access the task anymore after it has been handed over.
+		STAGE_SUSPEND,
+		// The task is complete.
+		STAGE_DONE
+	};
+
+	void run(ThreadedTaskContext &ctx) override final;
+
+protected:
+	// Runs the given stage. Stages run in increasing order by default, see `set_next_stage`.
+	virtual StageResult run_stage(uint8_t stage, ThreadedTaskContext &ctx) = 0;
+
+	// Sets which stage runs after the current one. Stages returning `STAGE_SUSPEND` must call this before handing the
+	// task over, if the default is not wanted.
+	inline void set_next_stage(uint8_t stage) {
+		_stage = stage;
+	}
+
+	// Gets how long the given stage has been yielding in a row, in microseconds, or 0 if it didn't yield last time.
+	// Can be used to stop yielding and wait instead, if the condition doesn't seem to resolve soon. Yielded tasks can
+	// be picked up again almost immediately, so a number of retries would not say much.
+	uint64_t get_yield_duration_usec(uint8_t stage) const;
+
+private:
+	static constexpr uint8_t NO_STAGE = 0xff;
+
+	uint8_t _stage = 0;
+	uint8_t _yield_stage = NO_STAGE;
+	uint64_t _first_yield_time_usec = 0;
+};
+
+} // namespace zylann
+
+#endif // ZN_RESUMABLE_THREADED_TASK_H
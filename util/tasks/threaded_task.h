@@ -67,6 +67,12 @@ public:
 		return false;
 	}
 
+	// Hints which NUMA node the task would rather run on, usually the one where the memory it works with lives.
+	// -1 means no preference. Only relevant when the runner has thread affinity enabled.
+	virtual int get_preferred_numa_node() const {
+		return -1;
+	}
+
 	// Gets the name of the task for debug purposes. The returned name's lifetime must span the execution of the engine
 	// (usually a string literal).
 	virtual const char *get_debug_name() const {
@@ -3,6 +3,7 @@
 #include "../godot/classes/time.h"
 #include "../profiling.h"
 #include "../string/format.h"
+#include "../thread/cpu_topology.h"
 
 namespace zylann {
 
@@ -34,6 +35,19 @@ void ThreadedTaskRunner::create_thread(ThreadData &d, uint32_t i) {
 	if (!_name.empty()) {
 		d.name = format("{} {}", _name, i);
 	}
+	if (_affinity_mode != AFFINITY_NONE) {
+		const cpu_topology::Topology &topology = cpu_topology::get_topology();
+		const unsigned int node_count = topology.nodes.size();
+		// Spread threads over nodes
+		const unsigned int node_index = i % node_count;
+		const cpu_topology::NumaNode &node = topology.nodes[node_index];
+		d.numa_node = node_index;
+		if (_affinity_mode == AFFINITY_CORE) {
+			d.cpus.push_back(node.cpus[(i / node_count) % node.cpus.size()]);
+		} else {
+			d.cpus = node.cpus;
+		}
+	}
 	d.thread.start(thread_func_static, &d);
 }
 
@@ -97,16 +111,28 @@ void ThreadedTaskRunner::set_thread_count(uint32_t count) {
 	}
 }
 
+void ThreadedTaskRunner::set_affinity_mode(AffinityMode mode) {
+	ZN_ASSERT_RETURN(mode >= 0 && mode < AFFINITY_MODE_COUNT);
+	ZN_ASSERT_RETURN_MSG(_thread_count == 0, "Affinity must be set before starting threads");
+	_affinity_mode = mode;
+}
+
 void ThreadedTaskRunner::set_priority_update_period(uint32_t milliseconds) {
 	_priority_update_period_ms = milliseconds;
 }
 
-void ThreadedTaskRunner::enqueue(IThreadedTask *task, bool serial) {
-	ZN_PROFILE_SCOPE();
-	ZN_ASSERT(task != nullptr);
+ThreadedTaskRunner::TaskItem ThreadedTaskRunner::make_task_item(IThreadedTask *task, bool serial) {
 	TaskItem t;
 	t.task = task;
 	t.is_serial = serial;
+	t.preferred_numa_node = task->get_preferred_numa_node();
+	return t;
+}
+
+void ThreadedTaskRunner::enqueue(IThreadedTask *task, bool serial) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT(task != nullptr);
+	const TaskItem t = make_task_item(task, serial);
 	{
 		MutexLock lock(_staged_tasks_mutex);
 		_staged_tasks.push_back(t);
@@ -133,10 +159,7 @@ void ThreadedTaskRunner::enqueue(Span<IThreadedTask *> new_tasks, bool serial) {
 		_staged_tasks.resize(_staged_tasks.size() + new_tasks.size());
 		for (size_t i = 0; i < new_tasks.size(); ++i) {
 			IThreadedTask *new_task = new_tasks[i];
-			TaskItem t;
-			t.task = new_task;
-			t.is_serial = serial;
-			_staged_tasks[dst_begin + i] = t;
+			_staged_tasks[dst_begin + i] = make_task_item(new_task, serial);
 
 #ifdef ZN_THREADED_TASK_RUNNER_CHECK_DUPLICATE_TASKS
 			debug_add_owned_task(new_task);
@@ -163,6 +186,14 @@ void ThreadedTaskRunner::thread_func_static(void *p_data) {
 #endif
 	}
 
+	if (data.cpus.size() > 0) {
+		if (!cpu_topology::set_current_thread_affinity(to_span(data.cpus))) {
+			ZN_PRINT_WARNING(format("Could not set affinity of thread {}", data.index));
+		}
+		// Set even if pinning failed, so memory pools and task picking still group work by node
+		cpu_topology::set_current_thread_numa_node(data.numa_node);
+	}
+
 	pool.thread_func(data);
 }
 
@@ -183,25 +214,37 @@ void ThreadedTaskRunner::thread_func(ThreadData &data) {
 
 			ZN_ASSERT(tasks.size() == 0);
 
-			// Pick a postponed task if any.
-			// We will still run a task from the main prioritized queue as well so postponed tasks will not
-			// monopolize execution.
-			//
-			// TODO What if postponed tasks remain while one big task is locking what they need to access?
-			// Those postponed tasks will sort of spinlock with no sleeping. Is that a bad thing?
-			{
-				MutexLock lock2(_spinning_tasks_mutex);
-				if (_spinning_tasks.size() > 0) {
-					tasks.push_back(_spinning_tasks.front());
-					_spinning_tasks.pop();
-				}
-			}
+			bool spinning_tasks_were_skipped = false;
 
 			{
 				// TODO When tasks are very short and there are a lot of tasks, one thread can monopolize this mutex.
 				//
 				MutexLock lock(_tasks_mutex);
 
+				// Pick a postponed task if any.
+				// We will still run a task from the main prioritized queue as well so postponed tasks will not
+				// monopolize execution.
+				// This is done while holding `_tasks_mutex`, because postponed serial tasks must not be picked while
+				// another serial task is running.
+				//
+				// TODO What if postponed tasks remain while one big task is locking what they need to access?
+				// Those postponed tasks will sort of spinlock with no sleeping. Is that a bad thing?
+				{
+					MutexLock lock2(_spinning_tasks_mutex);
+					// Skipped tasks are moved to the back, so the others keep their order
+					for (size_t remaining = _spinning_tasks.size(); remaining > 0; --remaining) {
+						const TaskItem item = _spinning_tasks.front();
+						_spinning_tasks.pop();
+						if (item.is_serial && _is_serial_task_running) {
+							_spinning_tasks.push(item);
+							spinning_tasks_were_skipped = true;
+						} else {
+							tasks.push_back(item);
+							break;
+						}
+					}
+				}
+
 				// Move tasks from the staging queue.
 				// Lock with minimal risk of blocking the main thread, it should be very short.
 				if (_staged_tasks_mutex.try_lock()) {
@@ -250,10 +293,17 @@ void ThreadedTaskRunner::thread_func(ThreadData &data) {
 						_last_priority_update_time_ms = Time::get_singleton()->get_ticks_msec();
 					}
 
-					// Pick task with highest priority if possible
+					// Pick task with highest priority if possible.
+					// When threads are grouped by NUMA node, we look a few tasks further for one preferring the node
+					// of the current thread, so it works on memory close to it.
+					static constexpr unsigned int NUMA_PICK_WINDOW = 4;
+					const unsigned int numa_window = data.numa_node >= 0 ? NUMA_PICK_WINDOW : 1;
+					unsigned int candidate_count = 0;
+					int picked_index = -1;
+
 					// for (int i = int(_tasks.size()) - 1; i >= 0; --i) {
-					for (unsigned int i = _tasks.size(); i-- > 0;) {
-						const TaskItem item = _tasks[i];
+					for (unsigned int i = _tasks.size(); i-- > 0 && candidate_count < numa_window;) {
+						const TaskItem &item = _tasks[i];
 						// Serial tasks are a bit annoying in that regard...
 						// We could make the save/load tasks accept more than one work, which is the best way to do
 						// serial work, but in some cases it's harder to know in advance...
@@ -262,11 +312,22 @@ void ThreadedTaskRunner::thread_func(ThreadData &data) {
 							continue;
 						}
 
-						tasks.push_back(item);
+						if (picked_index == -1) {
+							// Highest priority task we can run, fallback if none prefers our node
+							picked_index = i;
+						}
+						if (item.preferred_numa_node < 0 || item.preferred_numa_node == data.numa_node) {
+							picked_index = i;
+							break;
+						}
+						++candidate_count;
+					}
+
+					if (picked_index != -1) {
+						tasks.push_back(_tasks[picked_index]);
 						// We don't just pop the last item because of serial task handling. But ordered removal should
 						// be fast enough since serial tasks aren't common.
-						_tasks.erase(_tasks.begin() + i);
-						break;
+						_tasks.erase(_tasks.begin() + picked_index);
 					}
 
 				} // For each task to pick
@@ -287,7 +348,8 @@ void ThreadedTaskRunner::thread_func(ThreadData &data) {
 					}
 				}
 
-				task_queue_was_empty = _tasks.size() == 0;
+				// Skipped spinning tasks must be retried soon, they don't post the semaphore
+				task_queue_was_empty = _tasks.size() == 0 && !spinning_tasks_were_skipped;
 
 			} // Tasks queue mutex lock
 		}
@@ -312,7 +374,9 @@ void ThreadedTaskRunner::thread_func(ThreadData &data) {
 
 				// Wait for more tasks
 				data.waiting = true;
+				++_idle_thread_count;
 				_tasks_semaphore.wait();
+				--_idle_thread_count;
 				data.waiting = false;
 
 			} else {
@@ -351,6 +415,9 @@ void ThreadedTaskRunner::thread_func(ThreadData &data) {
 						tasks.push_back(next);
 					}
 					*/
+				} else {
+					// The task may have been postponed before it got cancelled. It must not be postponed again.
+					item.status = ThreadedTaskContext::STATUS_COMPLETE;
 				}
 			}
 
@@ -36,6 +36,16 @@ public:
 		STATE_STOPPED
 	};
 
+	enum AffinityMode { //
+		// Threads can run on any CPU, as decided by the OS
+		AFFINITY_NONE = 0,
+		// Threads are distributed across NUMA nodes and can run on any CPU of their node
+		AFFINITY_NUMA_NODE,
+		// Each thread is pinned to a single CPU, distributed across NUMA nodes
+		AFFINITY_CORE,
+		AFFINITY_MODE_COUNT
+	};
+
 	ThreadedTaskRunner();
 	~ThreadedTaskRunner();
 
@@ -50,6 +60,12 @@ public:
 		return _thread_count;
 	}
 
+	// Must be called before configuring thread count. Only supported on Linux, ignored on other platforms.
+	void set_affinity_mode(AffinityMode mode);
+	AffinityMode get_affinity_mode() const {
+		return _affinity_mode;
+	}
+
 	// TODO Add ability to change it while running
 	// Task priorities can change over time, but computing them too often with many tasks can be expensive,
 	// so they are cached. This sets how often task priorities will be polled.
@@ -92,6 +108,12 @@ public:
 	// Blocks and wait for all tasks to finish (assuming no more are getting added!)
 	void wait_for_all_tasks();
 
+	// Gets how many threads are currently waiting for tasks. Can be used as a hint to split work that would otherwise
+	// run on a single thread. The value may be outdated as soon as it is returned.
+	uint32_t get_idle_thread_count() const {
+		return _idle_thread_count.load(std::memory_order_relaxed);
+	}
+
 	State get_thread_debug_state(uint32_t i) const;
 	const char *get_thread_debug_task_name(unsigned int thread_index) const;
 	unsigned int get_debug_remaining_tasks() const;
@@ -103,6 +125,7 @@ private:
 		IThreadedTask *task = nullptr;
 		TaskPriority cached_priority;
 		bool is_serial = false;
+		int8_t preferred_numa_node = -1;
 		ThreadedTaskContext::Status status = ThreadedTaskContext::STATUS_COMPLETE;
 	};
 
@@ -110,6 +133,9 @@ private:
 		Thread thread;
 		ThreadedTaskRunner *pool = nullptr;
 		uint32_t index = 0;
+		// Only used when affinity is enabled
+		int numa_node = -1;
+		StdVector<uint32_t> cpus;
 		bool stop = false;
 		bool waiting = false;
 		State debug_state = STATE_STOPPED;
@@ -120,6 +146,8 @@ private:
 			thread.wait_to_finish();
 			pool = nullptr;
 			index = 0;
+			numa_node = -1;
+			cpus.clear();
 			stop = false;
 			waiting = false;
 			debug_state = STATE_STOPPED;
@@ -127,6 +155,7 @@ private:
 		}
 	};
 
+	static TaskItem make_task_item(IThreadedTask *task, bool serial);
 	static void thread_func_static(void *p_data);
 	void thread_func(ThreadData &data);
 
@@ -140,6 +169,7 @@ private:
 
 	FixedArray<ThreadData, MAX_THREADS> _threads;
 	uint32_t _thread_count = 0;
+	std::atomic_uint32_t _idle_thread_count = { 0 };
 
 	// Scheduled tasks are put here first. They will be moved to the main waiting queue by the next available thread.
 	// This is because the main waiting queue can be locked for longer due to dynamic priority sorting.
@@ -160,6 +190,8 @@ private:
 	StdVector<IThreadedTask *> _completed_tasks;
 	Mutex _completed_tasks_mutex;
 
+	AffinityMode _affinity_mode = AFFINITY_NONE;
+
 	uint32_t _priority_update_period_ms = 32;
 	uint64_t _last_priority_update_time_ms = 0;
 
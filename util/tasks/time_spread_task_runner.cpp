@@ -1,80 +1,224 @@
 #include "time_spread_task_runner.h"
 #include "../containers/std_vector.h"
+#include "../errors.h"
 #include "../godot/classes/time.h"
 #include "../memory/memory.h"
 #include "../profiling.h"
 
 namespace zylann {
 
+TimeSpreadTaskRunner::TimeSpreadTaskRunner() : _process_count(0) {}
+
 TimeSpreadTaskRunner::~TimeSpreadTaskRunner() {
 	flush();
 }
 
-void TimeSpreadTaskRunner::push(ITimeSpreadTask *task, Priority priority) {
-	Queue &queue = _queues[priority];
+void TimeSpreadTaskRunner::push(ITimeSpreadTask *task, Priority priority, uint8_t category) {
+	ZN_ASSERT_RETURN(category < _categories.size());
+	Queue &queue = _categories[category].queues[priority];
+	const uint32_t push_time = _process_count;
 	MutexLock lock(queue.tasks_mutex);
-	queue.tasks.push(task);
+	queue.tasks.push(Item{ task, push_time });
 }
 
-void TimeSpreadTaskRunner::push(Span<ITimeSpreadTask *> tasks, Priority priority) {
-	Queue &queue = _queues[priority];
+void TimeSpreadTaskRunner::push(Span<ITimeSpreadTask *> tasks, Priority priority, uint8_t category) {
+	ZN_ASSERT_RETURN(category < _categories.size());
+	Queue &queue = _categories[category].queues[priority];
+	const uint32_t push_time = _process_count;
 	MutexLock lock(queue.tasks_mutex);
 	for (unsigned int i = 0; i < tasks.size(); ++i) {
-		queue.tasks.push(tasks[i]);
+		queue.tasks.push(Item{ tasks[i], push_time });
 	}
 }
 
+void TimeSpreadTaskRunner::set_category_weight(unsigned int category, float weight) {
+	ZN_ASSERT_RETURN(category < _categories.size());
+	ZN_ASSERT_RETURN(weight >= 0.f);
+	_categories[category].weight = weight;
+}
+
+float TimeSpreadTaskRunner::get_category_weight(unsigned int category) const {
+	ZN_ASSERT_RETURN_V(category < _categories.size(), 0.f);
+	return _categories[category].weight;
+}
+
+void TimeSpreadTaskRunner::set_aging_threshold(uint32_t process_calls) {
+	_aging_threshold = process_calls;
+}
+
+void TimeSpreadTaskRunner::add_external_time_usage(unsigned int category, uint32_t usec) {
+	ZN_ASSERT_RETURN(category < _categories.size());
+	_categories[category].external_time_usec += usec;
+}
+
+void TimeSpreadTaskRunner::set_clock(uint64_t (*func)()) {
+	_get_ticks_usec = func;
+}
+
+uint64_t TimeSpreadTaskRunner::get_ticks_usec() const {
+	if (_get_ticks_usec != nullptr) {
+		return _get_ticks_usec();
+	}
+	return Time::get_singleton()->get_ticks_usec();
+}
+
+void TimeSpreadTaskRunner::promote_aged_tasks(Category &category) {
+	static thread_local StdVector<Item> tls_aged_items;
+	ZN_ASSERT(tls_aged_items.size() == 0);
+
+	const uint32_t now = _process_count;
+	{
+		Queue &low_queue = category.queues[PRIORITY_LOW];
+		MutexLock lock(low_queue.tasks_mutex);
+		// Queues are FIFO so the oldest tasks are in front
+		while (low_queue.tasks.size() != 0 && now - low_queue.tasks.front().push_time >= _aging_threshold) {
+			tls_aged_items.push_back(low_queue.tasks.front());
+			low_queue.tasks.pop();
+		}
+	}
+	if (tls_aged_items.size() > 0) {
+		Queue &normal_queue = category.queues[PRIORITY_NORMAL];
+		MutexLock lock(normal_queue.tasks_mutex);
+		for (const Item &item : tls_aged_items) {
+			normal_queue.tasks.push(item);
+		}
+		tls_aged_items.clear();
+	}
+}
+
+ITimeSpreadTask *TimeSpreadTaskRunner::pop_task(Category &category, Priority &out_priority) {
+	// Consume from high priority queues first
+	for (unsigned int queue_index = 0; queue_index < category.queues.size(); ++queue_index) {
+		Queue &queue = category.queues[queue_index];
+		MutexLock lock(queue.tasks_mutex);
+		if (queue.tasks.size() != 0) {
+			ITimeSpreadTask *task = queue.tasks.front().task;
+			queue.tasks.pop();
+			out_priority = Priority(queue_index);
+			return task;
+		}
+	}
+	return nullptr;
+}
+
 void TimeSpreadTaskRunner::process(uint64_t time_budget_usec) {
 	ZN_PROFILE_SCOPE();
-	const Time &time = *Time::get_singleton();
 
-	static thread_local FixedArray<StdVector<ITimeSpreadTask *>, PRIORITY_COUNT> tls_postponed_tasks;
-	for (unsigned int i = 0; i < tls_postponed_tasks.size(); ++i) {
-		ZN_ASSERT(tls_postponed_tasks[i].size() == 0);
+	static thread_local FixedArray<FixedArray<StdVector<ITimeSpreadTask *>, PRIORITY_COUNT>, MAX_CATEGORIES>
+			tls_postponed_tasks;
+
+	++_process_count;
+
+	// Reset stats and deduct time spent outside of tasks since the last call
+	uint64_t external_time_usec = 0;
+	float total_weight = 0.f;
+	FixedArray<bool, MAX_CATEGORIES> has_pending_tasks;
+	for (unsigned int category_index = 0; category_index < _categories.size(); ++category_index) {
+		Category &category = _categories[category_index];
+		promote_aged_tasks(category);
+
+		category.stats.last_time_usec = category.external_time_usec;
+		category.stats.last_budget_usec = 0;
+		category.stats.last_run_count = 0;
+		category.stats.total_time_usec += category.external_time_usec;
+		external_time_usec += category.external_time_usec;
+		category.external_time_usec = 0;
+
+		has_pending_tasks[category_index] = get_pending_count(category) > 0;
+		if (has_pending_tasks[category_index]) {
+			total_weight += category.weight;
+		}
 	}
 
-	const uint64_t time_before = time.get_ticks_usec();
+	const uint64_t budget_usec = external_time_usec < time_budget_usec ? time_budget_usec - external_time_usec : 0;
+
+	bool ran_any_task = false;
+
+	auto run_tasks = [this, &ran_any_task](
+							 Category &category,
+							 FixedArray<StdVector<ITimeSpreadTask *>, PRIORITY_COUNT> &postponed_tasks,
+							 uint64_t category_budget_usec,
+							 bool at_least_one
+					 ) {
+		const uint64_t time_before = get_ticks_usec();
+		uint64_t elapsed_usec = 0;
 
-	// Do at least one task
-	do {
-		ITimeSpreadTask *task = nullptr;
+		while (elapsed_usec < category_budget_usec || at_least_one) {
+			at_least_one = false;
 
-		// Consume from high priority queues first
-		unsigned int queue_index;
-		for (queue_index = 0; queue_index < _queues.size(); ++queue_index) {
-			Queue &queue = _queues[queue_index];
-			MutexLock lock(queue.tasks_mutex);
-			if (queue.tasks.size() != 0) {
-				task = queue.tasks.front();
-				queue.tasks.pop();
+			Priority priority;
+			ITimeSpreadTask *task = pop_task(category, priority);
+			if (task == nullptr) {
 				break;
 			}
-		}
 
-		if (task == nullptr) {
-			break;
+			TimeSpreadTaskContext ctx;
+			task->run(ctx);
+
+			if (ctx.postpone) {
+				postponed_tasks[priority].push_back(task);
+			} else {
+				// TODO Call recycling function instead?
+				ZN_DELETE(task);
+			}
+
+			++category.stats.last_run_count;
+			ran_any_task = true;
+			elapsed_usec = get_ticks_usec() - time_before;
 		}
 
-		TimeSpreadTaskContext ctx;
-		task->run(ctx);
+		category.stats.last_time_usec += elapsed_usec;
+		category.stats.total_time_usec += elapsed_usec;
+	};
 
-		if (ctx.postpone) {
-			tls_postponed_tasks[queue_index].push_back(task);
-		} else {
-			// TODO Call recycling function instead?
-			ZN_DELETE(task);
+	const uint64_t time_before = get_ticks_usec();
+
+	// First pass: each category runs within its own share. Categories with a weight run at least one task, so they
+	// can't be completely starved by others.
+	if (total_weight > 0.f) {
+		for (unsigned int category_index = 0; category_index < _categories.size(); ++category_index) {
+			Category &category = _categories[category_index];
+			if (!has_pending_tasks[category_index] || category.weight <= 0.f) {
+				continue;
+			}
+			const uint64_t share_usec = static_cast<uint64_t>(budget_usec * (category.weight / total_weight));
+			category.stats.last_budget_usec = share_usec;
+			run_tasks(category, tls_postponed_tasks[category_index], share_usec, true);
 		}
+	}
 
-	} while (time.get_ticks_usec() - time_before < time_budget_usec);
+	// Second pass: time left unused is given to categories in order
+	for (unsigned int category_index = 0; category_index < _categories.size(); ++category_index) {
+		if (!has_pending_tasks[category_index]) {
+			continue;
+		}
+		const uint64_t elapsed_usec = get_ticks_usec() - time_before;
+		// Do at least one task
+		if (elapsed_usec >= budget_usec && ran_any_task) {
+			break;
+		}
+		const uint64_t remaining_usec = elapsed_usec < budget_usec ? budget_usec - elapsed_usec : 0;
+		Category &category = _categories[category_index];
+		category.stats.last_budget_usec += remaining_usec;
+		run_tasks(category, tls_postponed_tasks[category_index], remaining_usec, !ran_any_task);
+	}
 
 	// Push postponed task back into queues
-	for (unsigned int queue_index = 0; queue_index < tls_postponed_tasks.size(); ++queue_index) {
-		StdVector<ITimeSpreadTask *> &tasks = tls_postponed_tasks[queue_index];
-		if (tasks.size() > 0) {
-			push(to_span(tasks), Priority(queue_index));
-			tasks.clear();
+	for (unsigned int category_index = 0; category_index < tls_postponed_tasks.size(); ++category_index) {
+		FixedArray<StdVector<ITimeSpreadTask *>, PRIORITY_COUNT> &postponed_tasks =
+				tls_postponed_tasks[category_index];
+		for (unsigned int queue_index = 0; queue_index < postponed_tasks.size(); ++queue_index) {
+			StdVector<ITimeSpreadTask *> &tasks = postponed_tasks[queue_index];
+			if (tasks.size() > 0) {
+				push(to_span(tasks), Priority(queue_index), category_index);
+				tasks.clear();
+			}
 		}
 	}
+
+	for (Category &category : _categories) {
+		category.stats.pending_count = get_pending_count(category);
+	}
 }
 
 void TimeSpreadTaskRunner::flush() {
@@ -86,14 +230,27 @@ void TimeSpreadTaskRunner::flush() {
 	}
 }
 
-unsigned int TimeSpreadTaskRunner::get_pending_count() const {
+unsigned int TimeSpreadTaskRunner::get_pending_count(const Category &category) const {
 	unsigned int count = 0;
-	for (unsigned int queue_index = 0; queue_index < _queues.size(); ++queue_index) {
-		const Queue &queue = _queues[queue_index];
+	for (unsigned int queue_index = 0; queue_index < category.queues.size(); ++queue_index) {
+		const Queue &queue = category.queues[queue_index];
 		MutexLock lock(queue.tasks_mutex);
 		count += queue.tasks.size();
 	}
 	return count;
 }
 
+unsigned int TimeSpreadTaskRunner::get_pending_count() const {
+	unsigned int count = 0;
+	for (const Category &category : _categories) {
+		count += get_pending_count(category);
+	}
+	return count;
+}
+
+TimeSpreadTaskRunner::CategoryStats TimeSpreadTaskRunner::get_category_stats(unsigned int category) const {
+	ZN_ASSERT_RETURN_V(category < _categories.size(), CategoryStats());
+	return _categories[category].stats;
+}
+
 } // namespace zylann
@@ -5,6 +5,7 @@
 #include "../containers/span.h"
 #include "../containers/std_queue.h"
 #include "../thread/mutex.h"
+#include <atomic>
 #include <cstdint>
 
 namespace zylann {
@@ -23,6 +24,10 @@ public:
 };
 
 // Runs tasks in the caller thread, within a time budget per call. Kind of like coroutines.
+//
+// Tasks are grouped into categories, each getting a share of the budget so one kind of work can't starve the others.
+// Categories with a lower index are processed first, and budget left unused by a category is given to the next ones.
+// Low-priority tasks that waited too many `process` calls are promoted to normal priority (aging).
 class TimeSpreadTaskRunner {
 public:
 	enum Priority { //
@@ -31,23 +36,76 @@ public:
 		PRIORITY_COUNT
 	};
 
+	static constexpr unsigned int MAX_CATEGORIES = 8;
+	static constexpr unsigned int DEFAULT_AGING_THRESHOLD = 30;
+
+	struct CategoryStats {
+		// Time spent during the last call to `process`, including time reported with `add_external_time_usage`.
+		uint32_t last_time_usec = 0;
+		// Budget the category was given during the last call to `process`.
+		uint32_t last_budget_usec = 0;
+		uint32_t last_run_count = 0;
+		uint32_t pending_count = 0;
+		uint64_t total_time_usec = 0;
+	};
+
+	TimeSpreadTaskRunner();
 	~TimeSpreadTaskRunner();
 
 	// Pushing is thread-safe.
-	void push(ITimeSpreadTask *task, Priority priority = PRIORITY_NORMAL);
-	void push(Span<ITimeSpreadTask *> tasks, Priority priority = PRIORITY_NORMAL);
+	void push(ITimeSpreadTask *task, Priority priority = PRIORITY_NORMAL, uint8_t category = 0);
+	void push(Span<ITimeSpreadTask *> tasks, Priority priority = PRIORITY_NORMAL, uint8_t category = 0);
+
+	// Sets how much of the budget a category gets relative to others. A weight of zero (the default) means the
+	// category only runs with time left over by other categories.
+	void set_category_weight(unsigned int category, float weight);
+	float get_category_weight(unsigned int category) const;
+
+	// How many calls to `process` a low-priority task can wait before it gets promoted.
+	void set_aging_threshold(uint32_t process_calls);
+
+	// Accounts for main-thread work done by a category outside of tasks (for example time-sliced loops in nodes).
+	// This time is deducted from the budget of the next call to `process`. Must be called from the same thread as
+	// `process`.
+	void add_external_time_usage(unsigned int category, uint32_t usec);
+
+	// Replaces the clock used to measure time spent by tasks, in microseconds. Used in tests.
+	void set_clock(uint64_t (*func)());
 
 	void process(uint64_t time_budget_usec);
 	void flush();
 	unsigned int get_pending_count() const;
+	CategoryStats get_category_stats(unsigned int category) const;
 
 private:
+	struct Item {
+		ITimeSpreadTask *task;
+		uint32_t push_time;
+	};
+
 	struct Queue {
-		StdQueue<ITimeSpreadTask *> tasks;
+		StdQueue<Item> tasks;
 		// TODO Optimization: naive thread safety. Should be enough for now.
 		BinaryMutex tasks_mutex;
 	};
-	FixedArray<Queue, PRIORITY_COUNT> _queues;
+
+	struct Category {
+		FixedArray<Queue, PRIORITY_COUNT> queues;
+		float weight = 0.f;
+		uint32_t external_time_usec = 0;
+		CategoryStats stats;
+	};
+
+	void promote_aged_tasks(Category &category);
+	ITimeSpreadTask *pop_task(Category &category, Priority &out_priority);
+	unsigned int get_pending_count(const Category &category) const;
+	uint64_t get_ticks_usec() const;
+
+	FixedArray<Category, MAX_CATEGORIES> _categories;
+	// Incremented on each call to `process`, used to measure how long tasks waited.
+	std::atomic_uint32_t _process_count;
+	uint32_t _aging_threshold = DEFAULT_AGING_THRESHOLD;
+	uint64_t (*_get_ticks_usec)() = nullptr;
 };
 
 } // namespace zylann
@@ -0,0 +1,131 @@
+#include "cpu_topology.h"
+#include "../errors.h"
+#include "../string/format.h"
+#include "thread.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <cstdio>
+#endif
+
+namespace zylann::cpu_topology {
+
+namespace {
+
+#if defined(__linux__)
+
+// Parses lists such as `0-15,32-47` as found in `/sys/devices/system/node/node*/cpulist`
+bool parse_cpu_list(const char *str, StdVector<uint32_t> &out_cpus) {
+	const char *c = str;
+	while (*c != '\0' && *c != '\n') {
+		char *end = nullptr;
+		const unsigned long begin_index = strtoul(c, &end, 10);
+		if (end == c) {
+			return false;
+		}
+		unsigned long end_index = begin_index;
+		c = end;
+		if (*c == '-') {
+			++c;
+			end_index = strtoul(c, &end, 10);
+			if (end == c || end_index < begin_index) {
+				return false;
+			}
+			c = end;
+		}
+		for (unsigned long i = begin_index; i <= end_index; ++i) {
+			out_cpus.push_back(i);
+		}
+		if (*c == ',') {
+			++c;
+		}
+	}
+	return true;
+}
+
+bool detect_numa_nodes(Topology &topology) {
+	for (unsigned int node_index = 0; node_index < MAX_NUMA_NODES; ++node_index) {
+		char path[64];
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node_index);
+
+		FILE *f = fopen(path, "r");
+		if (f == nullptr) {
+			// Nodes are numbered contiguously in most setups. Stop at the first missing one.
+			break;
+		}
+		char buffer[1024];
+		const bool read_ok = fgets(buffer, sizeof(buffer), f) != nullptr;
+		fclose(f);
+
+		NumaNode node;
+		node.os_index = node_index;
+		if (!read_ok || !parse_cpu_list(buffer, node.cpus)) {
+			ZN_PRINT_WARNING(format("Could not parse {}", path));
+			return false;
+		}
+		if (node.cpus.size() == 0) {
+			// Memory-only node
+			continue;
+		}
+		topology.nodes.push_back(std::move(node));
+	}
+	return topology.nodes.size() > 0;
+}
+
+#endif
+
+Topology detect_topology() {
+	Topology topology;
+	topology.cpu_count = Thread::get_hardware_concurrency();
+
+#if defined(__linux__)
+	if (detect_numa_nodes(topology)) {
+		return topology;
+	}
+	topology.nodes.clear();
+#endif
+
+	// Fallback to a single node
+	NumaNode node;
+	for (uint32_t i = 0; i < topology.cpu_count; ++i) {
+		node.cpus.push_back(i);
+	}
+	topology.nodes.push_back(std::move(node));
+	return topology;
+}
+
+thread_local unsigned int tls_numa_node = 0;
+
+} // namespace
+
+const Topology &get_topology() {
+	// Thread-safe initialization since C++11
+	static const Topology s_topology = detect_topology();
+	return s_topology;
+}
+
+bool set_current_thread_affinity(Span<const uint32_t> cpus) {
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (const uint32_t cpu : cpus) {
+		if (cpu < CPU_SETSIZE) {
+			CPU_SET(cpu, &set);
+		}
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
+
+unsigned int get_current_thread_numa_node() {
+	return tls_numa_node;
+}
+
+void set_current_thread_numa_node(unsigned int node_index) {
+	tls_numa_node = node_index;
+}
+
+} // namespace zylann::cpu_topology
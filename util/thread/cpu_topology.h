@@ -0,0 +1,43 @@
+#ifndef ZN_CPU_TOPOLOGY_H
+#define ZN_CPU_TOPOLOGY_H
+
+#include "../containers/span.h"
+#include "../containers/std_vector.h"
+#include <cstdint>
+
+namespace zylann::cpu_topology {
+
+static constexpr unsigned int MAX_NUMA_NODES = 8;
+
+struct NumaNode {
+	// Index of the node as numbered by the OS. Can differ from the index in `Topology::nodes`, because nodes without
+	// CPUs are not listed.
+	uint32_t os_index = 0;
+	// Indices of logical CPUs belonging to this node
+	StdVector<uint32_t> cpus;
+};
+
+// Describes how logical CPUs are grouped into NUMA nodes. Only implemented on Linux. On other platforms, or if
+// detection fails, a single node containing all CPUs is reported.
+struct Topology {
+	StdVector<NumaNode> nodes;
+	uint32_t cpu_count = 0;
+};
+
+// Detected once and cached. Thread-safe.
+const Topology &get_topology();
+
+inline unsigned int get_numa_node_count() {
+	return get_topology().nodes.size();
+}
+
+// Restricts the current thread to run on the given logical CPUs. Returns false if not supported or if it failed.
+bool set_current_thread_affinity(Span<const uint32_t> cpus);
+
+// The NUMA node a thread was assigned to, if it was pinned. Returns 0 for threads that were not.
+unsigned int get_current_thread_numa_node();
+void set_current_thread_numa_node(unsigned int node_index);
+
+} // namespace zylann::cpu_topology
+
+#endif // ZN_CPU_TOPOLOGY_H
@@ -105,14 +105,22 @@ public:
 	// Scoped helpers
 
 	struct Read {
-		Read(SpatialLock3D &p_locker, const BoxBounds3i p_box) : locker(p_locker), box(p_box) {
+		Read(SpatialLock3D &p_locker, const BoxBounds3i p_box) : locker(p_locker), box(p_box), locked(true) {
 			locker.lock_read(box);
 		}
+		// If `wait` is false, the lock is only attempted, and `locked` must be checked.
+		Read(SpatialLock3D &p_locker, const BoxBounds3i p_box, bool wait) :
+				locker(p_locker),
+				box(p_box),
+				locked(wait ? (locker.lock_read(box), true) : locker.try_lock_read(box)) {}
 		~Read() {
-			locker.unlock_read(box);
+			if (locked) {
+				locker.unlock_read(box);
+			}
 		}
 		SpatialLock3D &locker;
 		const BoxBounds3i box;
+		const bool locked;
 	};
 
 	struct Write {